@@ -55,7 +55,9 @@ CallbackSearchReturn CallbackAxisPointsAbstract::callback (const QString & /* cu
     QPointF posScreen = point.posScreen ();
     QPointF posGraph = point.posGraph ();
 
-    if (m_pointIdentifierOverride == point.identifier ()) {
+    // Points that do not belong to a Document, like the candidate point for an add, have no identifier
+    if (!m_pointIdentifierOverride.isEmpty () &&
+        (m_pointIdentifierOverride == point.identifier ())) {
 
       // Override the old point coordinates with its new (if all tests are passed) coordinates
       posScreen = m_posScreenOverride;
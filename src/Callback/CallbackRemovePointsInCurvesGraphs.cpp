@@ -12,9 +12,9 @@ CallbackSearchReturn CallbackRemovePointsInCurvesGraphs::callback (const QString
                                                                    const Point &point)
 {
   if (curveName == AXIS_CURVE_NAME) {
-    m_document.removePointAxis (point.identifier());
+    m_document.removePointAxis (point.pointId ());
   } else {
-    m_document.removePointGraph (point.identifier());
+    m_document.removePointGraph (point.pointId ());
   }
 
   return CALLBACK_SEARCH_RETURN_CONTINUE;
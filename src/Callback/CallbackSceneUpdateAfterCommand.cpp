@@ -21,16 +21,22 @@ CallbackSearchReturn CallbackSceneUpdateAfterCommand::callback (const QString &c
   CallbackSearchReturn rtn = CALLBACK_SEARCH_RETURN_CONTINUE;
 
   GraphicsPoint *graphicsPoint = 0;
-  if (m_pointIdentifierToGraphicsPoint.contains (point.identifier())) {
+  PointIdentifierToGraphicsPoint::const_iterator itr = m_pointIdentifierToGraphicsPoint.find (point.pointId ());
+  if (itr != m_pointIdentifierToGraphicsPoint.end ()) {
 
-    graphicsPoint = m_pointIdentifierToGraphicsPoint [point.identifier ()];
+    graphicsPoint = itr.value ();
+
+    // Bring position up to date, for Points that were replaced by Points at other positions
+    if (graphicsPoint->pos () != point.posScreen ()) {
+      graphicsPoint->setPos (point.posScreen ());
+    }
 
   } else {
 
     // Point does not exist in scene yet so create it
     const Curve *curve = m_document.curveForCurveName (curveName);
     ENGAUGE_CHECK_PTR (curve);
-    graphicsPoint = m_scene.addPoint (point.identifier (),
+    graphicsPoint = m_scene.addPoint (point.pointId (),
                                       curve->curveStyle().pointStyle (),
                                       point.posScreen ());
   }
@@ -1,4 +1,5 @@
 #include "Checker.h"
+#include "CheckerSideSampler.h"
 #include "EngaugeAssert.h"
 #include "EnumsToQt.h"
 #include "GraphicsArcItem.h"
@@ -146,41 +147,34 @@ void Checker::createSide (int pointRadius,
   // 1) Calculations for mostly orthogonal cartesian coordinates worked less well with non-orthogonal polar coordinates
   // 2) Ambiguity in polar coordinates between the shorter and longer paths between (theta0,radius) and (theta1,radius)
   //
-  // Current algorithm breaks up the interval between (xMin,yMin) and (xMax,yMax) into many smaller pieces and stitches the
-  // desired pieces together. For straight lines in linear graphs this algorithm is very much overkill, but there is no significant
-  // penalty and this approach works in every situation
-
-  // Should give single-pixel resolution on most images, and 'good enough' resolution on extremely large images
-  const int NUM_STEPS = 1000;
+  // Current algorithm breaks up the interval between (xMin,yMin) and (xMax,yMax) into smaller pieces and stitches the
+  // desired pieces together. The pieces are chosen adaptively by CheckerSideSampler, so they are only small where
+  // the side bends on the screen or crosses the circle around an axis point
+  CheckerSideSampler sampler (modelCoords,
+                              xFrom,
+                              yFrom,
+                              xTo,
+                              yTo,
+                              transformation,
+                              points,
+                              pointRadius);
+
+  QVector<QPointF> posScreens;
+  sampler.samples (posScreens);
+
+  LOG4CPP_DEBUG_S ((*mainCat)) << "Checker::createSide samples=" << posScreens.count ();
 
   bool stateSegmentIsActive = false;
   QPointF posStartScreen (0, 0);
 
-  // Loop through steps. Final step i=NUM_STEPS does final processing if a segment is active
-  for (int i = 0; i <= NUM_STEPS; i++) {
-
-    double s = (double) i / (double) NUM_STEPS;
-
-    // Interpolate coordinates assuming normal linear scaling
-    double xGraph = (1.0 - s) * xFrom + s * xTo;
-    double yGraph = (1.0 - s) * yFrom + s * yTo;
-
-    // Replace interpolated coordinates using log scaling if appropriate, preserving the same ranges
-    if (modelCoords.coordScaleXTheta() == COORD_SCALE_LOG) {
-      xGraph = qExp ((1.0 - s) * qLn (xFrom) + s * qLn (xTo));
-    }
-    if (modelCoords.coordScaleYRadius() == COORD_SCALE_LOG) {
-      yGraph = qExp ((1.0 - s) * qLn (yFrom) + s * qLn (yTo));
-    }
+  // Loop through samples. Final sample does final processing if a segment is active
+  int iLast = posScreens.count () - 1;
+  for (int i = 0; i <= iLast; i++) {
 
-    QPointF pointScreen;
-    transformation.transformRawGraphToScreen (QPointF (xGraph, yGraph),
-                                              pointScreen);
+    const QPointF &pointScreen = posScreens.at (i);
 
-    double distanceToNearestPoint = minScreenDistanceFromPoints (pointScreen,
-                                                                 points);
-    if ((distanceToNearestPoint < pointRadius) ||
-        (i == NUM_STEPS)) {
+    if (sampler.isInsidePointCircles (pointScreen) ||
+        (i == iLast)) {
 
         // Too close to point, so point is not included in side. Or this is the final iteration of the loop
       if (stateSegmentIsActive) {
@@ -385,25 +379,6 @@ QGraphicsItem *Checker::lineItem (const QPointF &posStartScreen,
                                         posEndScreen));
 }
 
-double Checker::minScreenDistanceFromPoints (const QPointF &posScreen,
-                                             const QList<Point> &points)
-{
-  double minDistance = 0;
-  for (int i = 0; i < points.count (); i++) {
-    const Point &pointCenter = points.at (i);
-
-    double dx = posScreen.x() - pointCenter.posScreen().x();
-    double dy = posScreen.y() - pointCenter.posScreen().y();
-
-    double distance = qSqrt (dx * dx + dy * dy);
-    if (i == 0 || distance < minDistance) {
-      minDistance = distance;
-    }
-  }
-
-  return minDistance;
-}
-
 void Checker::prepareForDisplay (const QPolygonF &polygon,
                                  int pointRadius,
                                  const DocumentModelAxesChecker &modelAxesChecker,
@@ -100,8 +100,6 @@ private:
                             SideSegments &sideSegments) const;
   QGraphicsItem *lineItem (const QPointF &posStartScreen,
                            const QPointF &posEndScreen) const;
-  double minScreenDistanceFromPoints (const QPointF &posScreen,
-                                      const QList<Point> &points);
 
   // Low level routine to set line color
   void setLineColor (SideSegments &sideSegments,
@@ -0,0 +1,196 @@
+#include "CheckerSideSampler.h"
+#include "DocumentModelCoords.h"
+#include <qmath.h>
+#include "Point.h"
+#include "Transformation.h"
+
+// Every side is split into at least 2^MIN_DEPTH intervals, so a side that bends back onto itself (like a full circle
+// in polar coordinates, where start and end coincide) is never mistaken for a straight line
+const int MIN_DEPTH = 3;
+
+// Safety limit on recursion, which is far beyond what single-pixel resolution requires on any image
+const int MAX_DEPTH = 24;
+
+// Intervals shorter than this many pixels are never subdivided, which gives the same single-pixel resolution as the
+// original fixed step algorithm had on most images
+const double MIN_INTERVAL_PIXELS = 1.0;
+
+// Largest allowed distance, in pixels, between the curve and the straight chords that approximate it
+const double BEND_TOLERANCE_PIXELS = 0.5;
+
+static double distanceSquaredToSegment (const QPointF &pos,
+                                        const QPointF &posStart,
+                                        const QPointF &posEnd)
+{
+  double dx = posEnd.x() - posStart.x();
+  double dy = posEnd.y() - posStart.y();
+  double lengthSquared = dx * dx + dy * dy;
+
+  double s = 0;
+  if (lengthSquared > 0) {
+    s = ((pos.x() - posStart.x()) * dx + (pos.y() - posStart.y()) * dy) / lengthSquared;
+    s = qMax (0.0, qMin (1.0, s));
+  }
+
+  double ex = posStart.x() + s * dx - pos.x();
+  double ey = posStart.y() + s * dy - pos.y();
+
+  return ex * ex + ey * ey;
+}
+
+static double distanceSquared (const QPointF &pos0,
+                               const QPointF &pos1)
+{
+  double dx = pos1.x() - pos0.x();
+  double dy = pos1.y() - pos0.y();
+
+  return dx * dx + dy * dy;
+}
+
+CheckerSideSampler::CheckerSideSampler(const DocumentModelCoords &modelCoords,
+                                       double xFrom,
+                                       double yFrom,
+                                       double xTo,
+                                       double yTo,
+                                       const Transformation &transformation,
+                                       const QList<Point> &points,
+                                       int pointRadius) :
+  m_transformation (transformation),
+  m_isLogX (modelCoords.coordScaleXTheta() == COORD_SCALE_LOG),
+  m_isLogY (modelCoords.coordScaleYRadius() == COORD_SCALE_LOG),
+  m_xFrom (m_isLogX ? qLn (xFrom) : xFrom),
+  m_yFrom (m_isLogY ? qLn (yFrom) : yFrom),
+  m_xTo (m_isLogX ? qLn (xTo) : xTo),
+  m_yTo (m_isLogY ? qLn (yTo) : yTo),
+  m_radius (pointRadius),
+  m_radiusSquared ((double) pointRadius * pointRadius)
+{
+  QList<Point>::const_iterator itr;
+  for (itr = points.begin (); itr != points.end (); itr++) {
+    m_centers.push_back ((*itr).posScreen ());
+  }
+}
+
+bool CheckerSideSampler::isInsidePointCircles (const QPointF &posScreen) const
+{
+  for (int i = 0; i < m_centers.count (); i++) {
+    if (distanceSquared (posScreen, m_centers.at (i)) < m_radiusSquared) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+QPointF CheckerSideSampler::posScreenAt (double s) const
+{
+  // Interpolate coordinates, which are already logs if log scaling applies so the same ranges are preserved
+  double xGraph = (1.0 - s) * m_xFrom + s * m_xTo;
+  double yGraph = (1.0 - s) * m_yFrom + s * m_yTo;
+
+  if (m_isLogX) {
+    xGraph = qExp (xGraph);
+  }
+  if (m_isLogY) {
+    yGraph = qExp (yGraph);
+  }
+
+  QPointF posScreen;
+  m_transformation.transformRawGraphToScreen (QPointF (xGraph, yGraph),
+                                              posScreen);
+
+  return posScreen;
+}
+
+void CheckerSideSampler::samples (QVector<QPointF> &posScreens) const
+{
+  posScreens.clear ();
+
+  QPointF posStart = posScreenAt (0.0);
+  QPointF posEnd = posScreenAt (1.0);
+
+  posScreens.push_back (posStart);
+  subdivide (0.0,
+             posStart,
+             1.0,
+             posEnd,
+             0,
+             posScreens);
+}
+
+bool CheckerSideSampler::shouldSubdivide (const QPointF &posStart,
+                                          const QPointF &posMiddle,
+                                          const QPointF &posEnd) const
+{
+  double chordSquared = distanceSquared (posStart, posEnd);
+  if (chordSquared < MIN_INTERVAL_PIXELS * MIN_INTERVAL_PIXELS &&
+      distanceSquared (posStart, posMiddle) < MIN_INTERVAL_PIXELS * MIN_INTERVAL_PIXELS) {
+    return false;
+  }
+
+  // Bend test uses the perpendicular distance of the middle position from the chord, so uneven speed along a straight
+  // line (as with log scaling) does not count as a bend
+  if (chordSquared > 0) {
+    double cross = (posEnd.x() - posStart.x()) * (posMiddle.y() - posStart.y()) -
+                   (posEnd.y() - posStart.y()) * (posMiddle.x() - posStart.x());
+    if (cross * cross > BEND_TOLERANCE_PIXELS * BEND_TOLERANCE_PIXELS * chordSquared) {
+      return true;
+    }
+  }
+
+  // Circle test. Distance from a circle center along a straight chord is largest at one of the chord endpoints,
+  // so the chords cross the circle boundary only if the nearest distance is inside and the farthest is outside
+  double radiusInnerSquared = qMax (0.0, m_radius - BEND_TOLERANCE_PIXELS);
+  radiusInnerSquared *= radiusInnerSquared;
+  double radiusOuterSquared = (m_radius + BEND_TOLERANCE_PIXELS) * (m_radius + BEND_TOLERANCE_PIXELS);
+  for (int i = 0; i < m_centers.count (); i++) {
+
+    const QPointF &center = m_centers.at (i);
+
+    double nearestSquared = qMin (distanceSquaredToSegment (center, posStart, posMiddle),
+                                  distanceSquaredToSegment (center, posMiddle, posEnd));
+    double farthestSquared = qMax (qMax (distanceSquared (center, posStart),
+                                         distanceSquared (center, posMiddle)),
+                                   distanceSquared (center, posEnd));
+
+    if ((nearestSquared < radiusOuterSquared) &&
+        (farthestSquared > radiusInnerSquared)) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void CheckerSideSampler::subdivide (double sStart,
+                                    const QPointF &posStart,
+                                    double sEnd,
+                                    const QPointF &posEnd,
+                                    int depth,
+                                    QVector<QPointF> &posScreens) const
+{
+  double sMiddle = (sStart + sEnd) / 2.0;
+  QPointF posMiddle = posScreenAt (sMiddle);
+
+  if ((depth < MIN_DEPTH) ||
+      ((depth < MAX_DEPTH) && shouldSubdivide (posStart, posMiddle, posEnd))) {
+
+    subdivide (sStart,
+               posStart,
+               sMiddle,
+               posMiddle,
+               depth + 1,
+               posScreens);
+    subdivide (sMiddle,
+               posMiddle,
+               sEnd,
+               posEnd,
+               depth + 1,
+               posScreens);
+
+  } else {
+
+    posScreens.push_back (posEnd);
+
+  }
+}
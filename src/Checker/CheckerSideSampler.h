@@ -0,0 +1,72 @@
+#ifndef CHECKER_SIDE_SAMPLER_H
+#define CHECKER_SIDE_SAMPLER_H
+
+#include "CoordScale.h"
+#include <QList>
+#include <QPointF>
+#include <QVector>
+
+class DocumentModelCoords;
+class Point;
+class Transformation;
+
+/// Adaptive sampling of one side of the Checker, from (xFrom,yFrom) to (xTo,yTo) in graph coordinates. Rather than
+/// sampling a fixed number of evenly spaced steps, each interval is only subdivided where the screen-space curve bends
+/// or where the interval crosses the circle around an axis point. A straight side in a linear graph then needs
+/// only tens of samples, most of them near the axis point circles.
+class CheckerSideSampler
+{
+public:
+  /// Single constructor. The logs for log scaling and the point circles are computed once here, so each sample
+  /// costs just one transformation and a few squared distance comparisons
+  CheckerSideSampler(const DocumentModelCoords &modelCoords,
+                     double xFrom,
+                     double yFrom,
+                     double xTo,
+                     double yTo,
+                     const Transformation &transformation,
+                     const QList<Point> &points,
+                     int pointRadius);
+
+  /// True if the screen position is inside the circle around any axis point
+  bool isInsidePointCircles (const QPointF &posScreen) const;
+
+  /// Screen positions along the side, in order, from the start to the end of the side inclusive
+  void samples (QVector<QPointF> &posScreens) const;
+
+private:
+  CheckerSideSampler();
+
+  // Screen position at fraction s along the side, with log interpolation where the scale is log
+  QPointF posScreenAt (double s) const;
+
+  // True if the interval between the two screen positions should be subdivided
+  bool shouldSubdivide (const QPointF &posStart,
+                        const QPointF &posMiddle,
+                        const QPointF &posEnd) const;
+
+  // Recursively subdivide between sStart and sEnd. Positions after posStart, up to and including posEnd, are appended
+  void subdivide (double sStart,
+                  const QPointF &posStart,
+                  double sEnd,
+                  const QPointF &posEnd,
+                  int depth,
+                  QVector<QPointF> &posScreens) const;
+
+  const Transformation &m_transformation;
+
+  // Interpolation endpoints, already converted to logs for log scaling
+  bool m_isLogX;
+  bool m_isLogY;
+  double m_xFrom;
+  double m_yFrom;
+  double m_xTo;
+  double m_yTo;
+
+  // Axis point circles
+  QVector<QPointF> m_centers;
+  double m_radius;
+  double m_radiusSquared;
+};
+
+#endif // CHECKER_SIDE_SAMPLER_H
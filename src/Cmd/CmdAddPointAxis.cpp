@@ -17,7 +17,8 @@ CmdAddPointAxis::CmdAddPointAxis (MainWindow &mainWindow,
                document,
                CMD_DESCRIPTION),
   m_posScreen (posScreen),
-  m_posGraph (posGraph)
+  m_posGraph (posGraph),
+  m_pointIdAdded (NULL_POINT_ID)
 {
   LOG4CPP_INFO_S ((*mainCat)) << "CmdAddPointAxis::CmdAddPointAxis"
                               << " posScreen=" << QPointFToString (posScreen).toLatin1 ().data ()
@@ -48,7 +49,7 @@ CmdAddPointAxis::CmdAddPointAxis (MainWindow &mainWindow,
   m_posScreen.setY(attributes.value(DOCUMENT_SERIALIZE_SCREEN_Y).toDouble());
   m_posGraph.setX(attributes.value(DOCUMENT_SERIALIZE_GRAPH_X).toDouble());
   m_posGraph.setY(attributes.value(DOCUMENT_SERIALIZE_GRAPH_Y).toDouble());
-  m_identifierAdded = attributes.value(DOCUMENT_SERIALIZE_IDENTIFIER).toString();
+  m_pointIdAdded = document.pointIdTable ()->intern (attributes.value(DOCUMENT_SERIALIZE_IDENTIFIER).toString());
 }
 
 CmdAddPointAxis::~CmdAddPointAxis ()
@@ -61,7 +62,7 @@ void CmdAddPointAxis::cmdRedo ()
 
   document().addPointAxisWithGeneratedIdentifier (m_posScreen,
                                                   m_posGraph,
-                                                  m_identifierAdded);
+                                                  m_pointIdAdded);
   document().updatePointOrdinals ();
   mainWindow().updateAfterCommand();
 }
@@ -70,7 +71,7 @@ void CmdAddPointAxis::cmdUndo ()
 {
   LOG4CPP_INFO_S ((*mainCat)) << "CmdAddPointAxis::cmdUndo";
 
-  document().removePointAxis (m_identifierAdded);
+  document().removePointAxis (m_pointIdAdded);
   document().updatePointOrdinals ();
   mainWindow().updateAfterCommand();
 }
@@ -84,6 +85,6 @@ void CmdAddPointAxis::saveXml (QXmlStreamWriter &writer) const
   writer.writeAttribute(DOCUMENT_SERIALIZE_SCREEN_Y, QString::number (m_posScreen.y()));
   writer.writeAttribute(DOCUMENT_SERIALIZE_GRAPH_X, QString::number (m_posGraph.x()));
   writer.writeAttribute(DOCUMENT_SERIALIZE_GRAPH_Y, QString::number (m_posGraph.y()));
-  writer.writeAttribute(DOCUMENT_SERIALIZE_IDENTIFIER, m_identifierAdded);
+  writer.writeAttribute(DOCUMENT_SERIALIZE_IDENTIFIER, document().pointIdTable ()->pointIdentifier (m_pointIdAdded));
   writer.writeEndElement();
 }
@@ -2,6 +2,7 @@
 #define CMD_ADD_POINT_AXIS_H
 
 #include "CmdAbstract.h"
+#include "PointIdTable.h"
 #include <QPointF>
 
 class QXmlStreamReader;
@@ -33,7 +34,7 @@ private:
 
   QPointF m_posScreen;
   QPointF m_posGraph;
-  QString m_identifierAdded; // Point that got added
+  PointId m_pointIdAdded; // Point that got added. Identifier string is available from the PointIdTable of the Document
 };
 
 #endif // CMD_ADD_POINT_AXIS_H
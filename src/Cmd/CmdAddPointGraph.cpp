@@ -20,6 +20,7 @@ CmdAddPointGraph::CmdAddPointGraph (MainWindow &mainWindow,
                CMD_DESCRIPTION),
   m_curveName (curveName),
   m_posScreen (posScreen),
+  m_pointIdAdded (NULL_POINT_ID),
   m_ordinal (ordinalForNewPoint (document,
                                  mainWindow.transformation(),
                                  posScreen,
@@ -54,7 +55,7 @@ CmdAddPointGraph::CmdAddPointGraph (MainWindow &mainWindow,
   m_posScreen.setY(attributes.value(DOCUMENT_SERIALIZE_SCREEN_Y).toDouble());
   m_curveName = attributes.value(DOCUMENT_SERIALIZE_CURVE_NAME).toString();
   m_ordinal = attributes.value(DOCUMENT_SERIALIZE_ORDINAL).toDouble();
-  m_identifierAdded = attributes.value(DOCUMENT_SERIALIZE_IDENTIFIER).toString();
+  m_pointIdAdded = document.pointIdTable ()->intern (attributes.value(DOCUMENT_SERIALIZE_IDENTIFIER).toString());
 }
 
 CmdAddPointGraph::~CmdAddPointGraph ()
@@ -67,7 +68,7 @@ void CmdAddPointGraph::cmdRedo ()
 
   document().addPointGraphWithGeneratedIdentifier (m_curveName,
                                                    m_posScreen,
-                                                   m_identifierAdded,
+                                                   m_pointIdAdded,
                                                    m_ordinal);
   document().updatePointOrdinals ();
   mainWindow().updateAfterCommand();
@@ -77,7 +78,7 @@ void CmdAddPointGraph::cmdUndo ()
 {
   LOG4CPP_INFO_S ((*mainCat)) << "CmdAddPointGraph::cmdUndo";
 
-  document().removePointGraph (m_identifierAdded);
+  document().removePointGraph (m_pointIdAdded);
   document().updatePointOrdinals ();
   mainWindow().updateAfterCommand();
 }
@@ -108,6 +109,6 @@ void CmdAddPointGraph::saveXml (QXmlStreamWriter &writer) const
   writer.writeAttribute(DOCUMENT_SERIALIZE_ORDINAL, QString::number (m_ordinal));
   writer.writeAttribute(DOCUMENT_SERIALIZE_SCREEN_X, QString::number (m_posScreen.x()));
   writer.writeAttribute(DOCUMENT_SERIALIZE_SCREEN_Y, QString::number (m_posScreen.y()));
-  writer.writeAttribute(DOCUMENT_SERIALIZE_IDENTIFIER, m_identifierAdded);
+  writer.writeAttribute(DOCUMENT_SERIALIZE_IDENTIFIER, document().pointIdTable ()->pointIdentifier (m_pointIdAdded));
   writer.writeEndElement();
 }
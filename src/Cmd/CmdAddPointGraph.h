@@ -2,6 +2,7 @@
 #define CMD_ADD_POINT_GRAPH_H
 
 #include "CmdAbstract.h"
+#include "PointIdTable.h"
 #include <QPointF>
 
 class QXmlStreamReader;
@@ -41,7 +42,7 @@ private:
 
   QString m_curveName;
   QPointF m_posScreen;
-  QString m_identifierAdded; // Point that got added
+  PointId m_pointIdAdded; // Point that got added. Identifier string is available from the PointIdTable of the Document
   double m_ordinal;
 };
 
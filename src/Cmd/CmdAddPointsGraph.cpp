@@ -0,0 +1,124 @@
+#include "CmdAddPointsGraph.h"
+#include "Document.h"
+#include "DocumentSerialize.h"
+#include "EngaugeAssert.h"
+#include "Logger.h"
+#include "MainWindow.h"
+#include <QXmlStreamReader>
+#include "Xml.h"
+
+const QString CMD_DESCRIPTION ("Add graph points");
+
+CmdAddPointsGraph::CmdAddPointsGraph (MainWindow &mainWindow,
+                                      Document &document,
+                                      const QString &curveName,
+                                      const QList<QPoint> &points) :
+  CmdAbstract (mainWindow,
+               document,
+               CMD_DESCRIPTION),
+  m_curveName (curveName)
+{
+  LOG4CPP_INFO_S ((*mainCat)) << "CmdAddPointsGraph::CmdAddPointsGraph"
+                              << " curve=" << curveName.toLatin1 ().data ()
+                              << " count=" << points.count ();
+
+  m_posScreens.reserve (points.count ());
+
+  QList<QPoint>::const_iterator itr;
+  for (itr = points.begin (); itr != points.end (); itr++) {
+    m_posScreens.push_back (*itr);
+  }
+}
+
+CmdAddPointsGraph::CmdAddPointsGraph (MainWindow &mainWindow,
+                                      Document &document,
+                                      const QString &cmdDescription,
+                                      QXmlStreamReader &reader) :
+  CmdAbstract (mainWindow,
+               document,
+               cmdDescription)
+{
+  LOG4CPP_INFO_S ((*mainCat)) << "CmdAddPointsGraph::CmdAddPointsGraph";
+
+  bool success = true;
+
+  QXmlStreamAttributes attributes = reader.attributes();
+
+  if (!attributes.hasAttribute(DOCUMENT_SERIALIZE_CURVE_NAME)) {
+      ENGAUGE_ASSERT (false);
+  }
+
+  m_curveName = attributes.value(DOCUMENT_SERIALIZE_CURVE_NAME).toString();
+
+  // Read each DOCUMENT_SERIALIZE_POINT until the end of DOCUMENT_SERIALIZE_CMD is encountered
+  while (loadNextFromReader (reader)) {
+
+    if (reader.atEnd() || reader.hasError ()) {
+      success = false;
+      break;
+    }
+
+    if ((reader.tokenType() == QXmlStreamReader::EndElement) &&
+        (reader.name() == DOCUMENT_SERIALIZE_CMD)) {
+      break;
+    }
+
+    if ((reader.tokenType() == QXmlStreamReader::StartElement) &&
+        (reader.name() == DOCUMENT_SERIALIZE_POINT)) {
+
+      attributes = reader.attributes();
+
+      if (attributes.hasAttribute(DOCUMENT_SERIALIZE_SCREEN_X) &&
+          attributes.hasAttribute(DOCUMENT_SERIALIZE_SCREEN_Y)) {
+
+        m_posScreens.push_back (QPointF (attributes.value(DOCUMENT_SERIALIZE_SCREEN_X).toDouble(),
+                                         attributes.value(DOCUMENT_SERIALIZE_SCREEN_Y).toDouble()));
+      }
+    }
+  }
+
+  if (!success) {
+    reader.raiseError ("Cannot read points to be added");
+  }
+}
+
+CmdAddPointsGraph::~CmdAddPointsGraph ()
+{
+}
+
+void CmdAddPointsGraph::cmdRedo ()
+{
+  LOG4CPP_INFO_S ((*mainCat)) << "CmdAddPointsGraph::cmdRedo count=" << m_posScreens.count ();
+
+  // Identifiers are the same every time, since CmdAbstract restores the identifier index before each redo
+  document().addPointsGraphWithGeneratedIdentifiers (m_curveName,
+                                                     m_posScreens,
+                                                     m_pointIdsAdded);
+  document().updatePointOrdinals ();
+  mainWindow().updateAfterCommand();
+}
+
+void CmdAddPointsGraph::cmdUndo ()
+{
+  LOG4CPP_INFO_S ((*mainCat)) << "CmdAddPointsGraph::cmdUndo count=" << m_pointIdsAdded.count ();
+
+  document().removePointsGraph (m_curveName,
+                                m_pointIdsAdded);
+  document().updatePointOrdinals ();
+  mainWindow().updateAfterCommand();
+}
+
+void CmdAddPointsGraph::saveXml (QXmlStreamWriter &writer) const
+{
+  writer.writeStartElement(DOCUMENT_SERIALIZE_CMD);
+  writer.writeAttribute(DOCUMENT_SERIALIZE_CMD_TYPE, DOCUMENT_SERIALIZE_CMD_ADD_POINTS_GRAPH);
+  writer.writeAttribute(DOCUMENT_SERIALIZE_CMD_DESCRIPTION, QUndoCommand::text ());
+  writer.writeAttribute(DOCUMENT_SERIALIZE_CURVE_NAME, m_curveName);
+  for (int i = 0; i < m_posScreens.count (); i++) {
+    writer.writeStartElement(DOCUMENT_SERIALIZE_POINT);
+    writer.writeAttribute(DOCUMENT_SERIALIZE_SCREEN_X, QString::number (m_posScreens.at (i).x()));
+    writer.writeAttribute(DOCUMENT_SERIALIZE_SCREEN_Y, QString::number (m_posScreens.at (i).y()));
+    writer.writeEndElement();
+  }
+  writer.writeEndElement();
+}
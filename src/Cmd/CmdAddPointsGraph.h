@@ -0,0 +1,45 @@
+#ifndef CMD_ADD_POINTS_GRAPH_H
+#define CMD_ADD_POINTS_GRAPH_H
+
+#include "CmdAbstract.h"
+#include "PointIdTable.h"
+#include <QList>
+#include <QPoint>
+#include <QPointF>
+#include <QVector>
+
+class QXmlStreamReader;
+
+/// Command for adding many graph points to one curve at once, such as the fill points of a Segment or the results of
+/// point matching. Compared to one CmdAddPointGraph per point, there is a single undo entry, the Document is updated in one
+/// pass, and the scene is updated once instead of once per point
+class CmdAddPointsGraph : public CmdAbstract
+{
+ public:
+  /// Constructor for normal creation
+  CmdAddPointsGraph(MainWindow &mainWindow,
+                    Document &document,
+                    const QString &curveName,
+                    const QList<QPoint> &points);
+
+  /// Constructor for parsing error report file xml
+  CmdAddPointsGraph(MainWindow &mainWindow,
+                    Document &document,
+                    const QString &cmdDescription,
+                    QXmlStreamReader &reader);
+
+  virtual ~CmdAddPointsGraph();
+
+  virtual void cmdRedo ();
+  virtual void cmdUndo ();
+  virtual void saveXml (QXmlStreamWriter &writer) const;
+
+private:
+  CmdAddPointsGraph();
+
+  QString m_curveName;
+  QVector<QPointF> m_posScreens;
+  QVector<PointId> m_pointIdsAdded; // Points that got added. Identifier strings are available from PointIdTable
+};
+
+#endif // CMD_ADD_POINTS_GRAPH_H
@@ -69,7 +69,8 @@ CmdCut::CmdCut (MainWindow &mainWindow,
   m_transformIsDefined = (defined == DOCUMENT_SERIALIZE_BOOL_TRUE);
   m_csv = attributes.value(DOCUMENT_SERIALIZE_CSV).toString();
   m_html = attributes.value(DOCUMENT_SERIALIZE_HTML).toString();
-  m_curvesGraphs.loadXml(reader);
+  m_curvesGraphs.loadXml(*document.pointIdTable (),
+                         reader);
 }
 
 CmdCut::~CmdCut ()
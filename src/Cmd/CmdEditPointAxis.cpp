@@ -12,18 +12,18 @@ const QString CMD_DESCRIPTION ("Edit axis point");
 
 CmdEditPointAxis::CmdEditPointAxis (MainWindow &mainWindow,
                                     Document &document,
-                                    const QString &pointIdentifier,
+                                    PointId pointId,
                                     const QPointF &posGraphBefore,
                                     const QPointF &posGraphAfter) :
   CmdAbstract (mainWindow,
                document,
                CMD_DESCRIPTION),
-  m_pointIdentifier (pointIdentifier),
+  m_pointId (pointId),
   m_posGraphBefore (posGraphBefore),
   m_posGraphAfter (posGraphAfter)
 {
   LOG4CPP_INFO_S ((*mainCat)) << "CmdEditPointAxis::CmdEditPointAxis point="
-                              << pointIdentifier.toLatin1 ().data ()
+                              << document.pointIdTable ()->pointIdentifier (pointId).toLatin1 ().data ()
                               << " posGraphBefore=" << QPointFToString (posGraphBefore).toLatin1 ().data ()
                               << " posGraphAfter=" << QPointFToString (posGraphAfter).toLatin1 ().data ();
 }
@@ -52,7 +52,7 @@ CmdEditPointAxis::CmdEditPointAxis (MainWindow &mainWindow,
   m_posGraphBefore.setY(attributes.value(DOCUMENT_SERIALIZE_GRAPH_Y_BEFORE).toDouble());
   m_posGraphAfter.setX(attributes.value(DOCUMENT_SERIALIZE_GRAPH_X_AFTER).toDouble());
   m_posGraphAfter.setY(attributes.value(DOCUMENT_SERIALIZE_GRAPH_Y_AFTER).toDouble());
-  m_pointIdentifier = attributes.value(DOCUMENT_SERIALIZE_IDENTIFIER).toString();
+  m_pointId = document.pointIdTable ()->intern (attributes.value(DOCUMENT_SERIALIZE_IDENTIFIER).toString());
 }
 
 CmdEditPointAxis::~CmdEditPointAxis ()
@@ -64,7 +64,7 @@ void CmdEditPointAxis::cmdRedo ()
   LOG4CPP_INFO_S ((*mainCat)) << "CmdEditPointAxis::cmdRedo";
 
   document().editPointAxis (m_posGraphAfter,
-                            m_pointIdentifier);
+                            m_pointId);
   document().updatePointOrdinals ();
   mainWindow().updateAfterCommand();
 }
@@ -74,7 +74,7 @@ void CmdEditPointAxis::cmdUndo ()
   LOG4CPP_INFO_S ((*mainCat)) << "CmdEditPointAxis::cmdUndo";
 
   document().editPointAxis (m_posGraphBefore,
-                            m_pointIdentifier);
+                            m_pointId);
   document().updatePointOrdinals ();
   mainWindow().updateAfterCommand();
 }
@@ -84,7 +84,7 @@ void CmdEditPointAxis::saveXml (QXmlStreamWriter &writer) const
   writer.writeStartElement(DOCUMENT_SERIALIZE_CMD);
   writer.writeAttribute(DOCUMENT_SERIALIZE_CMD_TYPE, DOCUMENT_SERIALIZE_CMD_EDIT_POINT_AXIS);
   writer.writeAttribute(DOCUMENT_SERIALIZE_CMD_DESCRIPTION, QUndoCommand::text ());
-  writer.writeAttribute(DOCUMENT_SERIALIZE_IDENTIFIER, m_pointIdentifier);
+  writer.writeAttribute(DOCUMENT_SERIALIZE_IDENTIFIER, document().pointIdTable ()->pointIdentifier (m_pointId));
   writer.writeAttribute(DOCUMENT_SERIALIZE_GRAPH_X_BEFORE, QString::number (m_posGraphBefore.x()));
   writer.writeAttribute(DOCUMENT_SERIALIZE_GRAPH_Y_BEFORE, QString::number (m_posGraphBefore.y()));
   writer.writeAttribute(DOCUMENT_SERIALIZE_GRAPH_X_AFTER, QString::number (m_posGraphAfter.x()));
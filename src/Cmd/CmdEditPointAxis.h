@@ -2,6 +2,7 @@
 #define CMD_EDIT_POINT_AXIS_H
 
 #include "CmdAbstract.h"
+#include "PointIdTable.h"
 #include <QPointF>
 
 class QXmlStreamReader;
@@ -14,7 +15,7 @@ class CmdEditPointAxis : public CmdAbstract
   /// Constructor for normal creation
   CmdEditPointAxis(MainWindow &mainWindow,
                    Document &document,
-                   const QString &pointIdentifier,
+                   PointId pointId,
                    const QPointF &posGraphBefore,
                    const QPointF &posGraphAfter);
 
@@ -33,7 +34,7 @@ class CmdEditPointAxis : public CmdAbstract
 private:
   CmdEditPointAxis();
 
-  QString m_pointIdentifier;
+  PointId m_pointId;
   QPointF m_posGraphBefore;
   QPointF m_posGraphAfter;
 };
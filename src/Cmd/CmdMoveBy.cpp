@@ -1,42 +1,55 @@
 #include "CmdMoveBy.h"
-#include "DataKey.h"
 #include "Document.h"
 #include "DocumentSerialize.h"
 #include "EngaugeAssert.h"
-#include "GraphicsItemType.h"
 #include "GraphicsScene.h"
-#include "GraphicsView.h"
 #include "Logger.h"
 #include "MainWindow.h"
-#include <QGraphicsItem>
+#include "PointIdentifiers.h"
+#include <algorithm>
 #include <QtToString.h>
 #include <QXmlStreamReader>
 
 const bool LINES_ARE_ALREADY_UPDATED = true;
 
+// Identifier for QUndoStack merging. Any value unique among the commands is fine
+const int CMD_MOVE_BY_ID = 1;
+
+// Identifier that tells QUndoStack to never merge
+const int CMD_MOVE_BY_ID_NO_MERGING = -1;
+
+// Moves further apart than this are kept as separate commands. Keyboard autorepeat is much faster than this
+const qint64 MERGE_WINDOW_MILLISECONDS = 1000;
+
 CmdMoveBy::CmdMoveBy(MainWindow &mainWindow,
                      Document &document,
                      const QPointF &deltaScreen,
                      const QString &moveText,
-                     const QStringList &selectedPointIdentifiers) :
+                     const QStringList &selectedPointIdentifiers,
+                     bool isKeyboardNudge) :
   CmdAbstract(mainWindow,
               document,
               moveText),
-  m_deltaScreen (deltaScreen)
+  m_deltaScreen (deltaScreen),
+  m_isKeyboardNudge (isKeyboardNudge)
 {
-  QStringList selected; // For debug
+  // Identifiers are converted once here, rather than on every redo and undo
+  m_movedPointIds.reserve (selectedPointIdentifiers.count ());
+
   QStringList::const_iterator itr;
   for (itr = selectedPointIdentifiers.begin (); itr != selectedPointIdentifiers.end (); itr++) {
-
-    QString selectedPointIdentifier = *itr;
-
-    selected << selectedPointIdentifier;
-    m_movedPoints.setKeyValue (selectedPointIdentifier, true);
+    m_movedPointIds.push_back (document.pointIdTable ()->pointId (*itr));
   }
 
+  sortMovedPointIds ();
+
+  // Only the count is logged, since logging thousands of identifiers on every keystroke is slow
   LOG4CPP_INFO_S ((*mainCat)) << "CmdMoveBy::CmdMoveBy"
                               << " deltaScreen=" << QPointFToString (deltaScreen).toLatin1 ().data ()
-                              << " selected=" << selected.join (", ").toLatin1 ().data () << ")";
+                              << " selected=" << selectedPointIdentifiers.count ()
+                              << " isKeyboardNudge=" << (isKeyboardNudge ? "true" : "false");
+
+  m_timeSinceLastMove.start ();
 }
 
 CmdMoveBy::CmdMoveBy (MainWindow &mainWindow,
@@ -45,7 +58,8 @@ CmdMoveBy::CmdMoveBy (MainWindow &mainWindow,
                       QXmlStreamReader &reader) :
   CmdAbstract (mainWindow,
                document,
-               cmdDescription)
+               cmdDescription),
+  m_isKeyboardNudge (false)
 {
   LOG4CPP_INFO_S ((*mainCat)) << "CmdMoveBy::CmdMoveBy";
 
@@ -58,7 +72,17 @@ CmdMoveBy::CmdMoveBy (MainWindow &mainWindow,
 
   m_deltaScreen.setX(attributes.value(DOCUMENT_SERIALIZE_SCREEN_X_DELTA).toDouble());
   m_deltaScreen.setY(attributes.value(DOCUMENT_SERIALIZE_SCREEN_Y_DELTA).toDouble());
-  m_movedPoints.loadXml (reader);
+
+  PointIdentifiers movedPoints;
+  movedPoints.loadXml (reader);
+
+  QList<QString> pointIdentifiers = movedPoints.keys ();
+  QList<QString>::const_iterator itr;
+  for (itr = pointIdentifiers.begin (); itr != pointIdentifiers.end (); itr++) {
+    m_movedPointIds.push_back (document.pointIdTable ()->intern (*itr));
+  }
+
+  sortMovedPointIds ();
 }
 
 CmdMoveBy::~CmdMoveBy ()
@@ -69,7 +93,7 @@ void CmdMoveBy::cmdRedo ()
 {
   LOG4CPP_INFO_S ((*mainCat)) << "CmdMoveBy::cmdRedo"
                               << " deltaScreen=" << QPointFToString (m_deltaScreen).toLatin1().data()
-                              << " moving=" << m_movedPoints.count ();
+                              << " moving=" << m_movedPointIds.count ();
 
   moveBy (m_deltaScreen);
   mainWindow().updateAfterCommand(LINES_ARE_ALREADY_UPDATED);
@@ -79,50 +103,61 @@ void CmdMoveBy::cmdUndo ()
 {
   LOG4CPP_INFO_S ((*mainCat)) << "CmdMoveBy::cmdUndo"
                               << " deltaScreen=" << QPointFToString (-1.0 * m_deltaScreen).toLatin1().data()
-                              << " moving=" << m_movedPoints.count ();
+                              << " moving=" << m_movedPointIds.count ();
 
   moveBy (-1.0 * m_deltaScreen);
   mainWindow().updateAfterCommand(LINES_ARE_ALREADY_UPDATED);
 }
 
-void CmdMoveBy::moveBy (const QPointF &deltaScreen)
+int CmdMoveBy::id () const
 {
-  LOG4CPP_INFO_S ((*mainCat)) << "CmdMoveBy::moveBy";
-
-  // Move Points in the Document
-  for (int i = 0; i < m_movedPoints.count(); i++) {
-
-    QString pointIdentifier = m_movedPoints.getKey (i);
-    document().movePoint (pointIdentifier, deltaScreen);
+  return (m_isKeyboardNudge ? CMD_MOVE_BY_ID : CMD_MOVE_BY_ID_NO_MERGING);
+}
 
+bool CmdMoveBy::mergeWith (const QUndoCommand *command)
+{
+  // QUndoStack only calls this for commands with the same id, which only keyboard nudges have, so the cast is safe.
+  // The other command has already been redone, so merging just accumulates its translation
+  const CmdMoveBy *cmdMoveBy = static_cast<const CmdMoveBy*> (command);
+
+  if (!m_isKeyboardNudge ||
+      !cmdMoveBy->m_isKeyboardNudge ||
+      !m_timeSinceLastMove.isValid () ||
+      !cmdMoveBy->m_timeSinceLastMove.isValid () ||
+      m_timeSinceLastMove.elapsed () > MERGE_WINDOW_MILLISECONDS ||
+      text () != cmdMoveBy->text () ||
+      m_movedPointIds != cmdMoveBy->m_movedPointIds) {
+    return false;
   }
 
-  // Move Points in GraphicsScene, using the new positions in Document
-  QList<QGraphicsItem *> items = mainWindow().view().items();
-  QList<QGraphicsItem *>::iterator itrS;
-  for (itrS = items.begin (); itrS != items.end (); itrS++) {
+  LOG4CPP_INFO_S ((*mainCat)) << "CmdMoveBy::mergeWith"
+                              << " deltaScreen=" << QPointFToString (cmdMoveBy->m_deltaScreen).toLatin1 ().data ();
 
-    QGraphicsItem *item = *itrS;
-    if (item->data (DATA_KEY_GRAPHICS_ITEM_TYPE).toInt () == GRAPHICS_ITEM_TYPE_POINT) {
+  m_deltaScreen += cmdMoveBy->m_deltaScreen;
+  m_timeSinceLastMove.restart ();
 
-      QString pointIdentifier = item->data (DATA_KEY_IDENTIFIER).toString ();
+  return true;
+}
+
+void CmdMoveBy::moveBy (const QPointF &deltaScreen)
+{
+  LOG4CPP_INFO_S ((*mainCat)) << "CmdMoveBy::moveBy";
 
-      if (m_movedPoints.contains (pointIdentifier)) {
+  GraphicsScene &scene = mainWindow().scene();
 
-        // Get the new position
-        QPointF posScreen = document().positionScreen (pointIdentifier);
+  // Move Points in the Document, then move the corresponding Points in GraphicsScene to the new positions
+  QVector<PointId>::const_iterator itr;
+  for (itr = m_movedPointIds.begin (); itr != m_movedPointIds.end (); itr++) {
 
-        if (item->pos () != posScreen) {
+    PointId pointId = *itr;
+    document().movePoint (pointId, deltaScreen);
+    scene.setPointPosition (pointId,
+                            document().positionScreen (pointId));
 
-          // Save the new position
-          item->setPos (posScreen);
-        }
-      }
-    }
   }
 
   // Update the lines attached to the points
-  mainWindow().updateGraphicsLinesToMatchGraphicsPoints();
+  mainWindow().updateGraphicsLinesToMatchGraphicsPoints(m_movedPointIds);
 }
 
 void CmdMoveBy::saveXml (QXmlStreamWriter &writer) const
@@ -132,6 +167,19 @@ void CmdMoveBy::saveXml (QXmlStreamWriter &writer) const
   writer.writeAttribute(DOCUMENT_SERIALIZE_CMD_DESCRIPTION, QUndoCommand::text ());
   writer.writeAttribute(DOCUMENT_SERIALIZE_SCREEN_X_DELTA, QString::number (m_deltaScreen.x()));
   writer.writeAttribute(DOCUMENT_SERIALIZE_SCREEN_Y_DELTA, QString::number (m_deltaScreen.y()));
-  m_movedPoints.saveXml (writer);
+
+  PointIdentifiers movedPoints;
+  for (int i = 0; i < m_movedPointIds.count (); i++) {
+    movedPoints.setKeyValue (document().pointIdTable ()->pointIdentifier (m_movedPointIds.at (i)),
+                             true);
+  }
+  movedPoints.saveXml (writer);
+
   writer.writeEndElement();
 }
+
+void CmdMoveBy::sortMovedPointIds ()
+{
+  std::sort (m_movedPointIds.begin (),
+             m_movedPointIds.end ());
+}
@@ -2,22 +2,29 @@
 #define CMD_MOVE_BY_H
 
 #include "CmdAbstract.h"
-#include "PointIdentifiers.h"
+#include "PointIdTable.h"
+#include <QElapsedTimer>
 #include <QPointF>
 #include <QStringList>
+#include <QVector>
 
 class QXmlStreamReader;
 
 /// Command for moving all selected Points by a specified translation.
+///
+/// Consecutive keyboard nudges of the same points in the same direction, arriving within a short time window of each
+/// other as when an arrow key is held down, are merged by QUndoStack into a single command using id and mergeWith.
+/// Mouse drags are never merged, so each drag stays a separate undo step
 class CmdMoveBy : public CmdAbstract
 {
 public:
-  /// Constructor for normal creation
+  /// Constructor for normal creation. Only keyboard nudges are merged with the previous command
   CmdMoveBy(MainWindow &mainWindow,
             Document &document,
             const QPointF &deltaScreen,
             const QString &moveText,
-            const QStringList &selectedPointIdentifiers);
+            const QStringList &selectedPointIdentifiers,
+            bool isKeyboardNudge);
 
   /// Constructor for parsing error report file xml
   CmdMoveBy(MainWindow &mainWindow,
@@ -29,6 +36,8 @@ public:
 
   virtual void cmdRedo ();
   virtual void cmdUndo ();
+  virtual int id () const;
+  virtual bool mergeWith (const QUndoCommand *command);
   virtual void saveXml (QXmlStreamWriter &writer) const;
 
 private:
@@ -36,8 +45,18 @@ private:
 
   void moveBy (const QPointF &deltaScreen);
 
+  // Sort the moved points, so mergeWith can compare the points of two commands directly
+  void sortMovedPointIds ();
+
   QPointF m_deltaScreen;
-  PointIdentifiers m_movedPoints;
+  QVector<PointId> m_movedPointIds; // Sorted. Identifier strings are only looked up when saving
+
+  // True for arrow key moves, which are the only moves that get merged. False for mouse drags and commands loaded
+  // from xml
+  bool m_isKeyboardNudge;
+
+  // Time since this command was created or last merged. Invalid for commands loaded from xml, which are never merged
+  QElapsedTimer m_timeSinceLastMove;
 };
 
 #endif // CMD_MOVE_BY_H
@@ -39,7 +39,8 @@ CmdSettingsCurves::CmdSettingsCurves(MainWindow &mainWindow,
     } else {
 
       // There was no original Curve
-      Curve curveCurrent (curveNameCurrent,
+      Curve curveCurrent (*document.pointIdTable (),
+                          curveNameCurrent,
                           ColorFilterSettings::defaultFilter(),
                           CurveStyle (LineStyle::defaultGraphCurve(m_curvesGraphsAfter.numCurves()),
                                       PointStyle::defaultGraphCurve(m_curvesGraphsAfter.numCurves())));
@@ -59,8 +60,10 @@ CmdSettingsCurves::CmdSettingsCurves (MainWindow &mainWindow,
 {
   LOG4CPP_INFO_S ((*mainCat)) << "CmdSettingsCurves::CmdSettingsCurves";
   
-  m_curvesGraphsBefore.loadXml (reader);
-  m_curvesGraphsAfter.loadXml (reader);
+  m_curvesGraphsBefore.loadXml (*document.pointIdTable (),
+                                reader);
+  m_curvesGraphsAfter.loadXml (*document.pointIdTable (),
+                               reader);
 }
 
 CmdSettingsCurves::~CmdSettingsCurves ()
@@ -4,8 +4,9 @@
 #include "EngaugeAssert.h"
 #include "Logger.h"
 #include "Point.h"
+#include <algorithm>
 #include <QDebug>
-#include <QMap>
+#include <QPair>
 #include <QXmlStreamReader>
 #include <QXmlStreamWriter>
 #include "Transformation.h"
@@ -15,34 +16,51 @@ const QString AXIS_CURVE_NAME ("Axes");
 const QString DEFAULT_GRAPH_CURVE_NAME ("Curve1");
 const QString TAB_DELIMITER ("\t");
 
-typedef QMap<double, QString> XOrThetaToPointIdentifier;
+// Beyond this number of changed graph coordinates, the ordinal index is rebuilt with one sort rather than being
+// updated point by point
+const int MAX_INCREMENTAL_ORDINAL_MOVES = 64;
 
-Curve::Curve(const QString &curveName,
+Curve::Curve(const PointIdTable &pointIdTable,
+             const QString &curveName,
              const ColorFilterSettings &colorFilterSettings,
              const CurveStyle &curveStyle) :
+  m_pointIdTable (&pointIdTable),
   m_curveName (curveName),
+  m_lookup (new CurvePointLookup),
+  m_lookupGeneration (0),
   m_colorFilterSettings (colorFilterSettings),
   m_curveStyle (curveStyle)
 {
 }
 
 Curve::Curve (const Curve &curve) :
+  m_pointIdTable (curve.m_pointIdTable),
   m_curveName (curve.curveName ()),
-  m_points (curve.points ()),
+  m_points (curve.m_points),
+  m_lookup (curve.m_lookup),
+  m_lookupGeneration (curve.m_lookupGeneration),
   m_colorFilterSettings (curve.colorFilterSettings ()),
   m_curveStyle (curve.curveStyle ())
 {
 }
 
-Curve::Curve (QXmlStreamReader &reader)
+Curve::Curve (PointIdTable &pointIdTable,
+              QXmlStreamReader &reader) :
+  m_pointIdTable (&pointIdTable),
+  m_lookup (new CurvePointLookup),
+  m_lookupGeneration (0)
 {
-  loadXml(reader);
+  loadXml(pointIdTable,
+          reader);
 }
 
 Curve &Curve::operator=(const Curve &curve)
 {
+  m_pointIdTable = curve.m_pointIdTable;
   m_curveName = curve.curveName ();
-  m_points = curve.points ();
+  m_points = curve.m_points;
+  m_lookup = curve.m_lookup;
+  m_lookupGeneration = curve.m_lookupGeneration;
   m_colorFilterSettings = curve.colorFilterSettings ();
   m_curveStyle = curve.curveStyle ();
 
@@ -51,23 +69,93 @@ Curve &Curve::operator=(const Curve &curve)
 
 void Curve::addPoint (Point point)
 {
-  m_points.push_back (point);
+  CurvePointLookup &lookup = lookupMutable ();
+
+  ENGAUGE_ASSERT (!lookup.m_pointIdToIndex.contains (point.pointId ()));
+
+  if (!lookup.m_ordinalIndexIsStale) {
+    lookup.m_ordinalIndex.insert (point.posGraph ().x (),
+                                  point.pointId (),
+                                  m_points.slotCount ());
+  }
+
+  lookup.m_pointIdToIndex [point.pointId ()] = m_points.slotCount ();
+  lookup.m_pointIdsDirty.insert (point.pointId ());
+  m_points.append (point);
 }
 
-void Curve::applyTransformation (const Transformation &transformation)
+void Curve::applyTransformation (const Transformation &transformation,
+                                 int transformationVersion)
 {
-  QList<Point>::iterator itr;
-  for (itr = m_points.begin (); itr != m_points.end (); itr++) {
+  CurvePointLookup &lookup = lookupMutable ();
 
-    // Get current screen coordinates
-    Point &point = *itr;
-    QPointF posScreen = point.posScreen();
-    QPointF posGraph;
-    transformation.transformScreenToRawGraph (posScreen,
-                                              posGraph);
+  // Indexes of the Points to be transformed
+  QVector<int> indexes;
+  if (transformationVersion != lookup.m_transformationVersion) {
+
+    indexes.reserve (m_points.count ());
+    for (int index = 0; index < m_points.slotCount (); index++) {
+      if (!m_points.isRemoved (index)) {
+        indexes.push_back (index);
+      }
+    }
+
+  } else {
+
+    QSet<PointId>::const_iterator itr;
+    for (itr = lookup.m_pointIdsDirty.begin (); itr != lookup.m_pointIdsDirty.end (); itr++) {
+      PointIdToIndex::const_iterator itrIndex = lookup.m_pointIdToIndex.find (*itr);
+      if (itrIndex != lookup.m_pointIdToIndex.end ()) {
+        indexes.push_back (itrIndex.value ());
+      }
+    }
+  }
+
+  lookup.m_transformationVersion = transformationVersion;
+  lookup.m_pointIdsDirty.clear ();
+
+  // Only the screen and graph columns are touched, so no Point objects are assembled
+  QVector<QPointF> posScreens (indexes.count ()), posGraphs;
+  for (int i = 0; i < indexes.count (); i++) {
+    posScreens [i] = m_points.posScreen (indexes.at (i));
+  }
+
+  transformation.transformScreenToRawGraph (posScreens,
+                                            posGraphs);
+
+  // Points whose x/theta values changed, with their old x/theta values, for updating the ordinal index
+  QVector<int> indexesMoved;
+  QVector<double> xOld;
+
+  for (int i = 0; i < indexes.count (); i++) {
+
+    int index = indexes.at (i);
+    const QPointF &posGraph = posGraphs.at (i);
+    double xGraphOld = m_points.posGraph (index).x ();
+
+    if (!lookup.m_ordinalIndexIsStale &&
+        (posGraph.x () != xGraphOld)) {
+
+      if (indexesMoved.count () < MAX_INCREMENTAL_ORDINAL_MOVES) {
+        indexesMoved.push_back (index);
+        xOld.push_back (xGraphOld);
+      } else {
+        lookup.m_ordinalIndexIsStale = true;
+      }
+    }
 
     // Overwrite old graph coordinates
-    point.setPosGraph (posGraph);
+    m_points.setPosGraph (index,
+                          posGraph);
+  }
+
+  if (!lookup.m_ordinalIndexIsStale) {
+    for (int i = 0; i < indexesMoved.count (); i++) {
+      int index = indexesMoved.at (i);
+      lookup.m_ordinalIndex.move (xOld.at (i),
+                                  m_points.posGraph (index).x (),
+                                  m_points.pointId (index));
+    }
   }
 }
 
@@ -87,19 +175,23 @@ CurveStyle Curve::curveStyle() const
 }
 
 void Curve::editPoint (const QPointF &posGraph,
-                       const QString &identifier)
+                       PointId pointId)
 {
-  // Search for the point with matching identifier
-  QList<Point>::iterator itr;
-  for (itr = m_points.begin (); itr != m_points.end (); itr++) {
+  CurvePointLookup &lookup = lookupMutable ();
 
-    Point &point = *itr;
-    if (point.identifier () == identifier) {
-
-      point.setPosGraph (posGraph);
-      break;
+  PointIdToIndex::const_iterator itr = lookup.m_pointIdToIndex.find (pointId);
+  if (itr != lookup.m_pointIdToIndex.end ()) {
 
+    int index = itr.value ();
+    if (!lookup.m_ordinalIndexIsStale) {
+      lookup.m_ordinalIndex.move (m_points.posGraph (index).x (),
+                                  posGraph.x (),
+                                  m_points.pointId (index));
     }
+
+    m_points.setPosGraph (index,
+                          posGraph);
+
   }
 }
 
@@ -112,11 +204,13 @@ void Curve::exportToClipboard (const QHash<QString, bool> &selectedHash,
   // This method assumes Copy is only allowed when Transformation is valid
 
   bool isFirst = true;
-  QList<Point>::const_iterator itr;
-  for (itr = m_points.begin (); itr != m_points.end (); itr++) {
+  for (int index = 0; index < m_points.slotCount (); index++) {
+
+    if (!m_points.isRemoved (index) &&
+        selectedHash.contains (m_pointIdTable->pointIdentifier (m_points.pointId (index)))) {
 
-    const Point &point = *itr;
-    if (selectedHash.contains (point.identifier ())) {
+      const Point point = m_points.point (*m_pointIdTable,
+                                          index);
 
       if (isFirst) {
 
@@ -134,7 +228,8 @@ void Curve::exportToClipboard (const QHash<QString, bool> &selectedHash,
 
       // Check if this curve already exists from a previously exported point
       if (curvesGraphs.curveForCurveName (m_curveName) == 0) {
-        Curve curve(m_curveName,
+        Curve curve(*m_pointIdTable,
+                    m_curveName,
                     ColorFilterSettings::defaultFilter (),
                     curveStyleDefault);
         curvesGraphs.addGraphCurveAtEnd(curve);
@@ -160,40 +255,60 @@ void Curve::exportToClipboard (const QHash<QString, bool> &selectedHash,
   }
 }
 
+bool Curve::isFunction () const
+{
+  return (m_curveStyle.lineStyle().curveConnectAs() == CONNECT_AS_FUNCTION_SMOOTH ||
+          m_curveStyle.lineStyle().curveConnectAs() == CONNECT_AS_FUNCTION_STRAIGHT);
+}
+
 void Curve::iterateThroughCurvePoints (const Functor2wRet<const QString &, const Point&, CallbackSearchReturn> &ftorWithCallback) const
 {
-  QList<Point>::const_iterator itr;
-  for (itr = m_points.begin (); itr != m_points.end (); itr++) {
+  for (int index = 0; index < m_points.slotCount (); index++) {
 
-    const Point &point = *itr;
+    if (!m_points.isRemoved (index)) {
 
-    CallbackSearchReturn rtn = ftorWithCallback (m_curveName, point);
+      const Point point = m_points.point (*m_pointIdTable,
+                                          index);
 
-    if (rtn == CALLBACK_SEARCH_RETURN_INTERRUPT) {
-      break;
+      CallbackSearchReturn rtn = ftorWithCallback (m_curveName, point);
+
+      if (rtn == CALLBACK_SEARCH_RETURN_INTERRUPT) {
+        break;
+      }
     }
   }
 }
 
 void Curve::iterateThroughCurveSegments (const Functor2wRet<const Point&, const Point&, CallbackSearchReturn> &ftorWithCallback) const
 {
-  int index;
-  typedef QMap<double, int> MapOrdinalToIndex;
-
-  // Compile a map of ordinals to list indexes
-  MapOrdinalToIndex mapOrdinalToIndex;
-  QList<Point>::const_iterator itr;
-  for (index = 0; index < m_points.count(); index++) {
+  typedef QPair<double, int> OrdinalAndIndex;
+
+  // Sort the indexes by ordinal, since the storage order of the Points is not significant. The index breaks ties, so
+  // Points with equal ordinals are all kept, in storage order, rather than overwriting each other as map keys would
+  QVector<OrdinalAndIndex> ordinalsAndIndexes;
+  ordinalsAndIndexes.reserve (m_points.count ());
+  for (int index = 0; index < m_points.slotCount (); index++) {
+    if (!m_points.isRemoved (index)) {
+      ordinalsAndIndexes.push_back (OrdinalAndIndex (m_points.ordinal (index),
+                                                     index));
+    }
+  }
 
-    const Point &point = m_points [index];
-    mapOrdinalToIndex [point.ordinal()] = index;
+  if (ordinalsAndIndexes.count () < 2) {
+    return;
   }
 
+  std::sort (ordinalsAndIndexes.begin (),
+             ordinalsAndIndexes.end ());
+
   // Loop through Points in order of their ordinals
-  for (index = 1; index < mapOrdinalToIndex.count(); index++) {
+  QVector<OrdinalAndIndex>::const_iterator itr = ordinalsAndIndexes.begin ();
+  Point pointMinus1 = m_points.point (*m_pointIdTable,
+                                      itr->second);
+  for (itr++; itr != ordinalsAndIndexes.end(); itr++) {
 
-    const Point &pointMinus1 = m_points [index - 1];
-    const Point &point = m_points [index];
+    Point point = m_points.point (*m_pointIdTable,
+                                  itr->second);
 
     CallbackSearchReturn rtn = ftorWithCallback (pointMinus1,
                                                  point);
@@ -201,10 +316,13 @@ void Curve::iterateThroughCurveSegments (const Functor2wRet<const Point&, const
     if (rtn == CALLBACK_SEARCH_RETURN_INTERRUPT) {
       break;
     }
+
+    pointMinus1 = point;
   }
 }
 
-void Curve::loadCurvePoints(QXmlStreamReader &reader)
+void Curve::loadCurvePoints(PointIdTable &pointIdTable,
+                            QXmlStreamReader &reader)
 {
   LOG4CPP_INFO_S ((*mainCat)) << "Curve::loadCurvePoints";
 
@@ -224,18 +342,23 @@ void Curve::loadCurvePoints(QXmlStreamReader &reader)
 
       if (reader.name () == DOCUMENT_SERIALIZE_POINT) {
 
-        Point point (reader);
-        m_points.push_back (point);
+        Point point (pointIdTable,
+                     reader);
+        addPoint (point);
       }
     }
   }
 
+  // Sorting once is much faster than inserting the loaded points one at a time
+  lookupMutable ().m_ordinalIndexIsStale = true;
+
   if (!success) {
     reader.raiseError("Cannot read curve data");
   }
 }
 
-void Curve::loadXml(QXmlStreamReader &reader)
+void Curve::loadXml(PointIdTable &pointIdTable,
+                    QXmlStreamReader &reader)
 {
   LOG4CPP_INFO_S ((*mainCat)) << "Curve::loadXml";
 
@@ -263,7 +386,8 @@ void Curve::loadXml(QXmlStreamReader &reader)
         if (reader.name() == DOCUMENT_SERIALIZE_COLOR_FILTER) {
           m_colorFilterSettings.loadXml(reader);
         } else if (reader.name() == DOCUMENT_SERIALIZE_CURVE_POINTS) {
-          loadCurvePoints(reader);
+          loadCurvePoints(pointIdTable,
+                          reader);
         } else if (reader.name() == DOCUMENT_SERIALIZE_CURVE_STYLE) {
           m_curveStyle.loadXml(reader);
         } else {
@@ -287,13 +411,41 @@ void Curve::loadXml(QXmlStreamReader &reader)
   }
 }
 
-void Curve::movePoint (const QString &pointIdentifier,
+const CurvePointLookup &Curve::lookupConst () const
+{
+  if (m_lookupGeneration != m_lookup->m_generation) {
+
+    // Another copy of this Curve has changed the shared lookups since they were copied, so they no longer match
+    // m_points. Build separate lookups, which releases this copy's reference to the shared lookups
+    m_lookup = QSharedPointer<CurvePointLookup> (new CurvePointLookup (m_points));
+    m_lookupGeneration = m_lookup->m_generation;
+  }
+
+  return *m_lookup;
+}
+
+CurvePointLookup &Curve::lookupMutable ()
+{
+  lookupConst ();
+
+  // Changed in place rather than copied, so a snapshot sharing these lookups never costs a copy of them
+  m_lookupGeneration = ++m_lookup->m_generation;
+
+  return *m_lookup;
+}
+
+void Curve::movePoint (PointId pointId,
                        const QPointF &deltaScreen)
 {
-  Point *point = pointForPointIdentifier (pointIdentifier);
+  CurvePointLookup &lookup = lookupMutable ();
 
-  QPointF posScreen = deltaScreen + point->posScreen ();
-  point->setPosScreen (posScreen);
+  PointIdToIndex::const_iterator itr = lookup.m_pointIdToIndex.find (pointId);
+  ENGAUGE_ASSERT (itr != lookup.m_pointIdToIndex.end ());
+
+  int index = itr.value ();
+  m_points.setPosScreen (index,
+                         deltaScreen + m_points.posScreen (index));
+  lookup.m_pointIdsDirty.insert (m_points.pointId (index));
 }
 
 int Curve::numPoints () const
@@ -301,70 +453,112 @@ int Curve::numPoints () const
   return m_points.count ();
 }
 
-Point *Curve::pointForPointIdentifier (const QString pointIdentifier)
+int Curve::numPointSlots () const
 {
-  Points::iterator itr;
-  for (itr = m_points.begin (); itr != m_points.end (); itr++) {
-    Point &point = *itr;
-    if (pointIdentifier == point.identifier ()) {
-      return &point;
-    }
-  }
+  return m_points.slotCount ();
+}
 
-  ENGAUGE_ASSERT (false);
-  return 0;
+double Curve::ordinalAt (int index) const
+{
+  return m_points.ordinal (index);
 }
 
-QPointF Curve::positionGraph (const QString &pointIdentifier) const
+double Curve::ordinalMax () const
+{
+  return m_points.ordinalMax ();
+}
+
+PointId Curve::pointIdAt (int index) const
+{
+  return m_points.pointId (index);
+}
+
+QPointF Curve::positionGraph (PointId pointId) const
 {
   QPointF posGraph;
 
-  // Search for point with matching identifier
-  Points::const_iterator itr;
-  for (itr = m_points.begin (); itr != m_points.end (); itr++) {
-    const Point &point = *itr;
-    if (pointIdentifier == point.identifier ()) {
-      posGraph = point.posGraph ();
-      break;
-    }
+  const PointIdToIndex &pointIdToIndex = lookupConst ().m_pointIdToIndex;
+  PointIdToIndex::const_iterator itr = pointIdToIndex.find (pointId);
+  if (itr != pointIdToIndex.end ()) {
+    posGraph = m_points.posGraph (itr.value ());
   }
 
   return posGraph;
 }
 
-QPointF Curve::positionScreen (const QString &pointIdentifier) const
+QPointF Curve::positionScreen (PointId pointId) const
 {
   QPointF posScreen;
 
-  // Search for point with matching identifier
-  Points::const_iterator itr;
-  for (itr = m_points.begin (); itr != m_points.end (); itr++) {
-    const Point &point = *itr;
-    if (pointIdentifier == point.identifier ()) {
-      posScreen = point.posScreen ();
-      break;
-    }
+  const PointIdToIndex &pointIdToIndex = lookupConst ().m_pointIdToIndex;
+  PointIdToIndex::const_iterator itr = pointIdToIndex.find (pointId);
+  if (itr != pointIdToIndex.end ()) {
+    posScreen = m_points.posScreen (itr.value ());
   }
 
   return posScreen;
 }
 
-const Points Curve::points () const
+QPointF Curve::positionScreenAt (int index) const
 {
-  return m_points;
+  return m_points.posScreen (index);
 }
 
-void Curve::removePoint (const QString &identifier)
+const QVector<Point> Curve::points () const
 {
-  // Search for point with matching identifier
-  Points::iterator itr;
-  for (itr = m_points.begin (); itr != m_points.end (); itr++) {
-    Point point = *itr;
-    if (point.identifier () == identifier) {
-      m_points.erase (itr);
-      break;
+  QVector<Point> points;
+  points.reserve (m_points.count ());
+
+  for (int index = 0; index < m_points.slotCount (); index++) {
+    if (!m_points.isRemoved (index)) {
+      points.push_back (m_points.point (*m_pointIdTable,
+                                        index));
+    }
+  }
+
+  return points;
+}
+
+void Curve::removePoint (PointId pointId)
+{
+  removePoints (QVector<PointId> (1, pointId));
+}
+
+void Curve::removePoints (const QVector<PointId> &pointIds)
+{
+  CurvePointLookup &lookup = lookupMutable ();
+
+  for (int i = 0; i < pointIds.count (); i++) {
+
+    PointIdToIndex::iterator itr = lookup.m_pointIdToIndex.find (pointIds.at (i));
+    if (itr != lookup.m_pointIdToIndex.end ()) {
+
+      int index = itr.value ();
+      if (!lookup.m_ordinalIndexIsStale) {
+        lookup.m_ordinalIndex.remove (m_points.posGraph (index).x (),
+                                      pointIds.at (i));
+      }
+
+      // The slot is left in place, so the other Points keep their indexes and the storage order is unchanged
+      m_points.remove (index);
+      lookup.m_pointIdToIndex.erase (itr);
+      lookup.m_pointIdsDirty.remove (pointIds.at (i));
     }
   }
+
+  // Reclaim the slots once they outnumber the Points, so the cost of compacting is spread over at least as many
+  // removals as there are Points left
+  if (m_points.countRemoved () > m_points.count ()) {
+
+    m_points.compact ();
+
+    lookup.m_pointIdToIndex.clear ();
+    for (int index = 0; index < m_points.slotCount (); index++) {
+      lookup.m_pointIdToIndex [m_points.pointId (index)] = index;
+    }
+
+    lookup.m_ordinalIndexIsStale = true;
+  }
 }
 
 void Curve::saveXml(QXmlStreamWriter &writer) const
@@ -379,10 +573,11 @@ void Curve::saveXml(QXmlStreamWriter &writer) const
 
   // Loop through points
   writer.writeStartElement(DOCUMENT_SERIALIZE_CURVE_POINTS);
-  Points::const_iterator itr;
-  for (itr = m_points.begin (); itr != m_points.end (); itr++) {
-    const Point &point = *itr;
-    point.saveXml (writer);
+  for (int index = 0; index < m_points.slotCount (); index++) {
+    if (!m_points.isRemoved (index)) {
+      m_points.point (*m_pointIdTable,
+                      index).saveXml (writer);
+    }
   }
   writer.writeEndElement();
 
@@ -401,42 +596,40 @@ void Curve::setCurveName (const QString &curveName)
 
 void Curve::setCurveStyle (const CurveStyle &curveStyle)
 {
+  // Switching between function and relation means every ordinal has to be redone
+  bool wasFunction = isFunction ();
   m_curveStyle = curveStyle;
+  if (wasFunction != isFunction ()) {
+    lookupMutable ().m_ordinalIndexIsStale = true;
+  }
 }
 
 void Curve::updatePointOrdinals ()
 {
   LOG4CPP_INFO_S ((*mainCat)) << "Curve::updatePointOrdinals";
 
-  if (m_curveStyle.lineStyle().curveConnectAs() == CONNECT_AS_FUNCTION_SMOOTH ||
-      m_curveStyle.lineStyle().curveConnectAs() == CONNECT_AS_FUNCTION_STRAIGHT) {
+  if (isFunction ()) {
 
-    // Make sure ordinals are properly ordered
+    CurvePointLookup &lookup = lookupMutable ();
 
-    // Get a map of x/theta values as keys with point identifiers as the values
-    XOrThetaToPointIdentifier xOrThetaToPointIdentifier;
-    Points::iterator itr;
-    for (itr = m_points.begin (); itr != m_points.end (); itr++) {
-      Point &point = *itr;
-      xOrThetaToPointIdentifier [point.posGraph().x()] = point.identifier();
+    // Make sure ordinals are properly ordered
+    if (lookup.m_ordinalIndexIsStale) {
+      lookup.m_ordinalIndex.rebuild (m_points);
+      lookup.m_ordinalIndexIsStale = false;
     }
 
-    // Since m_points is a list (and therefore does not provide direct access to elements), we build a temporary map of
-    // point identifier to ordinal, by looping through the sorted x/theta values. Since QMap is used, the x/theta keys are sorted
-    QMap<QString, double> pointIdentifierToOrdinal;
-    int ordinal = 0;
-    XOrThetaToPointIdentifier::const_iterator itrX;
-    for (itrX = xOrThetaToPointIdentifier.begin(); itrX != xOrThetaToPointIdentifier.end(); itrX++) {
+    // Override the old ordinal values, but only where positions in the index have changed. Points with the same
+    // x/theta value get distinct ordinals
+    int positionFirst, positionLast;
+    if (lookup.m_ordinalIndex.dirtyRange (positionFirst,
+                                          positionLast)) {
 
-      QString pointIdentifier = itrX.value();
-      pointIdentifierToOrdinal [pointIdentifier] = ordinal++;
+      for (int position = positionFirst; position <= positionLast; position++) {
+        m_points.setOrdinal (lookup.m_ordinalIndex.indexAt (position),
+                             position);
+      }
     }
 
-    // Override the old ordinal values
-    for (itr = m_points.begin(); itr != m_points.end(); itr++) {
-      Point &point = *itr;
-      int ordinalNew = pointIdentifierToOrdinal [point.identifier()];
-      point.setOrdinal (ordinalNew);
-    }
+    lookup.m_ordinalIndex.clearDirtyRange ();
   }
 }
@@ -3,14 +3,15 @@
 
 #include "CallbackSearchReturn.h"
 #include "ColorFilterSettings.h"
+#include "CurvePointColumns.h"
+#include "CurvePointLookup.h"
 #include "CurveStyle.h"
 #include "functor.h"
 #include "Point.h"
 #include <QHash>
-#include <QList>
+#include <QSharedPointer>
 #include <QString>
-
-typedef QList<Point> Points;
+#include <QVector>
 
 extern const QString AXIS_CURVE_NAME;
 extern const QString DEFAULT_GRAPH_CURVE_NAME;
@@ -25,13 +26,15 @@ class Transformation;
 class Curve
 {
 public:
-  /// Constructor from scratch.
-  Curve(const QString &curveName,
+  /// Constructor from scratch. The PointIdTable is that of the Document the Curve belongs to
+  Curve(const PointIdTable &pointIdTable,
+        const QString &curveName,
         const ColorFilterSettings &colorFilterSettings,
         const CurveStyle &curveStyle);
 
-  /// Constructor for use when loading from serialized xml
-  Curve (QXmlStreamReader &reader);
+  /// Constructor for use when loading from serialized xml. The identifiers of the Points are interned in the PointIdTable
+  Curve (PointIdTable &pointIdTable,
+         QXmlStreamReader &reader);
 
   /// Copy constructor. Copying a Curve only helps for making a copy, since access to any Points inside must be via functor.
   Curve (const Curve &curve);
@@ -42,8 +45,10 @@ public:
   /// Add Point to this Curve.
   void addPoint (Point point);
 
-  /// Apply transformation that is stored and updated externally.
-  void applyTransformation (const Transformation &transformation);
+  /// Apply transformation that is stored and updated externally. If the transformation version matches the version that
+  /// was last applied, only the Points added or moved since then are transformed. Otherwise all Points are transformed
+  void applyTransformation (const Transformation &transformation,
+                            int transformationVersion);
 
   /// Return the color filter.
   ColorFilterSettings colorFilterSettings () const;
@@ -56,7 +61,7 @@ public:
 
   /// Edit the graph coordinates of an axis point. This method does not apply to a graph point
   void editPoint (const QPointF &posGraph,
-                  const QString &identifier);
+                  PointId pointId);
 
   /// Export points in this Curve found in the specified point list.
   void exportToClipboard (const QHash<QString, bool> &selectedHash,
@@ -72,23 +77,47 @@ public:
   void iterateThroughCurveSegments (const Functor2wRet<const Point &, const Point &, CallbackSearchReturn> &ftorWithCallback) const;
 
   /// Translate the position of a point by the specified distance vector.
-  void movePoint (const QString &pointIdentifier,
+  void movePoint (PointId pointId,
                   const QPointF &deltaScreen);
 
   /// Number of points.
   int numPoints () const;
 
-  /// Return a shallow copy of the Points.
-  const Points points () const;
+  /// Number of slots for the per index accessors like ordinalAt. This includes the slots of removed Points that have
+  /// not been reclaimed yet, so it can be larger than numPoints
+  int numPointSlots () const;
+
+  /// Ordinal of the Point at the index, from 0 to numPointSlots () - 1. This and the other per index accessors read a
+  /// single column, so loops over every Point do not have to assemble a Point per index like points does. The slot of a
+  /// removed Point has NULL_POINT_ID as its PointId
+  double ordinalAt (int index) const;
+
+  /// Largest ordinal of the Points, or -1 if there are no Points. This reads a cached maximum per block of Points
+  /// rather than every Point
+  double ordinalMax () const;
+
+  /// PointId of the Point at the index. See ordinalAt
+  PointId pointIdAt (int index) const;
+
+  /// Return a copy of the Points. Each Point is assembled from the packed columns, so this takes linear time
+  const QVector<Point> points () const;
 
   /// Return the position, in graph coordinates, of the specified Point.
-  QPointF positionGraph (const QString &pointIdentifier) const;
+  QPointF positionGraph (PointId pointId) const;
 
   /// Return the position, in screen coordinates, of the specified Point.
-  QPointF positionScreen (const QString &pointIdentifier) const;
+  QPointF positionScreen (PointId pointId) const;
 
-  /// Perform the opposite of addPointAtEnd.
-  void removePoint (const QString &identifier);
+  /// Position, in screen coordinates, of the Point at the index. See ordinalAt
+  QPointF positionScreenAt (int index) const;
+
+  /// Perform the opposite of addPointAtEnd. The Point is only marked as removed, so this takes constant time and the
+  /// order of the remaining Points in saved files, exports and callbacks does not depend on which Points were removed
+  void removePoint (PointId pointId);
+
+  /// Same as removePoint for many Points. Identifiers of Points that are not in this Curve are ignored. Once removed
+  /// Points outnumber the remaining Points, their slots are reclaimed in a single pass that keeps the storage order
+  void removePoints (const QVector<PointId> &pointIds);
 
   /// Serialize curve
   void saveXml(QXmlStreamWriter &writer) const;
@@ -103,18 +132,37 @@ public:
   void setCurveStyle (const CurveStyle &curveStyle);
 
   /// See CurveGraphs::updatePointOrdinals. Same algorithm as GraphicsLineForCurve::updatePointOrdinalsAfterDrag, although
-  /// graph coordinates of points have been updated before this is called so the graph coordinates are not updated by this method
+  /// graph coordinates of points have been updated before this is called so the graph coordinates are not updated by this method.
+  /// Only the ordinals that changed since the last call are renumbered, using CurveOrdinalIndex
   void updatePointOrdinals ();
 
 private:
   Curve();
 
-  void loadCurvePoints(QXmlStreamReader &reader);
-  void loadXml(QXmlStreamReader &reader);
-  Point *pointForPointIdentifier (const QString pointIdentifier);
+  // True if ordinals follow the graph x/theta values rather than the order in which the points were created
+  bool isFunction () const;
+
+  void loadCurvePoints(PointIdTable &pointIdTable,
+                       QXmlStreamReader &reader);
+  void loadXml(PointIdTable &pointIdTable,
+               QXmlStreamReader &reader);
+
+  // Lookups for reading. They are rebuilt first if another copy of this Curve has changed the shared lookups
+  const CurvePointLookup &lookupConst () const;
+
+  // Lookups for writing. Other copies of this Curve that share the lookups will rebuild their own if they need them
+  CurvePointLookup &lookupMutable ();
 
+  const PointIdTable *m_pointIdTable; // Table of the Document, for the identifiers of the Points
   QString m_curveName;
-  Points m_points;
+  // Points are stored as columns, in the order they were added. Ordinals determine the order of the curve lines, but
+  // the storage order is what gets saved and exported
+  CurvePointColumns m_points;
+
+  // Lookups derived from m_points, shared with the copies of this Curve. They match m_points only while
+  // m_lookupGeneration equals their generation, and are rebuilt by lookupConst otherwise
+  mutable QSharedPointer<CurvePointLookup> m_lookup;
+  mutable int m_lookupGeneration;
 
   ColorFilterSettings m_colorFilterSettings;
   CurveStyle m_curveStyle;
@@ -0,0 +1,181 @@
+#include "CurveOrdinalIndex.h"
+#include "CurvePointColumns.h"
+#include "EngaugeAssert.h"
+#include <algorithm>
+#include <limits>
+#include <QtGlobal>
+
+const int NO_DIRTY_POSITION = -1;
+
+// Undefined graph coordinates, like the log of a negative value, are sorted before everything else so the sort order
+// is always well defined
+static double sortKey (double x)
+{
+  return qIsNaN (x) ? -std::numeric_limits<double>::max () : x;
+}
+
+static bool lessThan (const CurveOrdinalIndexEntry &entry0,
+                      const CurveOrdinalIndexEntry &entry1)
+{
+  return (entry0.x < entry1.x) ||
+         ((entry0.x == entry1.x) && (entry0.pointId < entry1.pointId));
+}
+
+CurveOrdinalIndex::CurveOrdinalIndex() :
+  m_dirtyFirst (NO_DIRTY_POSITION),
+  m_dirtyLast (NO_DIRTY_POSITION)
+{
+}
+
+void CurveOrdinalIndex::clear ()
+{
+  m_entries.clear ();
+  clearDirtyRange ();
+}
+
+void CurveOrdinalIndex::clearDirtyRange ()
+{
+  m_dirtyFirst = NO_DIRTY_POSITION;
+  m_dirtyLast = NO_DIRTY_POSITION;
+}
+
+int CurveOrdinalIndex::count () const
+{
+  return m_entries.count ();
+}
+
+bool CurveOrdinalIndex::dirtyRange (int &positionFirst,
+                                    int &positionLast) const
+{
+  positionFirst = m_dirtyFirst;
+  positionLast = qMin (m_dirtyLast, m_entries.count () - 1);
+
+  return (m_dirtyFirst != NO_DIRTY_POSITION) &&
+         (positionFirst <= positionLast);
+}
+
+int CurveOrdinalIndex::indexAt (int position) const
+{
+  return m_entries.at (position).index;
+}
+
+int CurveOrdinalIndex::insert (double x,
+                               PointId pointId,
+                               int index)
+{
+  CurveOrdinalIndexEntry entry;
+  entry.x = sortKey (x);
+  entry.pointId = pointId;
+  entry.index = index;
+
+  QVector<CurveOrdinalIndexEntry>::iterator itr = std::lower_bound (m_entries.begin (),
+                                                                    m_entries.end (),
+                                                                    entry,
+                                                                    lessThan);
+  int pos = itr - m_entries.begin ();
+  m_entries.insert (pos, entry);
+
+  // Every entry from here to the end has a new position
+  markDirty (pos, m_entries.count () - 1);
+
+  return pos;
+}
+
+void CurveOrdinalIndex::markDirty (int positionFirst,
+                                   int positionLast)
+{
+  if (m_dirtyFirst == NO_DIRTY_POSITION) {
+    m_dirtyFirst = positionFirst;
+    m_dirtyLast = positionLast;
+  } else {
+    m_dirtyFirst = qMin (m_dirtyFirst, positionFirst);
+    m_dirtyLast = qMax (m_dirtyLast, positionLast);
+  }
+}
+
+void CurveOrdinalIndex::move (double xOld,
+                              double xNew,
+                              PointId pointId)
+{
+  int pos = position (xOld, pointId);
+  int posStart = pos;
+
+  CurveOrdinalIndexEntry entry = m_entries [pos];
+  entry.x = sortKey (xNew);
+
+  // Local reorder. Neighbors are shifted over one at a time, which is fast since a moved point rarely passes more
+  // than a few of its neighbors
+  while ((pos + 1 < m_entries.count ()) && lessThan (m_entries [pos + 1], entry)) {
+    m_entries [pos] = m_entries [pos + 1];
+    ++pos;
+  }
+  while ((pos > 0) && lessThan (entry, m_entries [pos - 1])) {
+    m_entries [pos] = m_entries [pos - 1];
+    --pos;
+  }
+  m_entries [pos] = entry;
+
+  if (pos != posStart) {
+    markDirty (qMin (pos, posStart),
+               qMax (pos, posStart));
+  }
+}
+
+int CurveOrdinalIndex::position (double x,
+                                 PointId pointId) const
+{
+  CurveOrdinalIndexEntry entry;
+  entry.x = sortKey (x);
+  entry.pointId = pointId;
+  entry.index = 0;
+
+  QVector<CurveOrdinalIndexEntry>::const_iterator itr = std::lower_bound (m_entries.begin (),
+                                                                          m_entries.end (),
+                                                                          entry,
+                                                                          lessThan);
+  ENGAUGE_ASSERT (itr != m_entries.end ());
+  ENGAUGE_ASSERT (itr->pointId == pointId);
+
+  return itr - m_entries.begin ();
+}
+
+void CurveOrdinalIndex::rebuild (const CurvePointColumns &columns)
+{
+  m_entries.clear ();
+  m_entries.reserve (columns.count ());
+
+  for (int index = 0; index < columns.slotCount (); index++) {
+    if (!columns.isRemoved (index)) {
+
+      CurveOrdinalIndexEntry entry;
+      entry.x = sortKey (columns.posGraph (index).x ());
+      entry.pointId = columns.pointId (index);
+      entry.index = index;
+
+      m_entries.push_back (entry);
+    }
+  }
+
+  std::sort (m_entries.begin (),
+             m_entries.end (),
+             lessThan);
+
+  clearDirtyRange ();
+  if (m_entries.count () > 0) {
+    markDirty (0, m_entries.count () - 1);
+  }
+}
+
+void CurveOrdinalIndex::remove (double x,
+                                PointId pointId)
+{
+  int pos = position (x,
+                      pointId);
+
+  m_entries.remove (pos);
+
+  // Every entry from the removed entry to the end has a new position
+  if (pos < m_entries.count ()) {
+    markDirty (pos, m_entries.count () - 1);
+  }
+}
@@ -0,0 +1,78 @@
+#ifndef CURVE_ORDINAL_INDEX_H
+#define CURVE_ORDINAL_INDEX_H
+
+#include "PointIdTable.h"
+#include <QVector>
+
+class CurvePointColumns;
+
+/// One entry in CurveOrdinalIndex. The x value is a snapshot from when the entry was last inserted or moved, so
+/// entries can always be found by binary search even while the graph coordinates of the Points are being updated
+struct CurveOrdinalIndexEntry
+{
+  double x; ///< Graph x/theta value used for sorting
+  PointId pointId; ///< Tie breaker so points with the same x value keep distinct, repeatable ordinals
+  int index; ///< Index of the Point in the Curve
+};
+
+/// Points of one Curve sorted by graph x/theta value, so the ordinal of each point for function curves is just its
+/// position in this index. Insertions, removals and moves update the index incrementally with binary searches and local
+/// reordering, and remember the range of positions whose ordinals have changed so only that range gets renumbered.
+/// A full rebuild uses a single sort
+class CurveOrdinalIndex
+{
+public:
+  /// Single constructor
+  CurveOrdinalIndex();
+
+  /// Remove all entries
+  void clear ();
+
+  /// Number of entries
+  int count () const;
+
+  /// Forget the range of changed positions, after the ordinals have been renumbered
+  void clearDirtyRange ();
+
+  /// Range of positions whose ordinals have changed. Returns false if there are none
+  bool dirtyRange (int &positionFirst,
+                   int &positionLast) const;
+
+  /// Index of the Point at the specified position
+  int indexAt (int position) const;
+
+  /// Insert new entry. Returns the position of the new entry
+  int insert (double x,
+              PointId pointId,
+              int index);
+
+  /// Move existing entry to its new place after its x value changed
+  void move (double xOld,
+             double xNew,
+             PointId pointId);
+
+  /// Replace all entries using one sort. Only the graph and PointId columns are read, and removed Points are skipped
+  void rebuild (const CurvePointColumns &columns);
+
+  /// Remove existing entry. The indexes of the other entries are unchanged, since CurvePointColumns::remove leaves
+  /// the other Points in their slots
+  void remove (double x,
+               PointId pointId);
+
+private:
+
+  // Extend the range of changed positions
+  void markDirty (int positionFirst,
+                  int positionLast);
+
+  // Position of existing entry. The entry must exist
+  int position (double x,
+                PointId pointId) const;
+
+  QVector<CurveOrdinalIndexEntry> m_entries;
+
+  int m_dirtyFirst;
+  int m_dirtyLast;
+};
+
+#endif // CURVE_ORDINAL_INDEX_H
@@ -0,0 +1,276 @@
+#include "CurvePointColumns.h"
+#include "EngaugeAssert.h"
+#include "Point.h"
+
+// Points per block. Large enough that the per-block overhead is negligible and each column streams well, small enough
+// that editing one Point of a shared Curve copies little
+const int BLOCK_SHIFT = 10;
+const int BLOCK_SIZE = 1 << BLOCK_SHIFT;
+const int BLOCK_MASK = BLOCK_SIZE - 1;
+
+// Largest ordinal of a block without any Points. This matches Curve::ordinalMax for a Curve without any Points
+const double ORDINAL_MAX_EMPTY = -1.0;
+
+CurvePointBlock::CurvePointBlock () :
+  m_ordinalMax (ORDINAL_MAX_EMPTY)
+{
+}
+
+CurvePointColumns::CurvePointColumns() :
+  m_slotCount (0),
+  m_countRemoved (0)
+{
+}
+
+void CurvePointColumns::append (const Point &point)
+{
+  ENGAUGE_ASSERT (point.pointId () != NULL_POINT_ID);
+
+  if ((m_slotCount & BLOCK_MASK) == 0) {
+    m_blocks.push_back (BlockPointer (new CurvePointBlock));
+  }
+
+  CurvePointBlock &block = blockMutable (m_slotCount);
+  block.m_screenX.push_back (point.posScreen ().x ());
+  block.m_screenY.push_back (point.posScreen ().y ());
+  block.m_graphX.push_back (point.posGraph ().x ());
+  block.m_graphY.push_back (point.posGraph ().y ());
+  block.m_ordinal.push_back (point.ordinal ());
+  block.m_pointId.push_back (point.pointId ());
+  block.m_ordinalMax = qMax (block.m_ordinalMax,
+                             point.ordinal ());
+
+  ++m_slotCount;
+}
+
+const CurvePointBlock &CurvePointColumns::blockConst (int index) const
+{
+  ENGAUGE_ASSERT (index < m_slotCount);
+
+  return *m_blocks.at (index >> BLOCK_SHIFT);
+}
+
+CurvePointBlock &CurvePointColumns::blockMutable (int index)
+{
+  return *m_blocks [index >> BLOCK_SHIFT];
+}
+
+void CurvePointColumns::clear ()
+{
+  m_blocks.clear ();
+  m_slotCount = 0;
+  m_countRemoved = 0;
+}
+
+void CurvePointColumns::compact ()
+{
+  // Skip ahead to the first removed Point, so the blocks before it are not touched
+  int indexTo = 0;
+  while ((indexTo < m_slotCount) && !isRemoved (indexTo)) {
+    ++indexTo;
+  }
+
+  int indexFirstChanged = indexTo;
+
+  for (int indexFrom = indexTo; indexFrom < m_slotCount; indexFrom++) {
+    if (!isRemoved (indexFrom)) {
+
+      // Removed Points leave holes that the following Points slide into
+      copyPoint (indexFrom,
+                 indexTo);
+      ++indexTo;
+    }
+  }
+
+  truncate (indexTo);
+  m_countRemoved = 0;
+
+  for (int block = (indexFirstChanged >> BLOCK_SHIFT); block < m_blocks.count (); block++) {
+    updateOrdinalMax (*m_blocks [block]);
+  }
+}
+
+void CurvePointColumns::copyPoint (int indexFrom,
+                                   int indexTo)
+{
+  const CurvePointBlock &blockFrom = blockConst (indexFrom);
+  int offsetFrom = indexFrom & BLOCK_MASK;
+
+  // Values are copied out first since blockMutable may copy the block that blockFrom refers to
+  double screenX = blockFrom.m_screenX.at (offsetFrom);
+  double screenY = blockFrom.m_screenY.at (offsetFrom);
+  double graphX = blockFrom.m_graphX.at (offsetFrom);
+  double graphY = blockFrom.m_graphY.at (offsetFrom);
+  double ordinal = blockFrom.m_ordinal.at (offsetFrom);
+  PointId pointId = blockFrom.m_pointId.at (offsetFrom);
+
+  CurvePointBlock &blockTo = blockMutable (indexTo);
+  int offsetTo = indexTo & BLOCK_MASK;
+  blockTo.m_screenX [offsetTo] = screenX;
+  blockTo.m_screenY [offsetTo] = screenY;
+  blockTo.m_graphX [offsetTo] = graphX;
+  blockTo.m_graphY [offsetTo] = graphY;
+  blockTo.m_ordinal [offsetTo] = ordinal;
+  blockTo.m_pointId [offsetTo] = pointId;
+}
+
+int CurvePointColumns::count () const
+{
+  return m_slotCount - m_countRemoved;
+}
+
+int CurvePointColumns::countRemoved () const
+{
+  return m_countRemoved;
+}
+
+bool CurvePointColumns::isRemoved (int index) const
+{
+  return pointId (index) == NULL_POINT_ID;
+}
+
+double CurvePointColumns::ordinal (int index) const
+{
+  return blockConst (index).m_ordinal.at (index & BLOCK_MASK);
+}
+
+double CurvePointColumns::ordinalMax () const
+{
+  double ordinalMax = ORDINAL_MAX_EMPTY;
+
+  QVector<BlockPointer>::const_iterator itr;
+  for (itr = m_blocks.begin (); itr != m_blocks.end (); itr++) {
+    ordinalMax = qMax (ordinalMax,
+                       (*itr)->m_ordinalMax);
+  }
+
+  return ordinalMax;
+}
+
+Point CurvePointColumns::point (const PointIdTable &pointIdTable,
+                                int index) const
+{
+  const CurvePointBlock &block = blockConst (index);
+  int offset = index & BLOCK_MASK;
+
+  return Point (pointIdTable,
+                block.m_pointId.at (offset),
+                QPointF (block.m_screenX.at (offset),
+                         block.m_screenY.at (offset)),
+                QPointF (block.m_graphX.at (offset),
+                         block.m_graphY.at (offset)),
+                block.m_ordinal.at (offset));
+}
+
+PointId CurvePointColumns::pointId (int index) const
+{
+  return blockConst (index).m_pointId.at (index & BLOCK_MASK);
+}
+
+QPointF CurvePointColumns::posGraph (int index) const
+{
+  const CurvePointBlock &block = blockConst (index);
+  int offset = index & BLOCK_MASK;
+
+  return QPointF (block.m_graphX.at (offset),
+                  block.m_graphY.at (offset));
+}
+
+QPointF CurvePointColumns::posScreen (int index) const
+{
+  const CurvePointBlock &block = blockConst (index);
+  int offset = index & BLOCK_MASK;
+
+  return QPointF (block.m_screenX.at (offset),
+                  block.m_screenY.at (offset));
+}
+
+void CurvePointColumns::remove (int index)
+{
+  ENGAUGE_ASSERT (!isRemoved (index));
+
+  CurvePointBlock &block = blockMutable (index);
+  int offset = index & BLOCK_MASK;
+
+  block.m_pointId [offset] = NULL_POINT_ID;
+  if (block.m_ordinal.at (offset) == block.m_ordinalMax) {
+    updateOrdinalMax (block);
+  }
+
+  ++m_countRemoved;
+}
+
+void CurvePointColumns::setOrdinal (int index,
+                                    double ordinal)
+{
+  CurvePointBlock &block = blockMutable (index);
+  int offset = index & BLOCK_MASK;
+
+  double ordinalOld = block.m_ordinal.at (offset);
+  block.m_ordinal [offset] = ordinal;
+
+  if (ordinal >= block.m_ordinalMax) {
+    block.m_ordinalMax = ordinal;
+  } else if (ordinalOld == block.m_ordinalMax) {
+    updateOrdinalMax (block);
+  }
+}
+
+void CurvePointColumns::setPosGraph (int index,
+                                     const QPointF &posGraph)
+{
+  CurvePointBlock &block = blockMutable (index);
+  int offset = index & BLOCK_MASK;
+
+  block.m_graphX [offset] = posGraph.x ();
+  block.m_graphY [offset] = posGraph.y ();
+}
+
+void CurvePointColumns::setPosScreen (int index,
+                                      const QPointF &posScreen)
+{
+  CurvePointBlock &block = blockMutable (index);
+  int offset = index & BLOCK_MASK;
+
+  block.m_screenX [offset] = posScreen.x ();
+  block.m_screenY [offset] = posScreen.y ();
+}
+
+int CurvePointColumns::slotCount () const
+{
+  return m_slotCount;
+}
+
+void CurvePointColumns::truncate (int slotCount)
+{
+  ENGAUGE_ASSERT (slotCount <= m_slotCount);
+
+  m_blocks.resize ((slotCount + BLOCK_MASK) >> BLOCK_SHIFT);
+
+  int countLastBlock = slotCount & BLOCK_MASK;
+  if (countLastBlock != 0) {
+
+    // Partially filled last block. A full last block already has the right size
+    CurvePointBlock &blockLast = blockMutable (slotCount - 1);
+    blockLast.m_screenX.resize (countLastBlock);
+    blockLast.m_screenY.resize (countLastBlock);
+    blockLast.m_graphX.resize (countLastBlock);
+    blockLast.m_graphY.resize (countLastBlock);
+    blockLast.m_ordinal.resize (countLastBlock);
+    blockLast.m_pointId.resize (countLastBlock);
+  }
+
+  m_slotCount = slotCount;
+}
+
+void CurvePointColumns::updateOrdinalMax (CurvePointBlock &block)
+{
+  block.m_ordinalMax = ORDINAL_MAX_EMPTY;
+
+  for (int offset = 0; offset < block.m_pointId.count (); offset++) {
+    if (block.m_pointId.at (offset) != NULL_POINT_ID) {
+      block.m_ordinalMax = qMax (block.m_ordinalMax,
+                                 block.m_ordinal.at (offset));
+    }
+  }
+}
@@ -0,0 +1,145 @@
+#ifndef CURVE_POINT_COLUMNS_H
+#define CURVE_POINT_COLUMNS_H
+
+#include "PointIdTable.h"
+#include <QPointF>
+#include <QSharedData>
+#include <QSharedDataPointer>
+#include <QVector>
+
+class Point;
+
+/// Fixed capacity block of Points inside CurvePointColumns, with each Point member in its own contiguous array.
+/// Blocks are shared between copies of a Curve until one of the copies modifies the block
+class CurvePointBlock : public QSharedData
+{
+public:
+  /// Single constructor, for an empty block
+  CurvePointBlock ();
+
+  /// Screen x values
+  QVector<double> m_screenX;
+
+  /// Screen y values
+  QVector<double> m_screenY;
+
+  /// Graph x/theta values
+  QVector<double> m_graphX;
+
+  /// Graph y/radius values
+  QVector<double> m_graphY;
+
+  /// Ordinals
+  QVector<double> m_ordinal;
+
+  /// Compact point identifiers. Removed Points are left in place with NULL_POINT_ID
+  QVector<PointId> m_pointId;
+
+  /// Largest ordinal of the Points in this block that have not been removed, or -1 if there are none
+  double m_ordinalMax;
+};
+
+/// Structure-of-arrays storage for the Points of one Curve. Each Point member is kept in its own contiguous array of
+/// packed values, so bulk operations like transformations, exporting and line drawing stream through just the columns
+/// they need. Point identifier strings are not stored here, since the PointIdTable of the Document recovers them from
+/// the PointId column.
+///
+/// Point objects are created on demand as lightweight proxies by the point method, so code that works on single Points,
+/// like the Functor2wRet callbacks, is unchanged.
+///
+/// The arrays are split into copy-on-write blocks of BLOCK_SIZE Points. Copying a Curve, as the undo commands and the
+/// Document accessors do, only copies one pointer per block. Later edits to either copy duplicate just the blocks they
+/// touch, so snapshots of large Curves cost memory in proportion to the edits rather than to the Curve size. Every block
+/// except the last is always full.
+///
+/// Removing a Point just marks its slot with NULL_POINT_ID, so removal takes constant time and the other Points keep
+/// their slots and their storage order. The removed slots are reclaimed all at once by compact
+class CurvePointColumns
+{
+public:
+  /// Single constructor
+  CurvePointColumns();
+
+  /// Append a Point
+  void append (const Point &point);
+
+  /// Remove all Points
+  void clear ();
+
+  /// Reclaim the slots of the removed Points. The later Points are shifted down in one pass so their order is kept,
+  /// which changes their slot indexes. Blocks before the first removed Point are not touched
+  void compact ();
+
+  /// Number of Points, not counting removed Points
+  int count () const;
+
+  /// Number of removed Points whose slots have not been reclaimed by compact yet
+  int countRemoved () const;
+
+  /// True if the Point at index has been removed
+  bool isRemoved (int index) const;
+
+  /// Get method for ordinal of Point at index
+  double ordinal (int index) const;
+
+  /// Largest ordinal of the Points that have not been removed, or -1 if there are none. Only the cached maximum of
+  /// each block is read
+  double ordinalMax () const;
+
+  /// Proxy Point for the Point at index. The PointIdTable is that of the Document the Curve belongs to
+  Point point (const PointIdTable &pointIdTable,
+               int index) const;
+
+  /// Get method for PointId of Point at index, which is NULL_POINT_ID if the Point has been removed
+  PointId pointId (int index) const;
+
+  /// Get method for graph position of Point at index
+  QPointF posGraph (int index) const;
+
+  /// Get method for screen position of Point at index
+  QPointF posScreen (int index) const;
+
+  /// Remove the Point at index, in constant time. Its slot stays in place until the next compact
+  void remove (int index);
+
+  /// Set method for ordinal of Point at index
+  void setOrdinal (int index,
+                   double ordinal);
+
+  /// Set method for graph position of Point at index
+  void setPosGraph (int index,
+                    const QPointF &posGraph);
+
+  /// Set method for screen position of Point at index
+  void setPosScreen (int index,
+                     const QPointF &posScreen);
+
+  /// Number of slots, including those of removed Points. Indexes run from 0 to slotCount () - 1
+  int slotCount () const;
+
+private:
+
+  typedef QSharedDataPointer<CurvePointBlock> BlockPointer;
+
+  // Block for reading, which never triggers a copy
+  const CurvePointBlock &blockConst (int index) const;
+
+  // Block for writing, which is copied first if it is shared with another CurvePointColumns
+  CurvePointBlock &blockMutable (int index);
+
+  // Copy the Point at indexFrom over the Point at indexTo
+  void copyPoint (int indexFrom,
+                  int indexTo);
+
+  // Drop the slots at and after the specified slot count
+  void truncate (int slotCount);
+
+  // Recompute the largest ordinal of the block, after the Point with the largest ordinal was removed or lowered
+  void updateOrdinalMax (CurvePointBlock &block);
+
+  QVector<BlockPointer> m_blocks;
+  int m_slotCount;
+  int m_countRemoved;
+};
+
+#endif // CURVE_POINT_COLUMNS_H
@@ -0,0 +1,25 @@
+#include "CurvePointColumns.h"
+#include "CurvePointLookup.h"
+
+// Version for a Curve that has never been transformed. Document versions start after this
+const int TRANSFORMATION_VERSION_NONE = 0;
+
+CurvePointLookup::CurvePointLookup () :
+  m_ordinalIndexIsStale (true),
+  m_transformationVersion (TRANSFORMATION_VERSION_NONE),
+  m_generation (0)
+{
+}
+
+CurvePointLookup::CurvePointLookup (const CurvePointColumns &columns) :
+  m_ordinalIndexIsStale (true),
+  m_transformationVersion (TRANSFORMATION_VERSION_NONE),
+  m_generation (0)
+{
+  m_pointIdToIndex.reserve (columns.count ());
+  for (int index = 0; index < columns.slotCount (); index++) {
+    if (!columns.isRemoved (index)) {
+      m_pointIdToIndex [columns.pointId (index)] = index;
+    }
+  }
+}
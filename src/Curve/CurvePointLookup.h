@@ -0,0 +1,51 @@
+#ifndef CURVE_POINT_LOOKUP_H
+#define CURVE_POINT_LOOKUP_H
+
+#include "CurveOrdinalIndex.h"
+#include "PointIdTable.h"
+#include <QHash>
+#include <QSet>
+
+class CurvePointColumns;
+
+/// Index into CurvePointColumns for each point
+typedef QHash<PointId, int> PointIdToIndex;
+
+/// Lookups of one Curve that are derived from its CurvePointColumns. Copies of a Curve share a single CurvePointLookup
+/// rather than copying it, since otherwise the first edit after a Curve is copied, like the snapshots taken by the undo
+/// commands, would duplicate every hash entry and ordinal index entry of the Curve.
+///
+/// The copy that changes the lookups first keeps changing them in place and advances m_generation. The other copies
+/// then see that their generation is out of date, and build their own lookups from their columns only if they are
+/// used again
+class CurvePointLookup
+{
+public:
+  /// Constructor for a Curve without any Points
+  CurvePointLookup ();
+
+  /// Constructor that builds the lookups from the columns. Nothing is known about which ordinals and graph coordinates
+  /// are up to date, so the ordinal index is left to be rebuilt and every Point is left to be transformed
+  CurvePointLookup (const CurvePointColumns &columns);
+
+  /// Slot of each Point in the columns
+  PointIdToIndex m_pointIdToIndex;
+
+  /// Points sorted by graph x/theta, for function ordinals. When stale, the index is rebuilt on the next
+  /// Curve::updatePointOrdinals rather than updated point by point, which is faster for wholesale changes like loading
+  CurveOrdinalIndex m_ordinalIndex;
+
+  /// True if m_ordinalIndex has to be rebuilt before it is used
+  bool m_ordinalIndexIsStale;
+
+  /// Version of the transformation whose graph coordinates are in the columns, except for the dirty Points
+  int m_transformationVersion;
+
+  /// Points that were added or moved since the last transformation, and still have to be transformed
+  QSet<PointId> m_pointIdsDirty;
+
+  /// Advanced by every change, so the copies of a Curve that share this can tell whether it still matches their columns
+  int m_generation;
+};
+
+#endif // CURVE_POINT_LOOKUP_H
@@ -5,6 +5,7 @@
 #include "EngaugeAssert.h"
 #include "Logger.h"
 #include "Point.h"
+#include <QMap>
 #include <QTextStream>
 #include <QXmlStreamWriter>
 #include "Transformation.h"
@@ -16,55 +17,50 @@ CurvesGraphs::CurvesGraphs()
 
 void CurvesGraphs::addGraphCurveAtEnd (Curve curve)
 {
+  // First curve wins if names are duplicated, as with the original linear search
+  if (!m_curveNameToIndex.contains (curve.curveName ())) {
+    m_curveNameToIndex [curve.curveName ()] = m_curvesGraphs.count ();
+  }
+
   m_curvesGraphs.push_back (curve);
 }
 
 void CurvesGraphs::addPoint (const Point &point)
 {
-  QString curveName = Point::curveNameFromPointIdentifier (point.identifier());
-
-  Curve *curve = curveForCurveName (curveName);
+  Curve *curve = curveForCurveName (point.curveName ());
   curve->addPoint (point);
 }
 
-void CurvesGraphs::applyTransformation (const Transformation &transformation)
+void CurvesGraphs::applyTransformation (const Transformation &transformation,
+                                        int transformationVersion)
 {
   CurveList::iterator itr;
   for (itr = m_curvesGraphs.begin (); itr != m_curvesGraphs.end (); itr++) {
 
     Curve &curve = *itr;
-    curve.applyTransformation (transformation);
+    curve.applyTransformation (transformation,
+                               transformationVersion);
   }
 }
 
 Curve *CurvesGraphs::curveForCurveName (const QString &curveName)
 {
-  // Search for curve with matching name
-  CurveList::iterator itr;
-  for (itr = m_curvesGraphs.begin (); itr != m_curvesGraphs.end (); itr++) {
-
-    Curve &curve = *itr;
-    if (curveName == curve.curveName ()) {
-      return &curve;
-    }
+  int index = indexForCurveName (curveName);
+  if (index < 0) {
+    return 0;
   }
 
-  return 0;
+  return &m_curvesGraphs [index];
 }
 
 const Curve *CurvesGraphs::curveForCurveName (const QString &curveName) const
 {
-  // Search for curve with matching name
-  CurveList::const_iterator itr;
-  for (itr = m_curvesGraphs.begin (); itr != m_curvesGraphs.end (); itr++) {
-
-    const Curve &curve = *itr;
-    if (curveName == curve.curveName ()) {
-      return &curve;
-    }
+  int index = indexForCurveName (curveName);
+  if (index < 0) {
+    return 0;
   }
 
-  return 0;
+  return &m_curvesGraphs.at (index);
 }
 
 QStringList CurvesGraphs::curvesGraphsNames () const
@@ -83,53 +79,44 @@ QStringList CurvesGraphs::curvesGraphsNames () const
 
 int CurvesGraphs::curvesGraphsNumPoints (const QString &curveName) const
 {
-  // Search for curve with matching name
-  CurveList::const_iterator itr;
-  for (itr = m_curvesGraphs.begin (); itr != m_curvesGraphs.end (); itr++) {
+  const Curve *curve = curveForCurveName (curveName);
+  if (curve == 0) {
+    return 0;
+  }
 
-    const Curve &curve = *itr;
-    if (curve.curveName () == curveName) {
-      return curve.numPoints ();
-    }
+  return curve->numPoints ();
+}
+
+int CurvesGraphs::indexForCurveName (const QString &curveName) const
+{
+  CurveNameToIndex::const_iterator itr = m_curveNameToIndex.find (curveName);
+  if (itr == m_curveNameToIndex.end ()) {
+    return -1;
   }
 
-  return 0;
+  // Catch any curve that was renamed in place, which would leave the hash out of date
+  ENGAUGE_ASSERT (m_curvesGraphs.at (itr.value ()).curveName () == curveName);
+
+  return itr.value ();
 }
 
 void CurvesGraphs::iterateThroughCurvePoints (const QString &curveNameWanted,
                                               const Functor2wRet<const QString &, const Point &, CallbackSearchReturn> &ftorWithCallback)
 {
-  // Search for curve with matching name
-  CurveList::const_iterator itr;
-  for (itr = m_curvesGraphs.begin (); itr != m_curvesGraphs.end (); itr++) {
-
-    const Curve &curve = *itr;
-    if (curve.curveName () == curveNameWanted) {
+  // Const lookup, since the non-const one would detach the curve list from any copies that share it
+  const Curve *curve = static_cast<const CurvesGraphs *> (this)->curveForCurveName (curveNameWanted);
+  ENGAUGE_ASSERT (curve != 0);
 
-      curve.iterateThroughCurvePoints (ftorWithCallback);
-      return;
-    }
-  }
-
-  ENGAUGE_ASSERT (false);
+  curve->iterateThroughCurvePoints (ftorWithCallback);
 }
 
 void CurvesGraphs::iterateThroughCurveSegments (const QString &curveNameWanted,
                                                 const Functor2wRet<const Point &, const Point &, CallbackSearchReturn> &ftorWithCallback) const
 {
-  // Search for curve with matching name
-  CurveList::const_iterator itr;
-  for (itr = m_curvesGraphs.begin (); itr != m_curvesGraphs.end (); itr++) {
-
-    const Curve &curve = *itr;
-    if (curve.curveName () == curveNameWanted) {
+  const Curve *curve = curveForCurveName (curveNameWanted);
+  ENGAUGE_ASSERT (curve != 0);
 
-      curve.iterateThroughCurveSegments (ftorWithCallback);
-      return;
-    }
-  }
-
-  ENGAUGE_ASSERT (false);
+  curve->iterateThroughCurveSegments (ftorWithCallback);
 }
 
 void CurvesGraphs::iterateThroughCurvesPoints (const Functor2wRet<const QString &, const Point &, CallbackSearchReturn> &ftorWithCallback)
@@ -152,7 +139,8 @@ void CurvesGraphs::iterateThroughCurvesPoints (const Functor2wRet<const QString
   }
 }
 
-void CurvesGraphs::loadXml(QXmlStreamReader &reader)
+void CurvesGraphs::loadXml(PointIdTable &pointIdTable,
+                           QXmlStreamReader &reader)
 {
   LOG4CPP_INFO_S ((*mainCat)) << "CurvesGraphs::loadXml";
 
@@ -165,9 +153,10 @@ void CurvesGraphs::loadXml(QXmlStreamReader &reader)
     if ((reader.tokenType() == QXmlStreamReader::StartElement) &&
         (reader.name () == DOCUMENT_SERIALIZE_CURVE)) {
 
-      Curve curve (reader);
+      Curve curve (pointIdTable,
+                   reader);
 
-      m_curvesGraphs.push_back (curve);
+      addGraphCurveAtEnd (curve);
 
     } else {
 
@@ -194,12 +183,20 @@ int CurvesGraphs::numCurves () const
   return m_curvesGraphs.count ();
 }
 
-void CurvesGraphs::removePoint (const QString &pointIdentifier)
+void CurvesGraphs::removePoints (const PointIdTable &pointIdTable,
+                                 const QVector<PointId> &pointIds)
 {
-  QString curveName = Point::curveNameFromPointIdentifier(pointIdentifier);
+  QMap<QString, QVector<PointId> > curveNameToPointIds;
+  for (int i = 0; i < pointIds.count (); i++) {
+    curveNameToPointIds [pointIdTable.curveName (pointIds.at (i))].push_back (pointIds.at (i));
+  }
 
-  Curve *curve = curveForCurveName (curveName);
-  curve->removePoint (pointIdentifier);
+  QMap<QString, QVector<PointId> >::const_iterator itr;
+  for (itr = curveNameToPointIds.begin (); itr != curveNameToPointIds.end (); itr++) {
+
+    Curve *curve = curveForCurveName (itr.key ());
+    curve->removePoints (itr.value ());
+  }
 }
 
 void CurvesGraphs::saveXml(QXmlStreamWriter &writer) const
@@ -3,8 +3,10 @@
 
 #include "CallbackSearchReturn.h"
 #include "Curve.h"
+#include <QHash>
 #include <QList>
 #include <QStringList>
+#include <QVector>
 
 class CurveStyles;
 class Point;
@@ -14,7 +16,14 @@ class Transformation;
 
 typedef QList<Curve> CurveList;
 
+/// Index into CurveList for each curve name
+typedef QHash<QString, int> CurveNameToIndex;
+
 /// Container for all graph curves. The axes point curve is external to this class.
+///
+/// Curves are found by name through a hash, since lookups happen once per point in operations like exporting. Curves
+/// must therefore not be renamed after being added. Renaming, as in CmdSettingsCurves, is done by building a new
+/// CurvesGraphs out of renamed copies
 class CurvesGraphs
 {
 public:
@@ -26,8 +35,9 @@ public:
   /// Append new Point to the specified Curve.
   void addPoint (const Point &point);
 
-  /// Apply transformation to all curves.
-  void applyTransformation (const Transformation &transformation);
+  /// Apply transformation to all curves. See Curve::applyTransformation
+  void applyTransformation (const Transformation &transformation,
+                            int transformationVersion);
 
   /// Return the axis or graph curve for the specified curve name.
   Curve *curveForCurveName (const QString &curveName);
@@ -55,14 +65,17 @@ public:
   /// Apply functor to Points on all of the Curves.
   void iterateThroughCurvesPoints (const Functor2wRet<const QString &, const Point &, CallbackSearchReturn> &ftorWithCallback) const;
 
-  /// Load from serialized file
-  void loadXml(QXmlStreamReader &reader);
+  /// Load from serialized file. The identifiers of the Points are interned in the PointIdTable
+  void loadXml(PointIdTable &pointIdTable,
+               QXmlStreamReader &reader);
 
   /// Current number of graphs curves.
   int numCurves () const;
 
-  /// Remove the Point from its Curve.
-  void removePoint (const QString &pointIdentifier);
+  /// Remove the Points from their Curves, with one Curve::removePoints call per Curve. The curve of each Point comes
+  /// from the PointIdTable of the Document
+  void removePoints (const PointIdTable &pointIdTable,
+                     const QVector<PointId> &pointIds);
 
   /// Serialize curves
   void saveXml(QXmlStreamWriter &writer) const;
@@ -72,7 +85,11 @@ public:
 
 private:
 
+  // Index of the curve with the specified name, or -1 if there is no such curve
+  int indexForCurveName (const QString &curveName) const;
+
   CurveList m_curvesGraphs;
+  CurveNameToIndex m_curveNameToIndex; // Kept in sync with m_curvesGraphs for constant time lookups
 };
 
 #endif // CURVES_GRAPHS_H
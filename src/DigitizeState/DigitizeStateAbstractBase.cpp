@@ -38,8 +38,9 @@ void DigitizeStateAbstractBase::handleContextMenuEvent (const QString &pointIden
 {
   LOG4CPP_INFO_S ((*mainCat)) << "DigitizeStateAbstractBase::handleContextMenuEvent point=" << pointIdentifier.toLatin1 ().data ();
 
-  QPointF posScreen = context().cmdMediator().document().positionScreen (pointIdentifier);
-  QPointF posGraphBefore = context().cmdMediator().document().positionGraph (pointIdentifier);
+  PointId pointId = context().cmdMediator().document().pointIdTable ()->pointId (pointIdentifier);
+  QPointF posScreen = context().cmdMediator().document().positionScreen (pointId);
+  QPointF posGraphBefore = context().cmdMediator().document().positionGraph (pointId);
   QString xGraphValue = QString ("%1").arg (posGraphBefore.x ());
   QString yGraphValue = QString ("%1").arg (posGraphBefore.y ());
 
@@ -79,7 +80,7 @@ void DigitizeStateAbstractBase::handleContextMenuEvent (const QString &pointIden
       // Create a command to edit the point
       CmdEditPointAxis *cmd = new CmdEditPointAxis (context().mainWindow(),
                                                     context().cmdMediator().document(),
-                                                    pointIdentifier,
+                                                    pointId,
                                                     posGraphBefore,
                                                     posGraphAfter);
       context().appendNewCmd(cmd);
@@ -98,12 +98,14 @@ void DigitizeStateSelect::handleMouseRelease (QPointF posScreen)
 
     QString moveText = moveTextFromDeltaScreen (deltaScreen);
 
-    // Create command to move points
+    // Create command to move points. Each drag is its own undo step
+    const bool IS_KEYBOARD_NUDGE = false;
     CmdMoveBy *cmd = new CmdMoveBy (context().mainWindow(),
                                     context().cmdMediator().document(),
                                     deltaScreen,
                                     moveText,
-                                    positionHasChangedIdentifers);
+                                    positionHasChangedIdentifers,
+                                    IS_KEYBOARD_NUDGE);
     context().appendNewCmd (cmd);
 
    } else {
@@ -143,12 +145,14 @@ void DigitizeStateSelect::keyPressArrow (Qt::Key key)
       ENGAUGE_ASSERT (false);
   }
 
-  // Create command to move points
+  // Create command to move points. Repeated nudges are merged into one undo step
+  const bool IS_KEYBOARD_NUDGE = true;
   CmdMoveBy *cmd = new CmdMoveBy (context().mainWindow(),
                                   context().cmdMediator ().document(),
                                   deltaScreen,
                                   moveText,
-                                  context().mainWindow().scene ().selectedPointIdentifiers ());
+                                  context().mainWindow().scene ().selectedPointIdentifiers (),
+                                  IS_KEYBOARD_NUDGE);
   context().appendNewCmd (cmd);
 }
 
@@ -185,7 +189,8 @@ void DigitizeStateSelect::setCursorForPoints()
   for (itr = items.begin (); itr != items.end (); itr++) {
 
     QGraphicsItem *item = *itr;
-    if (item->data (DATA_KEY_GRAPHICS_ITEM_TYPE) == GRAPHICS_ITEM_TYPE_POINT) {
+    if ((item->data (DATA_KEY_GRAPHICS_ITEM_TYPE) == GRAPHICS_ITEM_TYPE_POINT) ||
+        (item->data (DATA_KEY_GRAPHICS_ITEM_TYPE) == GRAPHICS_ITEM_TYPE_POINTS_FOR_CURVE)) {
       item->setCursor (cursor);
     }
   }
@@ -198,7 +203,8 @@ void DigitizeStateSelect::unsetCursorForPoints()
   for (itr = items.begin (); itr != items.end (); itr++) {
 
     QGraphicsItem *item = *itr;
-    if (item->data (DATA_KEY_GRAPHICS_ITEM_TYPE) == GRAPHICS_ITEM_TYPE_POINT) {
+    if ((item->data (DATA_KEY_GRAPHICS_ITEM_TYPE) == GRAPHICS_ITEM_TYPE_POINT) ||
+        (item->data (DATA_KEY_GRAPHICS_ITEM_TYPE) == GRAPHICS_ITEM_TYPE_POINTS_FOR_CURVE)) {
       item->unsetCursor ();
     }
   }
@@ -0,0 +1,86 @@
+#include "DlgGridRemovalThread.h"
+#include "DlgGridRemovalWorker.h"
+#include "DlgSettingsGridRemoval.h"
+#include <QMutexLocker>
+
+DlgGridRemovalThread::DlgGridRemovalThread(const QPixmap &pixmapOriginal,
+                                           QRgb rgbBackground,
+                                           const Transformation &transformation,
+                                           ColorFilterMode colorFilterMode,
+                                           double low,
+                                           double high,
+                                           DlgSettingsGridRemoval &dlgSettingsGridRemoval) :
+  m_pixmapOriginal (pixmapOriginal),
+  m_rgbBackground (rgbBackground),
+  m_transformation (transformation),
+  m_colorFilterMode (colorFilterMode),
+  m_low (low),
+  m_high (high),
+  m_dlgSettingsGridRemoval (dlgSettingsGridRemoval),
+  m_generation (0)
+{
+}
+
+int DlgGridRemovalThread::applyParameters (const DocumentModelGridRemoval &modelGridRemoval)
+{
+  int generation;
+  {
+    QMutexLocker locker (&m_mutex);
+
+    m_modelGridRemoval = modelGridRemoval;
+    generation = m_generation.fetchAndAddOrdered (1) + 1;
+  }
+
+  emit signalNewParameters ();
+
+  return generation;
+}
+
+int DlgGridRemovalThread::generation () const
+{
+  return m_generation.load ();
+}
+
+const QAtomicInt *DlgGridRemovalThread::generationCounter () const
+{
+  return &m_generation;
+}
+
+bool DlgGridRemovalThread::isStale (int generation) const
+{
+  return generation != m_generation.load ();
+}
+
+int DlgGridRemovalThread::latestParameters (DocumentModelGridRemoval &modelGridRemoval) const
+{
+  QMutexLocker locker (&m_mutex);
+
+  modelGridRemoval = m_modelGridRemoval;
+  return m_generation.load ();
+}
+
+void DlgGridRemovalThread::run ()
+{
+  // Worker is created here so it belongs to this thread rather than the GUI thread, and is destroyed when the
+  // event loop is stopped
+  DlgGridRemovalWorker worker (m_pixmapOriginal,
+                               m_rgbBackground,
+                               m_transformation,
+                               m_colorFilterMode,
+                               m_low,
+                               m_high,
+                               *this);
+
+  // Connect signal to start process
+  connect (this, SIGNAL (signalNewParameters ()),
+           &worker, SLOT (slotNewParameters ()));
+
+  // Connect signal to return completed processing
+  connect (&worker, SIGNAL (signalTransferImage (int, QImage)),
+           &m_dlgSettingsGridRemoval, SLOT (slotTransferImage (int, QImage)));
+
+  // Pick up any parameters that arrived before the connections were made
+  worker.slotNewParameters ();
+
+  exec ();
+}
@@ -0,0 +1,74 @@
+#ifndef DLG_GRID_REMOVAL_THREAD_H
+#define DLG_GRID_REMOVAL_THREAD_H
+
+#include "ColorFilterMode.h"
+#include "DocumentModelGridRemoval.h"
+#include <QAtomicInt>
+#include <QImage>
+#include <QMutex>
+#include <QObject>
+#include <QPixmap>
+#include <QThread>
+#include "Transformation.h"
+
+class DlgSettingsGridRemoval;
+
+/// Class for computing the full resolution grid removal preview in the background, while DlgSettingsGridRemoval shows
+/// a downsampled preview right away. Every new set of parameters gets a new generation number, and work on older
+/// generations is abandoned. This is based on http://blog.debao.me/2013/08/how-to-use-qthread-in-the-right-way-part-1/
+class DlgGridRemovalThread : public QThread
+{
+  Q_OBJECT;
+
+public:
+  /// Single constructor.
+  DlgGridRemovalThread(const QPixmap &pixmapOriginal,
+                       QRgb rgbBackground,
+                       const Transformation &transformation,
+                       ColorFilterMode colorFilterMode,
+                       double low,
+                       double high,
+                       DlgSettingsGridRemoval &dlgSettingsGridRemoval);
+
+  /// Queue new parameters for processing, and return their generation number. Thread safe.
+  int applyParameters (const DocumentModelGridRemoval &modelGridRemoval);
+
+  /// Most recent generation number. Thread safe.
+  int generation () const;
+
+  /// Counter holding the most recent generation number, so GridRemoval can abandon stale work. Thread safe.
+  const QAtomicInt *generationCounter () const;
+
+  /// True if the specified generation has been superseded by newer parameters. Thread safe.
+  bool isStale (int generation) const;
+
+  /// Get the most recent parameters, and return their generation number. Thread safe.
+  int latestParameters (DocumentModelGridRemoval &modelGridRemoval) const;
+
+  /// Run this thread.
+  virtual void run();
+
+signals:
+  /// Wake up the worker since there are new parameters.
+  void signalNewParameters ();
+
+private:
+  DlgGridRemovalThread();
+
+  QPixmap m_pixmapOriginal;
+  QRgb m_rgbBackground;
+  Transformation m_transformation;
+  ColorFilterMode m_colorFilterMode;
+  double m_low;
+  double m_high;
+
+  DlgSettingsGridRemoval &m_dlgSettingsGridRemoval;
+
+  // Latest parameters from the gui thread. Parameters are stored here, rather than sent through signalNewParameters,
+  // so no parameters are lost if they arrive before the worker is connected in the run method
+  QAtomicInt m_generation;
+  mutable QMutex m_mutex;
+  DocumentModelGridRemoval m_modelGridRemoval;
+};
+
+#endif // DLG_GRID_REMOVAL_THREAD_H
@@ -0,0 +1,90 @@
+#include "ColorFilter.h"
+#include "DlgGridRemovalThread.h"
+#include "DlgGridRemovalWorker.h"
+#include "DocumentModelGridRemoval.h"
+#include "Logger.h"
+
+const int NO_GENERATION = 0;
+const int ROWS_PER_PIECE = 32;
+
+DlgGridRemovalWorker::DlgGridRemovalWorker(const QPixmap &pixmapOriginal,
+                                           QRgb rgbBackground,
+                                           const Transformation &transformation,
+                                           ColorFilterMode colorFilterMode,
+                                           double low,
+                                           double high,
+                                           const DlgGridRemovalThread &dlgGridRemovalThread) :
+  m_imageOriginal (pixmapOriginal.toImage()),
+  m_rgbBackground (rgbBackground),
+  m_transformation (transformation),
+  m_colorFilterMode (colorFilterMode),
+  m_low (low),
+  m_high (high),
+  m_dlgGridRemovalThread (dlgGridRemovalThread),
+  m_generationProcessed (NO_GENERATION)
+{
+}
+
+void DlgGridRemovalWorker::slotNewParameters ()
+{
+  DocumentModelGridRemoval modelGridRemoval;
+  int generation = m_dlgGridRemovalThread.latestParameters (modelGridRemoval);
+
+  // Queued signals pile up while a generation is being processed, so most of them find nothing new
+  if ((generation == NO_GENERATION) ||
+      (generation == m_generationProcessed)) {
+    return;
+  }
+
+  LOG4CPP_INFO_S ((*mainCat)) << "DlgGridRemovalWorker::slotNewParameters generation=" << generation;
+
+  // If newer parameters arrive then we immediately stop processing, even in the middle of the distance transform. The
+  // newer parameters have their own signalNewParameters queued up, so they will be handled next
+  QImage imageRemoved = m_imageOriginal;
+  if (!m_gridRemoval.removeGridLines (m_transformation,
+                                      modelGridRemoval,
+                                      m_rgbBackground,
+                                      imageRemoved,
+                                      m_dlgGridRemovalThread.generationCounter (),
+                                      generation)) {
+    return;
+  }
+
+  // This code is basically a customized version of ColorFilter::filterImage that is broken into pieces
+  ColorFilter filter;
+  QImage imageFiltered (imageRemoved.width (),
+                        imageRemoved.height (),
+                        QImage::Format_RGB32);
+  for (int yTop = 0; yTop < imageRemoved.height (); yTop += ROWS_PER_PIECE) {
+
+    if (m_dlgGridRemovalThread.isStale (generation)) {
+      return;
+    }
+
+    int yStop = qMin (yTop + ROWS_PER_PIECE, imageRemoved.height ());
+    for (int y = yTop; y < yStop; y++) {
+      for (int x = 0; x < imageRemoved.width (); x++) {
+        QColor pixel = imageRemoved.pixel (x, y);
+        bool isOn = false;
+        if (pixel.rgb() != m_rgbBackground) {
+
+          isOn = filter.pixelUnfilteredIsOn (m_colorFilterMode,
+                                             pixel,
+                                             m_rgbBackground,
+                                             m_low,
+                                             m_high);
+        }
+
+        imageFiltered.setPixel (x, y, (isOn ?
+                                       QColor (Qt::black).rgb () :
+                                       QColor (Qt::white).rgb ()));
+      }
+    }
+  }
+
+  if (!m_dlgGridRemovalThread.isStale (generation)) {
+    m_generationProcessed = generation;
+    emit signalTransferImage (generation,
+                              imageFiltered);
+  }
+}
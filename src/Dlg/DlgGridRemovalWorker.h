@@ -0,0 +1,55 @@
+#ifndef DLG_GRID_REMOVAL_WORKER_H
+#define DLG_GRID_REMOVAL_WORKER_H
+
+#include "ColorFilterMode.h"
+#include "GridRemoval.h"
+#include <QImage>
+#include <QObject>
+#include <QPixmap>
+#include <QRgb>
+#include "Transformation.h"
+
+class DlgGridRemovalThread;
+
+/// Class for processing new grid removal settings at full resolution. The GridRemoval cache is kept between
+/// generations, so only the grid lines of the axis that changed are recomputed
+class DlgGridRemovalWorker : public QObject
+{
+  Q_OBJECT;
+
+public:
+  /// Single constructor.
+  DlgGridRemovalWorker(const QPixmap &pixmapOriginal,
+                       QRgb rgbBackground,
+                       const Transformation &transformation,
+                       ColorFilterMode colorFilterMode,
+                       double low,
+                       double high,
+                       const DlgGridRemovalThread &dlgGridRemovalThread);
+
+public slots:
+  /// Process the latest parameters from DlgGridRemovalThread, unless they have already been processed.
+  void slotNewParameters ();
+
+signals:
+  /// Send the processed image for the specified generation.
+  void signalTransferImage (int generation,
+                            QImage image);
+
+private:
+  DlgGridRemovalWorker();
+
+  QImage m_imageOriginal; // Use QImage rather than QPixmap so we can access pixel by pixel
+  QRgb m_rgbBackground;
+  Transformation m_transformation;
+  ColorFilterMode m_colorFilterMode;
+  double m_low;
+  double m_high;
+
+  const DlgGridRemovalThread &m_dlgGridRemovalThread;
+
+  GridRemoval m_gridRemoval;
+  int m_generationProcessed;
+};
+
+#endif // DLG_GRID_REMOVAL_WORKER_H
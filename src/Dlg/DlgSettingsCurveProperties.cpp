@@ -305,6 +305,7 @@ void DlgSettingsCurveProperties::drawPoints (bool isRelation,
 
   // Left point
   GraphicsPoint *pointLeft = pointFactory.createPoint (*m_scenePreview,
+                                                       NULL_POINT_ID,
                                                        NULL_IDENTIFIER,
                                                        POS_LEFT,
                                                        pointStyle,
@@ -313,6 +314,7 @@ void DlgSettingsCurveProperties::drawPoints (bool isRelation,
 
   // Center point
   GraphicsPoint *pointCenter = pointFactory.createPoint (*m_scenePreview,
+                                                         NULL_POINT_ID,
                                                          NULL_IDENTIFIER,
                                                          POS_CENTER,
                                                          pointStyle,
@@ -321,6 +323,7 @@ void DlgSettingsCurveProperties::drawPoints (bool isRelation,
 
   // Right point
   GraphicsPoint *pointRight = pointFactory.createPoint (*m_scenePreview,
+                                                        NULL_POINT_ID,
                                                         NULL_IDENTIFIER,
                                                         POS_RIGHT,
                                                         pointStyle,
@@ -1,12 +1,17 @@
 #include "CmdMediator.h"
 #include "CmdSettingsGridRemoval.h"
+#include "ColorFilter.h"
+#include "DlgGridRemovalThread.h"
 #include "DlgSettingsGridRemoval.h"
 #include "EngaugeAssert.h"
+#include "GridRemoval.h"
 #include "Logger.h"
 #include "MainWindow.h"
 #include <QCheckBox>
 #include <QComboBox>
+#include <QCoreApplication>
 #include <QDoubleValidator>
+#include <QGraphicsPixmapItem>
 #include <QGraphicsScene>
 #include <QGridLayout>
 #include <QGroupBox>
@@ -22,12 +27,18 @@ const int COUNT_MIN = 1;
 const int COUNT_MAX = 100;
 const int COUNT_DECIMALS = 0;
 
+// Downsampled preview is the first pyramid level with no dimension larger than this
+const int PYRAMID_MAX_DIMENSION = 512;
+
 DlgSettingsGridRemoval::DlgSettingsGridRemoval(MainWindow &mainWindow) :
   DlgSettingsAbstractBase ("Grid Removal",
                            "DlgSettingsGridRemoval",
                            mainWindow),
   m_scenePreview (0),
   m_viewPreview (0),
+  m_itemPreview (0),
+  m_gridRemovalPyramid (0),
+  m_gridRemovalThread (0),
   m_modelGridRemovalBefore (0),
   m_modelGridRemovalAfter (0)
 {
@@ -35,6 +46,15 @@ DlgSettingsGridRemoval::DlgSettingsGridRemoval(MainWindow &mainWindow) :
   finishPanel (subPanel);
 }
 
+DlgSettingsGridRemoval::~DlgSettingsGridRemoval()
+{
+  stopThread ();
+
+  if (m_gridRemovalPyramid != 0) {
+    delete m_gridRemovalPyramid;
+  }
+}
+
 void DlgSettingsGridRemoval::createPreview (QGridLayout *layout, int &row)
 {
   LOG4CPP_INFO_S ((*mainCat)) << "DlgSettingsGridRemoval::createPreview";
@@ -51,6 +71,52 @@ void DlgSettingsGridRemoval::createPreview (QGridLayout *layout, int &row)
   layout->addWidget (m_viewPreview, row++, 0, 1, 5);
 }
 
+void DlgSettingsGridRemoval::createPreviewPyramid ()
+{
+  LOG4CPP_INFO_S ((*mainCat)) << "DlgSettingsGridRemoval::createPreviewPyramid";
+
+  QPixmap pixmap = cmdMediator().document().pixmap();
+  QImage image = pixmap.toImage();
+
+  // Filter parameters are those of the currently selected curve, just like the filtered background in MainWindow
+  ColorFilter filter;
+  QString curveName = mainWindow().selectedGraphCurve();
+  m_rgbBackground = filter.marginColor (&image);
+  m_colorFilterMode = cmdMediator().document().modelColorFilter().colorFilterMode(curveName);
+  m_low = cmdMediator().document().modelColorFilter().low(curveName);
+  m_high = cmdMediator().document().modelColorFilter().high(curveName);
+
+  // Pick the power of two downsampling level. Fast transformation is used since smoothing would blend thin lines
+  // into colors that the filter treats differently
+  int level = 0;
+  while (qMax (image.width (), image.height ()) > (PYRAMID_MAX_DIMENSION << level)) {
+    ++level;
+  }
+  m_imagePyramid = image.scaled (qMax (1, image.width () >> level),
+                                 qMax (1, image.height () >> level),
+                                 Qt::IgnoreAspectRatio,
+                                 Qt::FastTransformation);
+
+  if (m_gridRemovalPyramid != 0) {
+    delete m_gridRemovalPyramid;
+  }
+  m_gridRemovalPyramid = new GridRemoval (1.0 / (double) (1 << level));
+
+  Transformation transformation;
+  if (mainWindow().transformIsDefined()) {
+    transformation = mainWindow().transformation();
+  }
+
+  m_gridRemovalThread = new DlgGridRemovalThread (pixmap,
+                                                  m_rgbBackground,
+                                                  transformation,
+                                                  m_colorFilterMode,
+                                                  m_low,
+                                                  m_high,
+                                                  *this);
+  m_gridRemovalThread->start();
+}
+
 void DlgSettingsGridRemoval::createRemoveGridLines (QGridLayout *layout, int &row)
 {
   LOG4CPP_INFO_S ((*mainCat)) << "DlgSettingsGridRemoval::createRemoveGridLines";
@@ -299,6 +365,11 @@ void DlgSettingsGridRemoval::load (CmdMediator &cmdMediator)
     delete m_modelGridRemovalAfter;
   }
 
+  // Stop processing for the previous Document. Preview updates are ignored until createPreviewPyramid below
+  stopThread ();
+  m_scenePreview->clear();
+  m_itemPreview = 0;
+
   // Save new data
   m_modelGridRemovalBefore = new DocumentModelGridRemoval (cmdMediator.document());
   m_modelGridRemovalAfter = new DocumentModelGridRemoval (cmdMediator.document());
@@ -330,14 +401,28 @@ void DlgSettingsGridRemoval::load (CmdMediator &cmdMediator)
 
   m_chkRemoveParallel->setChecked (m_modelGridRemovalAfter->removeParallelToAxes());
 
-  m_scenePreview->clear();
-  m_scenePreview->addPixmap (cmdMediator.document().pixmap());
+  showPreview (cmdMediator.document().pixmap().toImage());
+  createPreviewPyramid ();
 
   updateControls ();
   enableOk (false); // Disable Ok button since there not yet any changes
   updatePreview();
 }
 
+void DlgSettingsGridRemoval::showPreview (const QImage &image)
+{
+  if (m_itemPreview == 0) {
+    m_itemPreview = m_scenePreview->addPixmap (QPixmap::fromImage (image));
+  } else {
+    m_itemPreview->setPixmap (QPixmap::fromImage (image));
+  }
+
+  // Stretch downsampled images to cover the same area as the original image
+  QSize sizeOriginal = cmdMediator().document().pixmap().size();
+  m_itemPreview->setTransform (QTransform::fromScale ((double) sizeOriginal.width () / image.width (),
+                                                      (double) sizeOriginal.height () / image.height ()));
+}
+
 void DlgSettingsGridRemoval::slotCloseDistance(const QString &)
 {
   LOG4CPP_INFO_S ((*mainCat)) << "DlgSettingsGridRemoval::slotCloseDistance";
@@ -457,6 +542,33 @@ void DlgSettingsGridRemoval::slotStopY(const QString &stopY)
   updatePreview();
 }
 
+void DlgSettingsGridRemoval::slotTransferImage (int generation,
+                                                QImage image)
+{
+  LOG4CPP_INFO_S ((*mainCat)) << "DlgSettingsGridRemoval::slotTransferImage generation=" << generation;
+
+  // Skip images computed from parameters that have since changed, or from a previous Document
+  if ((m_gridRemovalThread != 0) &&
+      !m_gridRemovalThread->isStale (generation)) {
+
+    showPreview (image);
+  }
+}
+
+void DlgSettingsGridRemoval::stopThread ()
+{
+  if (m_gridRemovalThread != 0) {
+
+    m_gridRemovalThread->quit ();
+    m_gridRemovalThread->wait ();
+    delete m_gridRemovalThread;
+    m_gridRemovalThread = 0;
+
+    // Discard images still queued up from the stopped thread, since the next thread restarts the generation numbers
+    QCoreApplication::removePostedEvents (this, QEvent::MetaCall);
+  }
+}
+
 void DlgSettingsGridRemoval::updateControls ()
 {
   m_editCloseDistance->setEnabled (m_chkRemoveGridLines->isChecked ());
@@ -502,5 +614,37 @@ void DlgSettingsGridRemoval::updateControls ()
 
 void DlgSettingsGridRemoval::updatePreview ()
 {
+  LOG4CPP_INFO_S ((*mainCat)) << "DlgSettingsGridRemoval::updatePreview";
+
+  // Skip if everything is not set up yet, which happens while the controls are being loaded
+  if (m_gridRemovalThread == 0) {
+    return;
+  }
+
+  // Start the full resolution processing first so it overlaps with the downsampled processing below
+  m_gridRemovalThread->applyParameters (*m_modelGridRemovalAfter);
+
+  Transformation transformation;
+  if (mainWindow().transformIsDefined()) {
+    transformation = mainWindow().transformation();
+  }
 
+  QImage imageRemoved = m_imagePyramid;
+  m_gridRemovalPyramid->removeGridLines (transformation,
+                                         *m_modelGridRemovalAfter,
+                                         m_rgbBackground,
+                                         imageRemoved);
+
+  ColorFilter filter;
+  QImage imageFiltered (imageRemoved.width (),
+                        imageRemoved.height (),
+                        QImage::Format_RGB32);
+  filter.filterImage (imageRemoved,
+                      imageFiltered,
+                      m_colorFilterMode,
+                      m_low,
+                      m_high,
+                      m_rgbBackground);
+
+  showPreview (imageFiltered);
 }
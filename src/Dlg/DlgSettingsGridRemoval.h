@@ -1,12 +1,18 @@
 #ifndef DLG_SETTINGS_GRID_REMOVAL_H
 #define DLG_SETTINGS_GRID_REMOVAL_H
 
+#include "ColorFilterMode.h"
 #include "DlgSettingsAbstractBase.h"
+#include <QImage>
+#include <QRgb>
 
+class DlgGridRemovalThread;
 class DocumentModelGridRemoval;
+class GridRemoval;
 class QCheckBox;
 class QComboBox;
 class QDoubleValidator;
+class QGraphicsPixmapItem;
 class QGraphicsScene;
 class QGridLayout;
 class QHBoxLayout;
@@ -21,10 +27,16 @@ class DlgSettingsGridRemoval : public DlgSettingsAbstractBase
 public:
   /// Single constructor.
   DlgSettingsGridRemoval(MainWindow &mainWindow);
+  virtual ~DlgSettingsGridRemoval();
 
   virtual QWidget *createSubPanel ();
   virtual void load (CmdMediator &cmdMediator);
 
+public slots:
+  /// Receive full resolution preview image from DlgGridRemovalThread. Ignored if generation is stale.
+  void slotTransferImage (int generation,
+                          QImage image);
+
 private slots:
   void slotRemoveGridLines (int);
   void slotCloseDistance(const QString &);
@@ -53,6 +65,9 @@ private:
   void createRemoveGridLinesY (QGridLayout *layoutGridLines, int &row);
   void createRemoveParallel (QGridLayout *layout, int &row);
   void createPreview (QGridLayout *layout, int &row);
+  void createPreviewPyramid (); // Also starts the full resolution thread
+  void showPreview (const QImage &image);
+  void stopThread ();
   void updateControls ();
   void updatePreview();
 
@@ -84,6 +99,17 @@ private:
 
   QGraphicsScene *m_scenePreview;
   ViewPreview *m_viewPreview;
+  QGraphicsPixmapItem *m_itemPreview;
+
+  // Preview is computed immediately on a downsampled level of the image pyramid, and then refined at full resolution
+  // by a separate thread so typing in the line edits is not slowed down by the full resolution processing
+  QImage m_imagePyramid;
+  GridRemoval *m_gridRemovalPyramid;
+  DlgGridRemovalThread *m_gridRemovalThread;
+  QRgb m_rgbBackground;
+  ColorFilterMode m_colorFilterMode;
+  double m_low;
+  double m_high;
 
   DocumentModelGridRemoval *m_modelGridRemovalBefore;
   DocumentModelGridRemoval *m_modelGridRemovalAfter;
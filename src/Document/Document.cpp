@@ -5,12 +5,14 @@
 #include "Curve.h"
 #include "CurveStyles.h"
 #include "Document.h"
+#include "DocumentContainer.h"
 #include "DocumentSerialize.h"
 #include "EngaugeAssert.h"
 #include "EnumsToQt.h"
 #include <iostream>
 #include "Logger.h"
 #include "Point.h"
+#include <QBuffer>
 #include <QByteArray>
 #include <QDataStream>
 #include <QDebug>
@@ -22,18 +24,26 @@
 #include "Transformation.h"
 #include "Xml.h"
 
+// Curves start out with a lower version, so the first applyTransformation covers all of their Points
+const int TRANSFORMATION_VERSION_FIRST = 1;
+
 Document::Document (const QImage &image) :
   m_name ("untitled"),
-  m_curveAxes (new Curve (AXIS_CURVE_NAME,
+  m_imageIsPending (false),
+  m_pointIdTable (new PointIdTable),
+  m_curveAxes (new Curve (*m_pointIdTable,
+                          AXIS_CURVE_NAME,
                           ColorFilterSettings::defaultFilter (),
                           CurveStyle (LineStyle::defaultAxesCurve(),
-                                      PointStyle::defaultAxesCurve ())))
+                                      PointStyle::defaultAxesCurve ()))),
+  m_transformationVersion (TRANSFORMATION_VERSION_FIRST)
 {
   m_successfulRead = true; // Reading from QImage always succeeds, resulting in empty Document
 
   m_pixmap.convertFromImage (image);
 
-  m_curvesGraphs.addGraphCurveAtEnd (Curve (DEFAULT_GRAPH_CURVE_NAME,
+  m_curvesGraphs.addGraphCurveAtEnd (Curve (*m_pointIdTable,
+                                            DEFAULT_GRAPH_CURVE_NAME,
                                             ColorFilterSettings::defaultFilter (),
                                             CurveStyle (LineStyle::defaultGraphCurve (m_curvesGraphs.numCurves ()),
                                                         PointStyle::defaultGraphCurve (m_curvesGraphs.numCurves ()))));
@@ -41,95 +51,57 @@ Document::Document (const QImage &image) :
 
 Document::Document (const QString &fileName) :
   m_name (fileName),
-  m_curveAxes (0)
+  m_imageIsPending (false),
+  m_pointIdTable (new PointIdTable),
+  m_curveAxes (0),
+  m_transformationVersion (TRANSFORMATION_VERSION_FIRST)
 {
   m_successfulRead = true;
 
-  QFile *file = new QFile (fileName);
-  if (file->open (QIODevice::ReadOnly | QIODevice::Text)) {
+  if (DocumentContainer::isContainerFile (fileName)) {
 
-    QXmlStreamReader reader (file);
+    // The xml section is parsed straight from the mapped file. The image chunk is copied out, and decoded later
+    DocumentContainer container (fileName);
+    if (container.isValid ()) {
 
-    // If this is purely a serialized Document then we process every node under the root. However, if this is an error report file
-    // then we need to skip the non-Document stuff. The common solution is to skip nodes outside the Document subtree using this flag
-    bool inDocumentSubtree = false;
+      m_imageChunk = container.imageChunk ();
+      m_imageIsPending = true;
 
-    // Import from xml. Loop to end of data or error condition occurs, whichever is first
-    while (!reader.atEnd() &&
-           !reader.hasError()) {
-      QXmlStreamReader::TokenType tokenType = loadNextFromReader(reader);
+      QByteArray xml = container.xml ();
+      QBuffer buffer (&xml);
+      buffer.open (QIODevice::ReadOnly);
+      QXmlStreamReader reader (&buffer);
 
-      // Special processing of DOCUMENT_SERIALIZE_IMAGE outside DOCUMENT_SERIALIZE_DOCUMENT, for an error report file
-      if ((reader.name() == DOCUMENT_SERIALIZE_IMAGE) &&
-          (tokenType == QXmlStreamReader::StartElement)) {
+      loadXml (reader);
 
-        generateEmptyPixmap (reader.attributes());
-      }
+      // Blank placeholder until the image chunk has been decoded
+      m_pixmap.fill (Qt::white);
 
-      // Branching to skip non-Document nodes, with the exception of any DOCUMENT_SERIALIZE_IMAGE outside DOCUMENT_SERIALIZE_DOCUMENT
-      if ((reader.name() == DOCUMENT_SERIALIZE_DOCUMENT) &&
-          (tokenType == QXmlStreamReader::StartElement)) {
+    } else {
 
-        inDocumentSubtree = true;
+      m_successfulRead = false;
+      m_reasonForUnsuccessfulRead = "File is incomplete or damaged";
+    }
 
-      } else if ((reader.name() == DOCUMENT_SERIALIZE_DOCUMENT) &&
-                 (tokenType == QXmlStreamReader::EndElement)) {
+  } else {
 
-        // Exit out of loop immediately
-        break;
-      }
+    QFile *file = new QFile (fileName);
+    if (file->open (QIODevice::ReadOnly | QIODevice::Text)) {
 
-      if (inDocumentSubtree) {
-
-        // Iterate to next StartElement
-        if (tokenType == QXmlStreamReader::StartElement) {
-
-          // This is a StartElement, so process it
-          QString tag = reader.name().toString();
-          if (tag == DOCUMENT_SERIALIZE_AXES_CHECKER){
-            m_modelAxesChecker.loadXml(reader);
-          } else if (tag == DOCUMENT_SERIALIZE_COORDS) {
-            m_modelCoords.loadXml(reader);
-          } else if (tag == DOCUMENT_SERIALIZE_CURVE) {
-            m_curveAxes = new Curve (reader);
-          } else if (tag == DOCUMENT_SERIALIZE_CURVES_GRAPHS) {
-            m_curvesGraphs.loadXml(reader);
-          } else if (tag == DOCUMENT_SERIALIZE_DOCUMENT) {
-            // Do nothing. This is the root node
-          } else if (tag == DOCUMENT_SERIALIZE_EXPORT) {
-            m_modelExport.loadXml(reader);
-          } else if (tag == DOCUMENT_SERIALIZE_GRID_REMOVAL) {
-            m_modelGridRemoval.loadXml(reader);
-          } else if (tag == DOCUMENT_SERIALIZE_IMAGE) {
-            // A standard Document file has DOCUMENT_SERIALIZE_IMAGE inside DOCUMENT_SERIALIZE_DOCUMENT, versus an error report file
-            loadImage(reader);
-          } else if (tag == DOCUMENT_SERIALIZE_POINT_MATCH) {
-            m_modelPointMatch.loadXml(reader);
-          } else if (tag == DOCUMENT_SERIALIZE_SEGMENTS) {
-            m_modelSegments.loadXml(reader);
-          } else {
-            m_successfulRead = false;
-            m_reasonForUnsuccessfulRead = QString ("Unexpected xml token '%1' encountered").arg (tokenType);
-            break;
-          }
-        }
-      }
-    }
-    if (reader.hasError ()) {
+      QXmlStreamReader reader (file);
 
-      m_successfulRead = false;
-      m_reasonForUnsuccessfulRead = reader.errorString();
-    }
+      loadXml (reader);
 
-    // Close and deactivate
-    file->close ();
-    delete file;
-    file = 0;
+      // Close and deactivate
+      file->close ();
+      delete file;
+      file = 0;
 
-  } else {
+    } else {
 
-    m_successfulRead = false;
-    m_reasonForUnsuccessfulRead = "Operating system says file is not readable";
+      m_successfulRead = false;
+      m_reasonForUnsuccessfulRead = "Operating system says file is not readable";
+    }
   }
 
   // There are already one axes curve and at least one graph curve so we do not need to add any more graph curves
@@ -137,7 +109,8 @@ Document::Document (const QString &fileName) :
 
 void Document::addGraphCurveAtEnd (const QString &curveName)
 {
-  m_curvesGraphs.addGraphCurveAtEnd  (Curve (curveName,
+  m_curvesGraphs.addGraphCurveAtEnd  (Curve (*m_pointIdTable,
+                                             curveName,
                                              ColorFilterSettings::defaultFilter (),
                                              CurveStyle (LineStyle::defaultGraphCurve(m_curvesGraphs.numCurves()),
                                                          PointStyle::defaultGraphCurve(m_curvesGraphs.numCurves()))));
@@ -145,32 +118,36 @@ void Document::addGraphCurveAtEnd (const QString &curveName)
 
 void Document::addPointAxisWithGeneratedIdentifier (const QPointF &posScreen,
                                                     const QPointF &posGraph,
-                                                    QString &identifier)
+                                                    PointId &pointId)
 {
-  Point point (AXIS_CURVE_NAME,
+  Point point (*m_pointIdTable,
+               AXIS_CURVE_NAME,
                posScreen,
                UNDEFINED_ORDINAL,
                posGraph);
   m_curveAxes->addPoint (point);
+  m_changeSet.addPointAdded (point.pointId ());
 
-  identifier = point.identifier();
+  pointId = point.pointId ();
 
   LOG4CPP_INFO_S ((*mainCat)) << "Document::addPointAxisWithGeneratedIdentifier"
                               << " posScreen=" << QPointFToString (posScreen).toLatin1 ().data ()
                               << " posGraph=" << QPointFToString (posGraph).toLatin1 ().data ()
-                              << " identifier=" << identifier.toLatin1 ().data ();
+                              << " identifier=" << point.identifier ().toLatin1 ().data ();
 }
 
 void Document::addPointAxisWithSpecifiedIdentifier (const QPointF &posScreen,
                                                     const QPointF &posGraph,
                                                     const QString &identifier)
 {
-  Point point (AXIS_CURVE_NAME,
+  Point point (*m_pointIdTable,
+               AXIS_CURVE_NAME,
                posScreen,
                identifier,
                UNDEFINED_ORDINAL,
                posGraph);
   m_curveAxes->addPoint (point);
+  m_changeSet.addPointAdded (point.pointId ());
 
   LOG4CPP_INFO_S ((*mainCat)) << "Document::addPointAxisWithSpecifiedIdentifier"
                               << " posScreen=" << QPointFToString (posScreen).toLatin1 ().data ()
@@ -180,19 +157,21 @@ void Document::addPointAxisWithSpecifiedIdentifier (const QPointF &posScreen,
 
 void Document::addPointGraphWithGeneratedIdentifier (const QString &curveName,
                                                      const QPointF &posScreen,
-                                                     QString &identifier,
+                                                     PointId &pointId,
                                                      double ordinal)
 {
-  Point point (curveName,
+  Point point (*m_pointIdTable,
+               curveName,
                posScreen,
                ordinal);
   m_curvesGraphs.addPoint (point);
+  m_changeSet.addPointAdded (point.pointId ());
 
-  identifier = point.identifier();
+  pointId = point.pointId ();
 
   LOG4CPP_INFO_S ((*mainCat)) << "Document::addPointGraphWithGeneratedIdentifier"
                               << " posScreen=" << QPointFToString (posScreen).toLatin1 ().data ()
-                              << " identifier=" << identifier.toLatin1 ().data ();
+                              << " identifier=" << point.identifier ().toLatin1 ().data ();
 }
 
 void Document::addPointGraphWithSpecifiedIdentifier (const QString &curveName,
@@ -200,17 +179,47 @@ void Document::addPointGraphWithSpecifiedIdentifier (const QString &curveName,
                                                      const QString &identifier,
                                                      double ordinal)
 {
-  Point point (curveName,
+  Point point (*m_pointIdTable,
+               curveName,
                posScreen,
                identifier,
                ordinal);
   m_curvesGraphs.addPoint (point);
+  m_changeSet.addPointAdded (point.pointId ());
 
   LOG4CPP_INFO_S ((*mainCat)) << "Document::addPointGraphWithSpecifiedIdentifier"
                               << " posScreen=" << QPointFToString (posScreen).toLatin1 ().data ()
                               << " identifier=" << identifier.toLatin1 ().data ();
 }
 
+void Document::addPointsGraphWithGeneratedIdentifiers (const QString &curveName,
+                                                       const QVector<QPointF> &posScreens,
+                                                       QVector<PointId> &pointIdsAdded)
+{
+  LOG4CPP_INFO_S ((*mainCat)) << "Document::addPointsGraphWithGeneratedIdentifiers"
+                              << " curve=" << curveName.toLatin1 ().data ()
+                              << " count=" << posScreens.count ();
+
+  // Curve is found once, rather than once per point as in addPointGraphWithGeneratedIdentifier
+  Curve *curve = curveForCurveName (curveName);
+  ENGAUGE_CHECK_PTR (curve);
+
+  double ordinal = curve->ordinalMax () + 1.0;
+
+  pointIdsAdded.resize (posScreens.count ());
+  for (int i = 0; i < posScreens.count (); i++) {
+
+    Point point (*m_pointIdTable,
+                 curveName,
+                 posScreens.at (i),
+                 ordinal++);
+    curve->addPoint (point);
+    m_changeSet.addPointAdded (point.pointId ());
+
+    pointIdsAdded [i] = point.pointId ();
+  }
+}
+
 void Document::addPointsInCurvesGraphs (CurvesGraphs &curvesGraphs)
 {
   CallbackAddPointsInCurvesGraphs ftor (*this);
@@ -223,7 +232,18 @@ void Document::addPointsInCurvesGraphs (CurvesGraphs &curvesGraphs)
 
 void Document::applyTransformation (const Transformation &transformation)
 {
-  m_curvesGraphs.applyTransformation (transformation);
+  if (transformation.transformMatrix () != m_transformApplied) {
+    m_transformApplied = transformation.transformMatrix ();
+    ++m_transformationVersion;
+  }
+
+  m_curvesGraphs.applyTransformation (transformation,
+                                      m_transformationVersion);
+}
+
+const DocumentChangeSet &Document::changeSet () const
+{
+  return m_changeSet;
 }
 
 void Document::checkAddPointAxis (const QPointF &posScreen,
@@ -269,6 +289,11 @@ void Document::checkEditPointAxis (const QString &pointIdentifier,
   errorMessage = ftor.errorMessage ();
 }
 
+void Document::clearChangeSet ()
+{
+  m_changeSet.clear ();
+}
+
 const Curve &Document::curveAxes () const
 {
   ENGAUGE_CHECK_PTR (m_curveAxes);
@@ -318,14 +343,14 @@ int Document::curvesGraphsNumPoints(const QString &curveName) const
 }
 
 void Document::editPointAxis (const QPointF &posGraph,
-                              const QString &identifier)
+                              PointId pointId)
 {
   LOG4CPP_INFO_S ((*mainCat)) << "Document::editPointAxis posGraph=("
                               << posGraph.x () << ", " << posGraph.y () << ") identifier="
-                              << identifier.toLatin1 ().data ();
+                              << m_pointIdTable->pointIdentifier (pointId).toLatin1 ().data ();
 
   m_curveAxes->editPoint (posGraph,
-                          identifier);
+                          pointId);
 }
 
 void Document::generateEmptyPixmap(const QXmlStreamAttributes &attributes)
@@ -345,6 +370,26 @@ void Document::generateEmptyPixmap(const QXmlStreamAttributes &attributes)
   m_pixmap = QPixmap (width, height);
 }
 
+QImage Document::image () const
+{
+  if (m_imageIsPending) {
+    return QImage::fromData (m_imageChunk,
+                             "PNG");
+  }
+
+  return m_pixmap.toImage ();
+}
+
+QByteArray Document::imageChunk () const
+{
+  return m_imageChunk;
+}
+
+bool Document::imageIsPending () const
+{
+  return m_imageIsPending;
+}
+
 void Document::iterateThroughCurvePointsAxes (const Functor2wRet<const QString &, const Point &, CallbackSearchReturn> &ftorWithCallback)
 {
   ENGAUGE_CHECK_PTR (m_curveAxes);
@@ -415,6 +460,85 @@ void Document::loadImage(QXmlStreamReader &reader)
   }
 }
 
+void Document::loadXml (QXmlStreamReader &reader)
+{
+  // If this is purely a serialized Document then we process every node under the root. However, if this is an error report file
+  // then we need to skip the non-Document stuff. The common solution is to skip nodes outside the Document subtree using this flag
+  bool inDocumentSubtree = false;
+
+  // Import from xml. Loop to end of data or error condition occurs, whichever is first
+  while (!reader.atEnd() &&
+         !reader.hasError()) {
+    QXmlStreamReader::TokenType tokenType = loadNextFromReader(reader);
+
+    // Special processing of DOCUMENT_SERIALIZE_IMAGE outside DOCUMENT_SERIALIZE_DOCUMENT, for an error report file
+    if ((reader.name() == DOCUMENT_SERIALIZE_IMAGE) &&
+        (tokenType == QXmlStreamReader::StartElement)) {
+
+      generateEmptyPixmap (reader.attributes());
+    }
+
+    // Branching to skip non-Document nodes, with the exception of any DOCUMENT_SERIALIZE_IMAGE outside DOCUMENT_SERIALIZE_DOCUMENT
+    if ((reader.name() == DOCUMENT_SERIALIZE_DOCUMENT) &&
+        (tokenType == QXmlStreamReader::StartElement)) {
+
+      inDocumentSubtree = true;
+
+    } else if ((reader.name() == DOCUMENT_SERIALIZE_DOCUMENT) &&
+               (tokenType == QXmlStreamReader::EndElement)) {
+
+      // Exit out of loop immediately
+      break;
+    }
+
+    if (inDocumentSubtree) {
+
+      // Iterate to next StartElement
+      if (tokenType == QXmlStreamReader::StartElement) {
+
+        // This is a StartElement, so process it
+        QString tag = reader.name().toString();
+        if (tag == DOCUMENT_SERIALIZE_AXES_CHECKER){
+          m_modelAxesChecker.loadXml(reader);
+        } else if (tag == DOCUMENT_SERIALIZE_COORDS) {
+          m_modelCoords.loadXml(reader);
+        } else if (tag == DOCUMENT_SERIALIZE_CURVE) {
+          m_curveAxes = new Curve (*m_pointIdTable,
+                                   reader);
+        } else if (tag == DOCUMENT_SERIALIZE_CURVES_GRAPHS) {
+          m_curvesGraphs.loadXml(*m_pointIdTable,
+                                 reader);
+        } else if (tag == DOCUMENT_SERIALIZE_DOCUMENT) {
+          // Do nothing. This is the root node
+        } else if (tag == DOCUMENT_SERIALIZE_EXPORT) {
+          m_modelExport.loadXml(reader);
+        } else if (tag == DOCUMENT_SERIALIZE_GRID_REMOVAL) {
+          m_modelGridRemoval.loadXml(reader);
+        } else if (tag == DOCUMENT_SERIALIZE_IMAGE) {
+          // A standard Document file has DOCUMENT_SERIALIZE_IMAGE inside DOCUMENT_SERIALIZE_DOCUMENT, versus an error report file.
+          // In a DocumentContainer file the image data is in the image chunk instead, so only the placeholder is generated, above
+          if (!m_imageIsPending) {
+            loadImage(reader);
+          }
+        } else if (tag == DOCUMENT_SERIALIZE_POINT_MATCH) {
+          m_modelPointMatch.loadXml(reader);
+        } else if (tag == DOCUMENT_SERIALIZE_SEGMENTS) {
+          m_modelSegments.loadXml(reader);
+        } else {
+          m_successfulRead = false;
+          m_reasonForUnsuccessfulRead = QString ("Unexpected xml token '%1' encountered").arg (tokenType);
+          break;
+        }
+      }
+    }
+  }
+  if (reader.hasError ()) {
+
+    m_successfulRead = false;
+    m_reasonForUnsuccessfulRead = reader.errorString();
+  }
+}
+
 DocumentModelAxesChecker Document::modelAxesChecker() const
 {
   return m_modelAxesChecker;
@@ -461,14 +585,13 @@ DocumentModelSegments Document::modelSegments() const
   return m_modelSegments;
 }
 
-void Document::movePoint (const QString &pointIdentifier,
+void Document::movePoint (PointId pointId,
                           const QPointF &deltaScreen)
 {
-  QString curveName = Point::curveNameFromPointIdentifier (pointIdentifier);
-
-  Curve *curve = curveForCurveName (curveName);
-  curve->movePoint (pointIdentifier,
+  Curve *curve = curveForCurveName (m_pointIdTable->curveName (pointId));
+  curve->movePoint (pointId,
                     deltaScreen);
+  m_changeSet.addPointMoved (pointId);
 }
 
 QPixmap Document::pixmap () const
@@ -476,20 +599,21 @@ QPixmap Document::pixmap () const
   return m_pixmap;
 }
 
-QPointF Document::positionGraph (const QString &pointIdentifier) const
+QSharedPointer<PointIdTable> Document::pointIdTable () const
 {
-  QString curveName = Point::curveNameFromPointIdentifier (pointIdentifier);
-
-  const Curve *curve = curveForCurveName (curveName);
-  return curve->positionGraph (pointIdentifier);
+  return m_pointIdTable;
 }
 
-QPointF Document::positionScreen (const QString &pointIdentifier) const
+QPointF Document::positionGraph (PointId pointId) const
 {
-  QString curveName = Point::curveNameFromPointIdentifier (pointIdentifier);
+  const Curve *curve = curveForCurveName (m_pointIdTable->curveName (pointId));
+  return curve->positionGraph (pointId);
+}
 
-  const Curve *curve = curveForCurveName (curveName);
-  return curve->positionScreen (pointIdentifier);
+QPointF Document::positionScreen (PointId pointId) const
+{
+  const Curve *curve = curveForCurveName (m_pointIdTable->curveName (pointId));
+  return curve->positionScreen (pointId);
 }
 
 QString Document::reasonForUnsuccessfulRead () const
@@ -499,18 +623,41 @@ QString Document::reasonForUnsuccessfulRead () const
   return m_reasonForUnsuccessfulRead;
 }
 
-void Document::removePointAxis (const QString &identifier)
+void Document::removePointAxis (PointId pointId)
 {
-  LOG4CPP_INFO_S ((*mainCat)) << "Document::removePointAxis identifier=" << identifier.toLatin1 ().data ();
+  LOG4CPP_INFO_S ((*mainCat)) << "Document::removePointAxis identifier="
+                              << m_pointIdTable->pointIdentifier (pointId).toLatin1 ().data ();
 
-  m_curveAxes->removePoint (identifier);
+  m_curveAxes->removePoint (pointId);
+  m_changeSet.addPointRemoved (pointId);
 }
 
-void Document::removePointGraph (const QString &identifier)
+void Document::removePointGraph (PointId pointId)
 {
-  LOG4CPP_INFO_S ((*mainCat)) << "Document::removePointGraph identifier=" << identifier.toLatin1 ().data ();
+  LOG4CPP_INFO_S ((*mainCat)) << "Document::removePointGraph identifier="
+                              << m_pointIdTable->pointIdentifier (pointId).toLatin1 ().data ();
 
-  m_curvesGraphs.removePoint (identifier);
+  m_curvesGraphs.removePoints (*m_pointIdTable,
+                               QVector<PointId> (1, pointId));
+  m_changeSet.addPointRemoved (pointId);
+}
+
+void Document::removePointsGraph (const QString &curveName,
+                                  const QVector<PointId> &pointIds)
+{
+  LOG4CPP_INFO_S ((*mainCat)) << "Document::removePointsGraph"
+                              << " curve=" << curveName.toLatin1 ().data ()
+                              << " count=" << pointIds.count ();
+
+  // Curve is found once, as in addPointsGraphWithGeneratedIdentifiers
+  Curve *curve = curveForCurveName (curveName);
+  ENGAUGE_CHECK_PTR (curve);
+
+  curve->removePoints (pointIds);
+
+  for (int i = 0; i < pointIds.count (); i++) {
+    m_changeSet.addPointRemoved (pointIds.at (i));
+  }
 }
 
 void Document::removePointsInCurvesGraphs (CurvesGraphs &curvesGraphs)
@@ -523,7 +670,38 @@ void Document::removePointsInCurvesGraphs (CurvesGraphs &curvesGraphs)
   curvesGraphs.iterateThroughCurvesPoints (ftorWithCallback);
 }
 
+bool Document::saveContainer (QIODevice &device)
+{
+  LOG4CPP_INFO_S ((*mainCat)) << "Document::saveContainer";
+
+  // Image is only encoded the first time. Documents read from a DocumentContainer file already have their png chunk
+  if (m_imageChunk.isEmpty ()) {
+
+    QBuffer buffer (&m_imageChunk);
+    buffer.open (QIODevice::WriteOnly);
+    image ().save (&buffer,
+                   "PNG");
+  }
+
+  QByteArray xml;
+  QXmlStreamWriter writer (&xml);
+  writer.setAutoFormatting(true);
+  saveXml (writer,
+           false);
+
+  return DocumentContainer::write (device,
+                                   xml,
+                                   m_imageChunk);
+}
+
 void Document::saveXml(QXmlStreamWriter &writer)
+{
+  saveXml (writer,
+           true);
+}
+
+void Document::saveXml(QXmlStreamWriter &writer,
+                       bool withImageData)
 {
   LOG4CPP_INFO_S ((*mainCat)) << "Document::saveXml";
 
@@ -532,18 +710,21 @@ void Document::saveXml(QXmlStreamWriter &writer)
   writer.writeStartElement(DOCUMENT_SERIALIZE_DOCUMENT);
 
   // Serialize the Document image. That binary data is encoded as base64
-  QByteArray array;
-  QDataStream str (&array, QIODevice::WriteOnly);
-  QImage img = m_pixmap.toImage ();
-  str << img;
   writer.writeStartElement(DOCUMENT_SERIALIZE_IMAGE);
 
   // Image width and height are explicitly inserted for error reports, since the CDATA is removed
-  // but we still want the image size for reconstructing the error(s)
-  writer.writeAttribute(DOCUMENT_SERIALIZE_IMAGE_WIDTH, QString::number (img.width()));
-  writer.writeAttribute(DOCUMENT_SERIALIZE_IMAGE_HEIGHT, QString::number (img.height()));
+  // but we still want the image size for reconstructing the error(s). DocumentContainer files have no CDATA either.
+  // A placeholder pixmap has the same size as the pending image
+  writer.writeAttribute(DOCUMENT_SERIALIZE_IMAGE_WIDTH, QString::number (m_pixmap.width()));
+  writer.writeAttribute(DOCUMENT_SERIALIZE_IMAGE_HEIGHT, QString::number (m_pixmap.height()));
 
-  writer.writeCDATA (array.toBase64 ());
+  if (withImageData) {
+    QByteArray array;
+    QDataStream str (&array, QIODevice::WriteOnly);
+    QImage img = image ();
+    str << img;
+    writer.writeCDATA (array.toBase64 ());
+  }
   writer.writeEndElement();
 
   // Serialize the Document variables
@@ -564,6 +745,17 @@ void Document::setCurvesGraphs (const CurvesGraphs &curvesGraphs)
   LOG4CPP_INFO_S ((*mainCat)) << "Document::setCurvesGraphs";
 
   m_curvesGraphs = curvesGraphs;
+
+  // Curves may have been added, removed or renamed, which the change set does not describe point by point
+  m_changeSet.setFullUpdate ();
+}
+
+void Document::setImage (const QImage &image)
+{
+  LOG4CPP_INFO_S ((*mainCat)) << "Document::setImage";
+
+  m_pixmap = QPixmap::fromImage (image);
+  m_imageIsPending = false;
 }
 
 void Document::setModelAxesChecker(const DocumentModelAxesChecker &modelAxesChecker)
@@ -590,6 +782,9 @@ void Document::setModelColorFilter(const DocumentModelColorFilter &modelColorFil
 void Document::setModelCoords (const DocumentModelCoords &modelCoords)
 {
   m_modelCoords = modelCoords;
+
+  // Log scaling, polar coordinates and theta units affect every graph coordinate even if the matrix is unchanged
+  ++m_transformationVersion;
 }
 
 void Document::setModelCurveStyles(const CurveStyles &modelCurveStyles)
@@ -604,6 +799,7 @@ void Document::setModelCurveStyles(const CurveStyles &modelCurveStyles)
 
     Curve *curve = curveForCurveName (curveName);
     curve->setCurveStyle (curveStyle);
+    m_changeSet.addCurveRestyled (curveName);
   }
 }
 
@@ -3,6 +3,7 @@
 
 #include "CurvesGraphs.h"
 #include "CurveStyles.h"
+#include "DocumentChangeSet.h"
 #include "DocumentModelAxesChecker.h"
 #include "DocumentModelColorFilter.h"
 #include "DocumentModelCoords.h"
@@ -11,14 +12,18 @@
 #include "DocumentModelPointMatch.h"
 #include "DocumentModelSegments.h"
 #include "PointStyle.h"
+#include <QByteArray>
 #include <QList>
 #include <QPixmap>
+#include <QSharedPointer>
 #include <QString>
+#include <QTransform>
+#include <QVector>
 #include <QXmlStreamReader>
 
 class Curve;
 class QImage;
-class QTransform;
+class QIODevice;
 class QXmlStreamWriter;
 class Transformation;
 
@@ -29,7 +34,9 @@ public:
   /// Constructor for imported images and dragged images
   Document (const QImage &image);
 
-  /// Constructor for opened Documents, and error report files. The specified file is opened and read
+  /// Constructor for opened Documents, and error report files. The specified file is opened and read. It can be either
+  /// an xml file or a DocumentContainer file. For a DocumentContainer file the pixmap is a blank placeholder until
+  /// setImage is called with the decoded image chunk. See imageIsPending
   Document (const QString &fileName);
 
   /// Add new graph curve to the list of existing graph curves.
@@ -38,10 +45,10 @@ public:
   /// Add a single axis point with a generated point identifier. Call this after checkAddPointAxis to guarantee success in this call.
   /// \param posScreen Screen coordinates from QGraphicsView
   /// \param posGraph Graph coordiantes from user
-  /// \param identifier Identifier for new axis point
+  /// \param pointId Identifier for new axis point
   void addPointAxisWithGeneratedIdentifier (const QPointF &posScreen,
                                             const QPointF &posGraph,
-                                            QString &identifier);
+                                            PointId &pointId);
 
   /// Add a single axis point with the specified point identifier. Call this after checkAddPointAxis to guarantee success in this call.
   /// \param posScreen Screen coordinates from QGraphicsView
@@ -54,7 +61,7 @@ public:
   /// Add a single graph point with a generated point identifier.
   void addPointGraphWithGeneratedIdentifier (const QString &curveName,
                                              const QPointF &posScreen,
-                                             QString &generatedIentifier,
+                                             PointId &generatedPointId,
                                              double ordinal);
 
   /// Add a single graph point with the specified point identifer. Note that PointStyle is not applied to the point within the Document.
@@ -63,12 +70,22 @@ public:
                                              const QString &identifier,
                                              double ordinal);
 
+  /// Add many graph points to one Curve in one pass, with generated point identifiers. The ordinals follow those of the
+  /// existing points, in the specified order. See also removePointsGraph
+  void addPointsGraphWithGeneratedIdentifiers (const QString &curveName,
+                                               const QVector<QPointF> &posScreens,
+                                               QVector<PointId> &pointIdsAdded);
+
   /// Add all points identified in the specified CurvesGraphs. See also removePointsInCurvesGraphs
   void addPointsInCurvesGraphs (CurvesGraphs &curvesGraphs);
 
-  /// See CurvesGraphs::applyTransformation.
+  /// See CurvesGraphs::applyTransformation. Only Points added or moved since the previous call are transformed, unless
+  /// the transformation or the coordinate settings have changed since then
   void applyTransformation (const Transformation &transformation);
 
+  /// Changes since the last clearChangeSet, for bringing the GraphicsScene up to date
+  const DocumentChangeSet &changeSet () const;
+
   /// Check before calling addPointAxis.
   void checkAddPointAxis (const QPointF &posScreen,
                           const QPointF &posGraph,
@@ -82,6 +99,9 @@ public:
                            bool &isError,
                            QString &errorMessage);
 
+  /// Forget the changes returned by changeSet, after they have been applied to the GraphicsScene
+  void clearChangeSet ();
+
   /// Get method for axis curve.
   const Curve &curveAxes () const;
 
@@ -99,7 +119,13 @@ public:
 
   /// Edit the graph coordinates of a single axis point. Call this after checkAddPointAxis to guarantee success in this call
   void editPointAxis (const QPointF &posGraph,
-                      const QString &identifier);
+                      PointId pointId);
+
+  /// Png chunk of the image. This is only available for Documents read from or saved to a DocumentContainer file
+  QByteArray imageChunk () const;
+
+  /// True if the pixmap is a placeholder, until setImage is called with the image decoded from imageChunk
+  bool imageIsPending () const;
 
   /// See Curve::iterateThroughCurvePoints, for the axes curve.
   void iterateThroughCurvePointsAxes (const Functor2wRet<const QString &, const Point &, CallbackSearchReturn> &ftorWithCallback);
@@ -142,36 +168,52 @@ public:
   DocumentModelSegments modelSegments() const;
 
   /// See Curve::movePoint
-  void movePoint (const QString &pointIdentifier,
+  void movePoint (PointId pointId,
                   const QPointF &deltaScreen);
 
-  /// Return the image that is being digitized.
+  /// Return the image that is being digitized. While imageIsPending is true this is a blank placeholder of the right
+  /// size, so MainWindow keeps the tools, dialogs and printing that read its pixels disabled until the image arrives
   QPixmap pixmap () const;
 
+  /// Intern table of the point identifiers in this Document. See PointIdTable. The GraphicsScene shares the table so it
+  /// can still look up the Points of this Document while removing them, after the Document has been replaced
+  QSharedPointer<PointIdTable> pointIdTable () const;
+
   /// See Curve::positionGraph.
-  QPointF positionGraph (const QString &pointIdentifier) const;
+  QPointF positionGraph (PointId pointId) const;
 
   /// See Curve::positionScreen.
-  QPointF positionScreen (const QString &pointIdentifier) const;
+  QPointF positionScreen (PointId pointId) const;
 
   /// Return an informative text message explaining why startup loading failed. Applies if successfulRead returns false
   QString reasonForUnsuccessfulRead () const;
 
   /// Perform the opposite of addPointAxis.
-  void removePointAxis (const QString &identifier);
+  void removePointAxis (PointId pointId);
 
   /// Perform the opposite of addPointGraph.
-  void removePointGraph (const QString &identifier);
+  void removePointGraph (PointId pointId);
+
+  /// Perform the opposite of addPointsGraphWithGeneratedIdentifiers. The Points are removed from the Curve by PointId,
+  /// without looking up the curve name of each Point
+  void removePointsGraph (const QString &curveName,
+                          const QVector<PointId> &pointIds);
 
   /// Remove all points identified in the specified CurvesGraphs. See also addPointsInCurvesGraphs
   void removePointsInCurvesGraphs (CurvesGraphs &curvesGraphs);
 
+  /// Save document to a DocumentContainer, with the xml from saveXml but without the image data, and the png chunk
+  bool saveContainer (QIODevice &device);
+
   /// Save document to xml
   void saveXml(QXmlStreamWriter &writer);
 
   /// Let CmdAbstract classes overwrite CurvesGraphs.
   void setCurvesGraphs (const CurvesGraphs &curvesGraphs);
 
+  /// Replace the placeholder pixmap by the image decoded from imageChunk
+  void setImage (const QImage &image);
+
   /// Set method for DocumentModelAxesChecker.
   void setModelAxesChecker(const DocumentModelAxesChecker &modelAxesChecker);
 
@@ -208,18 +250,25 @@ private:
 
   Curve *curveForCurveName (const QString &curveName); // For use by Document only. External classes should use functors
   void generateEmptyPixmap(const QXmlStreamAttributes &attributes);
+  QImage image () const; // Decodes the png chunk synchronously if the image is still pending
   void loadCurvesGraphs(QXmlStreamReader &reader);
   void loadImage(QXmlStreamReader &reader);
+  void loadXml (QXmlStreamReader &reader); // Shared by xml files and the xml section of DocumentContainer files
+  void saveXml (QXmlStreamWriter &writer,
+                bool withImageData);
 
   // Metadata
   QString m_name;
   QPixmap m_pixmap;
+  QByteArray m_imageChunk; // Png encoded image, kept so saving to a DocumentContainer never encodes the image again
+  bool m_imageIsPending;
 
   // Read variables
   bool m_successfulRead;
   QString m_reasonForUnsuccessfulRead;
 
-  // Curves
+  // Curves. The PointIdTable is declared first, since the Curves point to it
+  QSharedPointer<PointIdTable> m_pointIdTable;
   Curve *m_curveAxes;
   CurvesGraphs m_curvesGraphs;
 
@@ -232,6 +281,14 @@ private:
   DocumentModelGridRemoval m_modelGridRemoval;
   DocumentModelPointMatch m_modelPointMatch;
   DocumentModelSegments m_modelSegments;
+
+  // Transformation matrix from the previous applyTransformation, and a version number that is incremented whenever the
+  // matrix or the coordinate settings change. Each Curve remembers the last version it was transformed with
+  QTransform m_transformApplied;
+  int m_transformationVersion;
+
+  // Changes to be applied to the GraphicsScene. Every method that adds, removes, moves or restyles points records here
+  DocumentChangeSet m_changeSet;
 };
 
 #endif // DOCUMENT_H
@@ -0,0 +1,111 @@
+#include "DocumentChangeSet.h"
+
+DocumentChangeSet::DocumentChangeSet() :
+  m_isFullUpdate (true)
+{
+}
+
+void DocumentChangeSet::addCurveRestyled (const QString &curveName)
+{
+  if (!m_isFullUpdate) {
+    m_curvesRestyled.insert (curveName);
+  }
+}
+
+void DocumentChangeSet::addPointAdded (PointId pointId)
+{
+  if (!m_isFullUpdate) {
+
+    if (m_pointsRemoved.remove (pointId)) {
+
+      // Point is still in the scene, although possibly at a different position
+      m_pointsMoved.insert (pointId);
+
+    } else {
+
+      m_pointsAdded.insert (pointId);
+
+    }
+  }
+}
+
+void DocumentChangeSet::addPointMoved (PointId pointId)
+{
+  if (!m_isFullUpdate) {
+
+    if (!m_pointsAdded.contains (pointId)) {
+      m_pointsMoved.insert (pointId);
+    }
+  }
+}
+
+void DocumentChangeSet::addPointRemoved (PointId pointId)
+{
+  if (!m_isFullUpdate) {
+
+    if (!m_pointsAdded.remove (pointId)) {
+
+      m_pointsMoved.remove (pointId);
+      m_pointsRemoved.insert (pointId);
+
+    }
+  }
+}
+
+void DocumentChangeSet::clear ()
+{
+  m_isFullUpdate = false;
+  m_pointsAdded.clear ();
+  m_pointsMoved.clear ();
+  m_pointsRemoved.clear ();
+  m_curvesRestyled.clear ();
+}
+
+QSet<QString> DocumentChangeSet::curvesChanged (const PointIdTable &pointIdTable) const
+{
+  QSet<QString> curveNames = m_curvesRestyled;
+
+  QSet<PointId>::const_iterator itr;
+  for (itr = m_pointsAdded.begin (); itr != m_pointsAdded.end (); itr++) {
+    curveNames.insert (pointIdTable.curveName (*itr));
+  }
+  for (itr = m_pointsMoved.begin (); itr != m_pointsMoved.end (); itr++) {
+    curveNames.insert (pointIdTable.curveName (*itr));
+  }
+  for (itr = m_pointsRemoved.begin (); itr != m_pointsRemoved.end (); itr++) {
+    curveNames.insert (pointIdTable.curveName (*itr));
+  }
+
+  return curveNames;
+}
+
+const QSet<QString> &DocumentChangeSet::curvesRestyled () const
+{
+  return m_curvesRestyled;
+}
+
+bool DocumentChangeSet::isFullUpdate () const
+{
+  return m_isFullUpdate;
+}
+
+const QSet<PointId> &DocumentChangeSet::pointsAdded () const
+{
+  return m_pointsAdded;
+}
+
+const QSet<PointId> &DocumentChangeSet::pointsMoved () const
+{
+  return m_pointsMoved;
+}
+
+const QSet<PointId> &DocumentChangeSet::pointsRemoved () const
+{
+  return m_pointsRemoved;
+}
+
+void DocumentChangeSet::setFullUpdate ()
+{
+  clear ();
+  m_isFullUpdate = true;
+}
@@ -0,0 +1,65 @@
+#ifndef DOCUMENT_CHANGE_SET_H
+#define DOCUMENT_CHANGE_SET_H
+
+#include "PointIdTable.h"
+#include <QSet>
+#include <QString>
+
+/// Points added, removed and moved, and curves restyled, since the GraphicsScene was last brought up to date. Changes
+/// are recorded by Document as commands modify it, and applied by GraphicsScene::updateAfterCommand so the scene work
+/// depends on the size of the edit rather than the size of the Document. Changes that are not described point by point,
+/// like replacing all the curves, request a full update instead
+class DocumentChangeSet
+{
+public:
+  /// Single constructor. The first update is a full update, since the scene has not seen the Document yet
+  DocumentChangeSet();
+
+  /// Record restyled curve. The points and lines of the curve are restyled
+  void addCurveRestyled (const QString &curveName);
+
+  /// Record added point. A point that was removed earlier in the same change set counts as moved instead
+  void addPointAdded (PointId pointId);
+
+  /// Record moved point. A point that was added earlier in the same change set stays added
+  void addPointMoved (PointId pointId);
+
+  /// Record removed point. A point that was added earlier in the same change set cancels out
+  void addPointRemoved (PointId pointId);
+
+  /// Forget all changes, after they have been applied
+  void clear ();
+
+  /// Curves with at least one change, whose lines have to be redrawn. The curve of each Point comes from the
+  /// PointIdTable of the Document
+  QSet<QString> curvesChanged (const PointIdTable &pointIdTable) const;
+
+  /// Get method for restyled curves
+  const QSet<QString> &curvesRestyled () const;
+
+  /// True if the scene has to be rebuilt from the entire Document, rather than from the individual changes
+  bool isFullUpdate () const;
+
+  /// Get method for added points
+  const QSet<PointId> &pointsAdded () const;
+
+  /// Get method for moved points
+  const QSet<PointId> &pointsMoved () const;
+
+  /// Get method for removed points
+  const QSet<PointId> &pointsRemoved () const;
+
+  /// Request full update, for changes that are not described point by point. Individual changes are not recorded
+  /// until after the next clear
+  void setFullUpdate ();
+
+private:
+
+  bool m_isFullUpdate;
+  QSet<PointId> m_pointsAdded;
+  QSet<PointId> m_pointsMoved;
+  QSet<PointId> m_pointsRemoved;
+  QSet<QString> m_curvesRestyled;
+};
+
+#endif // DOCUMENT_CHANGE_SET_H
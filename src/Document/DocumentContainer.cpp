@@ -0,0 +1,139 @@
+#include "DocumentContainer.h"
+#include "Logger.h"
+#include <QDataStream>
+#include <QIODevice>
+
+// Magic number. The zero bytes make sure this cannot be mistaken for xml
+const char MAGIC [] = {'\0', 'E', 'N', 'G', 'A', 'U', 'G', 'E'};
+const int MAGIC_SIZE = sizeof (MAGIC);
+
+const quint32 CONTAINER_VERSION = 1;
+
+// Sizes of the version and of each section size, as written by QDataStream
+const int VERSION_SIZE = sizeof (quint32);
+const int SECTION_SIZE_SIZE = sizeof (quint64);
+
+DocumentContainer::DocumentContainer(const QString &fileName) :
+  m_file (fileName),
+  m_memory (0),
+  m_isValid (false),
+  m_xmlOffset (0),
+  m_xmlSize (0),
+  m_imageChunkOffset (0),
+  m_imageChunkSize (0)
+{
+  LOG4CPP_INFO_S ((*mainCat)) << "DocumentContainer::DocumentContainer fileName=" << fileName.toLatin1 ().data ();
+
+  if (!m_file.open (QIODevice::ReadOnly)) {
+    return;
+  }
+
+  qint64 fileSize = m_file.size ();
+  if (fileSize < MAGIC_SIZE + VERSION_SIZE + 2 * SECTION_SIZE_SIZE) {
+    return;
+  }
+
+  m_memory = (const char *) m_file.map (0,
+                                        fileSize);
+  if (m_memory == 0) {
+
+    // Some file systems cannot be mapped, so read the whole file instead
+    m_contents = m_file.readAll ();
+    m_memory = m_contents.constData ();
+  }
+
+  // Header and section sizes. Only the fixed size values are read through the stream
+  QByteArray header = QByteArray::fromRawData (m_memory,
+                                               fileSize);
+  QDataStream str (header);
+  str.skipRawData (MAGIC_SIZE);
+
+  quint32 version;
+  quint64 xmlSize, imageChunkSize;
+  str >> version;
+  str >> xmlSize;
+  if ((version != CONTAINER_VERSION) ||
+      (str.status () != QDataStream::Ok) ||
+      (xmlSize > (quint64) fileSize)) {
+    return;
+  }
+
+  m_xmlOffset = MAGIC_SIZE + VERSION_SIZE + SECTION_SIZE_SIZE;
+  m_xmlSize = xmlSize;
+
+  str.skipRawData ((int) m_xmlSize);
+  str >> imageChunkSize;
+  if ((str.status () != QDataStream::Ok) ||
+      (m_xmlOffset + m_xmlSize + SECTION_SIZE_SIZE + (qint64) imageChunkSize != fileSize)) {
+    return;
+  }
+
+  m_imageChunkOffset = m_xmlOffset + m_xmlSize + SECTION_SIZE_SIZE;
+  m_imageChunkSize = imageChunkSize;
+
+  m_isValid = true;
+}
+
+DocumentContainer::~DocumentContainer()
+{
+  // Closing the file also unmaps it
+  m_file.close ();
+}
+
+QByteArray DocumentContainer::imageChunk () const
+{
+  if (!m_isValid) {
+    return QByteArray ();
+  }
+
+  return QByteArray (m_memory + m_imageChunkOffset,
+                     m_imageChunkSize);
+}
+
+bool DocumentContainer::isContainerFile (const QString &fileName)
+{
+  QFile file (fileName);
+  if (!file.open (QIODevice::ReadOnly)) {
+    return false;
+  }
+
+  return (file.read (MAGIC_SIZE) == QByteArray (MAGIC,
+                                                MAGIC_SIZE));
+}
+
+bool DocumentContainer::isValid () const
+{
+  return m_isValid;
+}
+
+bool DocumentContainer::write (QIODevice &device,
+                               const QByteArray &xml,
+                               const QByteArray &imageChunk)
+{
+  LOG4CPP_INFO_S ((*mainCat)) << "DocumentContainer::write"
+                              << " xmlSize=" << xml.size ()
+                              << " imageChunkSize=" << imageChunk.size ();
+
+  QDataStream str (&device);
+  str.writeRawData (MAGIC,
+                    MAGIC_SIZE);
+  str << CONTAINER_VERSION;
+  str << (quint64) xml.size ();
+  str.writeRawData (xml.constData (),
+                    xml.size ());
+  str << (quint64) imageChunk.size ();
+  str.writeRawData (imageChunk.constData (),
+                    imageChunk.size ());
+
+  return (str.status () == QDataStream::Ok);
+}
+
+QByteArray DocumentContainer::xml () const
+{
+  if (!m_isValid) {
+    return QByteArray ();
+  }
+
+  return QByteArray::fromRawData (m_memory + m_xmlOffset,
+                                  m_xmlSize);
+}
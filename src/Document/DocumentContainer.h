@@ -0,0 +1,58 @@
+#ifndef DOCUMENT_CONTAINER_H
+#define DOCUMENT_CONTAINER_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+
+class QIODevice;
+
+/// Binary container for Document files. The Document xml is stored without the image data, and the image is stored
+/// after it as a separate png chunk, so neither one has to be base64 encoded or copied through a QDataStream. The
+/// layout, with integers in QDataStream byte order, is:
+/// -# Magic number, which can never start an xml file
+/// -# Version
+/// -# Size of the xml section, followed by the xml section
+/// -# Size of the png chunk, followed by the png chunk
+///
+/// Reading memory maps the file, so the xml section is parsed straight from the mapped memory and the png chunk is
+/// only touched when it is copied out for decoding. Files that start with anything else are xml Document files
+class DocumentContainer
+{
+public:
+  /// Constructor for reading the specified file. See isValid
+  DocumentContainer(const QString &fileName);
+  ~DocumentContainer();
+
+  /// Copy of the png chunk, which outlives this container
+  QByteArray imageChunk () const;
+
+  /// True if the file starts with the container magic number
+  static bool isContainerFile (const QString &fileName);
+
+  /// True if the file was read and its sections are consistent with its size
+  bool isValid () const;
+
+  /// Write a container with the specified sections. Returns false if the device could not be written
+  static bool write (QIODevice &device,
+                     const QByteArray &xml,
+                     const QByteArray &imageChunk);
+
+  /// Xml section. This refers to the mapped memory without copying it, so it is only valid while this container exists
+  QByteArray xml () const;
+
+private:
+  DocumentContainer();
+
+  QFile m_file;
+  const char *m_memory; // Mapped file, or the data in m_contents if the file could not be mapped
+  QByteArray m_contents;
+
+  bool m_isValid;
+  qint64 m_xmlOffset;
+  qint64 m_xmlSize;
+  qint64 m_imageChunkOffset;
+  qint64 m_imageChunkSize;
+};
+
+#endif // DOCUMENT_CONTAINER_H
@@ -11,6 +11,7 @@ const QString DOCUMENT_SERIALIZE_BOOL_TRUE ("True");
 const QString DOCUMENT_SERIALIZE_CMD ("Cmd");
 const QString DOCUMENT_SERIALIZE_CMD_ADD_POINT_AXIS ("CmdAddPointAxis");
 const QString DOCUMENT_SERIALIZE_CMD_ADD_POINT_GRAPH ("CmdAddPointGraph");
+const QString DOCUMENT_SERIALIZE_CMD_ADD_POINTS_GRAPH ("CmdAddPointsGraph");
 const QString DOCUMENT_SERIALIZE_CMD_COPY ("CmdCopy");
 const QString DOCUMENT_SERIALIZE_CMD_CUT ("CmdCut");
 const QString DOCUMENT_SERIALIZE_CMD_DELETE ("CmdDelete");
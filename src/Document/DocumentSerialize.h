@@ -15,6 +15,7 @@ extern const QString DOCUMENT_SERIALIZE_BOOL_TRUE;
 extern const QString DOCUMENT_SERIALIZE_CMD;
 extern const QString DOCUMENT_SERIALIZE_CMD_ADD_POINT_AXIS;
 extern const QString DOCUMENT_SERIALIZE_CMD_ADD_POINT_GRAPH;
+extern const QString DOCUMENT_SERIALIZE_CMD_ADD_POINTS_GRAPH;
 extern const QString DOCUMENT_SERIALIZE_CMD_COPY;
 extern const QString DOCUMENT_SERIALIZE_CMD_CUT;
 extern const QString DOCUMENT_SERIALIZE_CMD_DELETE;
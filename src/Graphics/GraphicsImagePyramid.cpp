@@ -0,0 +1,300 @@
+#include "DataKey.h"
+#include "GraphicsImagePyramid.h"
+#include "GraphicsImagePyramidThread.h"
+#include "GraphicsItemType.h"
+#include "Logger.h"
+#include <qmath.h>
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+#include <QTimer>
+
+const int TILE_SIZE = 256;
+
+// Tiles converted per pass through the event loop. Each conversion takes a fraction of a millisecond, so input events
+// are still handled promptly while a screen full of tiles is prepared
+const int TILES_PER_PREPARATION = 16;
+
+GraphicsImagePyramid::GraphicsImagePyramid(const QImage &image,
+                                           int tileCacheMegabytes) :
+  m_thread (0),
+  m_tilePreparationIsScheduled (false)
+{
+  initialize (image,
+              tileCacheMegabytes);
+}
+
+GraphicsImagePyramid::GraphicsImagePyramid(const QPixmap &pixmap,
+                                           const QImage &image,
+                                           int tileCacheMegabytes) :
+  m_pixmapLevel0 (pixmap),
+  m_thread (0),
+  m_tilePreparationIsScheduled (false)
+{
+  initialize (image,
+              tileCacheMegabytes);
+}
+
+GraphicsImagePyramid::~GraphicsImagePyramid()
+{
+  if (m_thread != 0) {
+    m_thread->stop ();
+    m_thread->wait ();
+    delete m_thread;
+  }
+}
+
+QRectF GraphicsImagePyramid::boundingRect () const
+{
+  return QRectF (m_levels.first ().rect ());
+}
+
+void GraphicsImagePyramid::initialize (const QImage &image,
+                                       int tileCacheMegabytes)
+{
+  LOG4CPP_INFO_S ((*mainCat)) << "GraphicsImagePyramid::initialize"
+                              << " width=" << image.width ()
+                              << " height=" << image.height ()
+                              << " sharesPixmap=" << (m_pixmapLevel0.isNull () ? "no" : "yes")
+                              << " tileCacheMegabytes=" << tileCacheMegabytes;
+
+  setData (DATA_KEY_IDENTIFIER, "view");
+  setData (DATA_KEY_GRAPHICS_ITEM_TYPE, GRAPHICS_ITEM_TYPE_IMAGE);
+
+  // Exposed rectangle is needed so painting can skip the tiles outside of it
+  setFlag (QGraphicsItem::ItemUsesExtendedStyleOption);
+
+  // Levels are added until one tile holds the whole image
+  m_levels.push_back (image);
+  int width = image.width ();
+  int height = image.height ();
+  while ((width > TILE_SIZE) || (height > TILE_SIZE)) {
+    width = (width + 1) / 2;
+    height = (height + 1) / 2;
+    m_levels.push_back (QImage ());
+  }
+
+  m_tiles.setMaxCost (qMax (1, tileCacheMegabytes) * 1024);
+}
+
+int GraphicsImagePyramid::levelForScale (double scale) const
+{
+  int level = 0;
+  if (scale > 0) {
+    while ((level + 1 < m_levels.count ()) &&
+           (qPow (2.0, level + 1) * scale <= 1.0)) {
+      ++level;
+    }
+  }
+
+  return level;
+}
+
+void GraphicsImagePyramid::paint (QPainter *painter,
+                                  const QStyleOptionGraphicsItem *option,
+                                  QWidget * /* widget */)
+{
+  double scale = qSqrt (qAbs (painter->worldTransform ().determinant ()));
+  int level = levelForScale (scale);
+
+  if (m_levels [level].isNull ()) {
+
+    if (m_thread == 0) {
+
+      // First time a coarser level is wanted, so build all of them
+      m_thread = new GraphicsImagePyramidThread (m_levels.first (),
+                                                 m_levels.count ());
+      connect (m_thread, SIGNAL (signalTransferLevel (int, QImage)),
+               this, SLOT (slotTransferLevel (int, QImage)));
+      m_thread->start (QThread::LowPriority);
+    }
+
+    // Use the finest level that is ready until the wanted level arrives
+    while (m_levels [level].isNull ()) {
+      --level;
+    }
+  }
+
+  QRectF rectExposed = option->exposedRect & boundingRect ();
+  if (rectExposed.isEmpty ()) {
+    return;
+  }
+
+  if ((level == 0) &&
+      !m_pixmapLevel0.isNull ()) {
+
+    // Full resolution comes straight from the Document pixmap, which is already in the format for drawing
+    painter->drawPixmap (rectExposed,
+                         m_pixmapLevel0,
+                         rectExposed);
+    return;
+  }
+
+  const QImage &imageLevel = m_levels [level];
+  double scaleX = (double) m_levels.first ().width () / imageLevel.width ();
+  double scaleY = (double) m_levels.first ().height () / imageLevel.height ();
+
+  int columnMin = qFloor (rectExposed.left () / scaleX / TILE_SIZE);
+  int columnMax = qMin (qFloor (rectExposed.right () / scaleX / TILE_SIZE),
+                        (imageLevel.width () - 1) / TILE_SIZE);
+  int rowMin = qFloor (rectExposed.top () / scaleY / TILE_SIZE);
+  int rowMax = qMin (qFloor (rectExposed.bottom () / scaleY / TILE_SIZE),
+                     (imageLevel.height () - 1) / TILE_SIZE);
+
+  for (int row = rowMin; row <= rowMax; row++) {
+    for (int column = columnMin; column <= columnMax; column++) {
+
+      quint64 key = tileKey (level,
+                             column,
+                             row);
+
+      const QPixmap *pixmap = m_tiles.object (key);
+      if (pixmap != 0) {
+
+        painter->drawPixmap (rectForTile (level,
+                                          column,
+                                          row),
+                             *pixmap,
+                             QRectF (pixmap->rect ()));
+
+      } else {
+
+        // Converting here would stall painting, so the tile is converted later and a coarser tile stands in for it
+        m_tileKeysPending.insert (key);
+        paintTileFromCoarserLevel (painter,
+                                   level,
+                                   column,
+                                   row);
+      }
+    }
+  }
+
+  if (!m_tileKeysPending.isEmpty () &&
+      !m_tilePreparationIsScheduled) {
+
+    m_tilePreparationIsScheduled = true;
+    QTimer::singleShot (0, this, SLOT (slotPrepareTiles ()));
+  }
+}
+
+void GraphicsImagePyramid::paintTileFromCoarserLevel (QPainter *painter,
+                                                      int level,
+                                                      int column,
+                                                      int row)
+{
+  QRectF rectTarget = rectForTile (level,
+                                   column,
+                                   row);
+
+  bool found = false;
+  for (int levelCoarser = level + 1; !found && (levelCoarser < m_levels.count ()); levelCoarser++) {
+
+    if (!m_levels [levelCoarser].isNull ()) {
+
+      int shift = levelCoarser - level;
+      const QPixmap *pixmap = m_tiles.object (tileKey (levelCoarser,
+                                                       column >> shift,
+                                                       row >> shift));
+      if (pixmap != 0) {
+
+        // Part of the coarser tile that covers the target
+        QRectF rectCoarser = rectForTile (levelCoarser,
+                                          column >> shift,
+                                          row >> shift);
+        double pixelsPerUnitX = pixmap->width () / rectCoarser.width ();
+        double pixelsPerUnitY = pixmap->height () / rectCoarser.height ();
+        QRectF rectSource ((rectTarget.left () - rectCoarser.left ()) * pixelsPerUnitX,
+                           (rectTarget.top () - rectCoarser.top ()) * pixelsPerUnitY,
+                           rectTarget.width () * pixelsPerUnitX,
+                           rectTarget.height () * pixelsPerUnitY);
+
+        painter->drawPixmap (rectTarget,
+                             *pixmap,
+                             rectSource);
+        found = true;
+      }
+    }
+  }
+}
+
+QRectF GraphicsImagePyramid::rectForTile (int level,
+                                          int column,
+                                          int row) const
+{
+  const QImage &imageLevel = m_levels [level];
+  double scaleX = (double) m_levels.first ().width () / imageLevel.width ();
+  double scaleY = (double) m_levels.first ().height () / imageLevel.height ();
+
+  QRect rectTile = QRect (column * TILE_SIZE,
+                          row * TILE_SIZE,
+                          TILE_SIZE,
+                          TILE_SIZE).intersected (imageLevel.rect ());
+
+  return QRectF (rectTile.left () * scaleX,
+                 rectTile.top () * scaleY,
+                 rectTile.width () * scaleX,
+                 rectTile.height () * scaleY);
+}
+
+void GraphicsImagePyramid::slotPrepareTiles ()
+{
+  m_tilePreparationIsScheduled = false;
+
+  int count = 0;
+  QSet<quint64>::iterator itr = m_tileKeysPending.begin ();
+  while ((count < TILES_PER_PREPARATION) &&
+         (itr != m_tileKeysPending.end ())) {
+
+    quint64 key = *itr;
+    itr = m_tileKeysPending.erase (itr);
+
+    int level = (int) (key >> 48);
+    int row = (int) ((key >> 24) & 0xffffff);
+    int column = (int) (key & 0xffffff);
+
+    if (!m_tiles.contains (key)) {
+
+      const QImage &imageLevel = m_levels [level];
+      QRect rectTile = QRect (column * TILE_SIZE,
+                              row * TILE_SIZE,
+                              TILE_SIZE,
+                              TILE_SIZE).intersected (imageLevel.rect ());
+
+      QPixmap *pixmap = new QPixmap (QPixmap::fromImage (imageLevel.copy (rectTile)));
+
+      // Cache takes ownership, and deletes the pixmap if it is larger than the whole budget
+      int cost = qMax (1, pixmap->width () * pixmap->height () * 4 / 1024);
+      if (m_tiles.insert (key,
+                          pixmap,
+                          cost)) {
+        update (rectForTile (level,
+                             column,
+                             row));
+      }
+
+      ++count;
+    }
+  }
+
+  if (!m_tileKeysPending.isEmpty ()) {
+
+    m_tilePreparationIsScheduled = true;
+    QTimer::singleShot (0, this, SLOT (slotPrepareTiles ()));
+  }
+}
+
+void GraphicsImagePyramid::slotTransferLevel (int level,
+                                              QImage image)
+{
+  LOG4CPP_INFO_S ((*mainCat)) << "GraphicsImagePyramid::slotTransferLevel level=" << level;
+
+  m_levels [level] = image;
+
+  update ();
+}
+
+quint64 GraphicsImagePyramid::tileKey (int level,
+                                       int column,
+                                       int row) const
+{
+  return ((quint64) level << 48) | ((quint64) row << 24) | (quint64) column;
+}
@@ -0,0 +1,94 @@
+#ifndef GRAPHICS_IMAGE_PYRAMID_H
+#define GRAPHICS_IMAGE_PYRAMID_H
+
+#include <QCache>
+#include <QGraphicsObject>
+#include <QImage>
+#include <QPixmap>
+#include <QSet>
+#include <QVector>
+
+class GraphicsImagePyramidThread;
+
+/// Background image drawn from a multi-resolution pyramid of 256x256 tiles, rather than from one full resolution
+/// QGraphicsPixmapItem. Level 0 is the full resolution image, and each following level has half the width and height
+/// of the one before it. Painting picks the coarsest level that still has at least one image pixel per device pixel,
+/// so a zoomed out view of a very large scan copies a few small tiles instead of rescaling the whole image.
+///
+/// Coarser levels are built lazily in a GraphicsImagePyramidThread the first time they are wanted. Until then the
+/// finest available level is used. Tiles are converted to pixmaps outside of paint, a few at a time from the event
+/// loop, and kept in an LRU cache with a memory budget from the settings, so tiles that have scrolled out of the
+/// viewport are the first to be evicted. Until a tile is ready its area is drawn from a cached tile of a coarser level
+class GraphicsImagePyramid : public QGraphicsObject
+{
+  Q_OBJECT;
+
+public:
+  /// Constructor for an image that only exists as a QImage, like the filtered image. Level 0 is drawn from tiles
+  GraphicsImagePyramid(const QImage &image,
+                       int tileCacheMegabytes);
+
+  /// Constructor for the Document image. Level 0 is drawn straight from the pixmap, which is shared with the Document,
+  /// so no full resolution tiles are made. The image holds the same pixels and is only used to build the coarser levels
+  GraphicsImagePyramid(const QPixmap &pixmap,
+                       const QImage &image,
+                       int tileCacheMegabytes);
+  virtual ~GraphicsImagePyramid();
+
+  /// Rectangle of the full resolution image
+  virtual QRectF boundingRect () const;
+
+  /// Paint the tiles of the appropriate level that intersect the exposed rectangle
+  virtual void paint (QPainter *painter,
+                      const QStyleOptionGraphicsItem *option,
+                      QWidget *widget);
+
+private slots:
+  void slotPrepareTiles ();
+  void slotTransferLevel (int level,
+                          QImage image);
+
+private:
+  GraphicsImagePyramid();
+
+  // Set up the levels and the tile cache. Called by each constructor
+  void initialize (const QImage &image,
+                   int tileCacheMegabytes);
+
+  // Coarsest level with at least one image pixel per device pixel at the specified scale
+  int levelForScale (double scale) const;
+
+  // Draw the area of a tile that is not cached yet from the first coarser level whose covering tile is cached
+  void paintTileFromCoarserLevel (QPainter *painter,
+                                  int level,
+                                  int column,
+                                  int row);
+
+  // Rectangle of a tile in the coordinates of the full resolution image
+  QRectF rectForTile (int level,
+                      int column,
+                      int row) const;
+
+  // Cache key of a tile
+  quint64 tileKey (int level,
+                   int column,
+                   int row) const;
+
+  // Level images. Levels that have not been built yet are null
+  QVector<QImage> m_levels;
+
+  // Pixmap shared with the Document, for drawing level 0 without tiles. Null for images that are not in the Document
+  QPixmap m_pixmapLevel0;
+
+  // Builds the coarser levels. Created when a coarser level is first wanted
+  GraphicsImagePyramidThread *m_thread;
+
+  // Tile pixmaps keyed by level, row and column, with cost in kilobytes
+  QCache<quint64, QPixmap> m_tiles;
+
+  // Tiles that paint wanted but were not cached, to be converted by slotPrepareTiles
+  QSet<quint64> m_tileKeysPending;
+  bool m_tilePreparationIsScheduled;
+};
+
+#endif // GRAPHICS_IMAGE_PYRAMID_H
@@ -0,0 +1,40 @@
+#include "GraphicsImagePyramidThread.h"
+#include "Logger.h"
+
+GraphicsImagePyramidThread::GraphicsImagePyramidThread(const QImage &image,
+                                                       int levelCount) :
+  m_image (image),
+  m_levelCount (levelCount),
+  m_stop (0)
+{
+}
+
+void GraphicsImagePyramidThread::run ()
+{
+  LOG4CPP_INFO_S ((*mainCat)) << "GraphicsImagePyramidThread::run levels=" << m_levelCount;
+
+  // Each level is scaled from the previous level rather than from the full resolution image, so the total cost is
+  // about one third of a single pass over the full resolution image
+  QImage imageFiner = m_image;
+  for (int level = 1; level < m_levelCount; level++) {
+
+    if (m_stop.load () != 0) {
+      return;
+    }
+
+    QImage imageCoarser = imageFiner.scaled ((imageFiner.width () + 1) / 2,
+                                             (imageFiner.height () + 1) / 2,
+                                             Qt::IgnoreAspectRatio,
+                                             Qt::SmoothTransformation);
+
+    emit signalTransferLevel (level,
+                              imageCoarser);
+
+    imageFiner = imageCoarser;
+  }
+}
+
+void GraphicsImagePyramidThread::stop ()
+{
+  m_stop.store (1);
+}
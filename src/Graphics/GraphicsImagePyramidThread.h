@@ -0,0 +1,38 @@
+#ifndef GRAPHICS_IMAGE_PYRAMID_THREAD_H
+#define GRAPHICS_IMAGE_PYRAMID_THREAD_H
+
+#include <QAtomicInt>
+#include <QImage>
+#include <QThread>
+
+/// Thread for building the coarser levels of a GraphicsImagePyramid. Each level is half the width and height of the
+/// previous level, and is sent back as soon as it is done so the view can use it while the next level is built
+class GraphicsImagePyramidThread : public QThread
+{
+  Q_OBJECT;
+
+public:
+  /// Single constructor.
+  GraphicsImagePyramidThread(const QImage &image,
+                             int levelCount);
+
+  /// Thread entry point
+  virtual void run ();
+
+  /// Stop as soon as the current level is done. Typically this is followed by QThread::wait
+  void stop ();
+
+signals:
+  /// Send one level of the pyramid
+  void signalTransferLevel (int level,
+                            QImage image);
+
+private:
+  GraphicsImagePyramidThread();
+
+  QImage m_image; // Full resolution image for level 0
+  int m_levelCount;
+  QAtomicInt m_stop;
+};
+
+#endif // GRAPHICS_IMAGE_PYRAMID_THREAD_H
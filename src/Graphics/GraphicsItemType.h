@@ -6,6 +6,7 @@ enum GraphicsItemType {
   GRAPHICS_ITEM_TYPE_IMAGE,
   GRAPHICS_ITEM_TYPE_LINE,
   GRAPHICS_ITEM_TYPE_POINT,
+  GRAPHICS_ITEM_TYPE_POINTS_FOR_CURVE,
   GRAPHICS_ITEM_TYPE_SEGMENT
 };
 
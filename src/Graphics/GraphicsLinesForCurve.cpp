@@ -6,168 +6,660 @@
 #include "GraphicsScene.h"
 #include "LineStyle.h"
 #include "Logger.h"
-#include "Point.h"
 #include <QGraphicsItem>
-#include <QMap>
+#include <QPainter>
+#include <QPainterPathStroker>
 #include <QPen>
+#include <QStyleOptionGraphicsItem>
 #include "QtToString.h"
-#include "Spline.h"
 #include "Transformation.h"
+#include <algorithm>
 
 using namespace std;
 
-typedef QMap<double, QString> XOrThetaToPointIdentifier;
+// Intervals per chunk. Dragging one point of a long curve draws one or two chunks again instead of the whole curve
+const int CHUNK_INTERVALS = 256;
+
+// Local spline updates are only worthwhile for a few changed points. Beyond that a full rebuild is just as fast
+const int MAX_LOCAL_SPLINE_CHANGES = 4;
+
+// Drawing order. Points with the same ordinal are kept in a repeatable order by their ids
+static bool lessThanByOrdinal (const GraphicsLinesForCurvePoint &point1,
+                               const GraphicsLinesForCurvePoint &point2)
+{
+  if (point1.ordinal != point2.ordinal) {
+    return point1.ordinal < point2.ordinal;
+  }
+
+  return point1.pointId < point2.pointId;
+}
+
+// Function order, for updatePointOrdinalsAfterDrag
+static bool lessThanByXOrTheta (const GraphicsLinesForCurvePoint &point1,
+                                const GraphicsLinesForCurvePoint &point2)
+{
+  if (point1.xOrTheta != point2.xOrTheta) {
+    return point1.xOrTheta < point2.xOrTheta;
+  }
+
+  return point1.pointId < point2.pointId;
+}
 
 GraphicsLinesForCurve::GraphicsLinesForCurve(const QString &curveName) :
-  m_curveName (curveName)
+  m_curveName (curveName),
+  m_pointsAreSorted (true),
+  m_xOrThetaAreCurrent (false),
+  m_linesMatchPoints (false),
+  m_intervalCount (0)
 {
+  // Exposed rectangle is needed so painting can skip the chunks outside of it
+  setFlag (QGraphicsItem::ItemUsesExtendedStyleOption);
 }
 
-QPainterPath GraphicsLinesForCurve::drawLinesSmooth (const OrdinalToPointIdentifier &ordinalToPointIdentifier)
+QRectF GraphicsLinesForCurve::boundingRect () const
 {
-  LOG4CPP_INFO_S ((*mainCat)) << "GraphicsLinesForCurve::drawLinesSmooth";
+  if (m_chunks.isEmpty ()) {
+    return QRectF ();
+  }
+
+  double marginPen = margin ();
+  return m_rectLines.adjusted (-marginPen, -marginPen, marginPen, marginPen);
+}
+
+const QPainterPath &GraphicsLinesForCurve::chunkStroke (int chunk) const
+{
+  const GraphicsLinesForCurveChunk &chunkLines = m_chunks.at (chunk);
+
+  if (chunkLines.strokeIsStale) {
+
+    QPainterPathStroker stroker;
+    stroker.setWidth (qMax (1.0, m_pen.widthF ()));
+
+    chunkLines.stroke = stroker.createStroke (chunkLines.path);
+    chunkLines.strokeIsStale = false;
+  }
+
+  return chunkLines.stroke;
+}
+
+bool GraphicsLinesForCurve::collidesWithPath (const QPainterPath &path,
+                                              Qt::ItemSelectionMode mode) const
+{
+  if (mode != Qt::IntersectsItemShape) {
+
+    // Containment needs the whole shape, and the bounding rectangle modes need no strokes at all
+    return QGraphicsItem::collidesWithPath (path,
+                                            mode);
+  }
+
+  // Path is in the coordinates of this item, like the chunks
+  QRectF rectPath = path.controlPointRect ();
+  double marginPen = margin ();
+  for (int chunk = 0; chunk < m_chunks.count (); chunk++) {
+
+    const QRectF &rectChunk = m_chunks.at (chunk).boundingRect;
+    if (rectChunk.adjusted (-marginPen, -marginPen, marginPen, marginPen).intersects (rectPath) &&
+        path.intersects (chunkStroke (chunk))) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+bool GraphicsLinesForCurve::contains (const QPointF &point) const
+{
+  double marginPen = margin ();
+  for (int chunk = 0; chunk < m_chunks.count (); chunk++) {
+
+    const QRectF &rectChunk = m_chunks.at (chunk).boundingRect;
+    if (rectChunk.adjusted (-marginPen, -marginPen, marginPen, marginPen).contains (point) &&
+        chunkStroke (chunk).contains (point)) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void GraphicsLinesForCurve::drawChunk (int chunk)
+{
+  int iIntervalFirst = chunk * CHUNK_INTERVALS;
+  int iIntervalLast = qMin (iIntervalFirst + CHUNK_INTERVALS, m_intervalCount) - 1;
 
   QPainterPath path;
 
-  // Prepare spline inputs. Note that the ordinal values may not start at 0
-  vector<double> t;
-  vector<SplinePair> xy;
-  OrdinalToPointIdentifier::const_iterator itr;
-  for (itr = ordinalToPointIdentifier.begin(); itr != ordinalToPointIdentifier.end(); itr++) {
+  if (m_spline.count () > 0) {
+
+    path.moveTo (m_spline.xy (iIntervalFirst).x(),
+                 m_spline.xy (iIntervalFirst).y());
+
+    // Drawing from point i to point i+1 uses the control points from interval i
+    for (int i = iIntervalFirst; i <= iIntervalLast; i++) {
+
+      path.cubicTo (QPointF (m_spline.p1 (i).x(),
+                             m_spline.p1 (i).y()),
+                    QPointF (m_spline.p2 (i).x(),
+                             m_spline.p2 (i).y()),
+                    QPointF (m_spline.xy (i + 1).x(),
+                             m_spline.xy (i + 1).y()));
+    }
+
+  } else {
 
-    const QString pointIdentifier = itr.value();
-    const Point &point = m_graphicsPoints [pointIdentifier];
+    path.moveTo (m_positionsStraight.at (iIntervalFirst));
 
-    t.push_back (point.ordinal ());
-    xy.push_back (SplinePair (point.posScreen ().x(),
-                              point.posScreen ().y()));
+    for (int i = iIntervalFirst; i <= iIntervalLast; i++) {
+      path.lineTo (m_positionsStraight.at (i + 1));
+    }
   }
 
-  // Spline through points
-  Spline spline (t, xy);
+  // Control point rectangle contains the curve, and unlike the exact bounding rectangle needs no curve solving
+  GraphicsLinesForCurveChunk &chunkLines = m_chunks [chunk];
+  chunkLines.path = path;
+  chunkLines.boundingRect = path.controlPointRect ();
+  chunkLines.isStale = false;
+  chunkLines.strokeIsStale = true;
+}
 
-  // Drawing from point i-1 to this point i uses the control points from point i-1
-  int segmentEndingAtPointI = 0;
+void GraphicsLinesForCurve::drawLinesSmooth ()
+{
+  LOG4CPP_INFO_S ((*mainCat)) << "GraphicsLinesForCurve::drawLinesSmooth";
 
-  // Create QPainterPath through the points
-  bool isFirst = true;
-  for (itr = ordinalToPointIdentifier.begin(); itr != ordinalToPointIdentifier.end(); itr++) {
+  m_positionsStraight.clear ();
 
-    const QString pointIdentifier = itr.value();
-    const Point &point = m_graphicsPoints [pointIdentifier];
+  // During a drag the spline already holds every point, so just the dragged points are moved in it
+  if (!m_linesMatchPoints ||
+      !updateSplineForMovedPoints ()) {
 
-    if (isFirst) {
-      isFirst = false;
-      path.moveTo (point.posScreen());
-    } else {
+    // Prepare spline inputs. Note that the ordinal values may not start at 0, but SplineIncremental only relies on
+    // the ordinals being one apart
+    int count = m_points.count ();
+    m_pointIdsForSpline.resize (count);
+    m_xyForSpline.resize (count);
+    for (int index = 0; index < count; index++) {
 
-      QPointF p1 (spline.p1 (segmentEndingAtPointI).x(),
-                  spline.p1 (segmentEndingAtPointI).y());
-      QPointF p2 (spline.p2 (segmentEndingAtPointI).x(),
-                  spline.p2 (segmentEndingAtPointI).y());
+      const GraphicsLinesForCurvePoint &point = m_points.at (index);
 
-      path.cubicTo (p1,
-                    p2,
-                    point.posScreen());
+      m_pointIdsForSpline [index] = point.pointId;
+      m_xyForSpline [index] = SplinePair (point.posScreen.x(),
+                                          point.posScreen.y());
+    }
 
-      ++segmentEndingAtPointI;
+    // Try local update of the persistent spline, which is much faster when one point has been inserted or removed
+    if (!updateSplineLocally (m_pointIdsForSpline,
+                              m_xyForSpline)) {
+
+      // Full rebuild. Swapping rather than assigning the ids keeps both arrays unshared, so neither is copied when it
+      // is next written
+      m_spline.rebuild (m_xyForSpline);
+      m_splinePointIds.swap (m_pointIdsForSpline);
+
+      resizeChunks (m_points.count () - 1);
+      markIntervalsStale (0,
+                          m_intervalCount - 1);
     }
   }
 
-  return path;
+  m_linesMatchPoints = true;
+  m_pointIdsMovedSinceDraw.clear ();
 }
 
-QPainterPath GraphicsLinesForCurve::drawLinesStraight (const OrdinalToPointIdentifier &ordinalToPointIdentifier)
+void GraphicsLinesForCurve::drawLinesStraight ()
 {
   LOG4CPP_INFO_S ((*mainCat)) << "GraphicsLinesForCurve::drawLinesStraight";
 
-  QPainterPath path;
+  int countOld = m_positionsStraight.count ();
+  int countNew = m_points.count ();
 
-  // Create QPainterPath through the points
-  bool isFirst = true;
-  OrdinalToPointIdentifier::const_iterator itr;
-  for (itr = ordinalToPointIdentifier.begin(); itr != ordinalToPointIdentifier.end(); itr++) {
+  if (m_linesMatchPoints &&
+      (countOld == countNew)) {
 
-    const QString pointIdentifier = itr.value();
-    const Point &point = m_graphicsPoints [pointIdentifier];
+    // During a drag the positions already hold every point, so just the dragged points are compared
+    QSet<PointId>::const_iterator itr;
+    for (itr = m_pointIdsMovedSinceDraw.begin (); itr != m_pointIdsMovedSinceDraw.end (); itr++) {
 
-    if (isFirst) {
-      isFirst = false;
-      path.moveTo (point.posScreen());
-    } else {
-      path.lineTo (point.posScreen());
+      int i = m_pointIdToIndex.value (*itr);
+      const QPointF &posScreen = m_points.at (i).posScreen;
+      if (m_positionsStraight.at (i) != posScreen) {
+
+        m_positionsStraight [i] = posScreen;
+        markIntervalsStale (i - 1,
+                            i);
+      }
+    }
+
+  } else {
+
+    resizeChunks (qMax (countNew - 1, 0));
+
+    // Each changed position affects the intervals on either side of it. Inserting or removing a point shifts the later
+    // positions, so their intervals are all stale, but new points are usually appended at the end
+    m_positionsStraight.resize (countNew);
+    for (int i = 0; i < countNew; i++) {
+
+      const QPointF &posScreen = m_points.at (i).posScreen;
+      if ((i >= countOld) ||
+          (m_positionsStraight.at (i) != posScreen)) {
+
+        m_positionsStraight [i] = posScreen;
+        markIntervalsStale (i - 1,
+                            i);
+      }
     }
   }
 
-  return path;
+  m_linesMatchPoints = true;
+  m_pointIdsMovedSinceDraw.clear ();
+}
+
+double GraphicsLinesForCurve::margin () const
+{
+  // Half the pen width covers round and flat line ends. Miter joins can stick out further, so the full width is used
+  return qMax (1.0, m_pen.widthF ()) + 1.0;
+}
+
+void GraphicsLinesForCurve::markIntervalsStale (int iIntervalFirst,
+                                                int iIntervalLast)
+{
+  iIntervalFirst = qMax (iIntervalFirst, 0);
+  iIntervalLast = qMin (iIntervalLast, m_intervalCount - 1);
+
+  if (iIntervalFirst <= iIntervalLast) {
+    for (int chunk = iIntervalFirst / CHUNK_INTERVALS; chunk <= iIntervalLast / CHUNK_INTERVALS; chunk++) {
+      m_chunks [chunk].isStale = true;
+    }
+  }
 }
 
-void GraphicsLinesForCurve::moveLinesWithDraggedPoint (const QString &pointIdentifier,
+void GraphicsLinesForCurve::moveLinesWithDraggedPoint (PointId pointId,
                                                        const QPointF &scenePos)
 {
-  // Since point membership was brought up to date already, we know there is an entry for pointIdentifier.
+  // Since point membership was brought up to date already, we know there is an entry for pointId.
   // We just need to update the points position
-  ENGAUGE_ASSERT (m_graphicsPoints.contains (pointIdentifier));
-  m_graphicsPoints [pointIdentifier].setPosScreen (scenePos);
+  QHash<PointId, int>::const_iterator itr = m_pointIdToIndex.find (pointId);
+  ENGAUGE_ASSERT (itr != m_pointIdToIndex.end ());
+  m_points [itr.value ()].posScreen = scenePos;
+  m_pointIdsXOrThetaStale.insert (pointId);
+  m_pointIdsMovedSinceDraw.insert (pointId);
+}
+
+void GraphicsLinesForCurve::paint (QPainter *painter,
+                                   const QStyleOptionGraphicsItem *option,
+                                   QWidget * /* widget */)
+{
+  painter->setPen (m_pen);
+  painter->setBrush (Qt::NoBrush);
+
+  double marginPen = margin ();
+  QVector<GraphicsLinesForCurveChunk>::const_iterator itr;
+  for (itr = m_chunks.begin (); itr != m_chunks.end (); itr++) {
+
+    const GraphicsLinesForCurveChunk &chunk = *itr;
+
+    if (chunk.boundingRect.adjusted (-marginPen, -marginPen, marginPen, marginPen).intersects (option->exposedRect)) {
+      painter->drawPath (chunk.path);
+    }
+  }
+}
+
+void GraphicsLinesForCurve::rebuildPointIdToIndex ()
+{
+  m_pointIdToIndex.clear ();
+  m_pointIdToIndex.reserve (m_points.count ());
+
+  for (int index = 0; index < m_points.count (); index++) {
+    m_pointIdToIndex [m_points.at (index).pointId] = index;
+  }
+}
+
+void GraphicsLinesForCurve::resizeChunks (int intervalCount)
+{
+  if (intervalCount != m_intervalCount) {
+
+    // Last chunk that both counts have in common gains or loses intervals
+    markIntervalsStale (qMin (intervalCount, m_intervalCount) - 1,
+                        qMin (intervalCount, m_intervalCount) - 1);
+
+    int chunkCountOld = m_chunks.count ();
+    int chunkCountNew = (intervalCount + CHUNK_INTERVALS - 1) / CHUNK_INTERVALS;
+
+    // Lines of the chunks that are going away still need to be erased
+    double marginPen = margin ();
+    for (int chunk = chunkCountNew; chunk < chunkCountOld; chunk++) {
+      update (m_chunks.at (chunk).boundingRect.adjusted (-marginPen, -marginPen, marginPen, marginPen));
+    }
+
+    m_chunks.resize (chunkCountNew);
+    for (int chunk = chunkCountOld; chunk < chunkCountNew; chunk++) {
+      m_chunks [chunk].isStale = true;
+      m_chunks [chunk].strokeIsStale = true;
+    }
+
+    m_intervalCount = intervalCount;
+  }
 }
 
-void GraphicsLinesForCurve::savePoint (const QString &pointIdentifier,
+void GraphicsLinesForCurve::savePoint (PointId pointId,
                                        double ordinal,
                                        GraphicsPoint &graphicsPoint)
 {
   LOG4CPP_INFO_S ((*mainCat)) << "GraphicsLinesForCurve::savePoint"
                               << " curve=" << m_curveName.toLatin1().data()
-                              << " identifier=" << pointIdentifier.toLatin1().data()
+                              << " pointId=" << pointId
                               << " ordinal=" << ordinal
                               << " pos=" << QPointFToString (graphicsPoint.pos()).toLatin1().data()
-                              << " newPointCount=" << (m_graphicsPoints.count() + 1);
+                              << " pointCount=" << m_points.count();
+
+  QHash<PointId, int>::const_iterator itr = m_pointIdToIndex.find (pointId);
+  if (itr != m_pointIdToIndex.end ()) {
+
+    // Update existing entry in place
+    GraphicsLinesForCurvePoint &point = m_points [itr.value ()];
+    if (point.ordinal != ordinal) {
+      point.ordinal = ordinal;
+      m_pointsAreSorted = false;
+    }
+    point.posScreen = graphicsPoint.pos();
+    point.wanted = true;
+
+  } else {
 
-  // Replace existing entry if there is one, with a proxy Point for the one in the Document
-  Point point (pointIdentifier,
-               ordinal,
-               graphicsPoint.pos());
+    GraphicsLinesForCurvePoint point;
+    point.pointId = pointId;
+    point.ordinal = ordinal;
+    point.posScreen = graphicsPoint.pos();
+    point.xOrTheta = 0;
+    point.wanted = true;
+
+    // New points usually have the largest ordinal, so appending keeps the points sorted
+    if (!m_points.isEmpty () &&
+        lessThanByOrdinal (point, m_points.last ())) {
+      m_pointsAreSorted = false;
+    }
+
+    m_pointIdToIndex [pointId] = m_points.count ();
+    m_points.push_back (point);
+    m_linesMatchPoints = false;
+  }
+}
+
+QPainterPath GraphicsLinesForCurve::shape () const
+{
+  QPainterPath path;
+  for (int chunk = 0; chunk < m_chunks.count (); chunk++) {
+    path.addPath (chunkStroke (chunk));
+  }
 
-  m_graphicsPoints [pointIdentifier] = point;
+  return path;
+}
+
+void GraphicsLinesForCurve::sortPointsByOrdinal ()
+{
+  if (!m_pointsAreSorted) {
+
+    std::sort (m_points.begin (),
+               m_points.end (),
+               lessThanByOrdinal);
+    rebuildPointIdToIndex ();
+
+    m_pointsAreSorted = true;
+    m_linesMatchPoints = false;
+  }
+}
+
+bool GraphicsLinesForCurve::sortPointsByXOrTheta (int indexFirst,
+                                                  int indexLast)
+{
+  bool orderHasChanged = false;
+
+  for (int index = indexFirst + 1; index <= indexLast; index++) {
+
+    if (lessThanByXOrTheta (m_points.at (index),
+                            m_points.at (index - 1))) {
+
+      GraphicsLinesForCurvePoint point = m_points.at (index);
+      int indexTo = index;
+      while ((indexTo > indexFirst) &&
+             lessThanByXOrTheta (point,
+                                 m_points.at (indexTo - 1))) {
+        m_points [indexTo] = m_points.at (indexTo - 1);
+        --indexTo;
+      }
+      m_points [indexTo] = point;
+
+      orderHasChanged = true;
+    }
+  }
+
+  return orderHasChanged;
+}
+
+void GraphicsLinesForCurve::updateChunks ()
+{
+  QRectF rectChanged;
+  QRectF rectLines;
+
+  for (int chunk = 0; chunk < m_chunks.count (); chunk++) {
+
+    if (m_chunks.at (chunk).isStale) {
+
+      // Both the old and the new lines of the chunk need repainting
+      rectChanged |= m_chunks.at (chunk).boundingRect;
+      drawChunk (chunk);
+      rectChanged |= m_chunks.at (chunk).boundingRect;
+    }
+
+    rectLines |= m_chunks.at (chunk).boundingRect;
+  }
+
+  if (rectLines != m_rectLines) {
+    prepareGeometryChange ();
+    m_rectLines = rectLines;
+  }
+
+  if (!rectChanged.isNull ()) {
+    double marginPen = margin ();
+    update (rectChanged.adjusted (-marginPen, -marginPen, marginPen, marginPen));
+  }
+}
+
+bool GraphicsLinesForCurve::updateSplineForMovedPoints ()
+{
+  if ((m_spline.count () != (unsigned int) m_points.count ()) ||
+      (m_pointIdsMovedSinceDraw.count () > MAX_LOCAL_SPLINE_CHANGES)) {
+    return false;
+  }
+
+  // Each move updates the spline in a window around the point, and only the chunks holding that window are drawn again
+  QSet<PointId>::const_iterator itr;
+  for (itr = m_pointIdsMovedSinceDraw.begin (); itr != m_pointIdsMovedSinceDraw.end (); itr++) {
+
+    int i = m_pointIdToIndex.value (*itr);
+    const QPointF &posScreen = m_points.at (i).posScreen;
+
+    SplinePair xyOld = m_spline.xy (i);
+    if ((xyOld.x() != posScreen.x()) ||
+        (xyOld.y() != posScreen.y())) {
+
+      unsigned int iIntervalFirst, iIntervalLast;
+      m_spline.movePoint (i,
+                          SplinePair (posScreen.x(),
+                                      posScreen.y()),
+                          iIntervalFirst,
+                          iIntervalLast);
+
+      markIntervalsStale (iIntervalFirst,
+                          iIntervalLast);
+    }
+  }
+
+  return true;
+}
+
+bool GraphicsLinesForCurve::updateSplineLocally (const QVector<PointId> &pointIds,
+                                                 const std::vector<SplinePair> &xy)
+{
+  unsigned int countOld = m_splinePointIds.count ();
+  unsigned int countNew = pointIds.count ();
+  if ((countOld < 3) ||
+      (m_spline.count () != countOld) ||
+      (m_intervalCount != (int) countOld - 1)) {
+    return false;
+  }
+
+  // Find the single point that was inserted or removed, if any, by matching the ids at the start and the end
+  unsigned int iFirstDifference = 0;
+  unsigned int countMin = qMin (countOld, countNew);
+  while ((iFirstDifference < countMin) &&
+         (m_splinePointIds [iFirstDifference] == pointIds [iFirstDifference])) {
+    ++iFirstDifference;
+  }
+
+  bool isInsert = (countNew == countOld + 1);
+  bool isRemove = (countNew + 1 == countOld);
+  if (countNew != countOld) {
+    if (!isInsert && !isRemove) {
+      return false;
+    }
+
+    // Every id after the inserted or removed one must match
+    int shift = (isInsert ? 1 : -1);
+    for (unsigned int i = iFirstDifference + (isRemove ? 1 : 0); i < countOld; i++) {
+      int iNew = i + shift;
+      if ((iNew >= 0) &&
+          (iNew < (int) countNew) &&
+          (m_splinePointIds [i] != pointIds [iNew])) {
+        return false;
+      }
+    }
+
+    if (isRemove && (countNew < 3)) {
+      return false;
+    }
+
+  } else if (iFirstDifference != countOld) {
+
+    // Same count but different ids, such as from a reordering
+    return false;
+  }
+
+  // Changes that require a full rebuild have been handled, so the spline can be updated now
+  unsigned int iIntervalFirst, iIntervalLast;
+  int changes = 0;
+  if (isInsert) {
+
+    m_spline.insertPoint (iFirstDifference,
+                          xy [iFirstDifference],
+                          iIntervalFirst,
+                          iIntervalLast);
+    m_splinePointIds.insert (iFirstDifference,
+                             pointIds [iFirstDifference]);
+    ++changes;
+
+  } else if (isRemove) {
+
+    m_spline.removePoint (iFirstDifference,
+                          iIntervalFirst,
+                          iIntervalLast);
+    m_splinePointIds.remove (iFirstDifference);
+    ++changes;
+  }
+
+  if (isInsert || isRemove) {
+
+    // Intervals after the inserted or removed point have shifted, so the chunks holding them are drawn again. This
+    // is usually just the last chunk, since new points are usually appended
+    resizeChunks (countNew - 1);
+    markIntervalsStale (iIntervalFirst,
+                        m_intervalCount - 1);
+  }
+
+  // Moved points. Each move updates the spline in a window around the point, and only the chunks holding that
+  // window are drawn again
+  for (unsigned int i = 0; i < countNew; i++) {
+
+    SplinePair xyOld = m_spline.xy (i);
+    if ((xyOld.x() != xy [i].x()) ||
+        (xyOld.y() != xy [i].y())) {
+
+      if (++changes > MAX_LOCAL_SPLINE_CHANGES) {
+        return false;
+      }
+
+      m_spline.movePoint (i,
+                          xy [i],
+                          iIntervalFirst,
+                          iIntervalLast);
+
+      markIntervalsStale (iIntervalFirst,
+                          iIntervalLast);
+    }
+  }
+
+  return true;
 }
 
 void GraphicsLinesForCurve::updateFinish (const LineStyle &lineStyle)
 {
   LOG4CPP_INFO_S ((*mainCat)) << "GraphicsLinesForCurve::updateFinish";
 
+  // Remove the points that savePoint did not mark as wanted since updateStart, keeping the others in order
+  int indexTo = 0;
+  for (int indexFrom = 0; indexFrom < m_points.count (); indexFrom++) {
+    if (m_points.at (indexFrom).wanted) {
+      if (indexTo != indexFrom) {
+        m_points [indexTo] = m_points.at (indexFrom);
+      }
+      ++indexTo;
+    }
+  }
+
+  if (indexTo != m_points.count ()) {
+    m_points.resize (indexTo);
+    rebuildPointIdToIndex ();
+    m_linesMatchPoints = false;
+  }
+
   // Apply line style
   QPen pen = QPen (QBrush (ColorPaletteToQColor (lineStyle.paletteColor())),
                    lineStyle.width());
-  setPen (pen);
+  if (pen != m_pen) {
+
+    // Pen width is part of the bounding rectangle and the strokes
+    prepareGeometryChange ();
+    if (pen.widthF () != m_pen.widthF ()) {
+      for (int chunk = 0; chunk < m_chunks.count (); chunk++) {
+        m_chunks [chunk].strokeIsStale = true;
+      }
+    }
+    m_pen = pen;
+    update ();
+  }
 
   updateGraphicsLinesToMatchGraphicsPoints (lineStyle);
 }
 
 void GraphicsLinesForCurve::updateGraphicsLinesToMatchGraphicsPoints (const LineStyle &lineStyle)
 {
-  OrdinalToPointIdentifier ordinalToPointIdentifier;
-
-  // Order by ordinals locally
-  PointIdentifierToPoint::const_iterator itr;
-  for (itr = m_graphicsPoints.begin(); itr != m_graphicsPoints.end(); itr++) {
-
-    const Point &point = *itr;
-    ordinalToPointIdentifier [point.ordinal ()] = point.identifier ();
-
-  }
+  sortPointsByOrdinal ();
 
   // Draw as either straight or smoothed. The function/relation differences were handled already with ordinals. The
   // Spline algorithm will crash with fewer than three points so it is only called when there are enough points
-  QPainterPath path;
   if (lineStyle.curveConnectAs() == CONNECT_AS_FUNCTION_STRAIGHT ||
       lineStyle.curveConnectAs() == CONNECT_AS_RELATION_STRAIGHT ||
-      m_graphicsPoints.count () < 3) {
+      m_points.count () < 3) {
+
+    drawLinesStraight ();
+
+    m_spline.clear ();
+    m_splinePointIds.clear ();
 
-    path = drawLinesStraight (ordinalToPointIdentifier);
   } else {
-    path = drawLinesSmooth (ordinalToPointIdentifier);
+    drawLinesSmooth ();
   }
 
-  setPath (path);
+  updateChunks ();
 }
 
 void GraphicsLinesForCurve::updatePointOrdinalsAfterDrag (const LineStyle &lineStyle,
@@ -176,38 +668,149 @@ void GraphicsLinesForCurve::updatePointOrdinalsAfterDrag (const LineStyle &lineS
   if (lineStyle.curveConnectAs() == CONNECT_AS_FUNCTION_SMOOTH ||
       lineStyle.curveConnectAs() == CONNECT_AS_FUNCTION_STRAIGHT) {
 
-    // Make sure ordinals are properly ordered
+    bool transformationHasChanged = (m_transformationXOrTheta != transformation);
 
-    // Get a map of x/theta values as keys with point identifiers as the values
-    XOrThetaToPointIdentifier xOrThetaToPointIdentifier;
-    PointIdentifierToPoint::iterator itrP;
-    for (itrP = m_graphicsPoints.begin(); itrP != m_graphicsPoints.end(); itrP++) {
+    if (m_xOrThetaAreCurrent &&
+        !transformationHasChanged) {
 
-       QString pointIdentifier = itrP.key();
-       const Point &pointScreen = itrP.value();
+      updateXOrThetaOfMovedPoints (transformation);
+
+    } else {
 
-       // Convert screen coordinate to graph coordinates, which gives us x/theta
-       QPointF pointGraph;
-       transformation.transformScreenToRawGraph(pointScreen.posScreen(),
-                                                pointGraph);
+      updateXOrThetaOfAllPoints (transformation);
 
-       xOrThetaToPointIdentifier [pointGraph.x()] = pointIdentifier;
+      m_transformationXOrTheta = transformation;
+      m_xOrThetaAreCurrent = true;
     }
 
-    // Loop through the sorted x/theta values. Since QMap is used, the x/theta keys are sorted
-    int ordinal = 0;
-    XOrThetaToPointIdentifier::const_iterator itrX;
-    for (itrX = xOrThetaToPointIdentifier.begin(); itrX != xOrThetaToPointIdentifier.end(); itrX++) {
+    m_pointsAreSorted = true;
+  }
 
-      QString pointIdentifier = itrX.value();
-      Point &point = m_graphicsPoints [pointIdentifier];
+  m_pointIdsXOrThetaStale.clear ();
+}
 
-      point.setOrdinal (ordinal++); // Override the old ordinal
-    }
+void GraphicsLinesForCurve::updateStart ()
+{
+  // Points are kept so savePoint can update them in place. The ones that are not saved again are removed by updateFinish
+  QVector<GraphicsLinesForCurvePoint>::iterator itr;
+  for (itr = m_points.begin(); itr != m_points.end(); itr++) {
+    (*itr).wanted = false;
   }
+
+  m_xOrThetaAreCurrent = false;
+  m_linesMatchPoints = false;
 }
 
-void GraphicsLinesForCurve::updateStart ()
+void GraphicsLinesForCurve::updateXOrThetaOfAllPoints (const Transformation &transformation)
+{
+  // Convert screen coordinates to graph coordinates, which gives us x/theta
+  QVector<GraphicsLinesForCurvePoint>::iterator itr;
+  for (itr = m_points.begin(); itr != m_points.end(); itr++) {
+
+    GraphicsLinesForCurvePoint &point = *itr;
+
+    QPointF posGraph;
+    transformation.transformScreenToRawGraph (point.posScreen,
+                                              posGraph);
+    point.xOrTheta = posGraph.x();
+  }
+
+  if (sortPointsByXOrTheta (0,
+                            m_points.count () - 1)) {
+    rebuildPointIdToIndex ();
+    m_linesMatchPoints = false;
+  }
+
+  // Override the old ordinals
+  for (int index = 0; index < m_points.count (); index++) {
+    m_points [index].ordinal = index;
+  }
+}
+
+void GraphicsLinesForCurve::updateXOrThetaOfMovedPoints (const Transformation &transformation)
 {
-  m_graphicsPoints.clear();
+  // Range of indexes that the moved points left or arrived at
+  int indexFirst = m_points.count ();
+  int indexLast = -1;
+
+  // All moved points get their new x/theta values before any of them changes places, so each comparison below uses
+  // current values
+  QSet<PointId>::const_iterator itr;
+  for (itr = m_pointIdsXOrThetaStale.begin (); itr != m_pointIdsXOrThetaStale.end (); itr++) {
+
+    QHash<PointId, int>::const_iterator itrIndex = m_pointIdToIndex.find (*itr);
+    ENGAUGE_ASSERT (itrIndex != m_pointIdToIndex.end ());
+
+    GraphicsLinesForCurvePoint &point = m_points [itrIndex.value ()];
+
+    QPointF posGraph;
+    transformation.transformScreenToRawGraph (point.posScreen,
+                                              posGraph);
+    point.xOrTheta = posGraph.x();
+  }
+
+  // Shift each moved point past its neighbors until it is in order with them, as in CurveOrdinalIndex::move. A dragged
+  // point rarely passes more than a few of its neighbors
+  for (itr = m_pointIdsXOrThetaStale.begin (); itr != m_pointIdsXOrThetaStale.end (); itr++) {
+
+    int index = m_pointIdToIndex.value (*itr);
+    GraphicsLinesForCurvePoint point = m_points.at (index);
+
+    int indexTo = index;
+    while ((indexTo + 1 < m_points.count ()) &&
+           lessThanByXOrTheta (m_points.at (indexTo + 1),
+                               point)) {
+      m_points [indexTo] = m_points.at (indexTo + 1);
+      m_pointIdToIndex [m_points.at (indexTo).pointId] = indexTo;
+      ++indexTo;
+    }
+    while ((indexTo > 0) &&
+           lessThanByXOrTheta (point,
+                               m_points.at (indexTo - 1))) {
+      m_points [indexTo] = m_points.at (indexTo - 1);
+      m_pointIdToIndex [m_points.at (indexTo).pointId] = indexTo;
+      --indexTo;
+    }
+    m_points [indexTo] = point;
+    m_pointIdToIndex [point.pointId] = indexTo;
+
+    if (indexTo != index) {
+      m_linesMatchPoints = false;
+    }
+
+    indexFirst = qMin (indexFirst, qMin (index, indexTo));
+    indexLast = qMax (indexLast, qMax (index, indexTo));
+  }
+
+  if (indexFirst <= indexLast) {
+
+    // Moved points can block each other while shifting, so the range they moved through is sorted. The points
+    // outside of the range were not touched, so if the range fits between them then every point is in order.
+    // Otherwise, which takes several moved points passing each other, all the points are sorted
+    if (sortPointsByXOrTheta (indexFirst,
+                              indexLast)) {
+      m_linesMatchPoints = false;
+    }
+
+    if (((indexFirst > 0) &&
+         lessThanByXOrTheta (m_points.at (indexFirst),
+                             m_points.at (indexFirst - 1))) ||
+        ((indexLast + 1 < m_points.count ()) &&
+         lessThanByXOrTheta (m_points.at (indexLast + 1),
+                             m_points.at (indexLast)))) {
+
+      indexFirst = 0;
+      indexLast = m_points.count () - 1;
+      sortPointsByXOrTheta (indexFirst,
+                            indexLast);
+
+      m_linesMatchPoints = false;
+    }
+
+    // Only the points that changed places get new ordinals
+    for (int index = indexFirst; index <= indexLast; index++) {
+      m_points [index].ordinal = index;
+      m_pointIdToIndex [m_points.at (index).pointId] = index;
+    }
+  }
 }
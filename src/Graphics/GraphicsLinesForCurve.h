@@ -1,58 +1,195 @@
 #ifndef GRAPHICS_LINES_FOR_CURVE_H
 #define GRAPHICS_LINES_FOR_CURVE_H
 
-#include "PointIdentifierToPoint.h"
-#include "Point.h"
-#include <QGraphicsPathItem>
-#include <QMap>
+#include "PointIdTable.h"
+#include <QGraphicsItem>
+#include <QHash>
+#include <QPainterPath>
+#include <QPen>
+#include <QPointF>
+#include <QRectF>
+#include <QSet>
+#include <QVector>
+#include "SplineIncremental.h"
+#include "Transformation.h"
+#include <vector>
 
 class GraphicsPoint;
 class GraphicsScene;
 class LineStyle;
-class Transformation;
 
-/// Order-preserving map from ordinal to pointIdentifier of Point
-typedef QMap<double, QString> OrdinalToPointIdentifier;
+/// Handle for one point in GraphicsLinesForCurve, with just what is needed for drawing lines
+struct GraphicsLinesForCurvePoint
+{
+  PointId pointId; ///< Point this handle refers to, and tie breaker for points with the same ordinal
+  double ordinal; ///< Drawing order
+  QPointF posScreen; ///< Position, which follows the GraphicsPoint while it is being dragged
+  double xOrTheta; ///< Graph x/theta value, cached by updatePointOrdinalsAfterDrag until the point is moved
+  bool wanted; ///< Cleared by updateStart and set by savePoint, so updateFinish can remove the stale points
+};
+
+/// Fixed size piece of the lines of one curve, with its own cached path
+struct GraphicsLinesForCurveChunk
+{
+  QPainterPath path; ///< Lines through the intervals of this chunk
+  QRectF boundingRect; ///< Control point rectangle of path, without the pen width
+  bool isStale; ///< Set when an interval of this chunk has changed, so the path gets drawn again
+  mutable QPainterPath stroke; ///< Outline of path at the pen width for hit testing, made when first needed
+  mutable bool strokeIsStale; ///< Set when path or the pen width has changed, so stroke gets made again
+};
 
-/// This class stores the GraphicsLine objects for one Curve. The container is a QMap since that container
-/// maintains order by key
-class GraphicsLinesForCurve : public QGraphicsPathItem
+/// This class stores the GraphicsLine objects for one Curve. The points are kept in a persistent vector that is
+/// sorted by ordinal, so drawing just iterates through the vector. Updates change the vector in place, and sorting is
+/// only needed when ordinals change.
+///
+/// The lines are split into chunks with a fixed number of intervals, each with its own cached path and bounding
+/// rectangle. Updates only draw the chunks with changed intervals again, and painting skips the chunks outside of the
+/// exposed rectangle
+class GraphicsLinesForCurve : public QGraphicsItem
 {
 public:
   /// Single constructor
   GraphicsLinesForCurve(const QString &curveName);
 
+  /// Union of the chunk rectangles, plus room for the pen
+  virtual QRectF boundingRect () const;
+
+  /// Hit test of the stroked lines. Only the chunks whose rectangles overlap the path are tested
+  virtual bool collidesWithPath (const QPainterPath &path,
+                                 Qt::ItemSelectionMode mode = Qt::IntersectsItemShape) const;
+
+  /// Hit test of the stroked lines. Only the chunks whose rectangles contain the point are tested
+  virtual bool contains (const QPointF &point) const;
+
   /// Move position of one point, so lines can be moved correspondingly
-  void moveLinesWithDraggedPoint (const QString &pointIdentifier,
+  void moveLinesWithDraggedPoint (PointId pointId,
                                   const QPointF &scenePos);
 
+  /// Paint the chunks that intersect the exposed rectangle
+  virtual void paint (QPainter *painter,
+                      const QStyleOptionGraphicsItem *option,
+                      QWidget *widget);
+
   /// Add new line.
   ///
   /// The GraphicsPoint arguments are not const since this line binds to the points, so dragging points also drags the lines
-  void savePoint (const QString &pointIdentifier,
+  void savePoint (PointId pointId,
                   double ordinal,
                   GraphicsPoint &point);
 
+  /// Stroked lines, so only the lines themselves are hit by the mouse. This combines the cached stroke of every chunk
+  virtual QPainterPath shape () const;
+
   /// Mark the end of savePoint calls. Remove stale lines, insert missing lines, and draw the graphics lines
   void updateFinish (const LineStyle &lineStyle);
 
   /// Calls to moveLinesWithDraggedPoint have finished so update the lines correspondingly
   void updateGraphicsLinesToMatchGraphicsPoints (const LineStyle &lineStyle);
 
-  /// See GraphicsScene::updateOrdinalsAfterDrag. Pretty much the same steps as Curve::updatePointOrdinals
+  /// See GraphicsScene::updateOrdinalsAfterDrag. Pretty much the same steps as Curve::updatePointOrdinals. The x/theta
+  /// values are cached, so during a drag only the points that were moved since the previous call are transformed and
+  /// put back in order
   void updatePointOrdinalsAfterDrag (const LineStyle &lineStyle,
                                      const Transformation &transformation);
 
-  /// Mark the start of savePoint calls. Afterwards, updateFinish gets called
+  /// Mark the start of savePoint calls. Afterwards, updateFinish gets called. The cached x/theta values are dropped,
+  /// since the command may have changed the coordinates or the points
   void updateStart ();
 
 private:
 
-  QPainterPath drawLinesSmooth (const OrdinalToPointIdentifier &ordinalToPointIdentifier);
-  QPainterPath drawLinesStraight (const OrdinalToPointIdentifier &ordinalToPointIdentifier);
+  // Outline of the lines of one chunk at the pen width, which is made again only after the chunk or the pen changes
+  const QPainterPath &chunkStroke (int chunk) const;
+
+  // Draw the path of one chunk, from the persistent spline if there is one and from the straight line positions otherwise
+  void drawChunk (int chunk);
+
+  // Mark the chunks with changed intervals as stale. While m_linesMatchPoints is true, only the points in
+  // m_pointIdsMovedSinceDraw are compared
+  void drawLinesSmooth ();
+  void drawLinesStraight ();
+
+  // Room around the lines for the pen
+  double margin () const;
+
+  // Mark the chunks holding intervals iIntervalFirst through iIntervalLast inclusive as stale
+  void markIntervalsStale (int iIntervalFirst,
+                           int iIntervalLast);
+
+  // Rebuild the point id to index lookup after the points have been reordered or removed
+  void rebuildPointIdToIndex ();
+
+  // Change the number of intervals. The chunk whose last interval moves is marked as stale, as are any new chunks
+  void resizeChunks (int intervalCount);
+
+  // Sort the points by ordinal, if they are not sorted already
+  void sortPointsByOrdinal ();
+
+  // Insertion sort of the points from indexFirst through indexLast inclusive by x/theta. The points are nearly sorted
+  // already, so this takes linear time plus a little for each point that changes places. Returns true if any point
+  // changed places
+  bool sortPointsByXOrTheta (int indexFirst,
+                             int indexLast);
+
+  // Draw the stale chunks again, and update the bounding rectangle and the affected area of the scene
+  void updateChunks ();
+
+  // Move the points in m_pointIdsMovedSinceDraw in the persistent spline, which already holds every point in the
+  // current order, and mark the chunks with changed intervals as stale. Returns false if there are too many moved
+  // points for local updates, in which case nothing was changed
+  bool updateSplineForMovedPoints ();
+
+  // Apply the differences between the persistent spline and the new points to the persistent spline, and mark the
+  // chunks with changed intervals as stale. Returns false if the differences are too large for local updates, in
+  // which case the caller falls back to a full rebuild
+  bool updateSplineLocally (const QVector<PointId> &pointIds,
+                            const std::vector<SplinePair> &xy);
+
+  // Recompute the x/theta values of every point, sort by them and renumber every ordinal
+  void updateXOrThetaOfAllPoints (const Transformation &transformation);
+
+  // Recompute the x/theta values of just the points in m_pointIdsXOrThetaStale, put them back in order and renumber
+  // the ordinals of the points that changed places
+  void updateXOrThetaOfMovedPoints (const Transformation &transformation);
 
   const QString m_curveName;
-  PointIdentifierToPoint m_graphicsPoints;
+
+  // Points sorted by ordinal, except when m_pointsAreSorted is false. The lookup gives the index of each point
+  QVector<GraphicsLinesForCurvePoint> m_points;
+  QHash<PointId, int> m_pointIdToIndex;
+  bool m_pointsAreSorted;
+
+  // While true, the points are sorted by x/theta with each ordinal equal to its index, and the x/theta values were
+  // computed with m_transformationXOrTheta, except for the points in m_pointIdsXOrThetaStale which moved afterwards
+  bool m_xOrThetaAreCurrent;
+  Transformation m_transformationXOrTheta;
+  QSet<PointId> m_pointIdsXOrThetaStale;
+
+  // Spline that persists between updates, so a point drag only solves the spline around the dragged point. The
+  // point ids are in the same order as the spline points
+  SplineIncremental m_spline;
+  QVector<PointId> m_splinePointIds;
+
+  // Spline inputs for updates that compare every point. They are kept so they are not allocated for each update
+  QVector<PointId> m_pointIdsForSpline;
+  std::vector<SplinePair> m_xyForSpline;
+
+  // True while the spline, or the straight line positions, hold every point in the current order. Then only the
+  // points moved since the last draw, which during a drag are just the dragged points, have to be updated. Cleared by
+  // updateStart and whenever points change places
+  bool m_linesMatchPoints;
+  QSet<PointId> m_pointIdsMovedSinceDraw;
+
+  // Positions the straight lines were drawn from, so the next update can find the changed intervals. Empty when the
+  // lines are smooth
+  QVector<QPointF> m_positionsStraight;
+
+  // Chunk i holds intervals i*CHUNK_INTERVALS through (i+1)*CHUNK_INTERVALS-1, where interval j joins points j and j+1
+  QVector<GraphicsLinesForCurveChunk> m_chunks;
+  int m_intervalCount;
+  QRectF m_rectLines;
+
+  QPen m_pen;
 };
 
 #endif // GRAPHICS_LINES_FOR_CURVE_H
@@ -15,29 +15,28 @@ GraphicsLinesForCurves::GraphicsLinesForCurves()
 {
 }
 
-void GraphicsLinesForCurves::moveLinesWithDraggedPoint (const QString &pointIdentifier,
+void GraphicsLinesForCurves::moveLinesWithDraggedPoint (const QString &curveName,
+                                                        PointId pointId,
                                                         const QPointF &scenePos)
 {
-  QString curveName = Point::curveNameFromPointIdentifier (pointIdentifier);
-
   if (curveName != AXIS_CURVE_NAME) {
 
     ENGAUGE_ASSERT (m_graphicsLinesForCurve.contains (curveName));
 
-    m_graphicsLinesForCurve [curveName]->moveLinesWithDraggedPoint (pointIdentifier,
+    m_graphicsLinesForCurve [curveName]->moveLinesWithDraggedPoint (pointId,
                                                                     scenePos);
   }
 }
 
 void GraphicsLinesForCurves::savePoint (GraphicsScene &scene,
                                         const QString &curveName,
-                                        const QString &pointIdentifier,
+                                        PointId pointId,
                                         double ordinal,
                                         GraphicsPoint &point)
 {
   LOG4CPP_INFO_S ((*mainCat)) << "GraphicsLinesForCurves::savePoint"
                               << " curve=" << curveName.toLatin1().data()
-                              << " identifier=" << pointIdentifier.toLatin1().data()
+                              << " pointId=" << pointId
                               << " pos=" << QPointFToString (point.pos()).toLatin1().data();
 
   // No lines are drawn for the axis points, other than the axes checker box
@@ -51,7 +50,7 @@ void GraphicsLinesForCurves::savePoint (GraphicsScene &scene,
       m_graphicsLinesForCurve [curveName] = item;
     }
 
-    m_graphicsLinesForCurve [curveName]->savePoint (pointIdentifier,
+    m_graphicsLinesForCurve [curveName]->savePoint (pointId,
                                                     ordinal,
                                                     point);
   }
@@ -71,31 +70,52 @@ void GraphicsLinesForCurves::updateFinish (const CurveStyles &curveStyles)
   }
 }
 
-void GraphicsLinesForCurves::updateGraphicsLinesToMatchGraphicsPoints (const CurveStyles &curveStyles)
+void GraphicsLinesForCurves::updateFinishForCurve (const QString &curveName,
+                                                   const CurveStyles &curveStyles)
+{
+  LOG4CPP_INFO_S ((*mainCat)) << "GraphicsLinesForCurves::updateFinishForCurve curve=" << curveName.toLatin1().data();
+
+  GraphicsLinesContainer::const_iterator itr = m_graphicsLinesForCurve.find (curveName);
+  if (itr != m_graphicsLinesForCurve.end ()) {
+
+    itr.value()->updateFinish (curveStyles.lineStyle (curveName));
+  }
+}
+
+void GraphicsLinesForCurves::updateGraphicsLinesToMatchGraphicsPoints (const QSet<QString> &curveNames,
+                                                                       const CurveStyles &curveStyles)
 {
   LOG4CPP_INFO_S ((*mainCat)) << "GraphicsLinesForCurves::updateGraphicsLinesToMatchGraphicsPoints";
 
-  GraphicsLinesContainer::const_iterator itr;
-  for (itr = m_graphicsLinesForCurve.begin (); itr != m_graphicsLinesForCurve.end (); itr++) {
+  // Curves without lines, like the axes curve, are skipped
+  QSet<QString>::const_iterator itr;
+  for (itr = curveNames.begin (); itr != curveNames.end (); itr++) {
 
-    QString curveName = itr.key();
-    m_graphicsLinesForCurve [curveName]->updateGraphicsLinesToMatchGraphicsPoints(curveStyles.lineStyle (curveName));
+    const QString &curveName = *itr;
+    GraphicsLinesContainer::const_iterator itrL = m_graphicsLinesForCurve.find (curveName);
+    if (itrL != m_graphicsLinesForCurve.end ()) {
+
+      itrL.value()->updateGraphicsLinesToMatchGraphicsPoints (curveStyles.lineStyle (curveName));
+    }
   }
 }
 
-void GraphicsLinesForCurves::updatePointOrdinalsAfterDrag (const CurveStyles &curveStyles,
+void GraphicsLinesForCurves::updatePointOrdinalsAfterDrag (const QSet<QString> &curveNames,
+                                                           const CurveStyles &curveStyles,
                                                            const Transformation &transformation)
 {
   LOG4CPP_INFO_S ((*mainCat)) << "GraphicsLinesForCurves::updatePointOrdinalsAfterDrag";
 
-  GraphicsLinesContainer::const_iterator itr;
-  for (itr = m_graphicsLinesForCurve.begin (); itr != m_graphicsLinesForCurve.end (); itr++) {
+  QSet<QString>::const_iterator itr;
+  for (itr = curveNames.begin (); itr != curveNames.end (); itr++) {
 
-    QString curveName = itr.key();
-    GraphicsLinesForCurve *graphicsLines = itr.value();
+    const QString &curveName = *itr;
+    GraphicsLinesContainer::const_iterator itrL = m_graphicsLinesForCurve.find (curveName);
+    if (itrL != m_graphicsLinesForCurve.end ()) {
 
-    graphicsLines->updatePointOrdinalsAfterDrag (curveStyles.lineStyle (curveName),
-                                                 transformation);
+      itrL.value()->updatePointOrdinalsAfterDrag (curveStyles.lineStyle (curveName),
+                                                  transformation);
+    }
   }
 }
 
@@ -111,3 +131,15 @@ void GraphicsLinesForCurves::updateStart ()
     graphicsLines->updateStart ();
   }
 }
+
+void GraphicsLinesForCurves::updateStartForCurve (const QString &curveName)
+{
+  LOG4CPP_INFO_S ((*mainCat)) << "GraphicsLinesForCurves::updateStartForCurve curve=" << curveName.toLatin1().data();
+
+  // Lines for a curve without any points yet are created by savePoint
+  GraphicsLinesContainer::const_iterator itr = m_graphicsLinesForCurve.find (curveName);
+  if (itr != m_graphicsLinesForCurve.end ()) {
+
+    itr.value()->updateStart ();
+  }
+}
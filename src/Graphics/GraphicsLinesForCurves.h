@@ -1,7 +1,9 @@
 #ifndef GRAPHICS_LINES_FOR_CURVES_H
 #define GRAPHICS_LINES_FOR_CURVES_H
 
+#include "PointIdTable.h"
 #include <QHash>
+#include <QSet>
 
 class CurveStyles;
 class GraphicsLinesForCurve;
@@ -21,29 +23,41 @@ public:
   GraphicsLinesForCurves();
 
   /// Move position of one point, so lines can be moved correspondingly
-  void moveLinesWithDraggedPoint (const QString &pointIdentifier,
+  void moveLinesWithDraggedPoint (const QString &curveName,
+                                  PointId pointId,
                                   const QPointF &scenePos);
 
   /// Add new point
   void savePoint (GraphicsScene &scene,
                   const QString &curveName,
-                  const QString &pointIdentifier,
+                  PointId pointId,
                   double ordinal,
                   GraphicsPoint &point);
 
   /// Mark the end of savePoint calls. Remove stale lines, insert missing lines, and draw the graphics lines
   void updateFinish (const CurveStyles &curveStyles);
 
-  /// Calls to moveLinesWithDraggedPoint have finished so update the lines correspondingly
-  void updateGraphicsLinesToMatchGraphicsPoints (const CurveStyles &curveStyles);
+  /// Same as updateFinish, but for the one curve that was passed to updateStartForCurve
+  void updateFinishForCurve (const QString &curveName,
+                             const CurveStyles &curveStyles);
 
-  /// See GraphicsScene::updateOrdinalsAfterDrag
-  void updatePointOrdinalsAfterDrag (const CurveStyles &curveStyles,
+  /// Calls to moveLinesWithDraggedPoint have finished so update the lines correspondingly. Only the specified curves
+  /// are updated, since the other curves have not changed
+  void updateGraphicsLinesToMatchGraphicsPoints (const QSet<QString> &curveNames,
+                                                 const CurveStyles &curveStyles);
+
+  /// See GraphicsScene::updateOrdinalsAfterDrag. Only the specified curves are updated
+  void updatePointOrdinalsAfterDrag (const QSet<QString> &curveNames,
+                                     const CurveStyles &curveStyles,
                                      const Transformation &transformation);
 
   /// Mark the start of savePoint calls. Afterwards, updateFinish gets called
   void updateStart ();
 
+  /// Same as updateStart, but only the lines of the specified curve are affected. Afterwards, savePoint gets called
+  /// for every point in that curve and then updateFinishForCurve gets called
+  void updateStartForCurve (const QString &curveName);
+
 private:
 
   GraphicsLinesContainer m_graphicsLinesForCurve;
@@ -1,158 +1,113 @@
 #include "CurveStyle.h"
 #include "DataKey.h"
-#include "EnumsToQt.h"
 #include "GraphicsItemType.h"
 #include "GraphicsPoint.h"
-#include "GraphicsPointEllipse.h"
-#include "GraphicsPointPolygon.h"
+#include "GraphicsPointGeometry.h"
+#include "GraphicsPointItem.h"
+#include "GraphicsPointsForCurve.h"
 #include "Logger.h"
 #include "PointStyle.h"
-#include <QGraphicsEllipseItem>
-#include <QGraphicsPolygonItem>
 #include <QGraphicsScene>
-#include <QGraphicsSceneContextMenuEvent>
-#include <QPen>
-#include "QtToString.h"
-
-const double ZERO_WIDTH = 0.0;
 
 GraphicsPoint::GraphicsPoint(QGraphicsScene &scene,
+                             PointId pointId,
                              const QString &identifier,
                              const QPointF &posScreen,
-                             const QColor &color,
-                             unsigned int radius,
-                             double lineWidth,
+                             const PointStyle &pointStyle,
                              double ordinal) :
   GraphicsPointAbstractBase (),
-  m_graphicsItemEllipse (0),
-  m_shadowZeroWidthEllipse (0),
-  m_graphicsItemPolygon (0),
-  m_shadowZeroWidthPolygon (0),
+  m_graphicsItem (0),
+  m_graphicsPointsForCurve (0),
+  m_ordinal (ordinal),
+  m_pointId (pointId),
   m_wanted (true)
 {
   LOG4CPP_INFO_S ((*mainCat)) << "GraphicsPoint::GraphicsPoint identifier=" << identifier.toLatin1 ().data ();
 
-  m_graphicsItemEllipse = new GraphicsPointEllipse (*this,
-                                                    QRect (- radius,
-                                                           - radius,
-                                                           2 * radius + 1,
-                                                           2 * radius + 1));
-  scene.addItem (m_graphicsItemEllipse);
-
-  m_graphicsItemEllipse->setData (DATA_KEY_IDENTIFIER, identifier);
-  m_graphicsItemEllipse->setData (DATA_KEY_GRAPHICS_ITEM_TYPE, GRAPHICS_ITEM_TYPE_POINT);
-  m_graphicsItemEllipse->setData (DATA_KEY_ORDINAL, ordinal);
-  m_graphicsItemEllipse->setPos (posScreen.x (),
-                                 posScreen.y ());
-  m_graphicsItemEllipse->setPen (QPen (QBrush (color), lineWidth));
-  m_graphicsItemEllipse->setEnabled (true);
-  m_graphicsItemEllipse->setFlags (QGraphicsItem::ItemIsSelectable |
-                                   QGraphicsItem::ItemIsMovable |
-                                   QGraphicsItem::ItemSendsGeometryChanges);
-
-  m_graphicsItemEllipse->setToolTip (identifier);
-  m_graphicsItemEllipse->setData (DATA_KEY_GRAPHICS_ITEM_TYPE, GRAPHICS_ITEM_TYPE_POINT);
-
-  // Shadow item is not selectable so it needs no stored data. Do NOT
-  // call QGraphicsScene::addItem since the QGraphicsItem::setParentItem call adds the item
-  m_shadowZeroWidthEllipse = new GraphicsPointEllipse (*this,
-                                                       QRect (- radius,
-                                                              - radius,
-                                                              2 * radius + 1,
-                                                              2 * radius + 1));
-  m_shadowZeroWidthEllipse->setParentItem(m_graphicsItemPolygon); // Dragging parent also drags child
-
-  m_shadowZeroWidthEllipse->setPen (QPen (QBrush (color), ZERO_WIDTH));
-  m_shadowZeroWidthEllipse->setEnabled (true);
+  m_graphicsItem = new GraphicsPointItem (*this,
+                                          GraphicsPointGeometry::geometry (pointStyle));
+  scene.addItem (m_graphicsItem);
+
+  m_graphicsItem->setData (DATA_KEY_IDENTIFIER, identifier);
+  m_graphicsItem->setData (DATA_KEY_POINT_ID, QVariant ((qulonglong) pointId));
+  m_graphicsItem->setData (DATA_KEY_GRAPHICS_ITEM_TYPE, GRAPHICS_ITEM_TYPE_POINT);
+  m_graphicsItem->setData (DATA_KEY_ORDINAL, ordinal);
+  m_graphicsItem->setPos (posScreen.x (),
+                          posScreen.y ());
+  m_graphicsItem->setEnabled (true);
+  m_graphicsItem->setFlags (QGraphicsItem::ItemIsSelectable |
+                            QGraphicsItem::ItemIsMovable |
+                            QGraphicsItem::ItemSendsGeometryChanges);
+
+  m_graphicsItem->setToolTip (identifier);
 }
 
-GraphicsPoint::GraphicsPoint(QGraphicsScene &scene,
-                             const QString &identifier,
+GraphicsPoint::GraphicsPoint(GraphicsPointsForCurve &graphicsPointsForCurve,
+                             PointId pointId,
                              const QPointF &posScreen,
-                             const QColor &color,
-                             const QPolygonF &polygon,
-                             double lineWidth,
                              double ordinal) :
   GraphicsPointAbstractBase (),
-  m_graphicsItemEllipse (0),
-  m_shadowZeroWidthEllipse (0),
-  m_graphicsItemPolygon (0),
-  m_shadowZeroWidthPolygon (0),
+  m_graphicsItem (0),
+  m_graphicsPointsForCurve (&graphicsPointsForCurve),
+  m_posBatched (posScreen),
+  m_ordinal (ordinal),
+  m_pointId (pointId),
   m_wanted (true)
 {
-  LOG4CPP_INFO_S ((*mainCat)) << "GraphicsPoint::GraphicsPoint identifier=" << identifier.toLatin1 ().data ();
-
-  m_graphicsItemPolygon = new GraphicsPointPolygon (*this,
-                                                    polygon);
-  scene.addItem (m_graphicsItemPolygon);
-
-  m_graphicsItemPolygon->setData (DATA_KEY_IDENTIFIER, identifier);
-  m_graphicsItemPolygon->setData (DATA_KEY_GRAPHICS_ITEM_TYPE, GRAPHICS_ITEM_TYPE_POINT);
-  m_graphicsItemPolygon->setData (DATA_KEY_ORDINAL, ordinal);
-  m_graphicsItemPolygon->setPos (posScreen.x (),
-                                 posScreen.y ());
-  m_graphicsItemPolygon->setPen (QPen (QBrush (color), lineWidth));
-  m_graphicsItemPolygon->setEnabled (true);
-  m_graphicsItemPolygon->setFlags (QGraphicsItem::ItemIsSelectable |
-                                   QGraphicsItem::ItemIsMovable |
-                                   QGraphicsItem::ItemSendsGeometryChanges);
-
-  m_graphicsItemPolygon->setToolTip (identifier);
-  m_graphicsItemPolygon->setData (DATA_KEY_GRAPHICS_ITEM_TYPE, GRAPHICS_ITEM_TYPE_POINT);
-
-  // Shadow item is not selectable so it needs no stored data. Do NOT
-  // call QGraphicsScene::addItem since the QGraphicsItem::setParentItem call adds the item
-  m_shadowZeroWidthPolygon = new GraphicsPointPolygon (*this,
-                                                       polygon);
-  m_shadowZeroWidthPolygon->setParentItem(m_graphicsItemPolygon); // Dragging parent also drags child
-
-  m_shadowZeroWidthPolygon->setPen (QPen (QBrush (color), ZERO_WIDTH));
-  m_shadowZeroWidthPolygon->setEnabled (true);
+  m_graphicsPointsForCurve->addPoint (m_pointId,
+                                      posScreen);
 }
 
 GraphicsPoint::~GraphicsPoint()
 {
   LOG4CPP_INFO_S ((*mainCat)) << "GraphicsPoint::~GraphicsPoint";
 
-  if (m_graphicsItemEllipse == 0) {
-
-    QGraphicsScene *scene = m_graphicsItemPolygon->scene();
-
-    // Since m_shadowZeroWidthPolygon is a child of m_graphicsItemPolygon, removing the parent removes both
-    scene->removeItem (m_graphicsItemPolygon);
-    delete m_graphicsItemPolygon;
-    m_graphicsItemPolygon = 0;
-    m_shadowZeroWidthPolygon = 0;
+  if (m_graphicsPointsForCurve != 0) {
 
+    m_graphicsPointsForCurve->removePoint (m_pointId,
+                                           m_posBatched);
 
   } else {
 
-    QGraphicsScene *scene = m_graphicsItemEllipse->scene();
+    QGraphicsScene *scene = m_graphicsItem->scene();
 
-    // Since m_shadowZeroWidthEllipse is a child of m_graphicsItemEllipse, removing the parent removes both
-    scene->removeItem (m_graphicsItemEllipse);
-    delete m_graphicsItemEllipse;
-    m_graphicsItemEllipse = 0;
-    m_shadowZeroWidthEllipse = 0;
+    scene->removeItem (m_graphicsItem);
+    delete m_graphicsItem;
+    m_graphicsItem = 0;
 
   }
 }
 
 QVariant GraphicsPoint::data (int key) const
 {
-  if (m_graphicsItemEllipse == 0) {
-    return m_graphicsItemPolygon->data (key);
+  if (m_graphicsPointsForCurve != 0) {
+    return QVariant ();
   } else {
-    return m_graphicsItemEllipse->data (key);
+    return m_graphicsItem->data (key);
   }
 }
 
+GraphicsPointsForCurve *GraphicsPoint::graphicsPointsForCurve () const
+{
+  return m_graphicsPointsForCurve;
+}
+
+double GraphicsPoint::ordinal () const
+{
+  return m_ordinal;
+}
+
+PointId GraphicsPoint::pointId () const
+{
+  return m_pointId;
+}
+
 QPointF GraphicsPoint::pos () const
 {
-  if (m_graphicsItemEllipse == 0) {
-    return m_graphicsItemPolygon->pos ();
+  if (m_graphicsPointsForCurve != 0) {
+    return m_posBatched;
   } else {
-    return m_graphicsItemEllipse->pos ();
+    return m_graphicsItem->pos ();
   }
 }
 
@@ -163,36 +118,50 @@ void GraphicsPoint::reset ()
 
 void GraphicsPoint::setData (int key, const QVariant &data)
 {
-  if (m_graphicsItemEllipse == 0) {
-    m_graphicsItemPolygon->setData (key, data);
+  if (m_graphicsPointsForCurve != 0) {
+    // Nowhere to store the data, and nothing reads it back
   } else {
-    m_graphicsItemEllipse->setData (key, data);
+    m_graphicsItem->setData (key, data);
   }
 }
 
 
+void GraphicsPoint::setPos (const QPointF &pos)
+{
+  if (m_graphicsPointsForCurve != 0) {
+    m_graphicsPointsForCurve->setPointPosition (m_pointId,
+                                                m_posBatched,
+                                                pos);
+    m_posBatched = pos;
+  } else {
+    m_graphicsItem->setPos (pos);
+  }
+}
+
 void GraphicsPoint::setPointStyle(const PointStyle &pointStyle)
 {
-  // Setting pen and radius of parent graphics items below also affects the child shadows
-  // (m_shadowItemPolygon and m_shadowItemEllipse)
-  if (m_graphicsItemEllipse == 0) {
-    m_graphicsItemPolygon->setPen (QPen (ColorPaletteToQColor(pointStyle.paletteColor()),
-                                         pointStyle.lineWidth()));
-    m_graphicsItemPolygon->setRadius (pointStyle.radius());
+  // Points in a GraphicsPointsForCurve are drawn with its point style, which GraphicsScene updates once for the whole
+  // curve
+  if (m_graphicsPointsForCurve == 0) {
+    m_graphicsItem->setGeometry (GraphicsPointGeometry::geometry (pointStyle));
+  }
+}
 
+void GraphicsPoint::setSelected (bool selected)
+{
+  if (m_graphicsPointsForCurve != 0) {
+    // Nothing to select until the point gets its own graphics items
   } else {
-    m_graphicsItemEllipse->setPen (QPen (ColorPaletteToQColor(pointStyle.paletteColor()),
-                                         pointStyle.lineWidth()));
-    m_graphicsItemEllipse->setRadius (pointStyle.radius());
+    m_graphicsItem->setSelected (selected);
   }
 }
 
 void GraphicsPoint::setToolTip (const QString &toolTip)
 {
-  if (m_graphicsItemEllipse == 0) {
-    m_graphicsItemPolygon->setToolTip (toolTip);
+  if (m_graphicsPointsForCurve != 0) {
+    // GraphicsScene::helpEvent shows the identifier as the tooltip until the point gets its own graphics items
   } else {
-    m_graphicsItemEllipse->setToolTip (toolTip);
+    m_graphicsItem->setToolTip (toolTip);
   }
 }
 
@@ -3,58 +3,58 @@
 
 #include "GraphicsPointAbstractBase.h"
 #include "GraphicsPoint.h"
+#include "PointIdTable.h"
 #include <QPointF>
 
 class CurveStyle;
-class GraphicsPointEllipse;
-class GraphicsPointPolygon;
+class GraphicsPointItem;
+class GraphicsPointsForCurve;
 class PointStyle;
-class QColor;
 class QGraphicsScene;
-class QPolygonF;
 class QVariant;
 
 /// Graphics item for drawing a circular or polygonal Point. 
 ///
-/// In this class, lines are drawn twice:
-/// 1) As nonzero-width lines so user can have thick, and highly visible, points
-/// 2) As a 'shadow' with zero-width lines since these always appear even when zooming results in some pixel
-///    rows/columns disappearing
-/// This dual-line approach is better than using QGraphicsItem::ItemIgnoresTransformations to prevent horrible
-/// aliasing problems, since that approach involves complicated transformation matrix manipulations
+/// The point is drawn by a single GraphicsPointItem, which holds just its position and a handle to the
+/// GraphicsPointGeometry shared by all points with the same PointStyle. Lines are drawn twice, with a wide pen and a
+/// zero-width 'shadow' pen, as explained in GraphicsPointGeometry. For large curves the point may instead be drawn by
+/// the GraphicsPointsForCurve of its curve.
 ///
-/// Layering is used for the single graphics item contained by this class. External code only has to deal with this
-/// single class, and there is no multiple inheritance involved. If inheritance was used, we would have one class
-/// based on QGraphicsEllipseItem and another on QGraphicsPolygonItem, so having a single class (for the convenience
-/// of the external code) would involve multiple inheritance (of those two classes). With the inheritance approach, 
-/// using just the methods supplied by QGraphicsItem would be inadequate.
+/// Layering is used for the graphics item contained by this class, so external code only has to deal with this
+/// single class whether or not the point has its own graphics item.
 class GraphicsPoint : public GraphicsPointAbstractBase
 {
 public:
-  /// Constructor of circular point.
+  /// Constructor of point with its own graphics item. The identifier is the one for the PointId in the PointIdTable
   GraphicsPoint(QGraphicsScene &scene,
+                PointId pointId,
                 const QString &identifier,
                 const QPointF &posScreen,
-                const QColor &color,
-                unsigned int radius,
-                double lineWidth,
+                const PointStyle &pointStyle,
                 double ordinal);
 
-  /// Constructor of polygon point.
-  GraphicsPoint(QGraphicsScene &scene,
-                const QString &identifier,
+  /// Constructor of point that has no graphics items of its own, since it is drawn by the GraphicsPointsForCurve of its
+  /// curve
+  GraphicsPoint(GraphicsPointsForCurve &graphicsPointsForCurve,
+                PointId pointId,
                 const QPointF &posScreen,
-                const QColor &color,
-                const QPolygonF &polygon,
-                double lineWidth,
                 double ordinal);
 
-  /// Destructor. This remove the graphics item from the scene
+  /// Destructor. This remove the graphics item from the scene, or the point from its GraphicsPointsForCurve
   ~GraphicsPoint ();
 
-  /// Proxy method for QGraphicsItem::data
+  /// Proxy method for QGraphicsItem::data. Points drawn by a GraphicsPointsForCurve have no data
   QVariant data (int key) const;
 
+  /// GraphicsPointsForCurve that draws this point, or null if the point has its own graphics items
+  GraphicsPointsForCurve *graphicsPointsForCurve () const;
+
+  /// Ordinal given at creation. This is the same as the DATA_KEY_ORDINAL data, without the QVariant unboxing
+  double ordinal () const;
+
+  /// PointId given at creation, for cheap lookups in the scene's point sets
+  PointId pointId () const;
+
   /// Proxy method for QGraphicsItem::pos.
   QPointF pos () const;
 
@@ -64,7 +64,13 @@ public:
   /// Proxy method for QGraphicsItem::setData
   void setData (int key, const QVariant &data);
 
-  /// Update the point style
+  /// Proxy method for QGraphicsItem::setPos
+  void setPos (const QPointF &pos);
+
+  /// Proxy method for QGraphicsItem::setSelected. Points drawn by a GraphicsPointsForCurve cannot be selected
+  void setSelected (bool selected);
+
+  /// Update the point style. This swaps the handle to the shared geometry, and does nothing if the style is unchanged
   void setPointStyle (const PointStyle &pointStyle);
 
   /// Proxy method for QGraphicsItem::setToolTip
@@ -82,15 +88,16 @@ public:
 private:
   GraphicsPoint();
 
-  // Ellipse graphics items. Unused if point is polygonal.
-  GraphicsPointEllipse *m_graphicsItemEllipse;
-  GraphicsPointEllipse *m_shadowZeroWidthEllipse; // Shadow item overlays the superclass instance to ensure visibility
+  // Graphics item. Unused if point is drawn by a GraphicsPointsForCurve
+  GraphicsPointItem *m_graphicsItem;
 
-  // Polygon graphics items. Unused if point is elliptical.
-  GraphicsPointPolygon *m_graphicsItemPolygon;
-  GraphicsPointPolygon *m_shadowZeroWidthPolygon; // Shadow item overlays the superclass instance to ensure visibility
+  // Batch item, and position within it. Unused if point has its own graphics items
+  GraphicsPointsForCurve *m_graphicsPointsForCurve;
+  QPointF m_posBatched;
 
   // Housekeeping
+  double m_ordinal;
+  PointId m_pointId;
   bool m_wanted;
 };
 
@@ -1,52 +1,27 @@
-#include "DataKey.h"
-#include "EnumsToQt.h"
-#include "GraphicsItemType.h"
 #include "GraphicsPoint.h"
 #include "GraphicsPointFactory.h"
 #include "PointStyle.h"
-#include <QColor>
 #include <QGraphicsScene>
 #include <QPointF>
-#include <QPolygonF>
 
 GraphicsPointFactory::GraphicsPointFactory()
 {
 }
 
 GraphicsPoint *GraphicsPointFactory::createPoint (QGraphicsScene &scene,
+                                                  PointId pointId,
                                                   const QString &identifier,
                                                   const QPointF &posScreen,
                                                   const PointStyle &pointStyle,
                                                   double ordinal)
 {
-  GraphicsPoint *item = 0;
+  // Every point gets the same kind of graphics item, with the shape taken from the shared geometry of the point style
+  GraphicsPoint *item = new GraphicsPoint (scene,
+                                           pointId,
+                                           identifier,
+                                           posScreen,
+                                           pointStyle,
+                                           ordinal);
 
-  switch (pointStyle.shape ())
-  {
-    case POINT_SHAPE_CIRCLE:
-      {
-        item = new GraphicsPoint (scene,
-                                  identifier,
-                                  posScreen,
-                                  ColorPaletteToQColor (pointStyle.paletteColor ()),
-                                  pointStyle.radius (),
-                                  pointStyle.lineWidth(),
-                                  ordinal);
-      }
-      break;
-
-    default:
-      {
-        item = new GraphicsPoint (scene,
-                                  identifier,
-                                  posScreen,
-                                  ColorPaletteToQColor (pointStyle.paletteColor ()),
-                                  pointStyle.polygon (),
-                                  pointStyle.lineWidth(),
-                                  ordinal);
-      }
-      break;
-  }
-  
   return item;
 }
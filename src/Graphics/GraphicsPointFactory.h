@@ -1,6 +1,7 @@
 #ifndef GRAPHICS_POINT_FACTORY_H
 #define GRAPHICS_POINT_FACTORY_H
 
+#include "PointIdTable.h"
 #include "PointShape.h"
 
 class GraphicsPoint;
@@ -17,6 +18,7 @@ public:
 
   /// Create circle or polygon point according to the PointStyle.
   GraphicsPoint *createPoint (QGraphicsScene &scene,
+                              PointId pointId,
                               const QString &identifier,
                               const QPointF &posScreen,
                               const PointStyle &pointStyle,
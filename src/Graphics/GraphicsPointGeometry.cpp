@@ -0,0 +1,82 @@
+#include "EnumsToQt.h"
+#include "GraphicsPointGeometry.h"
+#include "PointStyle.h"
+#include <QHash>
+#include <QPainter>
+#include <QPainterPathStroker>
+#include <QWeakPointer>
+
+const double ZERO_WIDTH = 0.0;
+
+// Weak pointers so a geometry is released once the last point using it is gone. Points are only created in the GUI
+// thread, so no locking is needed
+static QHash<quint64, QWeakPointer<const GraphicsPointGeometry> > geometries;
+
+static quint64 keyForPointStyle (const PointStyle &pointStyle)
+{
+  return ((quint64) pointStyle.shape () << 48) |
+         ((quint64) (quint16) pointStyle.radius () << 32) |
+         ((quint64) (quint16) pointStyle.lineWidth () << 16) |
+         (quint64) pointStyle.paletteColor ();
+}
+
+GraphicsPointGeometry::GraphicsPointGeometry(const PointStyle &pointStyle)
+{
+  QColor color = ColorPaletteToQColor (pointStyle.paletteColor ());
+  m_pen = QPen (QBrush (color), pointStyle.lineWidth ());
+  m_penShadow = QPen (QBrush (color), ZERO_WIDTH);
+
+  if (pointStyle.isCircle ()) {
+    int radius = pointStyle.radius ();
+    m_path.addEllipse (QRect (- radius,
+                              - radius,
+                              2 * radius + 1,
+                              2 * radius + 1));
+  } else {
+    m_path.addPolygon (pointStyle.polygon ());
+    m_path.closeSubpath ();
+  }
+
+  // Same hit test area as QGraphicsEllipseItem and QGraphicsPolygonItem, which is the interior plus the wide pen
+  QPainterPathStroker stroker;
+  stroker.setWidth (qMax (1.0, m_pen.widthF ()));
+  m_shape = m_path;
+  m_shape.addPath (stroker.createStroke (m_path));
+
+  double margin = m_pen.widthF () / 2.0;
+  m_boundingRect = m_path.boundingRect ().adjusted (-margin, -margin, margin, margin);
+}
+
+QRectF GraphicsPointGeometry::boundingRect () const
+{
+  return m_boundingRect;
+}
+
+GraphicsPointGeometryHandle GraphicsPointGeometry::geometry (const PointStyle &pointStyle)
+{
+  quint64 key = keyForPointStyle (pointStyle);
+
+  GraphicsPointGeometryHandle handle = geometries.value (key).toStrongRef ();
+  if (handle.isNull ()) {
+    handle = GraphicsPointGeometryHandle (new GraphicsPointGeometry (pointStyle));
+    geometries [key] = handle;
+  }
+
+  return handle;
+}
+
+void GraphicsPointGeometry::paint (QPainter *painter) const
+{
+  painter->setBrush (Qt::NoBrush);
+
+  painter->setPen (m_pen);
+  painter->drawPath (m_path);
+
+  painter->setPen (m_penShadow);
+  painter->drawPath (m_path);
+}
+
+QPainterPath GraphicsPointGeometry::shape () const
+{
+  return m_shape;
+}
@@ -0,0 +1,50 @@
+#ifndef GRAPHICS_POINT_GEOMETRY_H
+#define GRAPHICS_POINT_GEOMETRY_H
+
+#include <QPainterPath>
+#include <QPen>
+#include <QPolygonF>
+#include <QRectF>
+#include <QSharedPointer>
+
+class GraphicsPointGeometry;
+class PointStyle;
+class QPainter;
+
+/// Handle to a shared GraphicsPointGeometry. Points hold a handle rather than their own copy of the geometry and pens
+typedef QSharedPointer<const GraphicsPointGeometry> GraphicsPointGeometryHandle;
+
+/// Flyweight with the geometry and pens of one PointStyle, shared by every point drawn with that style. Geometries are
+/// reference counted, and cached by shape, radius, line width and color for as long as at least one handle exists.
+///
+/// Points are drawn twice:
+/// 1) As nonzero-width lines so user can have thick, and highly visible, points
+/// 2) As a 'shadow' with zero-width lines since these always appear even when zooming results in some pixel
+///    rows/columns disappearing
+class GraphicsPointGeometry
+{
+public:
+  /// Shared geometry for the point style, creating it if no point currently uses that style
+  static GraphicsPointGeometryHandle geometry (const PointStyle &pointStyle);
+
+  /// Bounding rectangle around the origin, including the width of the wide pen
+  QRectF boundingRect () const;
+
+  /// Paint the point centered on the origin, with both the wide and the zero-width pens
+  void paint (QPainter *painter) const;
+
+  /// Outline used for hit tests, including the interior
+  QPainterPath shape () const;
+
+private:
+  GraphicsPointGeometry();
+  GraphicsPointGeometry(const PointStyle &pointStyle);
+
+  QPainterPath m_path;
+  QPen m_pen;
+  QPen m_penShadow;
+  QRectF m_boundingRect;
+  QPainterPath m_shape;
+};
+
+#endif // GRAPHICS_POINT_GEOMETRY_H
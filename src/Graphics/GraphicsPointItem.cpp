@@ -0,0 +1,73 @@
+#include "GraphicsPoint.h"
+#include "GraphicsPointItem.h"
+#include "GraphicsScene.h"
+#include <QPainter>
+#include <QStyle>
+#include <QStyleOptionGraphicsItem>
+
+GraphicsPointItem::GraphicsPointItem(GraphicsPoint &graphicsPoint,
+                                     const GraphicsPointGeometryHandle &geometry) :
+  m_graphicsPoint (graphicsPoint),
+  m_geometry (geometry)
+{
+}
+
+QRectF GraphicsPointItem::boundingRect () const
+{
+  return m_geometry->boundingRect ();
+}
+
+QVariant GraphicsPointItem::itemChange (GraphicsItemChange change,
+                                        const QVariant &value)
+{
+  // The scene keeps sets of moved and selected points, so it never has to scan every item. Items in other scenes,
+  // like the preview in the curve properties dialog, are not tracked
+  if (change == QGraphicsItem::ItemPositionHasChanged) {
+
+    GraphicsScene *graphicsScene = dynamic_cast<GraphicsScene*> (scene ());
+    if (graphicsScene != 0) {
+      graphicsScene->pointPositionHasChanged (m_graphicsPoint.pointId ());
+    }
+
+  } else if (change == QGraphicsItem::ItemSelectedHasChanged) {
+
+    GraphicsScene *graphicsScene = dynamic_cast<GraphicsScene*> (scene ());
+    if (graphicsScene != 0) {
+      graphicsScene->pointSelectionHasChanged (m_graphicsPoint.pointId (),
+                                               value.toBool ());
+    }
+  }
+
+  return QGraphicsItem::itemChange (change,
+                                    value);
+}
+
+void GraphicsPointItem::paint (QPainter *painter,
+                               const QStyleOptionGraphicsItem *option,
+                               QWidget * /* widget */)
+{
+  m_geometry->paint (painter);
+
+  // Dashed highlight around selected points, like the one drawn by the standard QGraphicsItem shapes
+  if ((option->state & QStyle::State_Selected) != 0) {
+
+    painter->setPen (QPen (option->palette.windowText (), 0, Qt::DashLine));
+    painter->setBrush (Qt::NoBrush);
+    painter->drawRect (boundingRect ());
+  }
+}
+
+void GraphicsPointItem::setGeometry (const GraphicsPointGeometryHandle &geometry)
+{
+  if (geometry != m_geometry) {
+
+    prepareGeometryChange ();
+    m_geometry = geometry;
+    update ();
+  }
+}
+
+QPainterPath GraphicsPointItem::shape () const
+{
+  return m_geometry->shape ();
+}
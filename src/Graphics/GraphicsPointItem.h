@@ -0,0 +1,46 @@
+#ifndef GRAPHICS_POINT_ITEM_H
+#define GRAPHICS_POINT_ITEM_H
+
+#include "GraphicsPointGeometry.h"
+#include <QGraphicsItem>
+
+class GraphicsPoint;
+
+/// Graphics item for one circular or polygonal Point. The item holds only its position, which is kept by
+/// QGraphicsItem, and a handle to the GraphicsPointGeometry shared by all points with the same PointStyle
+class GraphicsPointItem : public QGraphicsItem
+{
+public:
+  /// Single constructor
+  GraphicsPointItem(GraphicsPoint &graphicsPoint,
+                    const GraphicsPointGeometryHandle &geometry);
+
+  /// Bounding rectangle of the shared geometry
+  virtual QRectF boundingRect () const;
+
+  /// Intercept moves and selection changes so the GraphicsScene can keep its sets of moved and selected points. This
+  /// replaces unreliable hit tests
+  virtual QVariant itemChange (GraphicsItemChange change,
+                               const QVariant &value);
+
+  /// Paint the shared geometry, plus the selection highlight if selected
+  virtual void paint (QPainter *painter,
+                      const QStyleOptionGraphicsItem *option,
+                      QWidget *widget);
+
+  /// Swap to another shared geometry. Nothing happens if the geometry is already in use
+  void setGeometry (const GraphicsPointGeometryHandle &geometry);
+
+  /// Hit test shape of the shared geometry
+  virtual QPainterPath shape () const;
+
+private:
+  GraphicsPointItem();
+
+  // Reference to the GraphicsPoint that this class belongs to
+  GraphicsPoint &m_graphicsPoint;
+
+  GraphicsPointGeometryHandle m_geometry;
+};
+
+#endif // GRAPHICS_POINT_ITEM_H
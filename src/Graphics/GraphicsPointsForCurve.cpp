@@ -0,0 +1,342 @@
+#include "DataKey.h"
+#include "GraphicsItemType.h"
+#include "GraphicsPointsForCurve.h"
+#include <qmath.h>
+#include <QPainter>
+#include <QPainterPath>
+#include <QStyleOptionGraphicsItem>
+
+// Size of the square grid cells, in scene pixels. A cell holds a few hundred points on a densely digitized curve,
+// and a typical exposed rectangle covers tens of cells
+const double GRID_CELL_SIZE = 64.0;
+
+GraphicsPointsForCurve::GraphicsPointsForCurve(const PointStyle &pointStyle) :
+  m_pointStyle (pointStyle),
+  m_geometry (GraphicsPointGeometry::geometry (pointStyle)),
+  m_rectCentersIsEmpty (true),
+  m_glyphScale (0.0),
+  m_glyphDevicePixelRatio (0.0)
+{
+  setData (DATA_KEY_GRAPHICS_ITEM_TYPE, GRAPHICS_ITEM_TYPE_POINTS_FOR_CURVE);
+
+  // Exposed rectangle is needed so painting can skip the grid cells outside of it
+  setFlag (QGraphicsItem::ItemUsesExtendedStyleOption);
+}
+
+void GraphicsPointsForCurve::addPoint (PointId pointId,
+                                       const QPointF &posScreen)
+{
+  GraphicsPointsForCurveEntry entry;
+  entry.pointId = pointId;
+  entry.posScreen = posScreen;
+
+  m_cells [keyForPosition (posScreen)].push_back (entry);
+
+  growRectCenters (posScreen);
+
+  double margin = extent ();
+  update (QRectF (posScreen.x () - margin,
+                  posScreen.y () - margin,
+                  2 * margin,
+                  2 * margin));
+}
+
+QRectF GraphicsPointsForCurve::boundingRect () const
+{
+  if (m_rectCentersIsEmpty) {
+    return QRectF ();
+  }
+
+  double margin = extent ();
+  return m_rectCenters.adjusted (-margin, -margin, margin, margin);
+}
+
+bool GraphicsPointsForCurve::contains (const QPointF &posScreen) const
+{
+  PointId pointId;
+  return pointAt (posScreen,
+                  pointId);
+}
+
+double GraphicsPointsForCurve::extent () const
+{
+  return m_pointStyle.radius () + m_pointStyle.lineWidth () + 1;
+}
+
+const QPixmap &GraphicsPointsForCurve::glyph (double scale,
+                                              double devicePixelRatio)
+{
+  if (m_glyph.isNull () ||
+      (m_glyphScale != scale) ||
+      (m_glyphDevicePixelRatio != devicePixelRatio)) {
+
+    int halfSize = qCeil (extent () * scale);
+
+    // Painting on the pixmap is in device independent pixels, since the pixmap has the device pixel ratio
+    m_glyph = QPixmap (qCeil ((2 * halfSize + 1) * devicePixelRatio),
+                       qCeil ((2 * halfSize + 1) * devicePixelRatio));
+    m_glyph.setDevicePixelRatio (devicePixelRatio);
+    m_glyph.fill (Qt::transparent);
+    m_glyphScale = scale;
+    m_glyphDevicePixelRatio = devicePixelRatio;
+
+    QPainter painter (&m_glyph);
+    painter.setRenderHint (QPainter::Antialiasing);
+    painter.translate (halfSize + 0.5,
+                       halfSize + 0.5);
+    painter.scale (scale,
+                   scale);
+
+    // Same geometry, and therefore the same two passes, as points with their own graphics items
+    m_geometry->paint (&painter);
+  }
+
+  return m_glyph;
+}
+
+void GraphicsPointsForCurve::growRectCenters (const QPointF &posScreen)
+{
+  if (m_rectCentersIsEmpty) {
+
+    prepareGeometryChange ();
+    m_rectCenters = QRectF (posScreen,
+                            posScreen);
+    m_rectCentersIsEmpty = false;
+
+  } else if ((posScreen.x () < m_rectCenters.left ()) ||
+             (posScreen.x () > m_rectCenters.right ()) ||
+             (posScreen.y () < m_rectCenters.top ()) ||
+             (posScreen.y () > m_rectCenters.bottom ())) {
+
+    prepareGeometryChange ();
+    m_rectCenters = QRectF (QPointF (qMin (posScreen.x (), m_rectCenters.left ()),
+                                     qMin (posScreen.y (), m_rectCenters.top ())),
+                            QPointF (qMax (posScreen.x (), m_rectCenters.right ()),
+                                     qMax (posScreen.y (), m_rectCenters.bottom ())));
+  }
+}
+
+quint64 GraphicsPointsForCurve::keyForCell (int column,
+                                            int row) const
+{
+  return ((quint64) (quint32) row << 32) | (quint64) (quint32) column;
+}
+
+quint64 GraphicsPointsForCurve::keyForPosition (const QPointF &posScreen) const
+{
+  return keyForCell (qFloor (posScreen.x () / GRID_CELL_SIZE),
+                     qFloor (posScreen.y () / GRID_CELL_SIZE));
+}
+
+void GraphicsPointsForCurve::paint (QPainter *painter,
+                                    const QStyleOptionGraphicsItem *option,
+                                    QWidget * /* widget */)
+{
+  // Glyphs are copied in device coordinates, so the glyph is rendered once for the current zoom
+  QTransform transform = painter->worldTransform ();
+  double scale = qSqrt (qAbs (transform.determinant ()));
+  if (scale <= 0) {
+    return;
+  }
+
+  // Painter coordinates are in device independent pixels even on high dpi screens, so the glyph needs the device pixel
+  // ratio to use every device pixel
+  double devicePixelRatio = painter->device ()->devicePixelRatioF ();
+  const QPixmap &pixmap = glyph (scale,
+                                 devicePixelRatio);
+  QPointF offset (pixmap.width () / (2.0 * devicePixelRatio),
+                  pixmap.height () / (2.0 * devicePixelRatio));
+
+  // Points just outside the exposed rectangle may still have part of their glyph inside it
+  double margin = extent ();
+  QRectF rectExposed = option->exposedRect.adjusted (-margin, -margin, margin, margin);
+
+  painter->save ();
+  painter->resetTransform ();
+
+  int columnMin, columnMax, rowMin, rowMax;
+  rangeOfCells (rectExposed,
+                columnMin,
+                columnMax,
+                rowMin,
+                rowMax);
+
+  if ((columnMax - columnMin + 1) * (rowMax - rowMin + 1) < m_cells.count ()) {
+
+    // Visit just the cells in the exposed rectangle, which is the usual case when zoomed in
+    for (int row = rowMin; row <= rowMax; row++) {
+      for (int column = columnMin; column <= columnMax; column++) {
+
+        QHash<quint64, GraphicsPointsForCurveCell>::const_iterator itrCell = m_cells.find (keyForCell (column, row));
+        if (itrCell != m_cells.end ()) {
+
+          const GraphicsPointsForCurveCell &cell = itrCell.value ();
+          for (int i = 0; i < cell.count (); i++) {
+            const QPointF &posScreen = cell.at (i).posScreen;
+            if (rectExposed.contains (posScreen)) {
+              painter->drawPixmap (transform.map (posScreen) - offset,
+                                   pixmap);
+            }
+          }
+        }
+      }
+    }
+
+  } else {
+
+    // Fewer occupied cells than cells in the exposed rectangle, so visit the occupied cells
+    QHash<quint64, GraphicsPointsForCurveCell>::const_iterator itrCell;
+    for (itrCell = m_cells.begin (); itrCell != m_cells.end (); itrCell++) {
+
+      const GraphicsPointsForCurveCell &cell = itrCell.value ();
+      for (int i = 0; i < cell.count (); i++) {
+        const QPointF &posScreen = cell.at (i).posScreen;
+        if (rectExposed.contains (posScreen)) {
+          painter->drawPixmap (transform.map (posScreen) - offset,
+                               pixmap);
+        }
+      }
+    }
+  }
+
+  painter->restore ();
+}
+
+bool GraphicsPointsForCurve::pointAt (const QPointF &posScreen,
+                                      PointId &pointId) const
+{
+  double radius = m_pointStyle.radius () + m_pointStyle.lineWidth () / 2.0;
+  double distanceSquaredNearest = radius * radius;
+  bool found = false;
+
+  int columnMin, columnMax, rowMin, rowMax;
+  rangeOfCells (QRectF (posScreen.x () - radius,
+                        posScreen.y () - radius,
+                        2 * radius,
+                        2 * radius),
+                columnMin,
+                columnMax,
+                rowMin,
+                rowMax);
+
+  for (int row = rowMin; row <= rowMax; row++) {
+    for (int column = columnMin; column <= columnMax; column++) {
+
+      QHash<quint64, GraphicsPointsForCurveCell>::const_iterator itrCell = m_cells.find (keyForCell (column, row));
+      if (itrCell != m_cells.end ()) {
+
+        const GraphicsPointsForCurveCell &cell = itrCell.value ();
+        for (int i = 0; i < cell.count (); i++) {
+
+          double dx = cell.at (i).posScreen.x () - posScreen.x ();
+          double dy = cell.at (i).posScreen.y () - posScreen.y ();
+          double distanceSquared = dx * dx + dy * dy;
+          if (distanceSquared <= distanceSquaredNearest) {
+            distanceSquaredNearest = distanceSquared;
+            pointId = cell.at (i).pointId;
+            found = true;
+          }
+        }
+      }
+    }
+  }
+
+  return found;
+}
+
+QList<PointId> GraphicsPointsForCurve::pointsInArea (const QPainterPath &area) const
+{
+  QList<PointId> pointIds;
+
+  int columnMin, columnMax, rowMin, rowMax;
+  rangeOfCells (area.boundingRect (),
+                columnMin,
+                columnMax,
+                rowMin,
+                rowMax);
+
+  for (int row = rowMin; row <= rowMax; row++) {
+    for (int column = columnMin; column <= columnMax; column++) {
+
+      QHash<quint64, GraphicsPointsForCurveCell>::const_iterator itrCell = m_cells.find (keyForCell (column, row));
+      if (itrCell != m_cells.end ()) {
+
+        const GraphicsPointsForCurveCell &cell = itrCell.value ();
+        for (int i = 0; i < cell.count (); i++) {
+          if (area.contains (cell.at (i).posScreen)) {
+            pointIds << cell.at (i).pointId;
+          }
+        }
+      }
+    }
+  }
+
+  return pointIds;
+}
+
+PointStyle GraphicsPointsForCurve::pointStyle () const
+{
+  return m_pointStyle;
+}
+
+void GraphicsPointsForCurve::rangeOfCells (const QRectF &rect,
+                                           int &columnMin,
+                                           int &columnMax,
+                                           int &rowMin,
+                                           int &rowMax) const
+{
+  columnMin = qFloor (rect.left () / GRID_CELL_SIZE);
+  columnMax = qFloor (rect.right () / GRID_CELL_SIZE);
+  rowMin = qFloor (rect.top () / GRID_CELL_SIZE);
+  rowMax = qFloor (rect.bottom () / GRID_CELL_SIZE);
+}
+
+void GraphicsPointsForCurve::removePoint (PointId pointId,
+                                          const QPointF &posScreen)
+{
+  QHash<quint64, GraphicsPointsForCurveCell>::iterator itrCell = m_cells.find (keyForPosition (posScreen));
+  if (itrCell != m_cells.end ()) {
+
+    // Order within a cell does not matter, so the last entry fills the gap
+    GraphicsPointsForCurveCell &cell = itrCell.value ();
+    for (int i = 0; i < cell.count (); i++) {
+      if (cell.at (i).pointId == pointId) {
+        cell [i] = cell.last ();
+        cell.pop_back ();
+        break;
+      }
+    }
+
+    if (cell.isEmpty ()) {
+      m_cells.erase (itrCell);
+    }
+  }
+
+  double margin = extent ();
+  update (QRectF (posScreen.x () - margin,
+                  posScreen.y () - margin,
+                  2 * margin,
+                  2 * margin));
+}
+
+void GraphicsPointsForCurve::setPointPosition (PointId pointId,
+                                               const QPointF &posScreenOld,
+                                               const QPointF &posScreenNew)
+{
+  removePoint (pointId,
+               posScreenOld);
+  addPoint (pointId,
+            posScreenNew);
+}
+
+void GraphicsPointsForCurve::setPointStyle (const PointStyle &pointStyle)
+{
+  // Extent of the glyph, and therefore the bounding rectangle, may change
+  prepareGeometryChange ();
+
+  m_pointStyle = pointStyle;
+  m_geometry = GraphicsPointGeometry::geometry (pointStyle);
+  m_glyph = QPixmap ();
+
+  update ();
+}
@@ -0,0 +1,118 @@
+#ifndef GRAPHICS_POINTS_FOR_CURVE_H
+#define GRAPHICS_POINTS_FOR_CURVE_H
+
+#include "GraphicsPointGeometry.h"
+#include "PointIdTable.h"
+#include "PointStyle.h"
+#include <QGraphicsItem>
+#include <QHash>
+#include <QList>
+#include <QPixmap>
+#include <QPointF>
+#include <QRectF>
+#include <QVector>
+
+class QPainterPath;
+
+/// One batched point in a GraphicsPointsForCurve grid cell
+struct GraphicsPointsForCurveEntry
+{
+  PointId pointId;
+  QPointF posScreen;
+};
+
+typedef QVector<GraphicsPointsForCurveEntry> GraphicsPointsForCurveCell;
+
+/// Single graphics item that draws many Points of one Curve, for curves too large to have one GraphicsPointItem per
+/// Point. Each Point is drawn by copying one cached glyph pixmap, and only the
+/// Points in the grid cells that intersect the exposed rectangle are visited.
+///
+/// Points drawn here cannot be selected or dragged. GraphicsScene moves a Point out of this item, into its own
+/// QGraphicsItems, just before it is pressed or rubber band selected, and moves it back once it is unselected
+class GraphicsPointsForCurve : public QGraphicsItem
+{
+public:
+  /// Single constructor
+  GraphicsPointsForCurve(const PointStyle &pointStyle);
+
+  /// Add one Point
+  void addPoint (PointId pointId,
+                 const QPointF &posScreen);
+
+  /// Bounding rectangle of all Points added so far, including the extent of the glyph. The rectangle never shrinks
+  virtual QRectF boundingRect () const;
+
+  /// True if the position is on one of the Points. This replaces the default bounding rectangle test so hit tests, and
+  /// therefore cursors and mouse presses, only apply to the Points rather than to the empty space between them
+  virtual bool contains (const QPointF &posScreen) const;
+
+  /// Paint the Points in the exposed rectangle
+  virtual void paint (QPainter *painter,
+                      const QStyleOptionGraphicsItem *option,
+                      QWidget *widget);
+
+  /// Find the Point drawn at the position, if there is one. Returns true if one was found
+  bool pointAt (const QPointF &posScreen,
+                PointId &pointId) const;
+
+  /// Points whose centers are inside the area
+  QList<PointId> pointsInArea (const QPainterPath &area) const;
+
+  /// Current point style
+  PointStyle pointStyle () const;
+
+  /// Remove one Point. The position is needed to find the grid cell of the Point
+  void removePoint (PointId pointId,
+                    const QPointF &posScreen);
+
+  /// Move one Point from its old position to its new position
+  void setPointPosition (PointId pointId,
+                         const QPointF &posScreenOld,
+                         const QPointF &posScreenNew);
+
+  /// Update the point style. The cached glyph is discarded
+  void setPointStyle (const PointStyle &pointStyle);
+
+private:
+  GraphicsPointsForCurve();
+
+  // Distance from the center of a Point to the far edge of its glyph, in scene coordinates
+  double extent () const;
+
+  // Render the glyph for the specified scale and device pixel ratio, if the cached glyph is for different ones. The
+  // scale is in device independent pixels, and the pixmap has device pixels so it stays sharp on high dpi screens
+  const QPixmap &glyph (double scale,
+                        double devicePixelRatio);
+
+  // Grow the bounding rectangle of the Point centers to include the position
+  void growRectCenters (const QPointF &posScreen);
+
+  // Key of the grid cell containing the position
+  quint64 keyForCell (int column,
+                      int row) const;
+  quint64 keyForPosition (const QPointF &posScreen) const;
+
+  // Range of grid cells that intersect the rectangle
+  void rangeOfCells (const QRectF &rect,
+                     int &columnMin,
+                     int &columnMax,
+                     int &rowMin,
+                     int &rowMax) const;
+
+  PointStyle m_pointStyle;
+  GraphicsPointGeometryHandle m_geometry;
+
+  // Spatial grid of fixed size cells, holding each Point with its position so painting needs no other lookups
+  QHash<quint64, GraphicsPointsForCurveCell> m_cells;
+
+  // Bounding rectangle of the Point centers
+  QRectF m_rectCenters;
+  bool m_rectCentersIsEmpty;
+
+  // Glyph cached for the most recent painter scale and device pixel ratio
+  QPixmap m_glyph;
+  double m_glyphScale;
+  double m_glyphDevicePixelRatio;
+};
+
+#endif // GRAPHICS_POINTS_FOR_CURVE_H
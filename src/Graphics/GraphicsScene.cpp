@@ -3,11 +3,14 @@
 #include "CurvesGraphs.h"
 #include "CurveStyles.h"
 #include "DataKey.h"
+#include "Document.h"
+#include "DocumentChangeSet.h"
 #include "EngaugeAssert.h"
 #include "EnumsToQt.h"
 #include "GraphicsItemType.h"
 #include "GraphicsPoint.h"
 #include "GraphicsPointFactory.h"
+#include "GraphicsPointsForCurve.h"
 #include "GraphicsScene.h"
 #include "Logger.h"
 #include "MainWindow.h"
@@ -15,11 +18,21 @@
 #include "PointStyle.h"
 #include <QApplication>
 #include <QGraphicsItem>
+#include <QGraphicsSceneHelpEvent>
+#include <QGraphicsSceneMouseEvent>
+#include <QPainterPath>
 #include "QtToString.h"
+#include <QToolTip>
 #include "Transformation.h"
 
+// Curves with at least this many points have their new points drawn by a GraphicsPointsForCurve. Below this, the
+// per item overhead is small and every point keeps its own graphics items
+const int MIN_POINTS_FOR_BATCHING = 1000;
+
 GraphicsScene::GraphicsScene(MainWindow *mainWindow) :
-  QGraphicsScene(mainWindow)
+  QGraphicsScene(mainWindow),
+  m_pointIdTable (new PointIdTable),
+  m_maxOrdinal (0)
 {
 }
 
@@ -27,51 +40,150 @@ GraphicsPoint *GraphicsScene::addPoint (const QString &identifier,
                                         const PointStyle &pointStyle,
                                         const QPointF &posScreen)
 {
-  double ordinal = maxOrdinal () + 1;
+  return addPoint (m_pointIdTable->intern (identifier),
+                   pointStyle,
+                   posScreen);
+}
+
+GraphicsPoint *GraphicsScene::addPoint (PointId pointId,
+                                        const PointStyle &pointStyle,
+                                        const QPointF &posScreen)
+{
+  double ordinal = ++m_maxOrdinal;
 
   LOG4CPP_INFO_S ((*mainCat)) << "GraphicsScene::addPoint"
-                              << " identifier=" << identifier.toLatin1().data()
+                              << " pointId=" << pointId
                               << " ordinal=" << ordinal;
 
+  QString curveName = m_pointIdTable->curveName (pointId);
+
   // Ordinal value is initially computed as one plus the max ordinal seen so far. This initial ordinal value will be overridden if the
-  // cordinates determine the ordinal values.
-  //
-  // This is an N-squared algorithm and may be worth replacing later
-  GraphicsPointFactory pointFactory;
-  GraphicsPoint *point = pointFactory.createPoint (*this,
-                                                   identifier,
-                                                   posScreen,
-                                                   pointStyle,
-                                                   ordinal);
+  // cordinates determine the ordinal values
+  GraphicsPoint *point = 0;
+  if (++m_curvePointCounts [curveName] >= MIN_POINTS_FOR_BATCHING) {
 
-  point->setToolTip (identifier);
-  point->setData (DATA_KEY_GRAPHICS_ITEM_TYPE, GRAPHICS_ITEM_TYPE_POINT);
+    point = new GraphicsPoint (*graphicsPointsForCurve (curveName,
+                                                        pointStyle),
+                               pointId,
+                               posScreen,
+                               ordinal);
+
+  } else {
+
+    point = createPointWithItems (pointId,
+                                  pointStyle,
+                                  posScreen,
+                                  ordinal);
+
+  }
 
   // Update the map
-  ENGAUGE_ASSERT (!m_pointIdentifierToGraphicsPoint.contains (identifier));
-  m_pointIdentifierToGraphicsPoint [identifier] = point;
+  ENGAUGE_ASSERT (!m_pointIdentifierToGraphicsPoint.contains (pointId));
+  m_pointIdentifierToGraphicsPoint [pointId] = point;
 
   return point;
 }
 
-MapOrdinalToPointIdentifier GraphicsScene::createMapOrdinalToPointIdentifier ()
+void GraphicsScene::batchPendingPoints ()
 {
-  // Start with empty map
-  MapOrdinalToPointIdentifier map;
+  // The mouse grabber cannot be deleted between its press and release, so it stays pending until the release
+  QSet<PointId> pointIdsStillPending;
+  QGraphicsItem *grabber = mouseGrabberItem ();
+  bool grabberIsPoint = ((grabber != 0) &&
+                         (grabber->data (DATA_KEY_GRAPHICS_ITEM_TYPE).toInt () == GRAPHICS_ITEM_TYPE_POINT));
+  PointId pointIdGrabber = (grabberIsPoint ?
+                            (PointId) grabber->data (DATA_KEY_POINT_ID).toULongLong () :
+                            0);
+
+  QSet<PointId>::const_iterator itr;
+  for (itr = m_pointIdsToBatch.begin (); itr != m_pointIdsToBatch.end (); itr++) {
+    if (grabberIsPoint && (*itr == pointIdGrabber)) {
+      pointIdsStillPending.insert (*itr);
+    } else {
+      batchPoint (*itr);
+    }
+  }
 
-  PointIdentifierToGraphicsPoint::const_iterator itr;
-  for (itr = m_pointIdentifierToGraphicsPoint.begin (); itr != m_pointIdentifierToGraphicsPoint.end (); itr++) {
+  m_pointIdsToBatch = pointIdsStillPending;
+}
 
-    // Get item
-    QString pointIdentifier = itr.key();
-    GraphicsPoint *point = itr.value();
+void GraphicsScene::batchPoint (PointId pointId)
+{
+  GraphicsPoint *pointOld = m_pointIdentifierToGraphicsPoint.value (pointId);
+  GraphicsPointsForCurve *graphicsPointsForCurve = m_graphicsPointsForCurves.value (m_pointIdTable->curveName (pointId));
+
+  if ((pointOld != 0) &&
+      (pointOld->graphicsPointsForCurve () == 0) &&
+      (graphicsPointsForCurve != 0) &&
+      !m_selectedPointIds.contains (pointId)) {
+
+    GraphicsPoint *pointNew = new GraphicsPoint (*graphicsPointsForCurve,
+                                                 pointId,
+                                                 pointOld->pos (),
+                                                 pointOld->ordinal ());
+    if (!pointOld->wanted ()) {
+      pointNew->reset ();
+    }
+
+    delete pointOld;
+    m_positionHasChangedPointIds.remove (pointId);
+    m_pointIdentifierToGraphicsPoint [pointId] = pointNew;
+  }
+}
+
+void GraphicsScene::batchPointsForLargeCurves ()
+{
+  LOG4CPP_INFO_S ((*mainCat)) << "GraphicsScene::batchPointsForLargeCurves";
 
-    double ordinal = point->data (DATA_KEY_ORDINAL).toDouble ();;
+  if (!m_graphicsPointsForCurves.isEmpty ()) {
 
-    map [ordinal] = pointIdentifier;
+    QList<PointId> pointIds = m_pointIdentifierToGraphicsPoint.keys ();
+    QList<PointId>::const_iterator itr;
+    for (itr = pointIds.begin (); itr != pointIds.end (); itr++) {
+      batchPoint (*itr);
+    }
+  }
+
+  m_pointIdsToBatch.clear ();
+}
+
+#if !defined(QT_NO_DEBUG)
+void GraphicsScene::checkPointMembership (const Document &document) const
+{
+  LOG4CPP_INFO_S ((*mainCat)) << "GraphicsScene::checkPointMembership";
+
+  QStringList curveNames;
+  curveNames << AXIS_CURVE_NAME << document.curvesGraphsNames();
+
+  int numPoints = 0;
+  QStringList::const_iterator itrC;
+  for (itrC = curveNames.begin (); itrC != curveNames.end (); itrC++) {
+
+    const Curve *curve = document.curveForCurveName (*itrC);
+    ENGAUGE_CHECK_PTR (curve);
+
+    for (int index = 0; index < curve->numPointSlots (); index++) {
+
+      // Slots of removed Points have NULL_POINT_ID
+      PointId pointId = curve->pointIdAt (index);
+      if (pointId != NULL_POINT_ID) {
+
+        PointIdentifierToGraphicsPoint::const_iterator itr = m_pointIdentifierToGraphicsPoint.find (pointId);
+        ENGAUGE_ASSERT (itr != m_pointIdentifierToGraphicsPoint.end ());
+        ENGAUGE_ASSERT (itr.value()->pos () == curve->positionScreenAt (index));
+
+        ++numPoints;
+      }
+    }
   }
 
-  return map;
+  ENGAUGE_ASSERT (numPoints == m_pointIdentifierToGraphicsPoint.count ());
+}
+#endif
+
+bool GraphicsScene::dragSessionIsActive () const
+{
+  return m_dragSessionPointIds.count () > 0;
 }
 
 QString GraphicsScene::dumpCursors () const
@@ -88,7 +200,84 @@ QString GraphicsScene::dumpCursors () const
   return dump;
 }
 
-const QGraphicsPixmapItem *GraphicsScene::image () const
+GraphicsPoint *GraphicsScene::createPointWithItems (PointId pointId,
+                                                    const PointStyle &pointStyle,
+                                                    const QPointF &posScreen,
+                                                    double ordinal)
+{
+  QString identifier = m_pointIdTable->pointIdentifier (pointId);
+
+  GraphicsPointFactory pointFactory;
+  GraphicsPoint *point = pointFactory.createPoint (*this,
+                                                   pointId,
+                                                   identifier,
+                                                   posScreen,
+                                                   pointStyle,
+                                                   ordinal);
+
+  point->setToolTip (identifier);
+  point->setData (DATA_KEY_GRAPHICS_ITEM_TYPE, GRAPHICS_ITEM_TYPE_POINT);
+
+  return point;
+}
+
+void GraphicsScene::forgetPoint (PointId pointId)
+{
+  m_positionHasChangedPointIds.remove (pointId);
+  m_selectedPointIds.remove (pointId);
+  m_pointIdsToBatch.remove (pointId);
+
+  --m_curvePointCounts [m_pointIdTable->curveName (pointId)];
+}
+
+GraphicsPointsForCurve *GraphicsScene::graphicsPointsForCurve (const QString &curveName,
+                                                               const PointStyle &pointStyle)
+{
+  GraphicsPointsForCurve *graphicsPointsForCurve = m_graphicsPointsForCurves.value (curveName);
+  if (graphicsPointsForCurve == 0) {
+
+    LOG4CPP_INFO_S ((*mainCat)) << "GraphicsScene::graphicsPointsForCurve"
+                                << " curve=" << curveName.toLatin1().data();
+
+    graphicsPointsForCurve = new GraphicsPointsForCurve (pointStyle);
+    addItem (graphicsPointsForCurve);
+    m_graphicsPointsForCurves [curveName] = graphicsPointsForCurve;
+  }
+
+  return graphicsPointsForCurve;
+}
+
+bool GraphicsScene::hasSelectedPoints () const
+{
+  return !m_selectedPointIds.isEmpty ();
+}
+
+void GraphicsScene::helpEvent (QGraphicsSceneHelpEvent *helpEvent)
+{
+  // Items above the batched points, including points with their own graphics items, keep their own tooltips
+  QList<QGraphicsItem*> itemsAtPos = items (helpEvent->scenePos ());
+  if (!itemsAtPos.isEmpty () &&
+      (itemsAtPos.first ()->data (DATA_KEY_GRAPHICS_ITEM_TYPE).toInt () == GRAPHICS_ITEM_TYPE_POINTS_FOR_CURVE)) {
+
+    const GraphicsPointsForCurve *graphicsPointsForCurve = dynamic_cast<const GraphicsPointsForCurve*> (itemsAtPos.first ());
+
+    PointId pointId;
+    if ((graphicsPointsForCurve != 0) &&
+        graphicsPointsForCurve->pointAt (helpEvent->scenePos (),
+                                         pointId)) {
+
+      QToolTip::showText (helpEvent->screenPos (),
+                          m_pointIdTable->pointIdentifier (pointId),
+                          helpEvent->widget ());
+      helpEvent->setAccepted (true);
+      return;
+    }
+  }
+
+  QGraphicsScene::helpEvent (helpEvent);
+}
+
+const QGraphicsItem *GraphicsScene::image () const
 {
   // Loop through items in scene to find the image
   QList<QGraphicsItem*> items = QGraphicsScene::items();
@@ -98,7 +287,7 @@ const QGraphicsPixmapItem *GraphicsScene::image () const
     QGraphicsItem* item = *itr;
     if (item->data (DATA_KEY_GRAPHICS_ITEM_TYPE).toInt () == GRAPHICS_ITEM_TYPE_IMAGE) {
 
-      return (QGraphicsPixmapItem *) item;
+      return item;
     }
   }
 
@@ -106,87 +295,164 @@ const QGraphicsPixmapItem *GraphicsScene::image () const
   return 0;
 }
 
-double GraphicsScene::maxOrdinal () const
+void GraphicsScene::mousePressEvent (QGraphicsSceneMouseEvent *event)
 {
-  // LOG4CPP_INFO_S is on exit
+  // Points drawn by a GraphicsPointsForCurve cannot be pressed, so the point under the cursor gets its own graphics items
+  unbatchPointAt (event->scenePos ());
 
-  double maxOrdinal = 0;
+  // Selection is brought up to date first, since QGraphicsScene drags every selected item when the press is on a
+  // selected item, and otherwise just the pressed item or nothing at all
+  QGraphicsScene::mousePressEvent (event);
 
-  const QList<QGraphicsItem*> &items = QGraphicsScene::items();
-  QList<QGraphicsItem*>::const_iterator itr;
-  for (itr = items.begin(); itr != items.end(); itr++) {
+  m_dragSessionPointIds.clear ();
+  m_dragSessionCurveNames.clear ();
 
-    const QGraphicsItem *item = *itr;
+  QGraphicsItem *grabber = mouseGrabberItem ();
+  if ((grabber != 0) &&
+      (grabber->data (DATA_KEY_GRAPHICS_ITEM_TYPE).toInt () == GRAPHICS_ITEM_TYPE_POINT)) {
 
-    // Only look at the Points
-    bool isPoint = (item->data (DATA_KEY_GRAPHICS_ITEM_TYPE).toInt () == GRAPHICS_ITEM_TYPE_POINT);
-    if (isPoint) {
+    QSet<PointId> pointIds = m_selectedPointIds;
+    if (!grabber->isSelected ()) {
+      pointIds.insert ((PointId) grabber->data (DATA_KEY_POINT_ID).toULongLong ());
+    }
 
-      // Save if max value so far
-      double ordinal = item->data (DATA_KEY_ORDINAL).toDouble ();
-      maxOrdinal = qMax (maxOrdinal, ordinal);
+    QSet<PointId>::const_iterator itr;
+    for (itr = pointIds.begin (); itr != pointIds.end (); itr++) {
+
+      PointId pointId = *itr;
+      m_dragSessionPointIds.push_back (pointId);
+      m_dragSessionCurveNames.insert (m_pointIdTable->curveName (pointId));
     }
   }
 
-  LOG4CPP_INFO_S ((*mainCat)) << "GraphicsScene::maxOrdinal maxOrdinal=" << maxOrdinal;
+  LOG4CPP_INFO_S ((*mainCat)) << "GraphicsScene::mousePressEvent"
+                              << " dragSessionPoints=" << m_dragSessionPointIds.count ()
+                              << " dragSessionCurves=" << m_dragSessionCurveNames.count ();
 
-  return maxOrdinal;
+  batchPendingPoints ();
 }
 
-QStringList GraphicsScene::positionHasChangedPointIdentifiers () const
+void GraphicsScene::mouseReleaseEvent (QGraphicsSceneMouseEvent *event)
 {
-  LOG4CPP_INFO_S ((*mainCat)) << "GraphicsScene::positionHasChangedPointIdentifiers";
-
-  QStringList movedIds;
+  LOG4CPP_INFO_S ((*mainCat)) << "GraphicsScene::mouseReleaseEvent";
 
-  const QList<QGraphicsItem*> &items = QGraphicsScene::items();
-  QList<QGraphicsItem*>::const_iterator itr;
-  for (itr = items.begin(); itr != items.end(); itr++) {
+  QGraphicsScene::mouseReleaseEvent (event);
 
-    const QGraphicsItem *item = *itr;
+  m_dragSessionPointIds.clear ();
+  m_dragSessionCurveNames.clear ();
 
-    // Skip the image and only keep the Points
-    bool isPoint = (item->data (DATA_KEY_GRAPHICS_ITEM_TYPE).toInt () == GRAPHICS_ITEM_TYPE_POINT);
-    if (isPoint) {
+  batchPendingPoints ();
+}
 
-      QString identifier = item->data (DATA_KEY_IDENTIFIER).toString ();
-      bool positionHasChanged = item->data (DATA_KEY_POSITION_HAS_CHANGED).toBool ();
+void GraphicsScene::pointPositionHasChanged (PointId pointId)
+{
+  m_positionHasChangedPointIds.insert (pointId);
+}
 
-      LOG4CPP_DEBUG_S ((*mainCat)) << "GraphicsScene::positionHasChangedPointIdentifiers"
-                                   << " identifier=" << identifier.toLatin1().data()
-                                   << " positionHasChanged=" << (positionHasChanged ? "yes" : "no");
+void GraphicsScene::pointSelectionHasChanged (PointId pointId,
+                                              bool isSelected)
+{
+  if (isSelected) {
+    m_selectedPointIds.insert (pointId);
+    m_pointIdsToBatch.remove (pointId);
+  } else {
+    m_selectedPointIds.remove (pointId);
+    if (m_graphicsPointsForCurves.contains (m_pointIdTable->curveName (pointId))) {
+      m_pointIdsToBatch.insert (pointId);
+    }
+  }
+}
 
-      if (isPoint && positionHasChanged) {
+QStringList GraphicsScene::positionHasChangedPointIdentifiers () const
+{
+  LOG4CPP_INFO_S ((*mainCat)) << "GraphicsScene::positionHasChangedPointIdentifiers"
+                              << " count=" << m_positionHasChangedPointIds.count ();
 
-        // Add Point to the list
-        movedIds << item->data(DATA_KEY_IDENTIFIER).toString ();
+  QStringList movedIds;
 
-      }
-    }
+  QSet<PointId>::const_iterator itr;
+  for (itr = m_positionHasChangedPointIds.begin (); itr != m_positionHasChangedPointIds.end (); itr++) {
+    movedIds << m_pointIdTable->pointIdentifier (*itr);
   }
 
   return  movedIds;
 }
 
+void GraphicsScene::removeAllPoints ()
+{
+  LOG4CPP_INFO_S ((*mainCat)) << "GraphicsScene::removeAllPoints";
+
+  PointIdentifierToGraphicsPoint::iterator itr;
+  for (itr = m_pointIdentifierToGraphicsPoint.begin (); itr != m_pointIdentifierToGraphicsPoint.end (); itr++) {
+
+    forgetPoint (itr.key ());
+    delete itr.value ();
+  }
+
+  m_pointIdentifierToGraphicsPoint.clear ();
+  m_dragSessionPointIds.clear ();
+  m_dragSessionCurveNames.clear ();
+}
+
 void GraphicsScene::removePoint (const QString &identifier)
 {
   LOG4CPP_INFO_S ((*mainCat)) << "GraphicsScene::removePoint identifier=" << identifier.toLatin1().data();
 
-  GraphicsPoint *point = m_pointIdentifierToGraphicsPoint [identifier];
-  m_pointIdentifierToGraphicsPoint.remove (identifier);
-  delete point;
+  PointIdentifierToGraphicsPoint::iterator itr = m_pointIdentifierToGraphicsPoint.find (m_pointIdTable->pointId (identifier));
+  if (itr != m_pointIdentifierToGraphicsPoint.end ()) {
+
+    forgetPoint (itr.key ());
+    delete itr.value ();
+    m_pointIdentifierToGraphicsPoint.erase (itr);
+  }
 }
 
 void GraphicsScene::resetPositionHasChangedFlags()
 {
   LOG4CPP_INFO_S ((*mainCat)) << "GraphicsScene::resetPositionHasChangedFlags";
 
-  QList<QGraphicsItem*> itms = items ();
-  QList<QGraphicsItem*>::const_iterator itr;
-  for (itr = itms.begin (); itr != itms.end (); itr++) {
+  m_positionHasChangedPointIds.clear ();
+}
+
+void GraphicsScene::selectPointsForCurvesInArea (const QPainterPath &area,
+                                                 Qt::ItemSelectionOperation operation)
+{
+  LOG4CPP_DEBUG_S ((*mainCat)) << "GraphicsScene::selectPointsForCurvesInArea";
 
-    QGraphicsItem *item = *itr;
-    item->setData (DATA_KEY_POSITION_HAS_CHANGED, false);
+  if (operation == Qt::ReplaceSelection) {
+
+    // Points of large curves are selected by their centers, so a point the rubber band has moved off of is unselected
+    // even if QGraphicsScene::setSelectionArea still sees part of its shape in the area. Iterating over a copy since
+    // unselecting updates m_selectedPointIds
+    QSet<PointId> pointIdsSelected = m_selectedPointIds;
+    QSet<PointId>::const_iterator itrS;
+    for (itrS = pointIdsSelected.begin (); itrS != pointIdsSelected.end (); itrS++) {
+
+      PointId pointId = *itrS;
+      GraphicsPoint *point = m_pointIdentifierToGraphicsPoint.value (pointId);
+      if ((point != 0) &&
+          m_graphicsPointsForCurves.contains (m_pointIdTable->curveName (pointId)) &&
+          !area.contains (point->pos ())) {
+
+        point->setSelected (false);
+      }
+    }
+  }
+
+  QHash<QString, GraphicsPointsForCurve*>::const_iterator itr;
+  for (itr = m_graphicsPointsForCurves.begin (); itr != m_graphicsPointsForCurves.end (); itr++) {
+
+    const GraphicsPointsForCurve *graphicsPointsForCurve = itr.value ();
+    if (graphicsPointsForCurve->isVisible ()) {
+
+      QList<PointId> pointIds = graphicsPointsForCurve->pointsInArea (area);
+      QList<PointId>::const_iterator itrP;
+      for (itrP = pointIds.begin (); itrP != pointIds.end (); itrP++) {
+
+        unbatchPoint (*itrP);
+        m_pointIdentifierToGraphicsPoint [*itrP]->setSelected (true);
+      }
+    }
   }
 }
 
@@ -194,24 +460,25 @@ QStringList GraphicsScene::selectedPointIdentifiers () const
 {
   QStringList selectedIds;
 
-  const QList<QGraphicsItem*> &items = QGraphicsScene::items();
-  QList<QGraphicsItem*>::const_iterator itr;
-  for (itr = items.begin(); itr != items.end(); itr++) {
-
-    const QGraphicsItem* item = *itr;
+  QSet<PointId>::const_iterator itr;
+  for (itr = m_selectedPointIds.begin (); itr != m_selectedPointIds.end (); itr++) {
+    selectedIds << m_pointIdTable->pointIdentifier (*itr);
+  }
 
-    // Skip the image and only keep the Points
-    bool isPoint = (item->data (DATA_KEY_GRAPHICS_ITEM_TYPE).toInt () == GRAPHICS_ITEM_TYPE_POINT);
-    bool isSelected = item->isSelected ();
-    if (isPoint && isSelected) {
+  return  selectedIds;
+}
 
-      // Add Point to the list
-      selectedIds << item->data(DATA_KEY_IDENTIFIER).toString ();
+void GraphicsScene::setPointPosition (PointId pointId,
+                                      const QPointF &posScreen)
+{
+  PointIdentifierToGraphicsPoint::const_iterator itr = m_pointIdentifierToGraphicsPoint.find (pointId);
+  if (itr != m_pointIdentifierToGraphicsPoint.end ()) {
 
+    GraphicsPoint *point = itr.value ();
+    if (point->pos () != posScreen) {
+      point->setPos (posScreen);
     }
   }
-
-  return  selectedIds;
 }
 
 void GraphicsScene::showPoints (bool show,
@@ -230,8 +497,8 @@ void GraphicsScene::showPoints (bool show,
 
       bool showThisPoint = show;
       if (show && !showAll) {
-        QString identifier = item->data (DATA_KEY_IDENTIFIER).toString ();
-        QString curveNameGot = Point::curveNameFromPointIdentifier (identifier);
+        PointId pointId = (PointId) item->data (DATA_KEY_POINT_ID).toULongLong ();
+        QString curveNameGot = m_pointIdTable->curveName (pointId);
 
         showThisPoint = (curveNameWanted == curveNameGot);
       }
@@ -240,22 +507,106 @@ void GraphicsScene::showPoints (bool show,
 
     }
   }
+
+  QHash<QString, GraphicsPointsForCurve*>::const_iterator itrC;
+  for (itrC = m_graphicsPointsForCurves.begin (); itrC != m_graphicsPointsForCurves.end (); itrC++) {
+    itrC.value ()->setVisible (show && (showAll || (curveNameWanted == itrC.key ())));
+  }
+}
+
+void GraphicsScene::unbatchPoint (PointId pointId)
+{
+  GraphicsPoint *pointOld = m_pointIdentifierToGraphicsPoint.value (pointId);
+
+  if ((pointOld != 0) &&
+      (pointOld->graphicsPointsForCurve () != 0)) {
+
+    GraphicsPoint *pointNew = createPointWithItems (pointId,
+                                                    pointOld->graphicsPointsForCurve ()->pointStyle (),
+                                                    pointOld->pos (),
+                                                    pointOld->ordinal ());
+    if (!pointOld->wanted ()) {
+      pointNew->reset ();
+    }
+
+    delete pointOld;
+    m_pointIdentifierToGraphicsPoint [pointId] = pointNew;
+
+    // Batched again after the next mouse event, unless it gets selected
+    m_pointIdsToBatch.insert (pointId);
+  }
+}
+
+void GraphicsScene::unbatchPointAt (const QPointF &posScreen)
+{
+  QHash<QString, GraphicsPointsForCurve*>::const_iterator itr;
+  for (itr = m_graphicsPointsForCurves.begin (); itr != m_graphicsPointsForCurves.end (); itr++) {
+
+    const GraphicsPointsForCurve *graphicsPointsForCurve = itr.value ();
+
+    PointId pointId;
+    if (graphicsPointsForCurve->isVisible () &&
+        graphicsPointsForCurve->pointAt (posScreen,
+                                         pointId)) {
+      unbatchPoint (pointId);
+    }
+  }
 }
 
 void GraphicsScene::updateAfterCommand (CmdMediator &cmdMediator,
                                         bool linesAreAlreadyUpdated)
 {
-  LOG4CPP_INFO_S ((*mainCat)) << "GraphicsScene::updateAfterCommand";
+  const Document &document = cmdMediator.document ();
+  const DocumentChangeSet &changeSet = document.changeSet ();
+
+  LOG4CPP_INFO_S ((*mainCat)) << "GraphicsScene::updateAfterCommand"
+                              << " isFullUpdate=" << (changeSet.isFullUpdate () ? "true" : "false")
+                              << " added=" << changeSet.pointsAdded ().count ()
+                              << " removed=" << changeSet.pointsRemoved ().count ()
+                              << " moved=" << changeSet.pointsMoved ().count ()
+                              << " restyled=" << changeSet.curvesRestyled ().count ();
+
+  if (m_pointIdTable != document.pointIdTable ()) {
+
+    // PointIds of different Documents can collide, so the points of the previous Document are removed while its
+    // PointIdTable is still around for looking up their curves
+    removeAllPoints ();
+    m_pointIdTable = document.pointIdTable ();
+  }
+
+  if (changeSet.isFullUpdate ()) {
+
+    // Update the points
+    updatePointMembership (cmdMediator);
+    batchPointsForLargeCurves ();
+
+    if (!linesAreAlreadyUpdated) {
+
+      // Update the lines between the points
+      updateLineMembershipForPoints (cmdMediator);
+
+    }
 
-  // Update the points
-  updatePointMembership (cmdMediator);
+  } else {
 
-  if (!linesAreAlreadyUpdated) {
+    // Update just the points that changed
+    updatePointMembershipFromChanges (document,
+                                      changeSet);
 
-    // Update the lines between the points
-    updateLineMembershipForPoints (cmdMediator);
+    if (!linesAreAlreadyUpdated) {
 
+      // Update the lines of just the curves that changed
+      updateLineMembershipForCurves (document,
+                                     changeSet.curvesChanged (*m_pointIdTable));
+
+    }
+
+#if !defined(QT_NO_DEBUG)
+    checkPointMembership (document);
+#endif
   }
+
+  cmdMediator.document ().clearChangeSet ();
 }
 
 void GraphicsScene::updateCurveStyles (const CurveStyles &modelCurveStyles)
@@ -266,81 +617,144 @@ void GraphicsScene::updateCurveStyles (const CurveStyles &modelCurveStyles)
   PointIdentifierToGraphicsPoint::iterator itr;
   for (itr = m_pointIdentifierToGraphicsPoint.begin(); itr != m_pointIdentifierToGraphicsPoint.end(); itr++) {
 
-    QString pointIdentifier = itr.key();
+    PointId pointId = itr.key();
     GraphicsPoint *point = itr.value();
 
-    QString curveName = Point::curveNameFromPointIdentifier(pointIdentifier);
+    QString curveName = m_pointIdTable->curveName (pointId);
 
     CurveStyle curveStyle = modelCurveStyles.curveStyle(curveName);
 
     point->updateCurveStyle (curveStyle);
   }
+
+  QHash<QString, GraphicsPointsForCurve*>::iterator itrC;
+  for (itrC = m_graphicsPointsForCurves.begin (); itrC != m_graphicsPointsForCurves.end (); itrC++) {
+    itrC.value ()->setPointStyle (modelCurveStyles.pointStyle (itrC.key ()));
+  }
 }
 
-void GraphicsScene::updateGraphicsLinesToMatchGraphicsPoints (const CurveStyles &curveStyles,
-                                                              const Transformation &transformation)
+void GraphicsScene::updateGraphicsLinesForDragSession (const CurveStyles &curveStyles,
+                                                       const Transformation &transformation)
 {
-  LOG4CPP_INFO_S ((*mainCat)) << "GraphicsScene::updateGraphicsLinesToMatchGraphicsPoints";
+  updateGraphicsLinesForPoints (m_dragSessionPointIds,
+                                m_dragSessionCurveNames,
+                                curveStyles,
+                                transformation);
+}
 
-  // Ordinals must be updated to reflect reordering that may have resulted from dragging points
-  m_graphicsLinesForCurves.updatePointOrdinalsAfterDrag (curveStyles,
-                                                         transformation);
+void GraphicsScene::updateGraphicsLinesForPoints (const QVector<PointId> &pointIds,
+                                                  const QSet<QString> &curveNames,
+                                                  const CurveStyles &curveStyles,
+                                                  const Transformation &transformation)
+{
+  LOG4CPP_INFO_S ((*mainCat)) << "GraphicsScene::updateGraphicsLinesForPoints"
+                              << " points=" << pointIds.count ()
+                              << " curves=" << curveNames.count ();
 
-  // Loop through items in scene and process all items. Note that the ordinal values
-  // just set by updateOrdinalsAfterDrag in m_graphicsLinesForCurves override the ordinal values
-  // in QGraphicsItem::data. This algorithm is slow since it processes all items versus just a few selected items
-  QList<QGraphicsItem*> items = QGraphicsScene::items();
-  QList<QGraphicsItem*>::iterator itr;
-  for (itr = items.begin(); itr != items.end(); itr++) {
+  // Bring the line positions of the points up to date
+  QVector<PointId>::const_iterator itr;
+  for (itr = pointIds.begin (); itr != pointIds.end (); itr++) {
 
-    QGraphicsItem* item = *itr;
-    if (item->data (DATA_KEY_GRAPHICS_ITEM_TYPE).toInt () == GRAPHICS_ITEM_TYPE_POINT) {
+    PointId pointId = *itr;
 
-      QString pointIdentifier = item->data (DATA_KEY_IDENTIFIER).toString();
+    PointIdentifierToGraphicsPoint::const_iterator itrG = m_pointIdentifierToGraphicsPoint.find (pointId);
+    if (itrG != m_pointIdentifierToGraphicsPoint.end ()) {
 
-      m_graphicsLinesForCurves.moveLinesWithDraggedPoint (pointIdentifier,
-                                                            item->scenePos ());
+      m_graphicsLinesForCurves.moveLinesWithDraggedPoint (m_pointIdTable->curveName (pointId),
+                                                          pointId,
+                                                          itrG.value ()->pos ());
     }
   }
 
+  // Ordinals must be updated to reflect reordering that may have resulted from dragging points. Note that the ordinal
+  // values set by updatePointOrdinalsAfterDrag in m_graphicsLinesForCurves override the ordinal values in QGraphicsItem::data
+  m_graphicsLinesForCurves.updatePointOrdinalsAfterDrag (curveNames,
+                                                         curveStyles,
+                                                         transformation);
+
   // Recompute the lines one time for efficiency
-  m_graphicsLinesForCurves.updateGraphicsLinesToMatchGraphicsPoints (curveStyles);
+  m_graphicsLinesForCurves.updateGraphicsLinesToMatchGraphicsPoints (curveNames,
+                                                                     curveStyles);
 }
 
-void GraphicsScene::updateLineMembershipForPoints (CmdMediator &cmdMediator)
+void GraphicsScene::updateGraphicsLinesToMatchGraphicsPoints (const QVector<PointId> &pointIds,
+                                                              const CurveStyles &curveStyles,
+                                                              const Transformation &transformation)
 {
-  LOG4CPP_INFO_S ((*mainCat)) << "GraphicsScene::updateLineMembershipForPoints";
+  LOG4CPP_INFO_S ((*mainCat)) << "GraphicsScene::updateGraphicsLinesToMatchGraphicsPoints";
 
-  // Create a sorted map of ordinal to point identifier
-  MapOrdinalToPointIdentifier mapOrdinalToPointIdentifier = createMapOrdinalToPointIdentifier();
+  QSet<QString> curveNames;
+  for (int i = 0; i < pointIds.count (); i++) {
+    curveNames.insert (m_pointIdTable->curveName (pointIds.at (i)));
+  }
 
-  // Names of axis and graph curves
-  QStringList curveNames;
-  curveNames << AXIS_CURVE_NAME << cmdMediator.document().curvesGraphsNames();
+  updateGraphicsLinesForPoints (pointIds,
+                                curveNames,
+                                curveStyles,
+                                transformation);
+}
 
-  // Initialize before saving points
-  m_graphicsLinesForCurves.updateStart();
+void GraphicsScene::updateLineMembershipForCurves (const Document &document,
+                                                   const QSet<QString> &curveNames)
+{
+  LOG4CPP_INFO_S ((*mainCat)) << "GraphicsScene::updateLineMembershipForCurves";
+
+  CurveStyles curveStyles = document.modelCurveStyles ();
+
+  QSet<QString>::const_iterator itrC;
+  for (itrC = curveNames.begin (); itrC != curveNames.end (); itrC++) {
+
+    const QString &curveName = *itrC;
+    const Curve *curve = document.curveForCurveName (curveName);
+    ENGAUGE_CHECK_PTR (curve);
+
+    m_graphicsLinesForCurves.updateStartForCurve (curveName);
+
+    // Same as updateLineMembershipForPoints, but only the points in this curve are saved. The ordinals are taken from
+    // the GraphicsPoints rather than the Document so both updates give the same lines
+    for (int index = 0; index < curve->numPointSlots (); index++) {
 
-  // Iterate through all points. The order, and grouping by curve, is not important since the
-  // ordering and grouping is handled afterwards by updateFinish
-  MapOrdinalToPointIdentifier::const_iterator itr;
-  for (itr = mapOrdinalToPointIdentifier.begin (); itr != mapOrdinalToPointIdentifier.end (); itr++) {
+      // Slots of removed Points have NULL_POINT_ID
+      PointId pointId = curve->pointIdAt (index);
+      if (pointId != NULL_POINT_ID) {
 
-    // Get point identifier for this ordinal
-    QString pointIdentifier = itr.value();
+        PointIdentifierToGraphicsPoint::const_iterator itr = m_pointIdentifierToGraphicsPoint.find (pointId);
+        ENGAUGE_ASSERT (itr != m_pointIdentifierToGraphicsPoint.end ());
+        GraphicsPoint *point = itr.value ();
 
-    // Get point
-    GraphicsPoint *point = m_pointIdentifierToGraphicsPoint [pointIdentifier];
+        m_graphicsLinesForCurves.savePoint (*this,
+                                            curveName,
+                                            pointId,
+                                            point->ordinal (),
+                                            *point);
+      }
+    }
+
+    m_graphicsLinesForCurves.updateFinishForCurve (curveName,
+                                                   curveStyles);
+  }
+}
+
+void GraphicsScene::updateLineMembershipForPoints (CmdMediator &cmdMediator)
+{
+  LOG4CPP_INFO_S ((*mainCat)) << "GraphicsScene::updateLineMembershipForPoints";
+
+  // Initialize before saving points
+  m_graphicsLinesForCurves.updateStart();
 
-    // Get parameters for the item
-    QString curveNameGot = Point::curveNameFromPointIdentifier (pointIdentifier);
-    double ordinal = point->data (DATA_KEY_ORDINAL).toDouble ();
+  // Iterate through all points. The order, and grouping by curve, is not important since each GraphicsLinesForCurve
+  // keeps its own points sorted by ordinal
+  PointIdentifierToGraphicsPoint::const_iterator itr;
+  for (itr = m_pointIdentifierToGraphicsPoint.begin (); itr != m_pointIdentifierToGraphicsPoint.end (); itr++) {
+
+    PointId pointId = itr.key();
+    GraphicsPoint *point = itr.value();
 
     // Save entry even if entry already exists
     m_graphicsLinesForCurves.savePoint (*this,
-                                        curveNameGot,
-                                        pointIdentifier,
-                                        ordinal,
+                                        m_pointIdTable->curveName (pointId),
+                                        pointId,
+                                        point->ordinal (),
                                         *point);
   }
 
@@ -385,6 +799,7 @@ void GraphicsScene::updatePointMembership (CmdMediator &cmdMediator)
 
     if (!point->wanted ()) {
 
+      forgetPoint (itr.key ());
       delete point;
 
       // Update map
@@ -392,3 +807,73 @@ void GraphicsScene::updatePointMembership (CmdMediator &cmdMediator)
     }
   }
 }
+
+void GraphicsScene::updatePointMembershipFromChanges (const Document &document,
+                                                      const DocumentChangeSet &changeSet)
+{
+  LOG4CPP_INFO_S ((*mainCat)) << "GraphicsScene::updatePointMembershipFromChanges";
+
+  QSet<PointId>::const_iterator itr;
+
+  // Remove points first, since a point identifier may be removed and then added again by one command
+  for (itr = changeSet.pointsRemoved ().begin (); itr != changeSet.pointsRemoved ().end (); itr++) {
+
+    PointIdentifierToGraphicsPoint::iterator itrG = m_pointIdentifierToGraphicsPoint.find (*itr);
+    if (itrG != m_pointIdentifierToGraphicsPoint.end ()) {
+
+      forgetPoint (*itr);
+      delete itrG.value ();
+      m_pointIdentifierToGraphicsPoint.erase (itrG);
+    }
+  }
+
+  for (itr = changeSet.pointsAdded ().begin (); itr != changeSet.pointsAdded ().end (); itr++) {
+
+    PointId pointId = *itr;
+
+    const Curve *curve = document.curveForCurveName (m_pointIdTable->curveName (pointId));
+    ENGAUGE_CHECK_PTR (curve);
+
+    if (m_pointIdentifierToGraphicsPoint.contains (pointId)) {
+
+      setPointPosition (pointId,
+                        curve->positionScreen (pointId));
+
+    } else {
+
+      addPoint (pointId,
+                curve->curveStyle().pointStyle (),
+                curve->positionScreen (pointId));
+
+    }
+  }
+
+  for (itr = changeSet.pointsMoved ().begin (); itr != changeSet.pointsMoved ().end (); itr++) {
+
+    setPointPosition (*itr,
+                      document.positionScreen (*itr));
+  }
+
+  // Restyle the points in the restyled curves. Their lines are restyled by updateLineMembershipForCurves
+  QSet<QString>::const_iterator itrC;
+  for (itrC = changeSet.curvesRestyled ().begin (); itrC != changeSet.curvesRestyled ().end (); itrC++) {
+
+    const Curve *curve = document.curveForCurveName (*itrC);
+    ENGAUGE_CHECK_PTR (curve);
+
+    CurveStyle curveStyle = curve->curveStyle ();
+
+    if (m_graphicsPointsForCurves.contains (*itrC)) {
+      m_graphicsPointsForCurves [*itrC]->setPointStyle (curveStyle.pointStyle ());
+    }
+
+    for (int index = 0; index < curve->numPointSlots (); index++) {
+
+      // Slots of removed Points have NULL_POINT_ID, which is never in the map
+      PointIdentifierToGraphicsPoint::const_iterator itrG = m_pointIdentifierToGraphicsPoint.find (curve->pointIdAt (index));
+      if (itrG != m_pointIdentifierToGraphicsPoint.end ()) {
+        itrG.value ()->updateCurveStyle (curveStyle);
+      }
+    }
+  }
+}
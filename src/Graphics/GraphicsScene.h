@@ -4,23 +4,29 @@
 #include "CmdMediator.h"
 #include "GraphicsLinesForCurves.h"
 #include "PointIdentifierToGraphicsPoint.h"
+#include "PointIdTable.h"
 #include <QGraphicsScene>
 #include <QHash>
-#include <QMap>
+#include <QSet>
+#include <QSharedPointer>
 #include <QStringList>
+#include <QVector>
 
 class CmdMediator;
 class Curve;
 class CurvesGraphs;
 class CurveStyles;
+class Document;
+class DocumentChangeSet;
 class GraphicsPoint;
+class GraphicsPointsForCurve;
 class MainWindow;
 class PointStyle;
+class QPainterPath;
+class QGraphicsSceneHelpEvent;
+class QGraphicsSceneMouseEvent;
 class Transformation;
 
-// Map ordinals to corresponding point identifiers. This augments the map from point identifier to GraphicsPoint
-typedef QMap<double, QString> MapOrdinalToPointIdentifier;
-
 /// Add point and line handling to generic QGraphicsScene. The primary tasks are:
 /// -# update the graphics items to stay in sync with the explicit Points in the Document
 /// -# update the graphics items to stay in sync with the implicit lines between the Points, according to Document settings
@@ -33,53 +39,150 @@ public:
   /// Single constructor.
   GraphicsScene(MainWindow *mainWindow);
 
-  /// Add one QGraphicsItem-based object that represents one Point.
+  /// Add one QGraphicsItem-based object that represents one Point. Once a curve has many Points, its new Points are
+  /// drawn by a single GraphicsPointsForCurve rather than by their own QGraphicsItems
+  GraphicsPoint *addPoint (PointId pointId,
+                           const PointStyle &pointStyle,
+                           const QPointF &posScreen);
+
+  /// Same as the other addPoint, for a Point that is not in the Document (like a temporary point) so its identifier
+  /// is interned first
   GraphicsPoint *addPoint (const QString &identifier,
                            const PointStyle &pointStyle,
                            const QPointF &posScreen);
 
-  /// Return a list of identifiers for the points that have moved since the last call to resetPositionHasChanged.
+  /// True if a drag session is in progress, with at least one Point that may be dragged. A drag session starts at a mouse
+  /// press on a Point and stops at the mouse release. While hovering there is no drag session
+  bool dragSessionIsActive () const;
+
+  /// True if at least one point is selected. This is a constant time query of the selected point set
+  bool hasSelectedPoints () const;
+
+  /// Called by the point graphics items when their position changes, to add the point to the moved point set
+  void pointPositionHasChanged (PointId pointId);
+
+  /// Called by the point graphics items when they are selected or unselected, to update the selected point set
+  void pointSelectionHasChanged (PointId pointId,
+                                 bool isSelected);
+
+  /// Return a list of identifiers for the points that have moved since the last call to resetPositionHasChanged. Cost
+  /// is proportional to the number of moved points
   QStringList positionHasChangedPointIdentifiers () const;
 
   /// Remove specified point
   void removePoint (const QString &identifier);
 
-  /// Reset positionHasChanged flag for all items. Typically this is done as part of mousePressEvent.
+  /// Empty the moved point set. Typically this is done as part of mousePressEvent.
   void resetPositionHasChangedFlags();
 
-  /// Return a list of identifiers for the currently selected points.
+  /// Select the Points drawn by any GraphicsPointsForCurve inside the area, which QGraphicsScene::setSelectionArea
+  /// cannot see since they have no graphics items of their own. Typically this is done on every change of a rubber
+  /// band. With ReplaceSelection, the selected Points of those curves whose centers have left the area are unselected,
+  /// and with AddToSelection they stay selected
+  void selectPointsForCurvesInArea (const QPainterPath &area,
+                                    Qt::ItemSelectionOperation operation);
+
+  /// Return a list of identifiers for the currently selected points. Cost is proportional to the number of selected points
   QStringList selectedPointIdentifiers () const;
 
+  /// Move the specified point to the specified position, if it is not already there. The point is found by a direct
+  /// lookup, rather than by iterating through all items in the scene
+  void setPointPosition (PointId pointId,
+                         const QPointF &posScreen);
+
   /// Show or hide all the Points in the Curves (if showAll is true) or just the selected Curve (if showAll is false);
   void showPoints (bool show,
                    bool showAll = false,
                    const QString &curveName = "");
 
   /// Update the Points and their Curves after executing a command. After a mouse drag, the lines are already updated and
-  /// updating would be done on out of date information (since that would be brought up to date by the NEXT command)
+  /// updating would be done on out of date information (since that would be brought up to date by the NEXT command).
+  ///
+  /// Only the changes recorded in the Document change set are applied, so the cost depends on the size of the edit. The
+  /// full multi-pass update is only performed when the change set asks for it, like after a new Document is loaded
   void updateAfterCommand (CmdMediator &cmdMediator,
                            bool linesAreAlreadyUpdated);
 
   /// Update curve styles after settings changed.
   void updateCurveStyles(const CurveStyles &modelCurveStyles);
 
-  /// A mouse move has just occurred so move the selected points, since they were dragged. The transformation is needed
-  /// so the screen coordinates can be converted to graph coordinates when updating point ordinals
-  void updateGraphicsLinesToMatchGraphicsPoints (const CurveStyles &modelCurveStyles,
+  /// Points in the drag session may have just been dragged, so update the lines of their curves. The transformation is
+  /// needed so the screen coordinates can be converted to graph coordinates when updating point ordinals
+  void updateGraphicsLinesForDragSession (const CurveStyles &modelCurveStyles,
+                                          const Transformation &transformation);
+
+  /// The specified points have just been moved, so update the lines of their curves. Other curves are left alone
+  void updateGraphicsLinesToMatchGraphicsPoints (const QVector<PointId> &pointIds,
+                                                 const CurveStyles &modelCurveStyles,
                                                  const Transformation &transformation);
 
+protected:
+  /// Show the identifier of a Point drawn by a GraphicsPointsForCurve as its tooltip, since it has no graphics item
+  /// of its own to hold one
+  virtual void helpEvent (QGraphicsSceneHelpEvent *helpEvent);
+
+  /// Start the drag session after QGraphicsScene has updated the selection
+  virtual void mousePressEvent (QGraphicsSceneMouseEvent *event);
+
+  /// Stop the drag session
+  virtual void mouseReleaseEvent (QGraphicsSceneMouseEvent *event);
+
 private:
 
-  /// Create internal, temporary map of ordinal to point identifier
-  MapOrdinalToPointIdentifier createMapOrdinalToPointIdentifier ();
+#if !defined(QT_NO_DEBUG)
+  /// Consistency check, for debug builds, that the Points in the scene are exactly the Points in the Document. This
+  /// visits every Point so it is much slower than applying the change set
+  void checkPointMembership (const Document &document) const;
+#endif
 
   /// Dump all important cursors
   QString dumpCursors () const;
 
-  const QGraphicsPixmapItem *image () const;
+  /// Move unselected Points of large curves back into their GraphicsPointsForCurve, after they were given their own
+  /// QGraphicsItems for a mouse press or selection
+  void batchPendingPoints ();
+
+  /// Move one Point from its own QGraphicsItems into the GraphicsPointsForCurve of its curve
+  void batchPoint (PointId pointId);
+
+  /// Move every unselected Point of a large curve into its GraphicsPointsForCurve. This visits every Point so it is only
+  /// done after a full update
+  void batchPointsForLargeCurves ();
 
-  /// Max ordinal of the Points.
-  double maxOrdinal () const;
+  /// Create a Point with its own QGraphicsItems
+  GraphicsPoint *createPointWithItems (PointId pointId,
+                                       const PointStyle &pointStyle,
+                                       const QPointF &posScreen,
+                                       double ordinal);
+
+  /// Remove the point from the moved and selected point sets, just before its graphics items are deleted. Deleted items
+  /// do not report that they are no longer selected
+  void forgetPoint (PointId pointId);
+
+  /// Return the GraphicsPointsForCurve of the curve, creating it if it does not exist yet
+  GraphicsPointsForCurve *graphicsPointsForCurve (const QString &curveName,
+                                                  const PointStyle &pointStyle);
+
+  const QGraphicsItem *image () const;
+
+  /// Remove every Point. This is done when switching to the PointIdTable of another Document
+  void removeAllPoints ();
+
+  /// Give the Point its own QGraphicsItems so it can be selected and dragged, if it is drawn by a GraphicsPointsForCurve
+  void unbatchPoint (PointId pointId);
+
+  /// Give the Point under the cursor its own QGraphicsItems, if it is drawn by a GraphicsPointsForCurve
+  void unbatchPointAt (const QPointF &posScreen);
+
+  /// Move the lines attached to the specified points, and redraw the lines of the specified curves
+  void updateGraphicsLinesForPoints (const QVector<PointId> &pointIds,
+                                     const QSet<QString> &curveNames,
+                                     const CurveStyles &curveStyles,
+                                     const Transformation &transformation);
+
+  /// Update lines of just the specified curves, from the Points in the Document that belong to those curves
+  void updateLineMembershipForCurves (const Document &document,
+                                      const QSet<QString> &curveNames);
 
   /// Update lines using a multi-pass algorithm, from points in m_graphicsLinesForCurves that were previously replicated
   /// from the points in CmdMediator. This method should never, for simplicity, try to access any points in CmdMediator
@@ -88,9 +191,37 @@ private:
   /// Update Points using a multi-pass algorithm.
   void updatePointMembership (CmdMediator &cmdMediator);
 
+  /// Update Points by applying the added, removed, moved and restyled Points in the change set
+  void updatePointMembershipFromChanges (const Document &document,
+                                         const DocumentChangeSet &changeSet);
+
+  /// PointIdTable of the Document whose Points are shown. It is shared with the Document, and replaced when a command
+  /// arrives from another Document
+  QSharedPointer<PointIdTable> m_pointIdTable;
+
   /// Mapping for finding Points.
   PointIdentifierToGraphicsPoint m_pointIdentifierToGraphicsPoint;
 
+  /// Points that may be dragged in the current drag session, and their curves. Both are empty outside of a drag session
+  QVector<PointId> m_dragSessionPointIds;
+  QSet<QString> m_dragSessionCurveNames;
+
+  /// Points that have moved since the last resetPositionHasChangedFlags, and points that are selected. Both are kept
+  /// up to date by the point graphics items, so queries never have to scan every item in the scene
+  QSet<PointId> m_positionHasChangedPointIds;
+  QSet<PointId> m_selectedPointIds;
+
+  /// GraphicsPointsForCurve of each curve that has had enough Points for batching, and the number of Points per curve
+  QHash<QString, GraphicsPointsForCurve*> m_graphicsPointsForCurves;
+  QHash<QString, int> m_curvePointCounts;
+
+  /// Points of large curves that were unselected while they had their own QGraphicsItems. They are batched again after
+  /// the mouse event, since graphics items cannot be deleted from inside their own itemChange
+  QSet<PointId> m_pointIdsToBatch;
+
+  /// Largest ordinal given to a Point so far. Each new Point gets the next ordinal, so lines follow the creation order
+  double m_maxOrdinal;
+
   /// Curve name to GraphicsLinesForCurve
   GraphicsLinesForCurves m_graphicsLinesForCurves;
 };
@@ -1,5 +1,6 @@
 #include "DataKey.h"
 #include "GraphicsItemType.h"
+#include "GraphicsScene.h"
 #include "GraphicsView.h"
 #include "Logger.h"
 #include "MainWindow.h"
@@ -11,6 +12,7 @@
 #include <QGraphicsScene>
 #include <QMimeData>
 #include <QMouseEvent>
+#include <QPainterPath>
 #include <QScrollBar>
 #include "QtToString.h"
 
@@ -18,7 +20,8 @@ extern const QString AXIS_CURVE_NAME;
 
 GraphicsView::GraphicsView(QGraphicsScene *scene,
                            MainWindow &mainWindow) :
-  QGraphicsView (scene)
+  QGraphicsView (scene),
+  m_rubberBandSelectionOperation (Qt::ReplaceSelection)
 {
   connect (this, SIGNAL (signalContextMenuEvent (QString)), &mainWindow, SLOT (slotContextMenuEvent (QString)));
   connect (this, SIGNAL (signalDraggedImage (QImage)), &mainWindow, SLOT (slotFileImportDraggedImage (QImage)));
@@ -197,6 +200,12 @@ void GraphicsView::mouseMoveEvent (QMouseEvent *event)
   emit signalMouseMove (posScreen);
 
   QGraphicsView::mouseMoveEvent (event);
+
+  // Points of large curves are highlighted while the rubber band is dragged, just like the points with their own items
+  QRect rubberBand = rubberBandRect ();
+  if (!rubberBand.isEmpty ()) {
+    selectPointsForCurvesInRubberBand (rubberBand);
+  }
 }
 
 void GraphicsView::mousePressEvent (QMouseEvent *event)
@@ -211,6 +220,11 @@ void GraphicsView::mousePressEvent (QMouseEvent *event)
 
   }
 
+  bool extendSelection = ((event->modifiers () & Qt::ControlModifier) != 0);
+  m_rubberBandSelectionOperation = (extendSelection ?
+                                    Qt::AddToSelection :
+                                    Qt::ReplaceSelection);
+
   QGraphicsView::mousePressEvent (event);
 }
 
@@ -233,5 +247,29 @@ void GraphicsView::mouseReleaseEvent (QMouseEvent *event)
 
   }
 
+  // Rubber band has to be saved before QGraphicsView::mouseReleaseEvent clears it
+  QRect rubberBand = rubberBandRect ();
+
   QGraphicsView::mouseReleaseEvent (event);
+
+  // Final rubber band, in case there was no mouse move since it last changed
+  if (!rubberBand.isEmpty ()) {
+    selectPointsForCurvesInRubberBand (rubberBand);
+  }
+}
+
+void GraphicsView::selectPointsForCurvesInRubberBand (const QRect &rubberBand)
+{
+  // QGraphicsView selected the points that have their own graphics items, but not those that are drawn by a
+  // GraphicsPointsForCurve
+  GraphicsScene *graphicsScene = dynamic_cast<GraphicsScene*> (scene ());
+  if (graphicsScene != 0) {
+
+    QPainterPath area;
+    area.addPolygon (mapToScene (rubberBand));
+    area.closeSubpath ();
+
+    graphicsScene->selectPointsForCurvesInArea (area,
+                                                m_rubberBandSelectionOperation);
+  }
 }
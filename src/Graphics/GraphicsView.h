@@ -76,6 +76,12 @@ private:
   GraphicsView();
 
   bool inBounds (const QPointF &posScreen);
+
+  // Select the Points of large curves inside the rubber band, since QGraphicsView only selects items of their own
+  void selectPointsForCurvesInRubberBand (const QRect &rubberBand);
+
+  // Rubber band adds to the selection when Control is held at the press, like in QGraphicsView
+  Qt::ItemSelectionOperation m_rubberBandSelectionOperation;
 };
 
 #endif // GRAPHICSVIEW_H
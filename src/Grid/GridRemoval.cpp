@@ -0,0 +1,570 @@
+#include "DocumentModelCoords.h"
+#include "DocumentModelGridRemoval.h"
+#include "EngaugeAssert.h"
+#include "GridRemoval.h"
+#include "Logger.h"
+#include <QImage>
+#include <qmath.h>
+#include "Transformation.h"
+
+// Sanity limit so a bad combination of start, step and stop cannot hang the application
+const int MAX_GRID_LINES = 1000;
+
+// Tolerance so a stop value that is an exact multiple of the step is not lost to roundoff
+const double COUNT_EPSILON = 1e-6;
+
+// Curved lines (constant radius in polar coordinates) are first sampled coarsely to estimate their length in pixels,
+// then sampled finely enough that each straight piece is no longer than a couple of pixels
+const int COARSE_SAMPLES = 64;
+const double MAX_PIXELS_PER_SAMPLE = 2.0;
+const int MAX_SAMPLES = 100000;
+
+// Distance squared values are saturated at this value, which is far beyond the largest close distance. Pixels that are
+// DISTANCE_MAX or more away from a line, along either axis, cannot be affected by that line
+const quint16 DISTANCE_SQUARED_MAX = 65535;
+const int DISTANCE_MAX = 256;
+const double DISTANCE_SQUARED_INFINITY = 1e20;
+
+// Staleness is checked after this many columns or rows of the distance transform, which is a few milliseconds of work
+const int LINES_PER_STALE_CHECK = 32;
+
+GridRemoval::GridRemoval(double scale) :
+  m_scale (scale),
+  m_coordsType (COORDS_TYPE_CARTESIAN),
+  m_coordScaleXTheta (COORD_SCALE_LINEAR),
+  m_coordScaleYRadius (COORD_SCALE_LINEAR),
+  m_originRadius (0.0),
+  m_imageSourceKey (0),
+  m_closeDistanceSquaredRemoved (0),
+  m_rgbBackgroundRemoved (0)
+{
+}
+
+QRect GridRemoval::boundingRectOfPixels (const GridLinePixels &pixels) const
+{
+  if (pixels.isEmpty ()) {
+    return QRect ();
+  }
+
+  int xMin = pixels.first ().x(), xMax = xMin;
+  int yMin = pixels.first ().y(), yMax = yMin;
+  for (int i = 1; i < pixels.count (); i++) {
+    const QPoint &p = pixels.at (i);
+    xMin = qMin (xMin, p.x());
+    xMax = qMax (xMax, p.x());
+    yMin = qMin (yMin, p.y());
+    yMax = qMax (yMax, p.y());
+  }
+
+  return QRect (QPoint (xMin, yMin),
+                QPoint (xMax, yMax));
+}
+
+bool GridRemoval::computeDistanceField (const QRect &rectBand,
+                                        const QAtomicInt *generationLatest,
+                                        int generation)
+{
+  LOG4CPP_INFO_S ((*mainCat)) << "GridRemoval::computeDistanceField"
+                              << " left=" << rectBand.left()
+                              << " top=" << rectBand.top()
+                              << " width=" << rectBand.width()
+                              << " height=" << rectBand.height();
+
+  int width = m_imageSize.width();
+
+  // Seeds farther than DISTANCE_MAX from the band only produce saturated distances inside it, so the transform runs
+  // over a window around the band rather than over the whole image
+  QRect rectWindow = rectBand.adjusted (-DISTANCE_MAX,
+                                        -DISTANCE_MAX,
+                                        DISTANCE_MAX,
+                                        DISTANCE_MAX) & QRect (QPoint (0, 0), m_imageSize);
+  int windowLeft = rectWindow.left();
+  int windowTop = rectWindow.top();
+  int windowWidth = rectWindow.width();
+  int windowHeight = rectWindow.height();
+
+  // Seed the grid line pixels of both axes. Pass 1 computes, in each column, the distance in rows to the nearest seed.
+  // Column distances saturate at NO_SEED, which is already beyond the saturated distance
+  const quint16 NO_SEED = DISTANCE_MAX + 1;
+  QVector<quint16> columnDistance (windowWidth * windowHeight, NO_SEED);
+  for (int axis = 0; axis < 2; axis++) {
+    const GridLinesPixels &linesPixels = (axis == 0 ? m_linesPixelsX : m_linesPixelsY);
+    GridLinesPixels::const_iterator itr;
+    for (itr = linesPixels.begin (); itr != linesPixels.end (); itr++) {
+      const GridLinePixels &pixels = itr.value ();
+      for (int i = 0; i < pixels.count (); i++) {
+        const QPoint &p = pixels.at (i);
+        if (rectWindow.contains (p)) {
+          columnDistance [(p.x() - windowLeft) + (p.y() - windowTop) * windowWidth] = 0;
+        }
+      }
+    }
+  }
+
+  for (int x = 0; x < windowWidth; x++) {
+
+    if ((x % LINES_PER_STALE_CHECK == 0) &&
+        isStale (generationLatest, generation)) {
+      return false;
+    }
+
+    for (int y = 1; y < windowHeight; y++) {
+      quint16 &d = columnDistance [x + y * windowWidth];
+      d = qMin (d, (quint16) qMin (columnDistance [x + (y - 1) * windowWidth] + 1, (int) NO_SEED));
+    }
+    for (int y = windowHeight - 2; y >= 0; y--) {
+      quint16 &d = columnDistance [x + y * windowWidth];
+      d = qMin (d, (quint16) qMin (columnDistance [x + (y + 1) * windowWidth] + 1, (int) NO_SEED));
+    }
+  }
+
+  // Pass 2 computes, in each row of the band, the lower envelope of the parabolas rooted at the column distances. This
+  // is the exact squared euclidean distance transform of Felzenszwalb and Huttenlocher
+  QVector<double> f (windowWidth), z (windowWidth + 1);
+  QVector<int> v (windowWidth);
+  for (int y = rectBand.top(); y <= rectBand.bottom(); y++) {
+
+    if (((y - rectBand.top()) % LINES_PER_STALE_CHECK == 0) &&
+        isStale (generationLatest, generation)) {
+      return false;
+    }
+
+    int yWindow = y - windowTop;
+    for (int x = 0; x < windowWidth; x++) {
+      int g = columnDistance [x + yWindow * windowWidth];
+      f [x] = (g == NO_SEED ? DISTANCE_SQUARED_INFINITY : (double) g * g);
+    }
+
+    int k = 0;
+    v [0] = 0;
+    z [0] = -DISTANCE_SQUARED_INFINITY;
+    z [1] = DISTANCE_SQUARED_INFINITY;
+    for (int q = 1; q < windowWidth; q++) {
+      double s = ((f [q] + (double) q * q) - (f [v [k]] + (double) v [k] * v [k])) / (2.0 * (q - v [k]));
+      while (s <= z [k]) {
+        --k;
+        s = ((f [q] + (double) q * q) - (f [v [k]] + (double) v [k] * v [k])) / (2.0 * (q - v [k]));
+      }
+      ++k;
+      v [k] = q;
+      z [k] = s;
+      z [k + 1] = DISTANCE_SQUARED_INFINITY;
+    }
+
+    k = 0;
+    for (int q = 0; q < windowWidth; q++) {
+      while (z [k + 1] < q) {
+        ++k;
+      }
+      int x = q + windowLeft;
+      if ((rectBand.left() <= x) && (x <= rectBand.right())) {
+        double distanceSquared = (double) (q - v [k]) * (q - v [k]) + f [v [k]];
+        m_distanceField [x + y * width] = (distanceSquared < DISTANCE_SQUARED_MAX ?
+                                           (quint16) distanceSquared :
+                                           DISTANCE_SQUARED_MAX);
+      }
+    }
+  }
+
+  return true;
+}
+
+void GridRemoval::computeGraphCoordinateLimits (const Transformation &transformation,
+                                                double &xMin,
+                                                double &xMax,
+                                                double &yMin,
+                                                double &yMax) const
+{
+  // Screen corners of the full resolution image
+  double width = m_imageSize.width() / m_scale;
+  double height = m_imageSize.height() / m_scale;
+
+  QPointF posGraphTL, posGraphTR, posGraphBL, posGraphBR;
+  transformation.transformScreenToRawGraph (QPointF (0, 0)         , posGraphTL);
+  transformation.transformScreenToRawGraph (QPointF (width, 0)     , posGraphTR);
+  transformation.transformScreenToRawGraph (QPointF (0, height)    , posGraphBL);
+  transformation.transformScreenToRawGraph (QPointF (width, height), posGraphBR);
+
+  if (m_coordsType == COORDS_TYPE_CARTESIAN) {
+
+    // For affine cartesian coordinates, we only need to look at the screen corners
+    xMin = qMin (qMin (qMin (posGraphTL.x(), posGraphTR.x()), posGraphBL.x()), posGraphBR.x());
+    xMax = qMax (qMax (qMax (posGraphTL.x(), posGraphTR.x()), posGraphBL.x()), posGraphBR.x());
+    yMin = qMin (qMin (qMin (posGraphTL.y(), posGraphTR.y()), posGraphBL.y()), posGraphBR.y());
+    yMax = qMax (qMax (qMax (posGraphTL.y(), posGraphTR.y()), posGraphBL.y()), posGraphBR.y());
+
+  } else {
+
+    // For polar coordinates, use the full circle out to the farthest corner
+    xMin = 0.0;
+    xMax = transformation.modelCoords().thetaPeriod();
+    yMin = (m_coordScaleYRadius == COORD_SCALE_LOG ? m_originRadius : 0.0);
+    yMax = qMax (qMax (qMax (posGraphTL.y(), posGraphTR.y()), posGraphBL.y()), posGraphBR.y());
+
+  }
+}
+
+void GridRemoval::flushIfTransformationChanged (const Transformation &transformation,
+                                                const QSize &imageSize)
+{
+  DocumentModelCoords modelCoords = transformation.modelCoords();
+
+  if ((m_imageSize != imageSize) ||
+      (m_transform != transformation.transformMatrix()) ||
+      (m_coordsType != modelCoords.coordsType()) ||
+      (m_coordScaleXTheta != modelCoords.coordScaleXTheta()) ||
+      (m_coordScaleYRadius != modelCoords.coordScaleYRadius()) ||
+      (m_originRadius != modelCoords.originRadius())) {
+
+    LOG4CPP_INFO_S ((*mainCat)) << "GridRemoval::flushIfTransformationChanged flushing";
+
+    m_imageSize = imageSize;
+    m_transform = transformation.transformMatrix();
+    m_coordsType = modelCoords.coordsType();
+    m_coordScaleXTheta = modelCoords.coordScaleXTheta();
+    m_coordScaleYRadius = modelCoords.coordScaleYRadius();
+    m_originRadius = modelCoords.originRadius();
+
+    m_linesPixelsX.clear ();
+    m_linesPixelsY.clear ();
+    m_distanceField.fill (DISTANCE_SQUARED_MAX,
+                          imageSize.width() * imageSize.height());
+    m_rectPending = QRect ();
+
+    m_imageSourceKey = 0;
+    m_imageSource = QImage ();
+    m_imageRemoved = QImage ();
+  }
+}
+
+QList<double> GridRemoval::gridLineValues (GridCoordDisable gridCoordDisable,
+                                           CoordScale coordScale,
+                                           int count,
+                                           double start,
+                                           double step,
+                                           double stop)
+{
+  QList<double> values;
+
+  bool isLog = (coordScale == COORD_SCALE_LOG);
+  if (isLog && ((start <= 0) || (stop <= 0))) {
+    return values;
+  }
+
+  // Derive the disabled value from the other three
+  switch (gridCoordDisable) {
+    case GRID_COORD_DISABLE_COUNT:
+      if ((isLog && step <= 1.0) || (!isLog && step <= 0.0)) {
+        return values;
+      }
+      count = 1 + (int) ((isLog ?
+                          qLn (stop / start) / qLn (step) :
+                          (stop - start) / step) + COUNT_EPSILON);
+      break;
+
+    case GRID_COORD_DISABLE_START:
+      start = (isLog ?
+               stop / qPow (step, count - 1.0) :
+               stop - step * (count - 1.0));
+      break;
+
+    case GRID_COORD_DISABLE_STEP:
+      if (count > 1) {
+        step = (isLog ?
+                qPow (stop / start, 1.0 / (count - 1.0)) :
+                (stop - start) / (count - 1.0));
+      }
+      break;
+
+    case GRID_COORD_DISABLE_STOP:
+      break;
+
+    default:
+      ENGAUGE_ASSERT (false);
+  }
+
+  // Multiple lines need a step that moves forward
+  if ((count > 1) &&
+      ((isLog && step <= 1.0) || (!isLog && step <= 0.0))) {
+    return values;
+  }
+
+  for (int i = 0; i < qMin (count, MAX_GRID_LINES); i++) {
+    values << (isLog ?
+               start * qPow (step, i) :
+               start + step * i);
+  }
+
+  return values;
+}
+
+bool GridRemoval::isStale (const QAtomicInt *generationLatest,
+                           int generation) const
+{
+  return (generationLatest != 0) &&
+         (generationLatest->load () != generation);
+}
+
+void GridRemoval::maskImage (const QRect &rect,
+                             quint16 closeDistanceSquared,
+                             QRgb rgbBackground)
+{
+  int width = m_imageSize.width();
+  const quint16 *distance = m_distanceField.constData ();
+  for (int y = rect.top(); y <= rect.bottom(); y++) {
+    const QRgb *lineSource = (const QRgb *) m_imageSource.constScanLine (y);
+    QRgb *lineRemoved = (QRgb *) m_imageRemoved.scanLine (y);
+    for (int x = rect.left(); x <= rect.right(); x++) {
+      lineRemoved [x] = (distance [x + y * width] <= closeDistanceSquared ?
+                         rgbBackground :
+                         lineSource [x]);
+    }
+  }
+}
+
+void GridRemoval::rasterizeGridLine (const Transformation &transformation,
+                                     bool isConstantX,
+                                     double value,
+                                     double otherMin,
+                                     double otherMax,
+                                     GridLinePixels &pixels) const
+{
+  bool isLogOther = (isConstantX ?
+                     m_coordScaleYRadius == COORD_SCALE_LOG :
+                     m_coordScaleXTheta == COORD_SCALE_LOG);
+  bool isLogValue = (isConstantX ?
+                     m_coordScaleXTheta == COORD_SCALE_LOG :
+                     m_coordScaleYRadius == COORD_SCALE_LOG);
+
+  pixels.clear ();
+
+  if ((isLogValue && value <= 0) ||
+      (isLogOther && otherMin <= 0)) {
+    return;
+  }
+
+  // Lines of constant x or y are straight in cartesian coordinates, and so are lines of constant theta in polar
+  // coordinates, even with log scaling since log scaling is applied separately to each coordinate. Only lines of
+  // constant radius in polar coordinates are curved
+  bool isCurved = (m_coordsType == COORDS_TYPE_POLAR) && !isConstantX;
+
+  int numSamples = 2;
+  for (int pass = 0; pass < (isCurved ? 2 : 1); pass++) {
+
+    if (isCurved && pass == 0) {
+      numSamples = COARSE_SAMPLES;
+    }
+
+    QVector<QPointF> posScreen (numSamples);
+    double length = 0;
+    for (int i = 0; i < numSamples; i++) {
+
+      double s = (double) i / (double) (numSamples - 1);
+      double other = (isLogOther ?
+                      qExp ((1.0 - s) * qLn (otherMin) + s * qLn (otherMax)) :
+                      (1.0 - s) * otherMin + s * otherMax);
+
+      transformation.transformRawGraphToScreen (isConstantX ? QPointF (value, other) : QPointF (other, value),
+                                                posScreen [i]);
+      posScreen [i] *= m_scale;
+
+      if (i > 0) {
+        QPointF delta = posScreen [i] - posScreen [i - 1];
+        length += qSqrt (delta.x() * delta.x() + delta.y() * delta.y());
+      }
+    }
+
+    if (isCurved && pass == 0) {
+
+      // Pick the fine sample count for the second pass
+      numSamples = qMin (MAX_SAMPLES,
+                         qMax (COARSE_SAMPLES, (int) (length / MAX_PIXELS_PER_SAMPLE) + 1));
+
+    } else {
+
+      for (int i = 1; i < numSamples; i++) {
+        rasterizeSegment (posScreen [i - 1],
+                          posScreen [i],
+                          pixels);
+      }
+    }
+  }
+}
+
+void GridRemoval::rasterizeSegment (const QPointF &posStart,
+                                    const QPointF &posEnd,
+                                    GridLinePixels &pixels) const
+{
+  if (!qIsFinite (posStart.x()) || !qIsFinite (posStart.y()) ||
+      !qIsFinite (posEnd.x()) || !qIsFinite (posEnd.y())) {
+    return;
+  }
+
+  QPointF delta = posEnd - posStart;
+  int numSteps = qCeil (qMax (qAbs (delta.x()), qAbs (delta.y())));
+  numSteps = qMax (1, numSteps);
+
+  for (int i = 0; i <= numSteps; i++) {
+
+    double s = (double) i / (double) numSteps;
+    QPoint p (qFloor (posStart.x() + s * delta.x()),
+              qFloor (posStart.y() + s * delta.y()));
+
+    if ((0 <= p.x()) && (p.x() < m_imageSize.width()) &&
+        (0 <= p.y()) && (p.y() < m_imageSize.height())) {
+
+      // Skip duplicates of the previous pixel, which happen at the shared endpoints of adjacent segments
+      if (pixels.isEmpty () || pixels.last () != p) {
+        pixels.push_back (p);
+      }
+    }
+  }
+}
+
+bool GridRemoval::removeGridLines (const Transformation &transformation,
+                                   const DocumentModelGridRemoval &modelGridRemoval,
+                                   QRgb rgbBackground,
+                                   QImage &image,
+                                   const QAtomicInt *generationLatest,
+                                   int generation)
+{
+  LOG4CPP_INFO_S ((*mainCat)) << "GridRemoval::removeGridLines";
+
+  if (!transformation.transformIsDefined() ||
+      !modelGridRemoval.removeDefinedGridLines() ||
+      (modelGridRemoval.closeDistance() <= 0)) {
+    return true;
+  }
+
+  flushIfTransformationChanged (transformation,
+                                image.size ());
+
+  double xMin, xMax, yMin, yMax;
+  computeGraphCoordinateLimits (transformation,
+                                xMin,
+                                xMax,
+                                yMin,
+                                yMax);
+
+  QList<double> valuesX = gridLineValues (modelGridRemoval.gridCoordDisableX(),
+                                          m_coordScaleXTheta,
+                                          modelGridRemoval.countX(),
+                                          modelGridRemoval.startX(),
+                                          modelGridRemoval.stepX(),
+                                          modelGridRemoval.stopX());
+  QList<double> valuesY = gridLineValues (modelGridRemoval.gridCoordDisableY(),
+                                          m_coordScaleYRadius,
+                                          modelGridRemoval.countY(),
+                                          modelGridRemoval.startY(),
+                                          modelGridRemoval.stepY(),
+                                          modelGridRemoval.stopY());
+
+  // Changed lines stay in the pending rectangle until the distance field has caught up, so abandoned work is redone
+  updateGridLines (transformation, true, valuesX, yMin, yMax, m_linesPixelsX, m_rectPending);
+  if (isStale (generationLatest, generation)) {
+    return false;
+  }
+  updateGridLines (transformation, false, valuesY, xMin, xMax, m_linesPixelsY, m_rectPending);
+  if (isStale (generationLatest, generation)) {
+    return false;
+  }
+
+  // Only the band around the lines that changed needs its distance field recomputed
+  QRect rectImage (QPoint (0, 0), m_imageSize);
+  QRect rectBand;
+  if (!m_rectPending.isNull ()) {
+    rectBand = m_rectPending.adjusted (-DISTANCE_MAX,
+                                       -DISTANCE_MAX,
+                                       DISTANCE_MAX,
+                                       DISTANCE_MAX) & rectImage;
+    if (!computeDistanceField (rectBand,
+                               generationLatest,
+                               generation)) {
+      return false;
+    }
+    m_rectPending = QRect ();
+  }
+
+  if (m_linesPixelsX.isEmpty () && m_linesPixelsY.isEmpty ()) {
+
+    // Nothing to remove. The cached masked image no longer matches the distance field
+    m_imageRemoved = QImage ();
+    return true;
+  }
+
+  // Close distance is in full resolution pixels, while the distance field is in pixels of the processed image
+  double closeDistance = modelGridRemoval.closeDistance() * m_scale;
+  quint16 closeDistanceSquared = (quint16) qMin ((double) DISTANCE_SQUARED_MAX - 1,
+                                                 closeDistance * closeDistance);
+
+  if (m_imageRemoved.isNull () ||
+      (m_imageSourceKey != image.cacheKey ()) ||
+      (m_closeDistanceSquaredRemoved != closeDistanceSquared) ||
+      (m_rgbBackgroundRemoved != rgbBackground)) {
+
+    // Different image or threshold, so mask every pixel
+    m_imageSourceKey = image.cacheKey ();
+    if ((image.format () != QImage::Format_RGB32) &&
+        (image.format () != QImage::Format_ARGB32)) {
+      m_imageSource = image.convertToFormat (QImage::Format_RGB32);
+    } else {
+      m_imageSource = image;
+    }
+    m_imageRemoved = m_imageSource;
+    m_closeDistanceSquaredRemoved = closeDistanceSquared;
+    m_rgbBackgroundRemoved = rgbBackground;
+
+    maskImage (rectImage,
+               closeDistanceSquared,
+               rgbBackground);
+
+  } else if (!rectBand.isNull ()) {
+
+    // Same image as last time, so only the band around the lines that changed is masked again
+    maskImage (rectBand,
+               closeDistanceSquared,
+               rgbBackground);
+  }
+
+  image = m_imageRemoved;
+
+  return true;
+}
+
+void GridRemoval::updateGridLines (const Transformation &transformation,
+                                   bool isConstantX,
+                                   const QList<double> &values,
+                                   double otherMin,
+                                   double otherMax,
+                                   GridLinesPixels &linesPixels,
+                                   QRect &rectChanged) const
+{
+  // Remove lines that are no longer wanted
+  GridLinesPixels::iterator itr = linesPixels.begin ();
+  while (itr != linesPixels.end ()) {
+    if (values.contains (itr.key ())) {
+      ++itr;
+    } else {
+      rectChanged |= boundingRectOfPixels (itr.value ());
+      itr = linesPixels.erase (itr);
+    }
+  }
+
+  // Rasterize lines that are new
+  QList<double>::const_iterator itrValue;
+  for (itrValue = values.begin (); itrValue != values.end (); itrValue++) {
+    double value = *itrValue;
+    if (!linesPixels.contains (value)) {
+
+      GridLinePixels pixels;
+      rasterizeGridLine (transformation,
+                         isConstantX,
+                         value,
+                         otherMin,
+                         otherMax,
+                         pixels);
+      linesPixels [value] = pixels;
+      rectChanged |= boundingRectOfPixels (pixels);
+    }
+  }
+}
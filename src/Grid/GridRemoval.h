@@ -0,0 +1,150 @@
+#ifndef GRID_REMOVAL_H
+#define GRID_REMOVAL_H
+
+#include "CoordScale.h"
+#include "CoordsType.h"
+#include "GridCoordDisable.h"
+#include <QAtomicInt>
+#include <QImage>
+#include <QList>
+#include <QMap>
+#include <QPoint>
+#include <QRect>
+#include <QRgb>
+#include <QSize>
+#include <QTransform>
+#include <QVector>
+
+class DocumentModelCoords;
+class DocumentModelGridRemoval;
+class Transformation;
+
+/// Pixels along one rasterized grid line, in screen coordinates
+typedef QVector<QPoint> GridLinePixels;
+
+/// Rasterized grid lines keyed by their graph coordinate value
+typedef QMap<double, GridLinePixels> GridLinesPixels;
+
+/// Squared pixel distance from the nearest grid line of either axis, one entry per pixel in row-major order
+typedef QVector<quint16> GridDistanceField;
+
+/// Pipeline stage that removes pixels close to the defined grid lines of DocumentModelGridRemoval. This stage
+/// sits between the original image and ColorFilter::filterImage, with removed pixels set to the background
+/// color so they are then filtered out.
+///
+/// This class uses the following tricks for faster performance:
+/// -# Each grid line is rasterized in screen space once, through the inverse transformation, and cached by its value.
+///    Changing a grid parameter only rasterizes the lines that did not exist before
+/// -# The distance field saturates a little over 255 pixels from the lines, so adding or removing a line only changes
+///    the field in a band around that line. Only that band is recomputed, and the lines of the other axis are reused
+/// -# The masked image is cached too, so when the same image comes back only the band is restored and masked again.
+///    Changing the close distance is just a threshold over the cached distance field
+/// -# The distance field holds squared distances so no square roots are needed
+class GridRemoval
+{
+public:
+  /// Single constructor. The scale converts screen coordinates into pixel coordinates of the processed image, and is
+  /// less than one when processing a downsampled level of an image pyramid
+  GridRemoval(double scale = 1.0);
+
+  /// Compute the graph coordinate values of the grid lines, from the three enabled values of start, step, stop and
+  /// count. For log scaling the step is a multiplicative factor
+  static QList<double> gridLineValues (GridCoordDisable gridCoordDisable,
+                                       CoordScale coordScale,
+                                       int count,
+                                       double start,
+                                       double step,
+                                       double stop);
+
+  /// Replace pixels in the image that are close to the defined grid lines by the background color. Noop if grid
+  /// line removal is disabled or the transformation is not yet defined. If generationLatest is given, the work is
+  /// abandoned as soon as it no longer equals generation, in which case false is returned, the image is left alone
+  /// and the unfinished work is picked up by the next call
+  bool removeGridLines (const Transformation &transformation,
+                        const DocumentModelGridRemoval &modelGridRemoval,
+                        QRgb rgbBackground,
+                        QImage &image,
+                        const QAtomicInt *generationLatest = 0,
+                        int generation = 0);
+
+private:
+
+  // Smallest rectangle that contains the pixels. Null if there are no pixels
+  QRect boundingRectOfPixels (const GridLinePixels &pixels) const;
+
+  // Compute the squared distance field inside the band using a separable exact euclidean distance transform. Seeds
+  // come from the lines of both axes. Returns false if abandoned for a newer generation
+  bool computeDistanceField (const QRect &rectBand,
+                             const QAtomicInt *generationLatest,
+                             int generation);
+
+  // Compute graph coordinate ranges that cover the image
+  void computeGraphCoordinateLimits (const Transformation &transformation,
+                                     double &xMin,
+                                     double &xMax,
+                                     double &yMin,
+                                     double &yMax) const;
+
+  // Flush the cache if the transformation or image size has changed since the last call
+  void flushIfTransformationChanged (const Transformation &transformation,
+                                     const QSize &imageSize);
+
+  // True if generationLatest is given and has moved on from generation
+  bool isStale (const QAtomicInt *generationLatest,
+                int generation) const;
+
+  // Replace pixels inside the rectangle whose distance is within the threshold by the background color, after
+  // restoring them from the source image
+  void maskImage (const QRect &rect,
+                  quint16 closeDistanceSquared,
+                  QRgb rgbBackground);
+
+  // Rasterize one screen segment into pixels, discarding pixels outside of the image
+  void rasterizeSegment (const QPointF &posStart,
+                         const QPointF &posEnd,
+                         GridLinePixels &pixels) const;
+
+  // Rasterize a line of constant x (isConstantX) or constant y, by sampling the other coordinate from its min to max
+  void rasterizeGridLine (const Transformation &transformation,
+                          bool isConstantX,
+                          double value,
+                          double otherMin,
+                          double otherMax,
+                          GridLinePixels &pixels) const;
+
+  // Bring the cached lines for one axis up to date. The bounding rectangle of the pixels of added and removed lines
+  // is merged into rectChanged
+  void updateGridLines (const Transformation &transformation,
+                        bool isConstantX,
+                        const QList<double> &values,
+                        double otherMin,
+                        double otherMax,
+                        GridLinesPixels &linesPixels,
+                        QRect &rectChanged) const;
+
+  double m_scale;
+
+  // Cache key. Any change to these invalidates everything
+  QSize m_imageSize;
+  QTransform m_transform;
+  CoordsType m_coordsType;
+  CoordScale m_coordScaleXTheta;
+  CoordScale m_coordScaleYRadius;
+  double m_originRadius;
+
+  // Cached lines and distance field. The pending rectangle covers lines that changed since the distance field and
+  // masked image were last brought up to date
+  GridLinesPixels m_linesPixelsX;
+  GridLinesPixels m_linesPixelsY;
+  GridDistanceField m_distanceField;
+  QRect m_rectPending;
+
+  // Cached masked image, which is reused while the same source image, threshold and background keep coming back
+  qint64 m_imageSourceKey;
+  QImage m_imageSource;
+  QImage m_imageRemoved;
+  quint16 m_closeDistanceSquaredRemoved;
+  QRgb m_rgbBackgroundRemoved;
+};
+
+#endif // GRID_REMOVAL_H
@@ -1,7 +1,8 @@
 #include "LoadImageFromUrl.h"
 #include "Logger.h"
 #include "MainWindow.h"
-#include <QFileInfo>
+#include <QBuffer>
+#include <QImageReader>
 #include <QMessageBox>
 #include <QtNetwork/QNetworkReply>
 #include <QUrl>
@@ -13,7 +14,8 @@ LoadImageFromUrl::LoadImageFromUrl (MainWindow &mainWindow) :
   m_reply (0),
   m_buffer (0)
 {
-  connect (this, SIGNAL (signalImportImage (QString, QImage)), &m_mainWindow, SLOT (slotFileImportImage (QString, QImage)));
+  connect (this, SIGNAL (signalImportData (QString, QByteArray)), &m_mainWindow, SLOT (slotFileImportData (QString, QByteArray)));
+  connect (this, SIGNAL (signalImportFile (QString)), &m_mainWindow, SLOT (slotFileImportFile (QString)));
 }
 
 LoadImageFromUrl::~LoadImageFromUrl ()
@@ -40,12 +42,13 @@ void LoadImageFromUrl::slotFinished ()
 
   QString urlWithoutScheme = m_url.toString (QUrl::RemoveScheme);
 
-  // Import
-  QImage image;
-  if (image.loadFromData (*m_buffer)) {
+  // Import. Decoding is left to MainWindow, but data that is obviously not an image is rejected here
+  QBuffer buffer (m_buffer);
+  buffer.open (QIODevice::ReadOnly);
+  if (!QImageReader::imageFormat (&buffer).isEmpty ()) {
 
-    emit signalImportImage (urlWithoutScheme,
-                            image);
+    emit signalImportData (urlWithoutScheme,
+                           *m_buffer);
   } else {
 
     // Images embedded in web pages produce html in m_buffer. No easy way to fix that. Even
@@ -70,14 +73,10 @@ void LoadImageFromUrl::startLoadImage (const QUrl &url)
   m_url = url;
   if (url.isLocalFile ()) {
 
-    QFileInfo fileInfo (url.toLocalFile ());
+    // Local file is decoded by MainWindow, after checking that it looks like an image file
+    if (!QImageReader::imageFormat (url.toLocalFile ()).isEmpty ()) {
 
-    // Load local file. This is done synchronously
-    QImage image;
-    if (image.load (url.toLocalFile ())) {
-
-      emit signalImportImage (fileInfo.fileName (),
-                              image);
+      emit signalImportFile (url.toLocalFile ());
 
     } else {
 
@@ -1,7 +1,7 @@
 #ifndef LOAD_IMAGE_FROM_URL_H
 #define LOAD_IMAGE_FROM_URL_H
 
-#include <QImage>
+#include <QByteArray>
 #include <QtNetwork/QNetworkAccessManager>
 #include <QObject>
 #include <QString>
@@ -10,7 +10,8 @@
 class MainWindow;
 class QUrl;
 
-/// Load QImage from url. This is trivial for a file, but requires an asynchronous download step for http urls.
+/// Load image from url. This is trivial for a file, but requires an asynchronous download step for http urls. In both
+/// cases MainWindow decodes the image in a LoadImageThread
 class LoadImageFromUrl : public QObject
 {
   Q_OBJECT;
@@ -28,8 +29,11 @@ private slots:
   void slotReadData ();
 
 signals:
-  /// Send the imported image to MainWindow. This completes the asynchronous loading of the image
-  void signalImportImage (QString, QImage);
+  /// Send the downloaded image data to MainWindow. This completes the asynchronous download of the image
+  void signalImportData (QString, QByteArray);
+
+  /// Send the local image file to MainWindow
+  void signalImportFile (QString);
 
 private:
   LoadImageFromUrl();
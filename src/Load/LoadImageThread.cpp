@@ -0,0 +1,146 @@
+#include "ColorFilter.h"
+#include "ColorFilterSettings.h"
+#include "LoadImageThread.h"
+#include "Logger.h"
+#include <QBuffer>
+#include <QImageReader>
+
+// Longer side of the preview. Images that already fit are not previewed, since decoding them is quick
+const int PREVIEW_SIZE = 1024;
+
+LoadImageThread::LoadImageThread(const QString &fileName) :
+  m_name (fileName),
+  m_fileName (fileName),
+  m_isDocumentImage (false),
+  m_stop (0)
+{
+}
+
+LoadImageThread::LoadImageThread(const QString &name,
+                                 const QByteArray &data,
+                                 bool isDocumentImage) :
+  m_name (name),
+  m_data (data),
+  m_isDocumentImage (isDocumentImage),
+  m_stop (0)
+{
+}
+
+QString LoadImageThread::fileName () const
+{
+  return m_fileName;
+}
+
+bool LoadImageThread::isDocumentImage () const
+{
+  return m_isDocumentImage;
+}
+
+void LoadImageThread::openReader (QImageReader &reader,
+                                  QBuffer &buffer)
+{
+  if (!m_fileName.isEmpty ()) {
+
+    reader.setFileName (m_fileName);
+
+  } else {
+
+    buffer.setBuffer (&m_data);
+    buffer.open (QIODevice::ReadOnly);
+    reader.setDevice (&buffer);
+  }
+}
+
+void LoadImageThread::run ()
+{
+  LOG4CPP_INFO_S ((*mainCat)) << "LoadImageThread::run name=" << m_name.toLatin1 ().data ();
+
+  // Preview, from a separate reader since a reader cannot be rewound after reading. Formats like jpeg decode a scaled
+  // image much faster than the full image, but formats without scaled reads would decode everything twice
+  QBuffer bufferPreview;
+  QImageReader readerPreview;
+  openReader (readerPreview,
+              bufferPreview);
+
+  // The image chunk of a Document is not previewed. Its curves are already shown, and a preview would cover them and
+  // change the zoom
+  QSize sizeFull = readerPreview.size ();
+  if (!m_isDocumentImage &&
+      sizeFull.isValid () &&
+      ((sizeFull.width () > PREVIEW_SIZE) || (sizeFull.height () > PREVIEW_SIZE)) &&
+      readerPreview.supportsOption (QImageIOHandler::ScaledSize)) {
+
+    readerPreview.setScaledSize (sizeFull.scaled (PREVIEW_SIZE,
+                                                  PREVIEW_SIZE,
+                                                  Qt::KeepAspectRatio));
+
+    QImage imagePreview = readerPreview.read ();
+    if (!imagePreview.isNull () && (m_stop.load () == 0)) {
+
+      emit signalTransferPreview (m_name,
+                                  imagePreview,
+                                  sizeFull);
+    }
+  }
+
+  if (m_stop.load () != 0) {
+    return;
+  }
+
+  // Full image
+  QBuffer buffer;
+  QImageReader reader;
+  openReader (reader,
+              buffer);
+
+  QImage image = reader.read ();
+  if (image.isNull ()) {
+
+    if (m_stop.load () == 0) {
+      emit signalTransferFailed (m_name,
+                                 reader.errorString ());
+    }
+
+    return;
+  }
+
+  if (m_stop.load () != 0) {
+    return;
+  }
+
+  // QPixmap can only be created in the GUI thread, so everything else is done here. The image gets the format that
+  // raster pixmaps use, so converting it to a pixmap in the GUI thread is a plain copy
+  image = image.convertToFormat (image.hasAlphaChannel () ?
+                                 QImage::Format_ARGB32_Premultiplied :
+                                 QImage::Format_RGB32);
+
+  // Same filtering as MainWindow::updateImages, for a new Document. Grid removal is skipped since a new Document has
+  // no transformation
+  QImage imageFiltered;
+  if (!m_isDocumentImage) {
+
+    ColorFilterSettings colorFilterSettings = ColorFilterSettings::defaultFilter ();
+    ColorFilter filter;
+    imageFiltered = QImage (image.width (),
+                            image.height (),
+                            QImage::Format_RGB32);
+    QRgb rgbBackground = filter.marginColor (&image);
+    filter.filterImage (image,
+                        imageFiltered,
+                        colorFilterSettings.colorFilterMode (),
+                        colorFilterSettings.low (),
+                        colorFilterSettings.high (),
+                        rgbBackground);
+  }
+
+  if (m_stop.load () == 0) {
+    emit signalTransferImage (m_name,
+                              image,
+                              imageFiltered);
+  }
+}
+
+void LoadImageThread::stop ()
+{
+  m_stop.store (1);
+}
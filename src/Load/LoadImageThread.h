@@ -0,0 +1,76 @@
+#ifndef LOAD_IMAGE_THREAD_H
+#define LOAD_IMAGE_THREAD_H
+
+#include <QAtomicInt>
+#include <QByteArray>
+#include <QImage>
+#include <QSize>
+#include <QString>
+#include <QThread>
+
+class QBuffer;
+class QImageReader;
+
+/// Thread for decoding an imported image, so large images do not freeze the user interface. When the image format
+/// supports scaled reads, a downscaled preview is sent first so it can be shown while the full image is decoded. There is
+/// no preview for the image chunk of a Document, since that would cost an extra decode and hide the curves. The
+/// full image is sent along with its filtered image for the default color filter, which is what a new Document starts
+/// out with, so MainWindow does not have to filter it again
+class LoadImageThread : public QThread
+{
+  Q_OBJECT;
+
+public:
+  /// Constructor for an image file
+  LoadImageThread(const QString &fileName);
+
+  /// Constructor for image data that was downloaded, or for the image chunk of a DocumentContainer file. The name is
+  /// only for display. The image chunk of a Document is not filtered, since the Document has its own filter settings
+  LoadImageThread(const QString &name,
+                  const QByteArray &data,
+                  bool isDocumentImage);
+
+  /// File that is being decoded, or empty if the image came from data
+  QString fileName () const;
+
+  /// True if the image is the image chunk of a Document, rather than an imported image
+  bool isDocumentImage () const;
+
+  /// Thread entry point
+  virtual void run ();
+
+  /// Stop sending results. Decoding cannot be interrupted, so this is typically followed by deleteLater once the
+  /// thread has finished
+  void stop ();
+
+signals:
+  /// Send the reason the image could not be decoded
+  void signalTransferFailed (QString name,
+                             QString reason);
+
+  /// Send the decoded image, already in the pixel format of a pixmap, and the image after color filtering with the
+  /// default filter. The filtered image is null for the image chunk of a Document
+  void signalTransferImage (QString name,
+                            QImage image,
+                            QImage imageFiltered);
+
+  /// Send the downscaled preview, and the size of the full image that it will be shown at
+  void signalTransferPreview (QString name,
+                              QImage imagePreview,
+                              QSize sizeFull);
+
+private:
+  LoadImageThread();
+
+  // Point the reader at the file, or at the data through the buffer
+  void openReader (QImageReader &reader,
+                   QBuffer &buffer);
+
+  QString m_name;
+  QString m_fileName;
+  QByteArray m_data;
+  bool m_isDocumentImage;
+  QAtomicInt m_stop;
+};
+
+#endif // LOAD_IMAGE_THREAD_H
@@ -11,7 +11,9 @@ unsigned int Point::m_identifierIndex = 0;
 
 const QString POINT_IDENTIFIER_DELIMITER ("_");
 
-Point::Point ()
+Point::Point () :
+  m_pointIdTable (0),
+  m_pointId (NULL_POINT_ID)
 {
 }
 
@@ -19,7 +21,8 @@ Point::Point(const QString &curveName,
              const QPointF &posScreen,
              double ordinal,
              const QPointF posGraph) :
-  m_identifier (uniqueIdentifierGenerator(curveName)),
+  m_pointIdTable (0),
+  m_pointId (NULL_POINT_ID),
   m_posScreen (posScreen),
   m_posGraph (posGraph),
   m_ordinal (ordinal)
@@ -27,12 +30,28 @@ Point::Point(const QString &curveName,
   ENGAUGE_ASSERT (!curveName.isEmpty ());
 }
 
-Point::Point(const QString &curveName,
+Point::Point(PointIdTable &pointIdTable,
+             const QString &curveName,
+             const QPointF &posScreen,
+             double ordinal,
+             const QPointF posGraph) :
+  m_pointIdTable (&pointIdTable),
+  m_pointId (pointIdTable.intern (uniqueIdentifierGenerator (curveName))),
+  m_posScreen (posScreen),
+  m_posGraph (posGraph),
+  m_ordinal (ordinal)
+{
+  ENGAUGE_ASSERT (!curveName.isEmpty ());
+}
+
+Point::Point(PointIdTable &pointIdTable,
+             const QString &curveName,
              const QPointF &posScreen,
              const QString &identifier,
              double ordinal,
              const QPointF posGraph) :
-  m_identifier (identifier),
+  m_pointIdTable (&pointIdTable),
+  m_pointId (pointIdTable.intern (identifier)),
   m_posScreen (posScreen),
   m_posGraph (posGraph),
   m_ordinal (ordinal)
@@ -40,16 +59,21 @@ Point::Point(const QString &curveName,
   ENGAUGE_ASSERT (!curveName.isEmpty ());
 }
 
-Point::Point (QXmlStreamReader &reader)
+Point::Point (PointIdTable &pointIdTable,
+              QXmlStreamReader &reader) :
+  m_pointIdTable (&pointIdTable),
+  m_pointId (NULL_POINT_ID)
 {
-  loadXml(reader);
+  loadXml(pointIdTable,
+          reader);
 }
 
 Point &Point::operator=(const Point &point)
 {
   m_posScreen = point.posScreen ();
   m_posGraph = point.posGraph ();
-  m_identifier = point.identifier ();
+  m_pointIdTable = point.m_pointIdTable;
+  m_pointId = point.pointId ();
   m_ordinal = point.ordinal ();
 
   return *this;
@@ -59,20 +83,33 @@ Point::Point (const Point &other)
 {
   m_posScreen = other.posScreen ();
   m_posGraph = other.posGraph ();
-  m_identifier = other.identifier ();
+  m_pointIdTable = other.m_pointIdTable;
+  m_pointId = other.pointId ();
   m_ordinal = other.ordinal ();
 }
 
-Point::Point (const QString &identifier,
-              double ordinal,
-              const QPointF &posScreen) :
-  m_identifier (identifier),
+Point::Point (const PointIdTable &pointIdTable,
+              PointId pointId,
+              const QPointF &posScreen,
+              const QPointF &posGraph,
+              double ordinal) :
+  m_pointIdTable (&pointIdTable),
+  m_pointId (pointId),
   m_posScreen (posScreen),
-  m_posGraph (0, 0),
+  m_posGraph (posGraph),
   m_ordinal (ordinal)
 {
 }
 
+QString Point::curveName () const
+{
+  if (m_pointIdTable == 0) {
+    return QString ();
+  }
+
+  return m_pointIdTable->curveName (m_pointId);
+}
+
 QString Point::curveNameFromPointIdentifier (const QString &pointIdentifier)
 {
   QStringList tokens = pointIdentifier.split (POINT_IDENTIFIER_DELIMITER);
@@ -81,7 +118,11 @@ QString Point::curveNameFromPointIdentifier (const QString &pointIdentifier)
 
 QString Point::identifier() const
 {
-  return m_identifier;
+  if (m_pointIdTable == 0) {
+    return QString ();
+  }
+
+  return m_pointIdTable->pointIdentifier (m_pointId);
 }
 
 unsigned int Point::identifierIndex ()
@@ -89,7 +130,8 @@ unsigned int Point::identifierIndex ()
   return m_identifierIndex;
 }
 
-void Point::loadXml(QXmlStreamReader &reader)
+void Point::loadXml(PointIdTable &pointIdTable,
+                    QXmlStreamReader &reader)
 {
   LOG4CPP_INFO_S ((*mainCat)) << "Point::loadXml";
 
@@ -101,7 +143,7 @@ void Point::loadXml(QXmlStreamReader &reader)
       attributes.hasAttribute(DOCUMENT_SERIALIZE_POINT_ORDINAL) &&
       attributes.hasAttribute(DOCUMENT_SERIALIZE_POINT_IDENTIFIER_INDEX)) {
 
-    m_identifier = attributes.value(DOCUMENT_SERIALIZE_POINT_IDENTIFIER).toString();
+    m_pointId = pointIdTable.intern (attributes.value(DOCUMENT_SERIALIZE_POINT_IDENTIFIER).toString());
     m_ordinal = attributes.value(DOCUMENT_SERIALIZE_POINT_ORDINAL).toDouble();
     m_identifierIndex = attributes.value(DOCUMENT_SERIALIZE_POINT_IDENTIFIER_INDEX).toInt();
 
@@ -166,6 +208,11 @@ QPointF Point::posGraph () const
   return m_posGraph;
 }
 
+PointId Point::pointId () const
+{
+  return m_pointId;
+}
+
 QPointF Point::posScreen () const
 {
   return m_posScreen;
@@ -176,7 +223,7 @@ void Point::saveXml(QXmlStreamWriter &writer) const
   LOG4CPP_INFO_S ((*mainCat)) << "Point::saveXml";
 
   writer.writeStartElement(DOCUMENT_SERIALIZE_POINT);
-  writer.writeAttribute(DOCUMENT_SERIALIZE_POINT_IDENTIFIER, m_identifier);
+  writer.writeAttribute(DOCUMENT_SERIALIZE_POINT_IDENTIFIER, identifier ());
   writer.writeAttribute(DOCUMENT_SERIALIZE_POINT_ORDINAL, QString::number (m_ordinal));
 
   // Variable m_identifierIndex is static, but for simplicity this is handled like other values. Those values are all
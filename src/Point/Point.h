@@ -1,6 +1,7 @@
 #ifndef POINT_H
 #define POINT_H
 
+#include "PointIdTable.h"
 #include <QPointF>
 #include <QString>
 
@@ -9,6 +10,8 @@ class QXmlStreamWriter;
 
 const double UNDEFINED_ORDINAL = -1.0;
 
+extern const QString POINT_IDENTIFIER_DELIMITER;
+
 /// Class that represents one digitized point. The screen-to-graph coordinate transformation is always external to this class
 class Point
 {
@@ -16,26 +19,40 @@ public:
   /// Default constructor so this class can be used inside a container
   Point ();
 
-  /// Constructor from scratch. The position, in screen coordinates, applies to the center of the Point
+  /// Constructor for a Point that does not belong to any Document, such as a candidate axis point that is being checked.
+  /// There is no identifier. The position, in screen coordinates, applies to the center of the Point
   Point (const QString &curveName,
          const QPointF &posScreen,
          double ordinal = UNDEFINED_ORDINAL,
          const QPointF posGraph = QPointF (0, 0));
 
+  /// Constructor from scratch, with a generated identifier that is interned in the PointIdTable of the Document. The
+  /// position, in screen coordinates, applies to the center of the Point
+  Point (PointIdTable &pointIdTable,
+         const QString &curveName,
+         const QPointF &posScreen,
+         double ordinal = UNDEFINED_ORDINAL,
+         const QPointF posGraph = QPointF (0, 0));
+
   /// Constructor for specified identifier (after redo). The position, in screen coordinates, applies to the center of the Point
-  Point (const QString &curveName,
+  Point (PointIdTable &pointIdTable,
+         const QString &curveName,
          const QPointF &posScreen,
          const QString &identifier,
          double ordinal = UNDEFINED_ORDINAL,
          const QPointF posGraph = QPointF (0, 0));
 
   /// Constructor when loading from serialized xml
-  Point (QXmlStreamReader &reader);
+  Point (PointIdTable &pointIdTable,
+         QXmlStreamReader &reader);
 
-  /// Constructor for creating a proxy Point outside of the Document
-  Point (const QString &identifier,
-         double ordinal,
-         const QPointF &posScreen);
+  /// Constructor for creating a proxy Point from the packed columns of a Curve. The identifier string is only looked
+  /// up in the PointIdTable if it is asked for, so no string is copied
+  Point (const PointIdTable &pointIdTable,
+         PointId pointId,
+         const QPointF &posScreen,
+         const QPointF &posGraph,
+         double ordinal);
 
   /// Assignment constructor.
   Point &operator=(const Point &point);
@@ -43,10 +60,14 @@ public:
   /// Copy constructor.
   Point (const Point &point);
 
-  /// Parse the curve name from the specified point identifier. This does the opposite of uniqueIdentifierGenerator
+  /// Curve name encoded in the identifier, from the PointIdTable. Empty if the Point does not belong to any Document
+  QString curveName () const;
+
+  /// Parse the curve name from the specified point identifier. This does the opposite of uniqueIdentifierGenerator.
+  /// Code with a PointId should use PointIdTable::curveName instead, which does no parsing
   static QString curveNameFromPointIdentifier (const QString &pointIdentifier);
 
-  /// Unique identifier for a specific Point.
+  /// Unique identifier for a specific Point. Empty if the Point does not belong to any Document
   QString identifier () const;
 
   /// Return the current index for storage in case we need to reset it later while performing a Redo.
@@ -58,6 +79,9 @@ public:
   /// Accessor for graph position.
   QPointF posGraph () const;
 
+  /// Compact form of the identifier, for use as a key in internal containers
+  PointId pointId () const;
+
   /// Accessor for screen position
   QPointF posScreen () const;
 
@@ -79,7 +103,8 @@ public:
 private:
 
   /// Load from serialized xml
-  void loadXml(QXmlStreamReader &reader);
+  void loadXml(PointIdTable &pointIdTable,
+               QXmlStreamReader &reader);
 
   /// Generate a unique identifier for a Point. This is static so it can be used while a
   /// GraphicsPointAbstractBase-based object is being constructed.
@@ -88,7 +113,8 @@ private:
   /// than alternatives such as 64-bit guids (like Microsoft)
   static QString uniqueIdentifierGenerator(const QString &curveName);
 
-  QString m_identifier;
+  const PointIdTable *m_pointIdTable; // Null if the Point does not belong to any Document
+  PointId m_pointId;
   QPointF m_posScreen;
   QPointF m_posGraph;
   double m_ordinal;
@@ -0,0 +1,69 @@
+#include "EngaugeAssert.h"
+#include "Point.h"
+#include "PointIdTable.h"
+
+const int CURVE_INDEX_SHIFT = 32;
+const PointId SEQUENCE_MASK = 0xffffffff;
+
+PointIdTable::PointIdTable() :
+  m_sequenceToPointIdentifier (1) // Sequence number zero is reserved for NULL_POINT_ID
+{
+}
+
+quint32 PointIdTable::curveIndex (const QString &curveName)
+{
+  QHash<QString, quint32>::const_iterator itr = m_curveNameToIndex.find (curveName);
+  if (itr != m_curveNameToIndex.end ()) {
+    return itr.value ();
+  }
+
+  quint32 index = m_indexToCurveName.count ();
+  m_indexToCurveName.push_back (curveName);
+  m_curveNameToIndex [curveName] = index;
+
+  return index;
+}
+
+QString PointIdTable::curveName (PointId pointId) const
+{
+  int index = (int) (pointId >> CURVE_INDEX_SHIFT);
+  ENGAUGE_ASSERT (pointId != NULL_POINT_ID);
+  ENGAUGE_ASSERT (index < m_indexToCurveName.count ());
+
+  return m_indexToCurveName.value (index);
+}
+
+PointId PointIdTable::intern (const QString &pointIdentifier)
+{
+  QHash<QString, PointId>::const_iterator itr = m_pointIdentifierToPointId.find (pointIdentifier);
+  if (itr != m_pointIdentifierToPointId.end ()) {
+    return itr.value ();
+  }
+
+  // First time this identifier has been seen, so parse out the curve name. This is the only place where the
+  // identifier string gets parsed, and matches the parsing of Point::curveNameFromPointIdentifier
+  QString curveName = Point::curveNameFromPointIdentifier (pointIdentifier);
+
+  PointId sequence = m_sequenceToPointIdentifier.count ();
+  ENGAUGE_ASSERT (sequence <= SEQUENCE_MASK);
+  m_sequenceToPointIdentifier.push_back (pointIdentifier);
+
+  PointId pointId = ((PointId) curveIndex (curveName) << CURVE_INDEX_SHIFT) | sequence;
+  m_pointIdentifierToPointId [pointIdentifier] = pointId;
+
+  return pointId;
+}
+
+PointId PointIdTable::pointId (const QString &pointIdentifier) const
+{
+  return m_pointIdentifierToPointId.value (pointIdentifier,
+                                           NULL_POINT_ID);
+}
+
+QString PointIdTable::pointIdentifier (PointId pointId) const
+{
+  int sequence = (int) (pointId & SEQUENCE_MASK);
+  ENGAUGE_ASSERT (sequence < m_sequenceToPointIdentifier.count ());
+
+  return m_sequenceToPointIdentifier.value (sequence);
+}
@@ -0,0 +1,51 @@
+#ifndef POINT_ID_TABLE_H
+#define POINT_ID_TABLE_H
+
+#include <QHash>
+#include <QString>
+#include <QtGlobal>
+#include <QVector>
+
+/// Compact identifier for a Point, used internally instead of the QString point identifier. The upper 32 bits hold
+/// the index of the curve name and the lower 32 bits hold the sequence number of the interned point identifier
+typedef quint64 PointId;
+
+/// Value that is never assigned to a point identifier
+const PointId NULL_POINT_ID = 0;
+
+/// Intern table between QString point identifiers and PointId values. Each point identifier is parsed only once, when it
+/// is first interned. After that the curve name and the string form are available through table lookups, so hot loops
+/// can use PointId keys without any string splitting or allocation. The string form is still used for serialization.
+///
+/// Each Document owns its own table, so PointId values are only meaningful within one Document and the table is freed
+/// along with the Document. The table is only used from the GUI thread, so there is no locking
+class PointIdTable
+{
+public:
+  /// Single constructor
+  PointIdTable();
+
+  /// Curve name that is encoded in the point identifier
+  QString curveName (PointId pointId) const;
+
+  /// Intern the point identifier if it has not been seen before, and return its PointId
+  PointId intern (const QString &pointIdentifier);
+
+  /// PointId of a point identifier that was already interned, or NULL_POINT_ID if it never was
+  PointId pointId (const QString &pointIdentifier) const;
+
+  /// String form of the point identifier
+  QString pointIdentifier (PointId pointId) const;
+
+private:
+
+  // Index for the curve name, which is added if it has not been seen before
+  quint32 curveIndex (const QString &curveName);
+
+  QHash<QString, PointId> m_pointIdentifierToPointId;
+  QVector<QString> m_sequenceToPointIdentifier;
+  QHash<QString, quint32> m_curveNameToIndex;
+  QVector<QString> m_indexToCurveName;
+};
+
+#endif // POINT_ID_TABLE_H
@@ -2,9 +2,9 @@
 #define POINT_IDENTIFIER_TO_GRAPHICS_POINT_H
 
 #include "GraphicsPoint.h"
+#include "PointIdTable.h"
 #include <QHash>
-#include <QString>
 
-typedef QHash<QString, GraphicsPoint*> PointIdentifierToGraphicsPoint;
+typedef QHash<PointId, GraphicsPoint*> PointIdentifierToGraphicsPoint;
 
 #endif // POINT_IDENTIFIER_TO_GRAPHICS_POINT_H
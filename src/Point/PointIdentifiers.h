@@ -29,6 +29,9 @@ public:
   /// Get value for key
   bool getValue (const QString &pointIdentifier) const;
 
+  /// All keys, copied once. Use this rather than getKey when looping through all entries
+  QList<QString> keys () const;
+
   /// Load from serialized xml
   void loadXml (QXmlStreamReader &reader);
 
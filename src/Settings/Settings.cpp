@@ -7,6 +7,7 @@ const QString SETTINGS_DIGITIZER ("Digitizer");
 // Environment group
 const QString SETTINGS_GROUP_ENVIRONMENT ("Environment");
 const QString SETTINGS_CURRENT_DIRECTORY ("currentDirectory");
+const QString SETTINGS_TILE_CACHE_MEGABYTES ("tileCacheMegabytes");
 
 // MainWindow group
 const QString SETTINGS_GROUP_MAIN_WINDOW ("MainWindow");
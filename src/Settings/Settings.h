@@ -13,6 +13,7 @@ extern const QString SETTINGS_GROUP_MAIN_WINDOW;
 extern const QString SETTINGS_POS;
 extern const QString SETTINGS_RECENT_FILE_LIST;
 extern const QString SETTINGS_SIZE;
+extern const QString SETTINGS_TILE_CACHE_MEGABYTES;
 extern const QString SETTINGS_VIEW_BACKGROUND_TOOLBAR;
 extern const QString SETTINGS_VIEW_DIGITIZE_TOOLBAR;
 extern const QString SETTINGS_VIEW_SETTINGS_VIEWS_TOOLBAR;
@@ -4,6 +4,7 @@
 
 #include "EngaugeAssert.h"
 #include <iostream>
+#include <qmath.h>
 #include "Spline.h"
 
 using namespace std;
@@ -101,6 +102,24 @@ void Spline::computeControlPointsForIntervals ()
   }
 }
 
+SplinePair Spline::evaluateBezier (unsigned int i,
+                                   double s) const
+{
+  double onems = 1.0 - s;
+  double w0 = onems * onems * onems;
+  double w1 = 3.0 * onems * onems * s;
+  double w2 = 3.0 * onems * s * s;
+  double w3 = s * s * s;
+
+  const SplinePair &p0 = m_xy [i];
+  const SplinePair &p1 = m_p1 [i];
+  const SplinePair &p2 = m_p2 [i];
+  const SplinePair &p3 = m_xy [i + 1];
+
+  return SplinePair (w0 * p0.x() + w1 * p1.x() + w2 * p2.x() + w3 * p3.x(),
+                     w0 * p0.y() + w1 * p1.y() + w2 * p2.y() + w3 * p3.y());
+}
+
 SplinePair Spline::interpolateCoeff (double t) const
 {
   ENGAUGE_ASSERT (m_elements.size() != 0);
@@ -116,24 +135,26 @@ SplinePair Spline::interpolateCoeff (double t) const
 
 SplinePair Spline::interpolateControlPoints (double t) const
 {
-  ENGAUGE_ASSERT (m_xy.size() != 0);
+  ENGAUGE_ASSERT (m_xy.size() >= 2);
 
-  for (int i = 0; i < (signed) m_xy.size() - 1; i++) {
+  unsigned int i = intervalContaining (t);
 
-    if (m_t[i] <= t && t <= m_t[i+1]) {
+  // Clamp so out of range t values evaluate to the nearest endpoint rather than extrapolating
+  double s = qMax (0.0, qMin (1.0, t - m_t [i]));
 
-      SplinePair s ((t - m_t[i]) / (m_t[i + 1] - m_t[i]));
-      SplinePair onems (SplinePair (1.0) - s);
-      SplinePair xy = onems * onems * onems * m_xy [i] +
-                      SplinePair (3.0) * onems * onems * s * m_p1 [i] +
-                      SplinePair (3.0) * onems * s * s * m_p2 [i] +
-                      s * s * s * m_xy[i + 1];
-      return xy;
-    }
-  }
+  return evaluateBezier (i,
+                         s);
+}
+
+unsigned int Spline::intervalContaining (double t) const
+{
+  ENGAUGE_ASSERT (m_xy.size() >= 2);
+
+  // Increments of t are all one (see checkTIncrements), so the interval index is just the offset from the first t
+  int iLast = (int) m_xy.size () - 2;
+  int i = (int) qFloor (t - m_t [0]);
 
-  // Input argument is out of bounds
-  ENGAUGE_ASSERT (false);
+  return (unsigned int) qMax (0, qMin (iLast, i));
 }
 
 SplinePair Spline::p1 (unsigned int i) const
@@ -27,7 +27,9 @@ class Spline
   SplinePair interpolateCoeff (double t) const;
 
   /// Return interpolated y for specified x, for testing. This uses the bezier points. If the t values
-  /// are not separated by +1 consistently then this algorithm will probably need additional effort to work right
+  /// are not separated by +1 consistently then this algorithm will probably need additional effort to work right.
+  /// Since the t values are separated by +1, the interval is computed directly rather than searched for. Values
+  /// of t outside of the range are clamped to the first or last point
   SplinePair interpolateControlPoints (double t) const;
 
   /// Bezier p1 control point for specified interval. P0 is m_xy[i] and P3 is m_xy[i+1]
@@ -48,6 +50,14 @@ private:
                                         const std::vector<SplinePair> &xy);
   void computeControlPointsForIntervals ();
 
+  // Evaluate bezier for interval i at fraction s from 0 to 1. The four bernstein weights are scalars that are
+  // computed once and then applied to both x and y
+  SplinePair evaluateBezier (unsigned int i,
+                             double s) const;
+
+  // Index of the interval containing t, clamped to the first and last intervals. There must be at least one interval
+  unsigned int intervalContaining (double t) const;
+
   // Coefficients a,b,c,d
   std::vector<SplineCoeff> m_elements;
 
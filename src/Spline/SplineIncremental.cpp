@@ -0,0 +1,205 @@
+#include "EngaugeAssert.h"
+#include "SplineIncremental.h"
+
+using namespace std;
+
+// Points solved again on each side of a change. The influence of the change at this distance is below
+// 0.27^24, or about 1e-14, of its size, which is far below anything visible
+const unsigned int SOLVE_HALF_WIDTH = 24;
+
+// Fewest points for which a spline is defined
+const unsigned int MIN_POINTS = 3;
+
+SplineIncremental::SplineIncremental()
+{
+}
+
+void SplineIncremental::clear ()
+{
+  m_xy.clear ();
+  m_c.clear ();
+  m_p1.clear ();
+  m_p2.clear ();
+}
+
+unsigned int SplineIncremental::count () const
+{
+  return m_xy.size ();
+}
+
+void SplineIncremental::insertPoint (unsigned int i,
+                                     const SplinePair &xy,
+                                     unsigned int &iIntervalFirst,
+                                     unsigned int &iIntervalLast)
+{
+  ENGAUGE_ASSERT (count () >= MIN_POINTS);
+  ENGAUGE_ASSERT (i <= count ());
+
+  m_xy.insert (m_xy.begin () + i, xy);
+  m_c.insert (m_c.begin () + i, SplinePair (0.0));
+
+  // Interval count grows by one. Values of the new interval are computed below
+  unsigned int iInterval = qMin (i, (unsigned int) m_p1.size ());
+  m_p1.insert (m_p1.begin () + iInterval, SplinePair (0.0));
+  m_p2.insert (m_p2.begin () + iInterval, SplinePair (0.0));
+
+  updateWindow (i,
+                iIntervalFirst,
+                iIntervalLast);
+}
+
+void SplineIncremental::movePoint (unsigned int i,
+                                   const SplinePair &xy,
+                                   unsigned int &iIntervalFirst,
+                                   unsigned int &iIntervalLast)
+{
+  ENGAUGE_ASSERT (i < count ());
+
+  m_xy [i] = xy;
+
+  updateWindow (i,
+                iIntervalFirst,
+                iIntervalLast);
+}
+
+SplinePair SplineIncremental::p1 (unsigned int i) const
+{
+  ENGAUGE_ASSERT (i < (unsigned int) m_p1.size ());
+
+  return m_p1 [i];
+}
+
+SplinePair SplineIncremental::p2 (unsigned int i) const
+{
+  ENGAUGE_ASSERT (i < (unsigned int) m_p2.size ());
+
+  return m_p2 [i];
+}
+
+void SplineIncremental::rebuild (const std::vector<SplinePair> &xy)
+{
+  ENGAUGE_ASSERT (xy.size () >= MIN_POINTS);
+
+  unsigned int n = xy.size ();
+
+  m_xy = xy;
+  m_c.assign (n, SplinePair (0.0));
+  m_p1.resize (n - 1);
+  m_p2.resize (n - 1);
+
+  solve (1, n - 2);
+  updateControlPoints (0, n - 2);
+}
+
+void SplineIncremental::removePoint (unsigned int i,
+                                     unsigned int &iIntervalFirst,
+                                     unsigned int &iIntervalLast)
+{
+  ENGAUGE_ASSERT (count () > MIN_POINTS);
+  ENGAUGE_ASSERT (i < count ());
+
+  m_xy.erase (m_xy.begin () + i);
+  m_c.erase (m_c.begin () + i);
+
+  unsigned int iInterval = qMin (i, (unsigned int) m_p1.size () - 1);
+  m_p1.erase (m_p1.begin () + iInterval);
+  m_p2.erase (m_p2.begin () + iInterval);
+
+  updateWindow (qMin (i, count () - 1),
+                iIntervalFirst,
+                iIntervalLast);
+}
+
+void SplineIncremental::solve (unsigned int iFirst,
+                               unsigned int iLast)
+{
+  // With unit t increments, the equation at each interior point i is c(i-1)+4c(i)+c(i+1)=3(xy(i+1)-2xy(i)+xy(i-1)),
+  // which is the same system that Spline::computeCoefficientsForIntervals solves for the general case. This is
+  // solved with the Thomas algorithm
+  if (iFirst > iLast) {
+    return;
+  }
+
+  // Work arrays are kept between calls, since a drag solves a window on every tick
+  unsigned int m = iLast - iFirst + 1;
+  if (m_cPrime.size () < m) {
+    m_cPrime.resize (m);
+    m_dPrime.resize (m);
+  }
+  vector<double> &cPrime = m_cPrime;
+  vector<SplinePair> &dPrime = m_dPrime;
+
+  for (unsigned int k = 0; k < m; k++) {
+
+    unsigned int i = iFirst + k;
+
+    SplinePair rhs = SplinePair (3.0) * (m_xy [i + 1] - SplinePair (2.0) * m_xy [i] + m_xy [i - 1]);
+    if (k == 0) {
+      rhs = rhs - m_c [iFirst - 1];
+    }
+    if (k == m - 1) {
+      rhs = rhs - m_c [iLast + 1];
+    }
+
+    double denominator = 4.0;
+    if (k > 0) {
+      denominator -= cPrime [k - 1];
+      rhs = rhs - dPrime [k - 1];
+    }
+
+    cPrime [k] = 1.0 / denominator;
+    dPrime [k] = rhs / SplinePair (denominator);
+  }
+
+  m_c [iLast] = dPrime [m - 1];
+  for (int k = m - 2; k >= 0; k--) {
+    m_c [iFirst + k] = dPrime [k] - SplinePair (cPrime [k]) * m_c [iFirst + k + 1];
+  }
+}
+
+void SplineIncremental::updateControlPoints (unsigned int iFirst,
+                                             unsigned int iLast)
+{
+  for (unsigned int i = iFirst; i <= iLast; i++) {
+
+    // With unit t increments, b=(xy(i+1)-xy(i))-(c(i+1)+2c(i))/3 and b+2c+3d=(xy(i+1)-xy(i))+(2c(i+1)+c(i))/3. Then
+    // as in Spline::computeControlPointsForIntervals, P1=P0+b/3 and P2=P3-(b+2c+3d)/3
+    SplinePair delta = m_xy [i + 1] - m_xy [i];
+
+    m_p1 [i] = m_xy [i] + (delta - (m_c [i + 1] + SplinePair (2.0) * m_c [i]) / SplinePair (3.0)) / SplinePair (3.0);
+    m_p2 [i] = m_xy [i + 1] - (delta + (SplinePair (2.0) * m_c [i + 1] + m_c [i]) / SplinePair (3.0)) / SplinePair (3.0);
+  }
+}
+
+void SplineIncremental::updateWindow (unsigned int i,
+                                      unsigned int &iIntervalFirst,
+                                      unsigned int &iIntervalLast)
+{
+  unsigned int n = count ();
+  ENGAUGE_ASSERT (n >= MIN_POINTS);
+
+  // Natural spline end conditions, which may have moved after an insertion or removal at either end
+  m_c [0] = SplinePair (0.0);
+  m_c [n - 1] = SplinePair (0.0);
+
+  // Interior points in the window
+  unsigned int iFirst = (i > SOLVE_HALF_WIDTH + 1 ? i - SOLVE_HALF_WIDTH : 1);
+  unsigned int iLast = qMin (i + SOLVE_HALF_WIDTH, n - 2);
+
+  solve (iFirst,
+         iLast);
+
+  // Intervals touching any point whose position or c coefficient changed
+  iIntervalFirst = iFirst - 1;
+  iIntervalLast = iLast;
+
+  updateControlPoints (iIntervalFirst,
+                       iIntervalLast);
+}
+
+SplinePair SplineIncremental::xy (unsigned int i) const
+{
+  ENGAUGE_ASSERT (i < count ());
+
+  return m_xy [i];
+}
@@ -0,0 +1,86 @@
+#ifndef SPLINE_INCREMENTAL_H
+#define SPLINE_INCREMENTAL_H
+
+#include "SplinePair.h"
+#include <vector>
+
+/// Natural cubic spline through points with t values 0, 1, 2,... that can be updated locally as points are moved,
+/// inserted or removed. This produces the same bezier control points as Spline, but is meant to persist between
+/// updates so that dragging one point of a long curve does not require solving for the entire curve again.
+///
+/// The influence of one point on the spline shrinks by a factor of about 2-sqrt(3)=0.27 with each point away from it,
+/// so only a small window of points around each change is solved again. The values just outside of that window are
+/// used as the boundary conditions. Calling rebuild performs the full solution
+class SplineIncremental
+{
+ public:
+  /// Default constructor. The spline is empty until rebuild is called
+  SplineIncremental();
+
+  /// Remove all points
+  void clear ();
+
+  /// Number of points. The number of intervals is one less
+  unsigned int count () const;
+
+  /// Insert point so it has index i. Intervals iIntervalFirst through iIntervalLast inclusive have new control points
+  void insertPoint (unsigned int i,
+                    const SplinePair &xy,
+                    unsigned int &iIntervalFirst,
+                    unsigned int &iIntervalLast);
+
+  /// Move point i. Intervals iIntervalFirst through iIntervalLast inclusive have new control points
+  void movePoint (unsigned int i,
+                  const SplinePair &xy,
+                  unsigned int &iIntervalFirst,
+                  unsigned int &iIntervalLast);
+
+  /// Bezier p1 control point for specified interval. P0 is point i and P3 is point i+1
+  SplinePair p1 (unsigned int i) const;
+
+  /// Bezier p2 control point for specified interval. P0 is point i and P3 is point i+1
+  SplinePair p2 (unsigned int i) const;
+
+  /// Full solution for all points. There must be at least three points
+  void rebuild (const std::vector<SplinePair> &xy);
+
+  /// Remove point i. Intervals iIntervalFirst through iIntervalLast inclusive have new control points
+  void removePoint (unsigned int i,
+                    unsigned int &iIntervalFirst,
+                    unsigned int &iIntervalLast);
+
+  /// Get method for point i
+  SplinePair xy (unsigned int i) const;
+
+private:
+
+  // Solve the tridiagonal system for the c coefficients of points iFirst through iLast inclusive, using the
+  // c coefficients of points iFirst-1 and iLast+1 as boundary conditions
+  void solve (unsigned int iFirst,
+              unsigned int iLast);
+
+  // Compute control points of intervals iFirst through iLast inclusive from the c coefficients
+  void updateControlPoints (unsigned int iFirst,
+                            unsigned int iLast);
+
+  // Solve again for the window of points around point i, then update the control points that depend on those points
+  void updateWindow (unsigned int i,
+                     unsigned int &iIntervalFirst,
+                     unsigned int &iIntervalLast);
+
+  // Points
+  std::vector<SplinePair> m_xy;
+
+  // Coefficient c for each point, where c is half of the second derivative. Natural spline has zero at both ends
+  std::vector<SplinePair> m_c;
+
+  // Control points for each interval
+  std::vector<SplinePair> m_p1;
+  std::vector<SplinePair> m_p2;
+
+  // Work arrays of solve. These only grow, to the largest window solved so far
+  std::vector<double> m_cPrime;
+  std::vector<SplinePair> m_dPrime;
+};
+
+#endif // SPLINE_INCREMENTAL_H
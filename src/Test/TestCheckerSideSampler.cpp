@@ -0,0 +1,234 @@
+#include "CheckerSideSampler.h"
+#include "CmdMediator.h"
+#include "Curve.h"
+#include "DocumentModelCoords.h"
+#include "Logger.h"
+#include "MainWindow.h"
+#include "Point.h"
+#include <qmath.h>
+#include <QtTest/QtTest>
+#include "Test/TestCheckerSideSampler.h"
+#include "Transformation.h"
+
+QTEST_MAIN (TestCheckerSideSampler)
+
+// Fixed step count of the sampling that CheckerSideSampler replaced
+const int NUM_STEPS = 1000;
+
+const int POINT_RADIUS = 10;
+const int IMAGE_WIDTH = 600;
+const int IMAGE_HEIGHT = 600;
+
+// Adaptive polyline has to stay this close to the dense samples
+const double BEND_TOLERANCE_PIXELS = 0.5;
+const double DISTANCE_EPSILON = 1e-3;
+
+// A straight side in a linear graph should need tens of samples rather than thousands
+const int MAX_SAMPLES_STRAIGHT_SIDE = 100;
+
+static double distanceToSegment (const QPointF &pos,
+                                 const QPointF &posStart,
+                                 const QPointF &posEnd)
+{
+  double dx = posEnd.x() - posStart.x();
+  double dy = posEnd.y() - posStart.y();
+  double lengthSquared = dx * dx + dy * dy;
+
+  double s = 0;
+  if (lengthSquared > 0) {
+    s = ((pos.x() - posStart.x()) * dx + (pos.y() - posStart.y()) * dy) / lengthSquared;
+    s = qMax (0.0, qMin (1.0, s));
+  }
+
+  double ex = posStart.x() + s * dx - pos.x();
+  double ey = posStart.y() + s * dy - pos.y();
+
+  return qSqrt (ex * ex + ey * ey);
+}
+
+TestCheckerSideSampler::TestCheckerSideSampler(QObject *parent) :
+  QObject(parent)
+{
+}
+
+void TestCheckerSideSampler::cleanupTestCase ()
+{
+
+}
+
+double TestCheckerSideSampler::distanceFromDenseSamples (const DocumentModelCoords &modelCoords,
+                                                         const Transformation &transformation,
+                                                         const QList<Point> &points,
+                                                         double xFrom,
+                                                         double yFrom,
+                                                         double xTo,
+                                                         double yTo,
+                                                         int &numSamples) const
+{
+  CheckerSideSampler sampler (modelCoords,
+                              xFrom,
+                              yFrom,
+                              xTo,
+                              yTo,
+                              transformation,
+                              points,
+                              POINT_RADIUS);
+
+  QVector<QPointF> posScreens;
+  sampler.samples (posScreens);
+  numSamples = posScreens.count ();
+
+  bool isLogX = (modelCoords.coordScaleXTheta() == COORD_SCALE_LOG);
+  bool isLogY = (modelCoords.coordScaleYRadius() == COORD_SCALE_LOG);
+
+  double distanceMax = 0;
+  for (int step = 0; step <= NUM_STEPS; step++) {
+
+    // Dense samples are interpolated the same way as the original fixed step algorithm, with logs for log scaling
+    double s = (double) step / (double) NUM_STEPS;
+    double xGraph = (isLogX ?
+                     qExp ((1.0 - s) * qLn (xFrom) + s * qLn (xTo)) :
+                     (1.0 - s) * xFrom + s * xTo);
+    double yGraph = (isLogY ?
+                     qExp ((1.0 - s) * qLn (yFrom) + s * qLn (yTo)) :
+                     (1.0 - s) * yFrom + s * yTo);
+
+    QPointF posScreen;
+    transformation.transformRawGraphToScreen (QPointF (xGraph, yGraph),
+                                              posScreen);
+
+    double distance = distanceToSegment (posScreen,
+                                         posScreens.first (),
+                                         posScreens.first ());
+    for (int i = 1; i < posScreens.count (); i++) {
+      distance = qMin (distance,
+                       distanceToSegment (posScreen,
+                                          posScreens.at (i - 1),
+                                          posScreens.at (i)));
+    }
+
+    distanceMax = qMax (distanceMax, distance);
+  }
+
+  return distanceMax;
+}
+
+void TestCheckerSideSampler::initTestCase ()
+{
+  const QString NO_ERROR_REPORT_LOG_FILE;
+  const bool DEBUG_FLAG = false;
+  initializeLogging ("engauge_test",
+                     "engauge_test.log",
+                     DEBUG_FLAG);
+
+  MainWindow w (NO_ERROR_REPORT_LOG_FILE);
+  w.show ();
+}
+
+void TestCheckerSideSampler::testLinearSides ()
+{
+  DocumentModelCoords modelCoords;
+
+  // Axes are slightly rotated and sheared so no side is parallel to the screen axes
+  QList<Point> points;
+  points << Point (AXIS_CURVE_NAME, QPointF (110, 400), UNDEFINED_ORDINAL, QPointF (0, 0));
+  points << Point (AXIS_CURVE_NAME, QPointF (500, 420), UNDEFINED_ORDINAL, QPointF (10, 0));
+  points << Point (AXIS_CURVE_NAME, QPointF (90, 100), UNDEFINED_ORDINAL, QPointF (0, 10));
+
+  Transformation transformation = transformationFromAxisPoints (modelCoords,
+                                                                points);
+
+  // Sides of the checker box pass through the axis points, so the point circles are crossed too
+  int numSamples;
+  QVERIFY (distanceFromDenseSamples (modelCoords, transformation, points, 0, 0, 0, 10, numSamples) <=
+           BEND_TOLERANCE_PIXELS + DISTANCE_EPSILON);
+  QVERIFY (numSamples < MAX_SAMPLES_STRAIGHT_SIDE);
+  QVERIFY (distanceFromDenseSamples (modelCoords, transformation, points, 0, 10, 10, 10, numSamples) <=
+           BEND_TOLERANCE_PIXELS + DISTANCE_EPSILON);
+  QVERIFY (numSamples < MAX_SAMPLES_STRAIGHT_SIDE);
+  QVERIFY (distanceFromDenseSamples (modelCoords, transformation, points, 10, 10, 10, 0, numSamples) <=
+           BEND_TOLERANCE_PIXELS + DISTANCE_EPSILON);
+  QVERIFY (numSamples < MAX_SAMPLES_STRAIGHT_SIDE);
+  QVERIFY (distanceFromDenseSamples (modelCoords, transformation, points, 10, 0, 0, 0, numSamples) <=
+           BEND_TOLERANCE_PIXELS + DISTANCE_EPSILON);
+  QVERIFY (numSamples < MAX_SAMPLES_STRAIGHT_SIDE);
+}
+
+void TestCheckerSideSampler::testLogSides ()
+{
+  DocumentModelCoords modelCoords;
+  modelCoords.setCoordScaleXTheta (COORD_SCALE_LOG);
+  modelCoords.setCoordScaleYRadius (COORD_SCALE_LOG);
+
+  QList<Point> points;
+  points << Point (AXIS_CURVE_NAME, QPointF (110, 400), UNDEFINED_ORDINAL, QPointF (1, 1));
+  points << Point (AXIS_CURVE_NAME, QPointF (500, 420), UNDEFINED_ORDINAL, QPointF (1000, 1));
+  points << Point (AXIS_CURVE_NAME, QPointF (90, 100), UNDEFINED_ORDINAL, QPointF (1, 1000));
+
+  Transformation transformation = transformationFromAxisPoints (modelCoords,
+                                                                points);
+
+  // Sides are straight on the screen even though the samples move along them at uneven speed
+  int numSamples;
+  QVERIFY (distanceFromDenseSamples (modelCoords, transformation, points, 1, 1, 1, 1000, numSamples) <=
+           BEND_TOLERANCE_PIXELS + DISTANCE_EPSILON);
+  QVERIFY (numSamples < MAX_SAMPLES_STRAIGHT_SIDE);
+  QVERIFY (distanceFromDenseSamples (modelCoords, transformation, points, 1, 1000, 1000, 1000, numSamples) <=
+           BEND_TOLERANCE_PIXELS + DISTANCE_EPSILON);
+  QVERIFY (numSamples < MAX_SAMPLES_STRAIGHT_SIDE);
+  QVERIFY (distanceFromDenseSamples (modelCoords, transformation, points, 3, 2, 700, 500, numSamples) <=
+           BEND_TOLERANCE_PIXELS + DISTANCE_EPSILON);
+  QVERIFY (numSamples < MAX_SAMPLES_STRAIGHT_SIDE);
+}
+
+void TestCheckerSideSampler::testPolarSides ()
+{
+  DocumentModelCoords modelCoords;
+  modelCoords.setCoordsType (COORDS_TYPE_POLAR);
+  modelCoords.setCoordThetaUnits (COORD_THETA_UNITS_DEGREES);
+
+  QList<Point> points;
+  points << Point (AXIS_CURVE_NAME, QPointF (300, 300), UNDEFINED_ORDINAL, QPointF (0, 0));
+  points << Point (AXIS_CURVE_NAME, QPointF (500, 300), UNDEFINED_ORDINAL, QPointF (0, 10));
+  points << Point (AXIS_CURVE_NAME, QPointF (300, 100), UNDEFINED_ORDINAL, QPointF (90, 10));
+
+  Transformation transformation = transformationFromAxisPoints (modelCoords,
+                                                                points);
+
+  // Sides of constant theta are straight, and sides of constant radius are arcs that bend the whole way
+  int numSamples;
+  QVERIFY (distanceFromDenseSamples (modelCoords, transformation, points, 30, 2, 30, 10, numSamples) <=
+           BEND_TOLERANCE_PIXELS + DISTANCE_EPSILON);
+  QVERIFY (distanceFromDenseSamples (modelCoords, transformation, points, 0, 10, 270, 10, numSamples) <=
+           BEND_TOLERANCE_PIXELS + DISTANCE_EPSILON);
+  QVERIFY (distanceFromDenseSamples (modelCoords, transformation, points, 270, 2, 0, 2, numSamples) <=
+           BEND_TOLERANCE_PIXELS + DISTANCE_EPSILON);
+  QVERIFY (distanceFromDenseSamples (modelCoords, transformation, points, 0, 5, 360, 5, numSamples) <=
+           BEND_TOLERANCE_PIXELS + DISTANCE_EPSILON);
+}
+
+Transformation TestCheckerSideSampler::transformationFromAxisPoints (const DocumentModelCoords &modelCoords,
+                                                                     const QList<Point> &points) const
+{
+  const QString NO_ERROR_REPORT_LOG_FILE;
+  MainWindow mainWindow (NO_ERROR_REPORT_LOG_FILE);
+  CmdMediator cmdMediator (mainWindow,
+                           QImage (IMAGE_WIDTH,
+                                   IMAGE_HEIGHT,
+                                   QImage::Format_RGB32));
+  cmdMediator.document().setModelCoords (modelCoords);
+
+  PointId pointId;
+  QList<Point>::const_iterator itr;
+  for (itr = points.begin (); itr != points.end (); itr++) {
+    cmdMediator.document().addPointAxisWithGeneratedIdentifier ((*itr).posScreen (),
+                                                                 (*itr).posGraph (),
+                                                                 pointId);
+  }
+
+  Transformation transformation;
+  transformation.update (true,
+                         cmdMediator);
+
+  return transformation;
+}
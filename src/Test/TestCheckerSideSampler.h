@@ -0,0 +1,45 @@
+#ifndef TEST_CHECKER_SIDE_SAMPLER_H
+#define TEST_CHECKER_SIDE_SAMPLER_H
+
+#include <QList>
+#include <QObject>
+
+class DocumentModelCoords;
+class Point;
+class Transformation;
+
+/// Unit test of CheckerSideSampler against the dense fixed step sampling that it replaced
+class TestCheckerSideSampler : public QObject
+{
+  Q_OBJECT
+public:
+  /// Single constructor.
+  explicit TestCheckerSideSampler(QObject *parent = 0);
+
+signals:
+
+private slots:
+  void cleanupTestCase ();
+  void initTestCase ();
+
+  void testLinearSides ();
+  void testLogSides ();
+  void testPolarSides ();
+
+private:
+  // Largest distance, in pixels, from the dense fixed step samples of one side to the adaptive polyline of that side
+  double distanceFromDenseSamples (const DocumentModelCoords &modelCoords,
+                                   const Transformation &transformation,
+                                   const QList<Point> &points,
+                                   double xFrom,
+                                   double yFrom,
+                                   double xTo,
+                                   double yTo,
+                                   int &numSamples) const;
+
+  // Transformation defined by three axis points
+  Transformation transformationFromAxisPoints (const DocumentModelCoords &modelCoords,
+                                               const QList<Point> &points) const;
+};
+
+#endif // TEST_CHECKER_SIDE_SAMPLER_H
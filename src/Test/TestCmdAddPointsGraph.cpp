@@ -0,0 +1,141 @@
+#include "CmdAddPointsGraph.h"
+#include "CmdMediator.h"
+#include "Curve.h"
+#include "Document.h"
+#include "Logger.h"
+#include "MainWindow.h"
+#include <QImage>
+#include <QtTest/QtTest>
+#include "Test/TestCmdAddPointsGraph.h"
+
+QTEST_MAIN (TestCmdAddPointsGraph)
+
+const QString NO_ERROR_REPORT_LOG_FILE;
+
+const int IMAGE_WIDTH = 200;
+const int IMAGE_HEIGHT = 100;
+
+const int NUM_POINTS = 10;
+
+// Points of a batch, with increasing x so the ordinals come out the same whether or not the curve is a function
+static QList<QPoint> batchPoints (int xStart)
+{
+  QList<QPoint> points;
+  for (int i = 0; i < NUM_POINTS; i++) {
+    points << QPoint (xStart + i,
+                      IMAGE_HEIGHT / 2);
+  }
+
+  return points;
+}
+
+static QImage blankImage ()
+{
+  QImage image (IMAGE_WIDTH,
+                IMAGE_HEIGHT,
+                QImage::Format_RGB32);
+  image.fill (qRgb (255, 255, 255));
+
+  return image;
+}
+
+TestCmdAddPointsGraph::TestCmdAddPointsGraph(QObject *parent) :
+  QObject(parent)
+{
+}
+
+void TestCmdAddPointsGraph::cleanupTestCase ()
+{
+}
+
+void TestCmdAddPointsGraph::initTestCase ()
+{
+  const bool DEBUG_FLAG = false;
+
+  initializeLogging ("engauge_test",
+                     "engauge_test.log",
+                     DEBUG_FLAG);
+}
+
+QList<double> TestCmdAddPointsGraph::ordinals (const Document &document) const
+{
+  QList<double> ordinals;
+
+  QVector<Point> points = document.curveForCurveName (DEFAULT_GRAPH_CURVE_NAME)->points ();
+  for (int i = 0; i < points.count (); i++) {
+    ordinals << points.at (i).ordinal ();
+  }
+
+  return ordinals;
+}
+
+QStringList TestCmdAddPointsGraph::pointIdentifiers (const Document &document) const
+{
+  QStringList pointIdentifiers;
+
+  QVector<Point> points = document.curveForCurveName (DEFAULT_GRAPH_CURVE_NAME)->points ();
+  for (int i = 0; i < points.count (); i++) {
+    pointIdentifiers << points.at (i).identifier ();
+  }
+
+  return pointIdentifiers;
+}
+
+void TestCmdAddPointsGraph::testOrdinalsFollowExistingPoints ()
+{
+  MainWindow w (NO_ERROR_REPORT_LOG_FILE);
+  w.slotFileImportDraggedImage (blankImage ());
+
+  CmdMediator &cmdMediator = w.cmdMediator ();
+  Document &document = cmdMediator.document ();
+
+  cmdMediator.push (new CmdAddPointsGraph (w,
+                                           document,
+                                           DEFAULT_GRAPH_CURVE_NAME,
+                                           batchPoints (0)));
+  cmdMediator.push (new CmdAddPointsGraph (w,
+                                           document,
+                                           DEFAULT_GRAPH_CURVE_NAME,
+                                           batchPoints (NUM_POINTS)));
+
+  QList<double> ordinalsExpected;
+  for (int i = 0; i < 2 * NUM_POINTS; i++) {
+    ordinalsExpected << i;
+  }
+  QCOMPARE (ordinals (document), ordinalsExpected);
+
+  // Undoing the second batch leaves the ordinals of the first batch alone
+  cmdMediator.undo ();
+  QCOMPARE (ordinals (document), ordinalsExpected.mid (0, NUM_POINTS));
+
+  cmdMediator.redo ();
+  QCOMPARE (ordinals (document), ordinalsExpected);
+}
+
+void TestCmdAddPointsGraph::testRedoUndoRedo ()
+{
+  MainWindow w (NO_ERROR_REPORT_LOG_FILE);
+  w.slotFileImportDraggedImage (blankImage ());
+
+  CmdMediator &cmdMediator = w.cmdMediator ();
+  Document &document = cmdMediator.document ();
+  int countCommandsBefore = cmdMediator.count ();
+
+  // Pushing performs the first redo
+  cmdMediator.push (new CmdAddPointsGraph (w,
+                                           document,
+                                           DEFAULT_GRAPH_CURVE_NAME,
+                                           batchPoints (0)));
+  QCOMPARE (cmdMediator.count (), countCommandsBefore + 1); // Whole batch is a single undo entry
+  QCOMPARE (document.curvesGraphsNumPoints (DEFAULT_GRAPH_CURVE_NAME), NUM_POINTS);
+
+  QStringList pointIdentifiersFirstRedo = pointIdentifiers (document);
+
+  cmdMediator.undo ();
+  QCOMPARE (document.curvesGraphsNumPoints (DEFAULT_GRAPH_CURVE_NAME), 0);
+
+  // Redo brings back the same points with the same identifiers, so later commands that refer to them still apply
+  cmdMediator.redo ();
+  QCOMPARE (document.curvesGraphsNumPoints (DEFAULT_GRAPH_CURVE_NAME), NUM_POINTS);
+  QCOMPARE (pointIdentifiers (document), pointIdentifiersFirstRedo);
+}
@@ -0,0 +1,34 @@
+#ifndef TEST_CMD_ADD_POINTS_GRAPH_H
+#define TEST_CMD_ADD_POINTS_GRAPH_H
+
+#include <QObject>
+#include <QStringList>
+
+class Document;
+
+/// Unit test of CmdAddPointsGraph, which adds a batch of graph points as a single undo entry
+class TestCmdAddPointsGraph : public QObject
+{
+  Q_OBJECT
+public:
+  /// Single constructor.
+  explicit TestCmdAddPointsGraph(QObject *parent = 0);
+
+signals:
+
+private slots:
+  void cleanupTestCase ();
+  void initTestCase ();
+
+  void testOrdinalsFollowExistingPoints ();
+  void testRedoUndoRedo ();
+
+private:
+  // Ordinals of the Points in the curve, in storage order
+  QList<double> ordinals (const Document &document) const;
+
+  // Identifiers of the Points in the curve, in storage order
+  QStringList pointIdentifiers (const Document &document) const;
+};
+
+#endif // TEST_CMD_ADD_POINTS_GRAPH_H
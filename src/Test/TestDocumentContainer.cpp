@@ -0,0 +1,230 @@
+#include "Document.h"
+#include "DocumentContainer.h"
+#include <limits>
+#include "Logger.h"
+#include "MainWindow.h"
+#include <QBuffer>
+#include <QDataStream>
+#include <QImage>
+#include <QTemporaryFile>
+#include <QtTest/QtTest>
+#include <QXmlStreamWriter>
+#include "Test/TestDocumentContainer.h"
+
+QTEST_MAIN (TestDocumentContainer)
+
+// Offsets of the section sizes. The magic number and version come first
+const int XML_SIZE_OFFSET = 8 + 4;
+const int XML_OFFSET = XML_SIZE_OFFSET + 8;
+
+const int IMAGE_WIDTH = 40;
+const int IMAGE_HEIGHT = 30;
+
+// Sections small enough that every truncation can be tried
+const QByteArray XML_SECTION ("<?xml version=\"1.0\"?><Document/>");
+const QByteArray IMAGE_CHUNK_SECTION ("0123456789abcdefghijklmnopqrstuvwxyz");
+
+TestDocumentContainer::TestDocumentContainer(QObject *parent) :
+  QObject(parent)
+{
+}
+
+void TestDocumentContainer::cleanupTestCase ()
+{
+
+}
+
+QByteArray TestDocumentContainer::containerBytes (const QByteArray &xml,
+                                                  const QByteArray &imageChunk) const
+{
+  QByteArray bytes;
+  QBuffer buffer (&bytes);
+  buffer.open (QIODevice::WriteOnly);
+
+  bool success = DocumentContainer::write (buffer,
+                                           xml,
+                                           imageChunk);
+  Q_ASSERT (success);
+  Q_UNUSED (success);
+
+  return bytes;
+}
+
+void TestDocumentContainer::initTestCase ()
+{
+  const QString NO_ERROR_REPORT_LOG_FILE;
+  const bool DEBUG_FLAG = false;
+  initializeLogging ("engauge_test",
+                     "engauge_test.log",
+                     DEBUG_FLAG);
+
+  MainWindow w (NO_ERROR_REPORT_LOG_FILE);
+  w.show ();
+}
+
+bool TestDocumentContainer::isValidContainer (const QByteArray &bytes) const
+{
+  QTemporaryFile file;
+  file.open ();
+  file.write (bytes);
+  file.close ();
+
+  DocumentContainer container (file.fileName ());
+
+  return container.isValid ();
+}
+
+void TestDocumentContainer::setSectionSize (QByteArray &bytes,
+                                            int offset,
+                                            quint64 size) const
+{
+  QBuffer buffer (&bytes);
+  buffer.open (QIODevice::ReadWrite);
+  buffer.seek (offset);
+
+  QDataStream str (&buffer);
+  str << size;
+}
+
+void TestDocumentContainer::testDocumentRoundTrip ()
+{
+  QImage image (IMAGE_WIDTH,
+                IMAGE_HEIGHT,
+                QImage::Format_RGB32);
+  image.fill (qRgb (255, 255, 255));
+  for (int x = 0; x < IMAGE_WIDTH; x++) {
+    image.setPixel (x, x % IMAGE_HEIGHT, qRgb (0, 0, 255));
+  }
+
+  Document document (image);
+
+  QTemporaryFile file;
+  QVERIFY (file.open ());
+  QVERIFY (document.saveContainer (file));
+  file.close ();
+
+  QVERIFY (DocumentContainer::isContainerFile (file.fileName ()));
+
+  Document documentRead (file.fileName ());
+  QVERIFY (documentRead.successfulRead ());
+  QVERIFY (documentRead.imageIsPending ());
+  QCOMPARE (documentRead.pixmap ().size (), image.size ());
+
+  // Image comes back from the png chunk, which is what LoadImageThread decodes
+  QImage imageRead = QImage::fromData (documentRead.imageChunk (),
+                                       "PNG");
+  QCOMPARE (imageRead.convertToFormat (QImage::Format_RGB32), image);
+}
+
+void TestDocumentContainer::testOversizedSections ()
+{
+  QByteArray bytes = containerBytes (XML_SECTION,
+                                     IMAGE_CHUNK_SECTION);
+  QVERIFY (isValidContainer (bytes));
+
+  int imageChunkSizeOffset = XML_OFFSET + XML_SECTION.size ();
+
+  // Xml section runs past the end of the file
+  QByteArray bytesXmlPastEnd = bytes;
+  setSectionSize (bytesXmlPastEnd,
+                  XML_SIZE_OFFSET,
+                  bytes.size () + 1);
+  QVERIFY (!isValidContainer (bytesXmlPastEnd));
+
+  // Largest size, which would be negative if it was read as signed
+  QByteArray bytesXmlHuge = bytes;
+  setSectionSize (bytesXmlHuge,
+                  XML_SIZE_OFFSET,
+                  std::numeric_limits<quint64>::max ());
+  QVERIFY (!isValidContainer (bytesXmlHuge));
+
+  // Xml section one byte too long, so the png chunk size is read from the wrong place
+  QByteArray bytesXmlLonger = bytes;
+  setSectionSize (bytesXmlLonger,
+                  XML_SIZE_OFFSET,
+                  XML_SECTION.size () + 1);
+  QVERIFY (!isValidContainer (bytesXmlLonger));
+
+  // Png chunk runs past the end of the file
+  QByteArray bytesImageChunkLonger = bytes;
+  setSectionSize (bytesImageChunkLonger,
+                  imageChunkSizeOffset,
+                  IMAGE_CHUNK_SECTION.size () + 1);
+  QVERIFY (!isValidContainer (bytesImageChunkLonger));
+
+  QByteArray bytesImageChunkHuge = bytes;
+  setSectionSize (bytesImageChunkHuge,
+                  imageChunkSizeOffset,
+                  std::numeric_limits<quint64>::max ());
+  QVERIFY (!isValidContainer (bytesImageChunkHuge));
+
+  // Png chunk stops short of the end of the file
+  QByteArray bytesImageChunkShorter = bytes;
+  setSectionSize (bytesImageChunkShorter,
+                  imageChunkSizeOffset,
+                  IMAGE_CHUNK_SECTION.size () - 1);
+  QVERIFY (!isValidContainer (bytesImageChunkShorter));
+
+  // Trailing bytes after the png chunk
+  QVERIFY (!isValidContainer (bytes + QByteArray (1, '\0')));
+}
+
+void TestDocumentContainer::testRoundTrip ()
+{
+  QTemporaryFile file;
+  QVERIFY (file.open ());
+  QVERIFY (DocumentContainer::write (file,
+                                     XML_SECTION,
+                                     IMAGE_CHUNK_SECTION));
+  file.close ();
+
+  QVERIFY (DocumentContainer::isContainerFile (file.fileName ()));
+
+  DocumentContainer container (file.fileName ());
+  QVERIFY (container.isValid ());
+  QCOMPARE (container.xml (), XML_SECTION);
+  QCOMPARE (container.imageChunk (), IMAGE_CHUNK_SECTION);
+
+  // Empty sections are allowed
+  QVERIFY (isValidContainer (containerBytes (QByteArray (),
+                                             QByteArray ())));
+}
+
+void TestDocumentContainer::testTruncated ()
+{
+  QByteArray bytes = containerBytes (XML_SECTION,
+                                     IMAGE_CHUNK_SECTION);
+  QVERIFY (isValidContainer (bytes));
+
+  // Every truncation is rejected, whether it cuts into the header, a section size or a section
+  for (int size = 0; size < bytes.size (); size++) {
+    QVERIFY2 (!isValidContainer (bytes.left (size)),
+              qPrintable (QString ("size=%1").arg (size)));
+  }
+}
+
+void TestDocumentContainer::testXmlFileStillLoads ()
+{
+  QImage image (IMAGE_WIDTH,
+                IMAGE_HEIGHT,
+                QImage::Format_RGB32);
+  image.fill (qRgb (255, 255, 255));
+
+  Document document (image);
+
+  // Xml Document file, as saved before DocumentContainer files
+  QTemporaryFile file;
+  QVERIFY (file.open ());
+  QXmlStreamWriter writer (&file);
+  writer.setAutoFormatting (true);
+  document.saveXml (writer);
+  file.close ();
+
+  QVERIFY (!DocumentContainer::isContainerFile (file.fileName ()));
+  QVERIFY (!DocumentContainer (file.fileName ()).isValid ());
+
+  Document documentRead (file.fileName ());
+  QVERIFY (documentRead.successfulRead ());
+  QVERIFY (!documentRead.imageIsPending ());
+  QCOMPARE (documentRead.pixmap ().size (), image.size ());
+}
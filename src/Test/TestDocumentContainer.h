@@ -0,0 +1,41 @@
+#ifndef TEST_DOCUMENT_CONTAINER_H
+#define TEST_DOCUMENT_CONTAINER_H
+
+#include <QByteArray>
+#include <QObject>
+
+/// Unit test of DocumentContainer reading and writing, including damaged containers and xml Document files
+class TestDocumentContainer : public QObject
+{
+  Q_OBJECT
+public:
+  /// Single constructor.
+  explicit TestDocumentContainer(QObject *parent = 0);
+
+signals:
+
+private slots:
+  void cleanupTestCase ();
+  void initTestCase ();
+
+  void testDocumentRoundTrip ();
+  void testOversizedSections ();
+  void testRoundTrip ();
+  void testTruncated ();
+  void testXmlFileStillLoads ();
+
+private:
+  // Container bytes as written by DocumentContainer::write
+  QByteArray containerBytes (const QByteArray &xml,
+                             const QByteArray &imageChunk) const;
+
+  // Write the bytes to a file and return DocumentContainer::isValid for that file
+  bool isValidContainer (const QByteArray &bytes) const;
+
+  // Overwrite the section size that starts at the offset, in the same byte order as QDataStream
+  void setSectionSize (QByteArray &bytes,
+                       int offset,
+                       quint64 size) const;
+};
+
+#endif // TEST_DOCUMENT_CONTAINER_H
@@ -3,6 +3,7 @@
 #include <qmath.h>
 #include <QtTest/QtTest>
 #include "Spline.h"
+#include "SplineIncremental.h"
 #include "SplinePair.h"
 #include "Test/TestSpline.h"
 
@@ -82,5 +83,64 @@ void TestSpline::testSplinesAsControlPoints ()
     }
   }
 
+  // Out of range values are clamped to the endpoints
+  SplinePair spFirst = s.interpolateControlPoints (T_START - 10.0);
+  SplinePair spLast = s.interpolateControlPoints (T_STOP + 10.0);
+  if (qAbs (spFirst.x() - xy.front().x()) > SPLINE_EPSILON ||
+      qAbs (spFirst.y() - xy.front().y()) > SPLINE_EPSILON ||
+      qAbs (spLast.x() - xy.back().x()) > SPLINE_EPSILON ||
+      qAbs (spLast.y() - xy.back().y()) > SPLINE_EPSILON) {
+    success = false;
+  }
+
+  QVERIFY (success);
+}
+
+void TestSpline::testSplinesIncremental ()
+{
+  const int NUM_POINTS = 100;
+  const double SPLINE_EPSILON = 0.000001;
+
+  bool success = true;
+
+  vector<SplinePair> xy;
+  for (int i = 0; i < NUM_POINTS; i++) {
+    xy.push_back (SplinePair (10.0 * i + qSin (i), 100.0 * qCos (0.3 * i)));
+  }
+
+  SplineIncremental splineIncremental;
+  splineIncremental.rebuild (xy);
+
+  // Local updates, including at both ends
+  unsigned int iIntervalFirst, iIntervalLast;
+  xy [50] = SplinePair (505.0, -30.0);
+  splineIncremental.movePoint (50, xy [50], iIntervalFirst, iIntervalLast);
+  xy [0] = SplinePair (-5.0, 20.0);
+  splineIncremental.movePoint (0, xy [0], iIntervalFirst, iIntervalLast);
+  xy.insert (xy.begin () + 20, SplinePair (197.0, 50.0));
+  splineIncremental.insertPoint (20, xy [20], iIntervalFirst, iIntervalLast);
+  xy.erase (xy.begin () + 70);
+  splineIncremental.removePoint (70, iIntervalFirst, iIntervalLast);
+  xy.pop_back ();
+  splineIncremental.removePoint (xy.size (), iIntervalFirst, iIntervalLast);
+
+  // Full solution for comparison
+  vector<double> t;
+  for (unsigned int i = 0; i < xy.size (); i++) {
+    t.push_back (i);
+  }
+  Spline spline (t, xy);
+
+  QVERIFY (splineIncremental.count () == xy.size ());
+
+  for (unsigned int i = 0; i < xy.size () - 1; i++) {
+    if (qAbs (spline.p1 (i).x() - splineIncremental.p1 (i).x()) > SPLINE_EPSILON ||
+        qAbs (spline.p1 (i).y() - splineIncremental.p1 (i).y()) > SPLINE_EPSILON ||
+        qAbs (spline.p2 (i).x() - splineIncremental.p2 (i).x()) > SPLINE_EPSILON ||
+        qAbs (spline.p2 (i).y() - splineIncremental.p2 (i).y()) > SPLINE_EPSILON) {
+      success = false;
+    }
+  }
+
   QVERIFY (success);
 }
@@ -18,6 +18,7 @@ private slots:
   void initTestCase ();
 
   void testSplinesAsControlPoints ();
+  void testSplinesIncremental ();
 };
 
 #endif // TEST_SPLINE_H
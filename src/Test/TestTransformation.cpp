@@ -0,0 +1,298 @@
+#include "CmdMediator.h"
+#include "Curve.h"
+#include "DocumentModelCoords.h"
+#include "Logger.h"
+#include "MainWindow.h"
+#include "Point.h"
+#include <qmath.h>
+#include <QtTest/QtTest>
+#include "Test/TestTransformation.h"
+#include "Transformation.h"
+
+QTEST_MAIN (TestTransformation)
+
+const int NUM_POINTS = 100000;
+const double TRANSFORMATION_EPSILON = 1e-9;
+
+// Relative tolerance for round trips through log and polar coordinates
+const double ROUND_TRIP_EPSILON = 1e-7;
+
+const int IMAGE_WIDTH = 600;
+const int IMAGE_HEIGHT = 600;
+
+static bool isClose (double value,
+                     double valueExpected)
+{
+  return qAbs (value - valueExpected) <= ROUND_TRIP_EPSILON * qMax (1.0, qAbs (valueExpected));
+}
+
+static bool isClose (const QPointF &pos,
+                     const QPointF &posExpected)
+{
+  return isClose (pos.x(), posExpected.x()) &&
+         isClose (pos.y(), posExpected.y());
+}
+
+TestTransformation::TestTransformation(QObject *parent) :
+  QObject(parent)
+{
+}
+
+void TestTransformation::benchmarkScreenToGraphCached ()
+{
+  Transformation transformation;
+  transformation.identity ();
+
+  QPointF posGraph, posGraphSum;
+  QBENCHMARK {
+    posGraphSum = QPointF (0, 0);
+    for (int i = 0; i < NUM_POINTS; i++) {
+      transformation.transformScreenToLinearCartesianGraph (QPointF (i, i),
+                                                            posGraph);
+      posGraphSum += posGraph;
+    }
+  }
+
+  // Identity maps (i,i) onto itself, so the sum is known
+  double sumExpected = (double) NUM_POINTS * (NUM_POINTS - 1) / 2.0;
+  QVERIFY (isClose (posGraphSum, QPointF (sumExpected, sumExpected)));
+}
+
+void TestTransformation::benchmarkScreenToGraphUncached ()
+{
+  Transformation transformation;
+  transformation.identity ();
+
+  // This is how each point was transformed before the derived matrices were cached
+  QPointF posGraph, posGraphSum;
+  QBENCHMARK {
+    posGraphSum = QPointF (0, 0);
+    for (int i = 0; i < NUM_POINTS; i++) {
+      posGraph = transformation.transformMatrix ().transposed ().map (QPointF (i, i));
+      posGraphSum += posGraph;
+    }
+  }
+
+  double sumExpected = (double) NUM_POINTS * (NUM_POINTS - 1) / 2.0;
+  QVERIFY (isClose (posGraphSum, QPointF (sumExpected, sumExpected)));
+}
+
+void TestTransformation::cleanupTestCase ()
+{
+
+}
+
+void TestTransformation::initTestCase ()
+{
+  const QString NO_ERROR_REPORT_LOG_FILE;
+  const bool DEBUG_FLAG = false;
+  initializeLogging ("engauge_test",
+                     "engauge_test.log",
+                     DEBUG_FLAG);
+
+  MainWindow w (NO_ERROR_REPORT_LOG_FILE);
+  w.show ();
+}
+
+bool TestTransformation::roundTripMatchesBaseline (const DocumentModelCoords &modelCoords,
+                                                   const QList<Point> &points) const
+{
+  Transformation transformation = transformationFromAxisPoints (modelCoords,
+                                                                points);
+  if (!transformation.transformIsDefined ()) {
+    return false;
+  }
+
+  // Axis points are exact by construction
+  QList<Point>::const_iterator itr;
+  for (itr = points.begin (); itr != points.end (); itr++) {
+
+    QPointF posScreen, posGraph;
+    transformation.transformRawGraphToScreen ((*itr).posGraph (),
+                                              posScreen);
+    transformation.transformScreenToRawGraph ((*itr).posScreen (),
+                                              posGraph);
+
+    if (!isClose (posScreen, (*itr).posScreen ()) ||
+        !isClose (posGraph, (*itr).posGraph ())) {
+      return false;
+    }
+  }
+
+  bool isPolar = (modelCoords.coordsType() == COORDS_TYPE_POLAR);
+  bool isLogX = (modelCoords.coordScaleXTheta() == COORD_SCALE_LOG);
+  bool isLogY = (modelCoords.coordScaleYRadius() == COORD_SCALE_LOG);
+  QTransform matrix = transformation.transformMatrix ();
+
+  for (int i = 0; i < 100; i++) {
+
+    QPointF posScreen (150.0 + 3.0 * i, 350.0 - 2.0 * i);
+
+    // Screen to graph as it was done before the derived matrices and constants were cached
+    QPointF posGraphExpected = matrix.transposed ().map (posScreen);
+    if (isPolar) {
+      posGraphExpected = Transformation::cartesianOrPolarFromCartesian (modelCoords,
+                                                                        posGraphExpected);
+    }
+    if (isLogX) {
+      posGraphExpected.setX (qExp (posGraphExpected.x()));
+    }
+    if (isLogY) {
+      posGraphExpected.setY (isPolar ?
+                             qExp (posGraphExpected.y() + qLn (modelCoords.originRadius ())) :
+                             qExp (posGraphExpected.y()));
+    }
+
+    QPointF posGraph, posScreenRoundTrip;
+    transformation.transformScreenToRawGraph (posScreen,
+                                              posGraph);
+    transformation.transformRawGraphToScreen (posGraph,
+                                              posScreenRoundTrip);
+
+    if (!isClose (posGraph, posGraphExpected) ||
+        !isClose (posScreenRoundTrip, posScreen)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void TestTransformation::testCachedMatchesUncached ()
+{
+  // Rotated and sheared axes so the cached matrices differ from the identity
+  QList<Point> points;
+  points << Point (AXIS_CURVE_NAME, QPointF (110, 400), UNDEFINED_ORDINAL, QPointF (0, 0));
+  points << Point (AXIS_CURVE_NAME, QPointF (500, 420), UNDEFINED_ORDINAL, QPointF (10, 0));
+  points << Point (AXIS_CURVE_NAME, QPointF (90, 100), UNDEFINED_ORDINAL, QPointF (0, 10));
+
+  Transformation transformation = transformationFromAxisPoints (DocumentModelCoords (),
+                                                                points);
+  QVERIFY (transformation.transformIsDefined ());
+
+  QTransform matrix = transformation.transformMatrix ();
+
+  for (int i = 0; i < 100; i++) {
+
+    QPointF posScreen (3.0 * i, 100.0 - i);
+    QPointF posGraph, posScreenRoundTrip;
+
+    transformation.transformScreenToLinearCartesianGraph (posScreen,
+                                                          posGraph);
+    transformation.transformLinearCartesianGraphToScreen (posGraph,
+                                                          posScreenRoundTrip);
+
+    QPointF posGraphExpected = matrix.transposed ().map (posScreen);
+    QPointF posScreenExpected = matrix.inverted ().transposed ().map (posGraph);
+
+    QVERIFY (qAbs (posGraph.x() - posGraphExpected.x()) < TRANSFORMATION_EPSILON);
+    QVERIFY (qAbs (posGraph.y() - posGraphExpected.y()) < TRANSFORMATION_EPSILON);
+    QVERIFY (qAbs (posScreenRoundTrip.x() - posScreenExpected.x()) < TRANSFORMATION_EPSILON);
+    QVERIFY (qAbs (posScreenRoundTrip.y() - posScreenExpected.y()) < TRANSFORMATION_EPSILON);
+  }
+}
+
+void TestTransformation::testRoundTripCartesianLogIgnoresOriginRadius ()
+{
+  // Origin radius only applies to polar coordinates. Before the constants were cached, a cartesian log y coordinate
+  // was offset by the origin radius in one direction but not the other, so round trips drifted
+  DocumentModelCoords modelCoords;
+  modelCoords.setCoordScaleYRadius (COORD_SCALE_LOG);
+  modelCoords.setOriginRadius (5.0);
+
+  QList<Point> points;
+  points << Point (AXIS_CURVE_NAME, QPointF (110, 400), UNDEFINED_ORDINAL, QPointF (0, 1));
+  points << Point (AXIS_CURVE_NAME, QPointF (500, 420), UNDEFINED_ORDINAL, QPointF (10, 1));
+  points << Point (AXIS_CURVE_NAME, QPointF (90, 100), UNDEFINED_ORDINAL, QPointF (0, 1000));
+
+  QVERIFY (roundTripMatchesBaseline (modelCoords,
+                                     points));
+}
+
+void TestTransformation::testRoundTripLinear ()
+{
+  DocumentModelCoords modelCoords;
+
+  // Axes are slightly rotated and sheared
+  QList<Point> points;
+  points << Point (AXIS_CURVE_NAME, QPointF (110, 400), UNDEFINED_ORDINAL, QPointF (0, 0));
+  points << Point (AXIS_CURVE_NAME, QPointF (500, 420), UNDEFINED_ORDINAL, QPointF (10, 0));
+  points << Point (AXIS_CURVE_NAME, QPointF (90, 100), UNDEFINED_ORDINAL, QPointF (0, 10));
+
+  QVERIFY (roundTripMatchesBaseline (modelCoords,
+                                     points));
+}
+
+void TestTransformation::testRoundTripLogXLogY ()
+{
+  DocumentModelCoords modelCoords;
+  modelCoords.setCoordScaleXTheta (COORD_SCALE_LOG);
+  modelCoords.setCoordScaleYRadius (COORD_SCALE_LOG);
+
+  QList<Point> points;
+  points << Point (AXIS_CURVE_NAME, QPointF (110, 400), UNDEFINED_ORDINAL, QPointF (1, 1));
+  points << Point (AXIS_CURVE_NAME, QPointF (500, 420), UNDEFINED_ORDINAL, QPointF (1000, 1));
+  points << Point (AXIS_CURVE_NAME, QPointF (90, 100), UNDEFINED_ORDINAL, QPointF (1, 100));
+
+  QVERIFY (roundTripMatchesBaseline (modelCoords,
+                                     points));
+}
+
+void TestTransformation::testRoundTripPolarDegreesLogRadius ()
+{
+  // Origin radius other than one exercises the cached log of the origin radius
+  DocumentModelCoords modelCoords;
+  modelCoords.setCoordsType (COORDS_TYPE_POLAR);
+  modelCoords.setCoordThetaUnits (COORD_THETA_UNITS_DEGREES);
+  modelCoords.setCoordScaleYRadius (COORD_SCALE_LOG);
+  modelCoords.setOriginRadius (2.0);
+
+  QList<Point> points;
+  points << Point (AXIS_CURVE_NAME, QPointF (300, 300), UNDEFINED_ORDINAL, QPointF (0, 2));
+  points << Point (AXIS_CURVE_NAME, QPointF (500, 310), UNDEFINED_ORDINAL, QPointF (0, 200));
+  points << Point (AXIS_CURVE_NAME, QPointF (290, 100), UNDEFINED_ORDINAL, QPointF (90, 200));
+
+  QVERIFY (roundTripMatchesBaseline (modelCoords,
+                                     points));
+}
+
+void TestTransformation::testRoundTripPolarRadians ()
+{
+  DocumentModelCoords modelCoords;
+  modelCoords.setCoordsType (COORDS_TYPE_POLAR);
+  modelCoords.setCoordThetaUnits (COORD_THETA_UNITS_RADIANS);
+
+  QList<Point> points;
+  points << Point (AXIS_CURVE_NAME, QPointF (300, 300), UNDEFINED_ORDINAL, QPointF (0, 0));
+  points << Point (AXIS_CURVE_NAME, QPointF (500, 310), UNDEFINED_ORDINAL, QPointF (0, 10));
+  points << Point (AXIS_CURVE_NAME, QPointF (290, 100), UNDEFINED_ORDINAL, QPointF (1.5, 10));
+
+  QVERIFY (roundTripMatchesBaseline (modelCoords,
+                                     points));
+}
+
+Transformation TestTransformation::transformationFromAxisPoints (const DocumentModelCoords &modelCoords,
+                                                                 const QList<Point> &points) const
+{
+  const QString NO_ERROR_REPORT_LOG_FILE;
+  MainWindow mainWindow (NO_ERROR_REPORT_LOG_FILE);
+  CmdMediator cmdMediator (mainWindow,
+                           QImage (IMAGE_WIDTH,
+                                   IMAGE_HEIGHT,
+                                   QImage::Format_RGB32));
+  cmdMediator.document().setModelCoords (modelCoords);
+
+  PointId pointId;
+  QList<Point>::const_iterator itr;
+  for (itr = points.begin (); itr != points.end (); itr++) {
+    cmdMediator.document().addPointAxisWithGeneratedIdentifier ((*itr).posScreen (),
+                                                                 (*itr).posGraph (),
+                                                                 pointId);
+  }
+
+  Transformation transformation;
+  transformation.update (true,
+                         cmdMediator);
+
+  return transformation;
+}
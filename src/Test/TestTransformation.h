@@ -0,0 +1,45 @@
+#ifndef TEST_TRANSFORMATION_H
+#define TEST_TRANSFORMATION_H
+
+#include <QList>
+#include <QObject>
+
+class DocumentModelCoords;
+class Point;
+class Transformation;
+
+/// Unit test and microbenchmark of per-point Transformation methods
+class TestTransformation : public QObject
+{
+  Q_OBJECT
+public:
+  /// Single constructor.
+  explicit TestTransformation(QObject *parent = 0);
+
+signals:
+
+private slots:
+  void cleanupTestCase ();
+  void initTestCase ();
+
+  void benchmarkScreenToGraphCached ();
+  void benchmarkScreenToGraphUncached ();
+  void testCachedMatchesUncached ();
+  void testRoundTripCartesianLogIgnoresOriginRadius ();
+  void testRoundTripLinear ();
+  void testRoundTripLogXLogY ();
+  void testRoundTripPolarDegreesLogRadius ();
+  void testRoundTripPolarRadians ();
+
+private:
+  // Verify that the axis points map onto each other, and that screen positions survive a round trip through graph
+  // coordinates, with the graph coordinates matching the formulas used before the constants were cached
+  bool roundTripMatchesBaseline (const DocumentModelCoords &modelCoords,
+                                 const QList<Point> &points) const;
+
+  // Transformation defined by three axis points
+  Transformation transformationFromAxisPoints (const DocumentModelCoords &modelCoords,
+                                               const QList<Point> &points) const;
+};
+
+#endif // TEST_TRANSFORMATION_H
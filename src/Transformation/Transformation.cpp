@@ -17,12 +17,18 @@ const double LOG_OFFSET = 1;
 Transformation::Transformation() :
   m_transformIsDefined (false)
 {
+  updateCachedCoords ();
+  updateCachedMatrices ();
 }
 
 Transformation &Transformation::operator=(const Transformation &other)
 {
   m_transformIsDefined = other.transformIsDefined();
   m_transform = other.transformMatrix ();
+  m_modelCoords = other.modelCoords ();
+
+  updateCachedCoords ();
+  updateCachedMatrices ();
 
   return *this;
 }
@@ -202,6 +208,8 @@ void Transformation::identity()
 
   QTransform ident;
   m_transform = ident;
+
+  updateCachedMatrices ();
 }
 
 double Transformation::logToLinearCartesian (double xy)
@@ -229,101 +237,22 @@ double Transformation::roundOffSmallValues (double value, double range)
   return value;
 }
 
-void Transformation::transformLinearCartesianGraphToRawGraph (const QPointF &pointLinearCartesianGraph,
-                                                              QPointF &pointRawGraph) const
-{
-  pointRawGraph = pointLinearCartesianGraph;
-
-  // Apply polar coordinates if appropriate
-  if (m_modelCoords.coordsType() == COORDS_TYPE_POLAR) {
-    pointRawGraph = cartesianOrPolarFromCartesian (m_modelCoords,
-                                                   pointRawGraph);
-  }
-
-  // Apply log scaling if appropriate
-  if (m_modelCoords.coordScaleXTheta() == COORD_SCALE_LOG) {
-    pointRawGraph.setX (qExp (pointRawGraph.x()));
-  }
-
-  if (m_modelCoords.coordScaleYRadius() == COORD_SCALE_LOG) {
-    if (m_modelCoords.coordsType() == COORDS_TYPE_CARTESIAN) {
-      // Cartesian
-      pointRawGraph.setY (qExp (pointRawGraph.y()));
-    } else {
-      // Polar radius
-      pointRawGraph.setY (qExp (pointRawGraph.y() + qLn (m_modelCoords.originRadius ())));
-    }
-  }
-}
-
-void Transformation::transformLinearCartesianGraphToScreen (const QPointF &coordGraph,
-                                                            QPointF &coordScreen) const
-{
-  ENGAUGE_ASSERT (m_transformIsDefined);
-
-  coordScreen = m_transform.inverted ().transposed ().map (coordGraph);
-}
-
 QTransform Transformation::transformMatrix () const
 {
   return m_transform;
 }
 
-void Transformation::transformRawGraphToLinearCartesianGraph (const QPointF &pointRaw,
-                                                              QPointF &pointLinearCartesian) const
+void Transformation::transformScreenToRawGraph (const QVector<QPointF> &coordsScreen,
+                                                QVector<QPointF> &coordsGraph) const
 {
-  double x = pointRaw.x();
-  double y = pointRaw.y();
-
-  // Apply log scaling if appropriate
-  if (m_modelCoords.coordScaleXTheta() == COORD_SCALE_LOG) {
-    x = logToLinearCartesian (x);
-  }
-
-  if (m_modelCoords.coordScaleYRadius() == COORD_SCALE_LOG) {
-    y = logToLinearRadius (y,
-                           m_modelCoords.originRadius());
-  }
+  coordsGraph.resize (coordsScreen.count ());
 
-  // Apply polar coordinates if appropriate. Note range coordinate has just been transformed if it has log scaling
-  if (m_modelCoords.coordsType() == COORDS_TYPE_POLAR) {
-    QPointF pointCart = cartesianFromCartesianOrPolar (m_modelCoords,
-                                                       QPointF (x, y));
-    x = pointCart.x();
-    y = pointCart.y();
+  const QPointF *coordScreen = coordsScreen.constData ();
+  QPointF *coordGraph = coordsGraph.data ();
+  for (int i = 0; i < coordsScreen.count (); i++) {
+    transformScreenToRawGraph (coordScreen [i],
+                               coordGraph [i]);
   }
-
-  pointLinearCartesian.setX (x);
-  pointLinearCartesian.setY (y);
-}
-
-void Transformation::transformRawGraphToScreen (const QPointF &pointRaw,
-                                                QPointF &pointScreen) const
-{
-  QPointF pointLinearCartesianGraph;
-
-  transformRawGraphToLinearCartesianGraph (pointRaw,
-                                           pointLinearCartesianGraph);
-  transformLinearCartesianGraphToScreen (pointLinearCartesianGraph,
-                                         pointScreen);
-}
-
-void Transformation::transformScreenToLinearCartesianGraph (const QPointF &coordScreen,
-                                                            QPointF &coordGraph) const
-{
-  ENGAUGE_ASSERT (m_transformIsDefined);
-
-  coordGraph = m_transform.transposed ().map (coordScreen);
-}
-
-void Transformation::transformScreenToRawGraph (const QPointF &coordScreen,
-                                                QPointF &coordGraph) const
-{
-  QPointF pointLinearCartesianGraph;
-  transformScreenToLinearCartesianGraph (coordScreen,
-                                         pointLinearCartesianGraph);
-  transformLinearCartesianGraphToRawGraph (pointLinearCartesianGraph,
-                                           coordGraph);
 }
 
 void Transformation::update (bool fileIsLoaded,
@@ -338,6 +267,7 @@ void Transformation::update (bool fileIsLoaded,
   } else {
 
     m_modelCoords = cmdMediator.document().modelCoords();
+    updateCachedCoords ();
 
     CallbackUpdateTransform ftor (m_modelCoords);
 
@@ -355,6 +285,48 @@ void Transformation::update (bool fileIsLoaded,
   }
 }
 
+void Transformation::updateCachedCoords ()
+{
+  m_isPolar = (m_modelCoords.coordsType() == COORDS_TYPE_POLAR);
+  m_isLogX = (m_modelCoords.coordScaleXTheta() == COORD_SCALE_LOG);
+  m_isLogY = (m_modelCoords.coordScaleYRadius() == COORD_SCALE_LOG);
+  m_logOriginRadius = ((m_isPolar && m_isLogY) ? qLn (m_modelCoords.originRadius ()) : 0.0);
+
+  switch (m_modelCoords.coordThetaUnits())
+  {
+    case COORD_THETA_UNITS_DEGREES:
+    case COORD_THETA_UNITS_DEGREES_MINUTES:
+    case COORD_THETA_UNITS_DEGREES_MINUTES_SECONDS:
+      m_thetaToRadians = PI / 180.0;
+      m_radiansToTheta = 180.0 / PI;
+      break;
+
+    case COORD_THETA_UNITS_GRADIANS:
+      m_thetaToRadians = PI / 200.0;
+      m_radiansToTheta = 200.0 / PI;
+      break;
+
+    case COORD_THETA_UNITS_RADIANS:
+      m_thetaToRadians = 1.0;
+      m_radiansToTheta = 1.0;
+      break;
+
+    case COORD_THETA_UNITS_TURNS:
+      m_thetaToRadians = 2.0 * PI;
+      m_radiansToTheta = 1.0 / (2.0 * PI);
+      break;
+
+    default:
+      ENGAUGE_ASSERT (false);
+  }
+}
+
+void Transformation::updateCachedMatrices ()
+{
+  m_transformScreenToGraph = m_transform.transposed ();
+  m_transformGraphToScreen = m_transform.inverted ().transposed ();
+}
+
 void Transformation::updateTransformFromMatrices (const QTransform &matrixScreen,
                                                   const QTransform &matrixGraph)
 {
@@ -383,4 +355,6 @@ void Transformation::updateTransformFromMatrices (const QTransform &matrixScreen
                                                              QPointF (pointGraphLinearCart0.x(), pointGraphLinearCart0.y()),
                                                              QPointF (pointGraphLinearCart1.x(), pointGraphLinearCart1.y()),
                                                              QPointF (pointGraphLinearCart2.x(), pointGraphLinearCart2.y()));
+
+  updateCachedMatrices ();
 }
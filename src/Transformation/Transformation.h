@@ -3,9 +3,12 @@
 
 #include "CmdMediator.h"
 #include "DocumentModelCoords.h"
+#include "EngaugeAssert.h"
+#include <qmath.h>
 #include <QPointF>
 #include <QString>
 #include <QTransform>
+#include <QVector>
 
 /// Affine transformation between screen and graph coordinates, based on digitized axis points.
 ///
@@ -20,6 +23,10 @@
 /// Log scaling is calculated as (xLinear - xLogMin) / (xLogMax - xLogMin) = (ln(xLog) - ln(xLogMin)) / (ln(xLogMax) - ln(xLogMin)),
 /// which leaves the points (xLogMin,yLonMin) and (xLogMax,yLogMax) unaffected but gives log growth on all
 /// other points
+///
+/// The transposed and inverted matrices, and the log and theta unit constants, are computed once whenever the
+/// transform changes, so the per-point transformations below are inline and involve no matrix inversion, no switch
+/// statements and no redundant logs
 class Transformation
 {
 public:
@@ -102,6 +109,10 @@ public:
   void transformScreenToRawGraph (const QPointF &coordScreen,
                                   QPointF &coordGraph) const;
 
+  /// Batch version of transformScreenToRawGraph, for converting many points in one call
+  void transformScreenToRawGraph (const QVector<QPointF> &coordsScreen,
+                                  QVector<QPointF> &coordsGraph) const;
+
   /// Update transform by iterating through the axis points.
   void update (bool fileIsLoaded,
                const CmdMediator &cmdMediator);
@@ -111,6 +122,17 @@ private:
   // No need to display values like 1E-17 when it is insignificant relative to the range
   double roundOffSmallValues (double value, double range);
 
+  // Apply 3x3 matrix to point. This is QTransform::map without its switch on the transformation type
+  static QPointF mapPoint (const QTransform &matrix,
+                           const QPointF &point);
+
+  // Recompute constants that depend on m_modelCoords. This must be called before m_transform is recomputed, since
+  // computing m_transform uses these constants
+  void updateCachedCoords ();
+
+  // Recompute matrices that are derived from m_transform
+  void updateCachedMatrices ();
+
   // Compute transform from screen and graph points. The 3x3 matrices are handled as QTransform since QMatrix is deprecated
   void updateTransformFromMatrices (const QTransform &matrixScreen,
                                     const QTransform &matrixGraph);
@@ -123,6 +145,123 @@ private:
 
   // Coordinates information from last time the transform was updated. Only defined if  m_transformIsDefined is true
   DocumentModelCoords m_modelCoords;
+
+  // Cached matrices derived from m_transform. These are applied directly to each point
+  QTransform m_transformScreenToGraph; // Transposed m_transform
+  QTransform m_transformGraphToScreen; // Transposed inverse of m_transform
+
+  // Cached constants derived from m_modelCoords
+  bool m_isPolar;
+  bool m_isLogX;
+  bool m_isLogY;
+  double m_logOriginRadius; // Log of the origin radius for polar coordinates, or zero for cartesian coordinates
+  double m_thetaToRadians; // Multiplier from theta units to radians
+  double m_radiansToTheta; // Multiplier from radians to theta units
 };
 
+inline QPointF Transformation::mapPoint (const QTransform &matrix,
+                                         const QPointF &point)
+{
+  double x = matrix.m11() * point.x() + matrix.m21() * point.y() + matrix.m31();
+  double y = matrix.m12() * point.x() + matrix.m22() * point.y() + matrix.m32();
+  double w = matrix.m13() * point.x() + matrix.m23() * point.y() + matrix.m33();
+
+  return QPointF (x / w,
+                  y / w);
+}
+
+inline void Transformation::transformLinearCartesianGraphToRawGraph (const QPointF &pointLinearCartesianGraph,
+                                                                     QPointF &pointRawGraph) const
+{
+  double x = pointLinearCartesianGraph.x();
+  double y = pointLinearCartesianGraph.y();
+
+  // Apply polar coordinates if appropriate
+  if (m_isPolar) {
+    double angleRadians = qAtan2 (y, x);
+    double radius = qSqrt (x * x + y * y);
+    x = angleRadians * m_radiansToTheta;
+    y = radius;
+  }
+
+  // Apply log scaling if appropriate
+  if (m_isLogX) {
+    x = qExp (x);
+  }
+
+  if (m_isLogY) {
+    y = qExp (y + m_logOriginRadius);
+  }
+
+  pointRawGraph.setX (x);
+  pointRawGraph.setY (y);
+}
+
+inline void Transformation::transformLinearCartesianGraphToScreen (const QPointF &coordGraph,
+                                                                   QPointF &coordScreen) const
+{
+  ENGAUGE_ASSERT (m_transformIsDefined);
+
+  coordScreen = mapPoint (m_transformGraphToScreen,
+                          coordGraph);
+}
+
+inline void Transformation::transformRawGraphToLinearCartesianGraph (const QPointF &pointRaw,
+                                                                     QPointF &pointLinearCartesian) const
+{
+  double x = pointRaw.x();
+  double y = pointRaw.y();
+
+  // Apply log scaling if appropriate
+  if (m_isLogX) {
+    x = qLn (x);
+  }
+
+  if (m_isLogY) {
+    y = qLn (y) - m_logOriginRadius;
+  }
+
+  // Apply polar coordinates if appropriate. Note range coordinate has just been transformed if it has log scaling
+  if (m_isPolar) {
+    double angleRadians = x * m_thetaToRadians;
+    double radius = y;
+    x = radius * qCos (angleRadians);
+    y = radius * qSin (angleRadians);
+  }
+
+  pointLinearCartesian.setX (x);
+  pointLinearCartesian.setY (y);
+}
+
+inline void Transformation::transformRawGraphToScreen (const QPointF &pointRaw,
+                                                       QPointF &pointScreen) const
+{
+  QPointF pointLinearCartesianGraph;
+
+  transformRawGraphToLinearCartesianGraph (pointRaw,
+                                           pointLinearCartesianGraph);
+  transformLinearCartesianGraphToScreen (pointLinearCartesianGraph,
+                                         pointScreen);
+}
+
+inline void Transformation::transformScreenToLinearCartesianGraph (const QPointF &coordScreen,
+                                                                   QPointF &coordGraph) const
+{
+  ENGAUGE_ASSERT (m_transformIsDefined);
+
+  coordGraph = mapPoint (m_transformScreenToGraph,
+                         coordScreen);
+}
+
+inline void Transformation::transformScreenToRawGraph (const QPointF &coordScreen,
+                                                       QPointF &coordGraph) const
+{
+  QPointF pointLinearCartesianGraph;
+
+  transformScreenToLinearCartesianGraph (coordScreen,
+                                         pointLinearCartesianGraph);
+  transformLinearCartesianGraphToRawGraph (pointLinearCartesianGraph,
+                                           coordGraph);
+}
+
 #endif // TRANSFORMATION_H
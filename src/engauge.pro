@@ -19,9 +19,11 @@ HEADERS  += \
     Callback/CallbackUpdateTransform.h \
     Checker/Checker.h \
     Checker/CheckerMode.h \
+    Checker/CheckerSideSampler.h \
     Cmd/CmdAbstract.h \
     Cmd/CmdAddPointAxis.h \
     Cmd/CmdAddPointGraph.h \
+    Cmd/CmdAddPointsGraph.h \
     Cmd/CmdCopy.h \
     Cmd/CmdCut.h \
     Cmd/CmdDelete.h \
@@ -55,6 +57,9 @@ HEADERS  += \
     Curve/CurveConnectAs.h \
     Curve/CurveNameList.h \
     Curve/CurveNameListEntry.h \
+    Curve/CurveOrdinalIndex.h \
+    Curve/CurvePointColumns.h \
+    Curve/CurvePointLookup.h \
     Curve/CurveSettingsInt.h \
     Curve/CurvesGraphs.h \
     Curve/CurveStyle.h \
@@ -76,6 +81,8 @@ HEADERS  += \
     Dlg/DlgFilterCommand.h \
     Dlg/DlgFilterThread.h \
     Dlg/DlgFilterWorker.h \
+    Dlg/DlgGridRemovalThread.h \
+    Dlg/DlgGridRemovalWorker.h \
     Dlg/DlgSettingsAbstractBase.h \
     Dlg/DlgSettingsAxesChecker.h \
     Dlg/DlgSettingsColorFilter.h \
@@ -88,6 +95,8 @@ HEADERS  += \
     Dlg/DlgSettingsSegments.h \
     Dlg/DlgValidatorLog.h \
     Document/Document.h \
+    Document/DocumentChangeSet.h \
+    Document/DocumentContainer.h \
     Document/DocumentModelAbstractBase.h \
     Document/DocumentModelAxesChecker.h \
     Document/DocumentModelColorFilter.h \
@@ -109,20 +118,25 @@ HEADERS  += \
     Export/ExportToFile.h \
     Callback/functor.h \
     Graphics/GraphicsArcItem.h \
+    Graphics/GraphicsImagePyramid.h \
+    Graphics/GraphicsImagePyramidThread.h \
     Graphics/GraphicsItemType.h \
     Graphics/GraphicsLinesForCurve.h \
     Graphics/GraphicsLinesForCurves.h \
     Graphics/GraphicsPoint.h \
     Graphics/GraphicsPointAbstractBase.h \
-    Graphics/GraphicsPointEllipse.h \
     Graphics/GraphicsPointFactory.h \
-    Graphics/GraphicsPointPolygon.h \
+    Graphics/GraphicsPointGeometry.h \
+    Graphics/GraphicsPointItem.h \
+    Graphics/GraphicsPointsForCurve.h \
     Graphics/GraphicsScene.h \
     Graphics/GraphicsView.h \
     Grid/GridClassifier.h \
     Grid/GridCoordDisable.h \
+    Grid/GridRemoval.h \
     Line/LineStyle.h \
     Load/LoadImageFromUrl.h \
+    Load/LoadImageThread.h \
     Logger/Logger.h \
     Logger/LoggerUpload.h \
     main/MainWindow.h \
@@ -131,7 +145,7 @@ HEADERS  += \
     Point/Point.h \
     Point/PointIdentifiers.h \
     Point/PointIdentifierToGraphicsPoint.h \
-    Point/PointIdentifierToPoint.h \
+    Point/PointIdTable.h \
     Point/PointShape.h \
     Point/PointStyle.h \
     util/QtToString.h \
@@ -141,6 +155,7 @@ HEADERS  += \
     Settings/Settings.h \
     Spline/Spline.h \
     Spline/SplineCoeff.h \
+    Spline/SplineIncremental.h \
     Spline/SplinePair.h \
     StatusBar/StatusBar.h \
     StatusBar/StatusBarMode.h \
@@ -172,9 +187,11 @@ SOURCES += \
     Callback/CallbackSceneUpdateAfterCommand.cpp \
     Callback/CallbackUpdateTransform.cpp \
     Checker/Checker.cpp \
+    Checker/CheckerSideSampler.cpp \
     Cmd/CmdAbstract.cpp \
     Cmd/CmdAddPointAxis.cpp \
     Cmd/CmdAddPointGraph.cpp \
+    Cmd/CmdAddPointsGraph.cpp \
     Cmd/CmdCopy.cpp \
     Cmd/CmdCut.cpp \
     Cmd/CmdDelete.cpp \
@@ -206,6 +223,9 @@ SOURCES += \
     Curve/CurveConnectAs.cpp \
     Curve/CurveNameList.cpp \
     Curve/CurveNameListEntry.cpp \
+    Curve/CurveOrdinalIndex.cpp \
+    Curve/CurvePointColumns.cpp \
+    Curve/CurvePointLookup.cpp \
     Curve/CurveSettingsInt.cpp \
     Curve/CurvesGraphs.cpp \
     Curve/CurveStyle.cpp \
@@ -226,6 +246,8 @@ SOURCES += \
     Dlg/DlgFilterCommand.cpp \
     Dlg/DlgFilterThread.cpp \
     Dlg/DlgFilterWorker.cpp \
+    Dlg/DlgGridRemovalThread.cpp \
+    Dlg/DlgGridRemovalWorker.cpp \
     Dlg/DlgSettingsAbstractBase.cpp \
     Dlg/DlgSettingsAxesChecker.cpp \
     Dlg/DlgSettingsColorFilter.cpp \
@@ -238,6 +260,8 @@ SOURCES += \
     Dlg/DlgSettingsSegments.cpp \
     Dlg/DlgValidatorLog.cpp \
     Document/Document.cpp \
+    Document/DocumentChangeSet.cpp \
+    Document/DocumentContainer.cpp \
     Document/DocumentModelAbstractBase.cpp \
     Document/DocumentModelAxesChecker.cpp \
     Document/DocumentModelColorFilter.cpp \
@@ -256,19 +280,24 @@ SOURCES += \
     Export/ExportToClipboard.cpp \
     Export/ExportToFile.cpp \
     Graphics/GraphicsArcItem.cpp \
+    Graphics/GraphicsImagePyramid.cpp \
+    Graphics/GraphicsImagePyramidThread.cpp \
     Graphics/GraphicsLinesForCurve.cpp \
     Graphics/GraphicsLinesForCurves.cpp \
     Graphics/GraphicsPoint.cpp \
     Graphics/GraphicsPointAbstractBase.cpp \
-    Graphics/GraphicsPointEllipse.cpp \
     Graphics/GraphicsPointFactory.cpp \
-    Graphics/GraphicsPointPolygon.cpp \
+    Graphics/GraphicsPointGeometry.cpp \
+    Graphics/GraphicsPointItem.cpp \
+    Graphics/GraphicsPointsForCurve.cpp \
     Graphics/GraphicsScene.cpp \
     Graphics/GraphicsView.cpp \
     Grid/GridClassifier.cpp \
     Grid/GridCoordDisable.cpp \
+    Grid/GridRemoval.cpp \
     Line/LineStyle.cpp \
     Load/LoadImageFromUrl.cpp \
+    Load/LoadImageThread.cpp \
     Logger/Logger.cpp \
     Logger/LoggerUpload.cpp \
     main/main.cpp \
@@ -277,6 +306,7 @@ SOURCES += \
     util/mmsubs.cpp \
     Point/Point.cpp \
     Point/PointIdentifiers.cpp \
+    Point/PointIdTable.cpp \
     Point/PointShape.cpp \
     Point/PointStyle.cpp \
     util/QtToString.cpp \
@@ -286,6 +316,7 @@ SOURCES += \
     Settings/Settings.cpp \
     Spline/Spline.cpp \
     Spline/SplineCoeff.cpp \
+    Spline/SplineIncremental.cpp \
     Spline/SplinePair.cpp \
     StatusBar/StatusBar.cpp \
     Transformation/Transformation.cpp \
@@ -19,9 +19,11 @@ HEADERS  += \
     Callback/CallbackUpdateTransform.h \
     Checker/Checker.h \
     Checker/CheckerMode.h \
+    Checker/CheckerSideSampler.h \
     Cmd/CmdAbstract.h \
     Cmd/CmdAddPointAxis.h \
     Cmd/CmdAddPointGraph.h \
+    Cmd/CmdAddPointsGraph.h \
     Cmd/CmdCopy.h \
     Cmd/CmdCut.h \
     Cmd/CmdDelete.h \
@@ -55,6 +57,8 @@ HEADERS  += \
     Curve/CurveConnectAs.h \
     Curve/CurveNameList.h \
     Curve/CurveNameListEntry.h \
+    Curve/CurveOrdinalIndex.h \
+    Curve/CurvePointColumns.h \
     Curve/CurveSettingsInt.h \
     Curve/CurvesGraphs.h \
     Curve/CurveStyle.h \
@@ -76,6 +80,8 @@ HEADERS  += \
     Dlg/DlgFilterCommand.h \
     Dlg/DlgFilterThread.h \
     Dlg/DlgFilterWorker.h \
+    Dlg/DlgGridRemovalThread.h \
+    Dlg/DlgGridRemovalWorker.h \
     Dlg/DlgSettingsAbstractBase.h \
     Dlg/DlgSettingsAxesChecker.h \
     Dlg/DlgSettingsColorFilter.h \
@@ -88,6 +94,8 @@ HEADERS  += \
     Dlg/DlgSettingsSegments.h \
     Dlg/DlgValidatorLog.h \
     Document/Document.h \
+    Document/DocumentChangeSet.h \
+    Document/DocumentContainer.h \
     Document/DocumentModelAbstractBase.h \
     Document/DocumentModelAxesChecker.h \
     Document/DocumentModelColorFilter.h \
@@ -109,20 +117,25 @@ HEADERS  += \
     Export/ExportToFile.h \
     Callback/functor.h \
     Graphics/GraphicsArcItem.h \
+    Graphics/GraphicsImagePyramid.h \
+    Graphics/GraphicsImagePyramidThread.h \
     Graphics/GraphicsItemType.h \
     Graphics/GraphicsLinesForCurve.h \
     Graphics/GraphicsLinesForCurves.h \
     Graphics/GraphicsPoint.h \
     Graphics/GraphicsPointAbstractBase.h \
-    Graphics/GraphicsPointEllipse.h \
     Graphics/GraphicsPointFactory.h \
-    Graphics/GraphicsPointPolygon.h \
+    Graphics/GraphicsPointGeometry.h \
+    Graphics/GraphicsPointItem.h \
+    Graphics/GraphicsPointsForCurve.h \
     Graphics/GraphicsScene.h \
     Graphics/GraphicsView.h \
     Grid/GridClassifier.h \
     Grid/GridCoordDisable.h \
+    Grid/GridRemoval.h \
     Line/LineStyle.h \
     Load/LoadImageFromUrl.h \
+    Load/LoadImageThread.h \
     Logger/Logger.h \
     Logger/LoggerUpload.h \
     main/MainWindow.h \
@@ -131,7 +144,7 @@ HEADERS  += \
     Point/Point.h \
     Point/PointIdentifiers.h \
     Point/PointIdentifierToGraphicsPoint.h \
-    Point/PointIdentifierToPoint.h \
+    Point/PointIdTable.h \
     Point/PointShape.h \
     Point/PointStyle.h \
     util/QtToString.h \
@@ -141,6 +154,7 @@ HEADERS  += \
     Settings/Settings.h \
     Spline/Spline.h \
     Spline/SplineCoeff.h \
+    Spline/SplineIncremental.h \
     Spline/SplinePair.h \
     StatusBar/StatusBar.h \
     StatusBar/StatusBarMode.h \
@@ -173,9 +187,11 @@ SOURCES += \
     Callback/CallbackSceneUpdateAfterCommand.cpp \
     Callback/CallbackUpdateTransform.cpp \
     Checker/Checker.cpp \
+    Checker/CheckerSideSampler.cpp \
     Cmd/CmdAbstract.cpp \
     Cmd/CmdAddPointAxis.cpp \
     Cmd/CmdAddPointGraph.cpp \
+    Cmd/CmdAddPointsGraph.cpp \
     Cmd/CmdCopy.cpp \
     Cmd/CmdCut.cpp \
     Cmd/CmdDelete.cpp \
@@ -207,6 +223,8 @@ SOURCES += \
     Curve/CurveConnectAs.cpp \
     Curve/CurveNameList.cpp \
     Curve/CurveNameListEntry.cpp \
+    Curve/CurveOrdinalIndex.cpp \
+    Curve/CurvePointColumns.cpp \
     Curve/CurveSettingsInt.cpp \
     Curve/CurvesGraphs.cpp \
     Curve/CurveStyle.cpp \
@@ -227,6 +245,8 @@ SOURCES += \
     Dlg/DlgFilterCommand.cpp \
     Dlg/DlgFilterThread.cpp \
     Dlg/DlgFilterWorker.cpp \
+    Dlg/DlgGridRemovalThread.cpp \
+    Dlg/DlgGridRemovalWorker.cpp \
     Dlg/DlgSettingsAbstractBase.cpp \
     Dlg/DlgSettingsAxesChecker.cpp \
     Dlg/DlgSettingsColorFilter.cpp \
@@ -239,6 +259,8 @@ SOURCES += \
     Dlg/DlgSettingsSegments.cpp \
     Dlg/DlgValidatorLog.cpp \
     Document/Document.cpp \
+    Document/DocumentChangeSet.cpp \
+    Document/DocumentContainer.cpp \
     Document/DocumentModelAbstractBase.cpp \
     Document/DocumentModelAxesChecker.cpp \
     Document/DocumentModelColorFilter.cpp \
@@ -257,19 +279,24 @@ SOURCES += \
     Export/ExportToClipboard.cpp \
     Export/ExportToFile.cpp \
     Graphics/GraphicsArcItem.cpp \
+    Graphics/GraphicsImagePyramid.cpp \
+    Graphics/GraphicsImagePyramidThread.cpp \
     Graphics/GraphicsLinesForCurve.cpp \
     Graphics/GraphicsLinesForCurves.cpp \
     Graphics/GraphicsPoint.cpp \
     Graphics/GraphicsPointAbstractBase.cpp \
-    Graphics/GraphicsPointEllipse.cpp \
     Graphics/GraphicsPointFactory.cpp \
-    Graphics/GraphicsPointPolygon.cpp \
+    Graphics/GraphicsPointGeometry.cpp \
+    Graphics/GraphicsPointItem.cpp \
+    Graphics/GraphicsPointsForCurve.cpp \
     Graphics/GraphicsScene.cpp \
     Graphics/GraphicsView.cpp \
     Grid/GridClassifier.cpp \
     Grid/GridCoordDisable.cpp \
+    Grid/GridRemoval.cpp \
     Line/LineStyle.cpp \
     Load/LoadImageFromUrl.cpp \
+    Load/LoadImageThread.cpp \
     Logger/Logger.cpp \
     Logger/LoggerUpload.cpp \
     main/MainWindow.cpp \
@@ -277,6 +304,7 @@ SOURCES += \
     util/mmsubs.cpp \
     Point/Point.cpp \
     Point/PointIdentifiers.cpp \
+    Point/PointIdTable.cpp \
     Point/PointShape.cpp \
     Point/PointStyle.cpp \
     util/QtToString.cpp \
@@ -286,6 +314,7 @@ SOURCES += \
     Settings/Settings.cpp \
     Spline/Spline.cpp \
     Spline/SplineCoeff.cpp \
+    Spline/SplineIncremental.cpp \
     Spline/SplinePair.cpp \
     StatusBar/StatusBar.cpp \
     Test/TEST.cpp \
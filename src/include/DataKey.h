@@ -7,7 +7,7 @@ enum DataKey {
   DATA_KEY_GRAPHICS_ITEM_TYPE,   ///> Item type (i.e. image versus point)
   DATA_KEY_ORDINAL_LAST,         ///> Ordinal value of previous point. This and DATA_KEY_ORDINAL apply to a line since it has two points
   DATA_KEY_ORDINAL,              ///> Ordinal value for ordering points when drawing lines
-  DATA_KEY_POSITION_HAS_CHANGED  ///> True if item has changed since last mousePressEvent
+  DATA_KEY_POINT_ID              ///> PointId of a point, so the identifier does not have to be looked up in the PointIdTable
 };
 
 #endif // DATA_KEY_H
@@ -30,14 +30,17 @@
 #include "DlgSettingsGridRemoval.h"
 #include "DlgSettingsPointMatch.h"
 #include "DlgSettingsSegments.h"
+#include "DocumentContainer.h"
 #include "DocumentSerialize.h"
 #include "EngaugeAssert.h"
 #include "EnumsToQt.h"
 #include "ExportToFile.h"
 #include "GraphicsItemType.h"
+#include "GraphicsImagePyramid.h"
 #include "GraphicsScene.h"
 #include "GraphicsView.h"
 #include "LoadImageFromUrl.h"
+#include "LoadImageThread.h"
 #include "Logger.h"
 #include "MainWindow.h"
 #include <QAction>
@@ -49,8 +52,10 @@
 #include <QKeyEvent>
 #include <QFileDialog>
 #include <QFileInfo>
+#include <QGuiApplication>
 #include <QGraphicsLineItem>
 #include <QGraphicsPixmapItem>
+#include <QGraphicsRectItem>
 #include <QImageReader>
 #include <QKeyEvent>
 #include <QKeySequence>
@@ -60,8 +65,10 @@
 #include <QMessageBox>
 #include <QPrintDialog>
 #include <QPrinter>
+#include <QScreen>
 #include <QSettings>
 #include <QTextStream>
+#include <QTimer>
 #include <QToolBar>
 #include <QToolButton>
 #include "QtToString.h"
@@ -88,11 +95,24 @@ const QString DIGITIZE_ACTION_SELECT (QObject::tr ("Select Tool"));
 const QString EMPTY_FILENAME ("");
 const QString ENGAUGE_FILENAME_DESCRIPTION ("Engauge Document");
 const QString ENGAUGE_FILENAME_EXTENSION ("dig");
+const QString ENGAUGE_CONTAINER_FILENAME_DESCRIPTION ("Engauge Document Container");
+const QString ENGAUGE_CONTAINER_FILENAME_EXTENSION ("digc"); // DocumentContainer format, which opens faster than xml
 const QString CSV_FILENAME_EXTENSION ("csv");
 const QString TSV_FILENAME_EXTENSION ("tsv");
 
 const unsigned int MAX_RECENT_FILE_LIST_SIZE = 8;
 
+// Lines are updated at most once per display refresh while points are being dragged, since mouse moves can arrive much
+// faster than that. This interval, for 60 hertz, applies if the refresh rate of the screen is not known
+const int DRAG_LINES_INTERVAL_DEFAULT_MS = 16;
+
+// Memory budget for the tile pixmaps of each background image, unless the settings have another value. This is several
+// screens full of tiles even on large monitors
+const int TILE_CACHE_MEGABYTES_DEFAULT = 128;
+
+// Import preview is in front of everything, so it hides the previous Document until the new image is ready
+const double Z_VALUE_IMAGE_PREVIEW = 1000.0;
+
 const char *VERSION_NUMBER = "6.0";
 
 MainWindow::MainWindow(const QString &errorReportFile,
@@ -103,9 +123,14 @@ MainWindow::MainWindow(const QString &errorReportFile,
   m_layout (0),
   m_scene (0),
   m_view (0),
+  m_timerDragLines (0),
   m_imageNone (0),
   m_imageUnfiltered (0),
   m_imageFiltered (0),
+  m_tileCacheMegabytes (TILE_CACHE_MEGABYTES_DEFAULT),
+  m_imageOriginalKey (0),
+  m_loadImageThread (0),
+  m_imagePreview (0),
   m_cmdMediator (0),
   m_transformationStateContext (0)
 {
@@ -144,6 +169,32 @@ MainWindow::MainWindow(const QString &errorReportFile,
 
 MainWindow::~MainWindow()
 {
+  if (m_loadImageThread != 0) {
+    m_loadImageThread->stop ();
+    m_loadImageThread->wait ();
+    delete m_loadImageThread;
+  }
+}
+
+void MainWindow::abandonLoadImageThread ()
+{
+  if (m_loadImageThread != 0) {
+
+    LOG4CPP_INFO_S ((*mainCat)) << "MainWindow::abandonLoadImageThread";
+
+    // Decoding cannot be interrupted, so the thread deletes itself when it finishes. Signals it queued before the
+    // disconnect are still delivered, so deletion is always deferred until after them. Otherwise a new thread could
+    // reuse the address and those signals would pass isSignalFromLoadImageThread
+    disconnect (m_loadImageThread, 0, this, 0);
+    connect (m_loadImageThread, SIGNAL (finished ()), m_loadImageThread, SLOT (deleteLater ()));
+    m_loadImageThread->stop ();
+    if (m_loadImageThread->isFinished ()) {
+      m_loadImageThread->deleteLater ();
+    }
+
+    m_loadImageThread = 0;
+    QApplication::restoreOverrideCursor ();
+  }
 }
 
 void MainWindow::closeEvent(QCloseEvent *event)
@@ -773,6 +824,18 @@ void MainWindow::createScene ()
   m_scene = new GraphicsScene (this);
   m_view = new GraphicsView (m_scene, *this);
   m_layout->addWidget (m_view);
+
+  int intervalDragLines = DRAG_LINES_INTERVAL_DEFAULT_MS;
+  QScreen *screen = QGuiApplication::primaryScreen ();
+  if ((screen != 0) &&
+      (screen->refreshRate () > 0)) {
+    intervalDragLines = qRound (1000.0 / screen->refreshRate ());
+  }
+
+  m_timerDragLines = new QTimer (this);
+  m_timerDragLines->setSingleShot (true);
+  m_timerDragLines->setInterval (intervalDragLines);
+  connect (m_timerDragLines, SIGNAL (timeout ()), this, SLOT (slotTimeoutDragLines ()));
 }
 
 void MainWindow::createStateContextDigitize ()
@@ -892,28 +955,19 @@ void MainWindow::fileImport (const QString &fileName)
 {
   LOG4CPP_INFO_S ((*mainCat)) << "MainWindow::fileImport fileName=" << fileName.toLatin1 ().data ();
 
-  QString originalFileOld = m_originalFile;
-  bool originalFileWasImported = m_originalFileWasImported;
-
-  m_originalFile = fileName; // Make this available for logging in case an error occurs during the load
-  m_originalFileWasImported = true;
-
-  QImage image;
-  if (!image.load (fileName)) {
-    QMessageBox::warning (this,
-                          engaugeWindowTitle(),
-                          tr("Cannot read file %1.").
-                          arg(fileName));
+  // Decoding continues in slotFileImportPreview and slotFileImportImage, or slotFileImportFailed
+  startLoadImageThread (new LoadImageThread (fileName));
+}
 
-    // Reset
-    m_originalFile = originalFileOld;
-    m_originalFileWasImported = originalFileWasImported;
+bool MainWindow::isSignalFromLoadImageThread () const
+{
+  if (sender () != m_loadImageThread) {
 
-    return;
+    LOG4CPP_INFO_S ((*mainCat)) << "MainWindow::isSignalFromLoadImageThread ignoring signal from abandoned thread";
+    return false;
   }
 
-  loadImage (fileName,
-             image);
+  return true;
 }
 
 void MainWindow::loadCurveListFromCmdMediator ()
@@ -940,6 +994,9 @@ void MainWindow::loadDocumentFile (const QString &fileName)
 
   if (cmdMediator->successfulRead ()) {
 
+    // Any image that is still being decoded belongs to the previous Document, or to an import that is superseded
+    abandonLoadImageThread ();
+
     setCurrentPathFromFile (fileName);
     rebuildRecentFileListForCurrentFile(fileName);
     m_currentFile = fileName; // This enables the FileSaveAs menu option
@@ -964,6 +1021,15 @@ void MainWindow::loadDocumentFile (const QString &fileName)
 
     updateAfterCommand (); // Enable Save button now that m_engaugeFile is set
 
+    if (m_cmdMediator->document ().imageIsPending ()) {
+
+      // Curves and settings of a DocumentContainer file are shown already, in front of a blank placeholder, while the
+      // image chunk is decoded. See slotFileImportImage
+      startLoadImageThread (new LoadImageThread (fileName,
+                                                 m_cmdMediator->document ().imageChunk (),
+                                                 true));
+    }
+
   } else {
 
     QMessageBox::warning (this,
@@ -1058,6 +1124,17 @@ void MainWindow::loadImage (const QString &fileName,
 
 void MainWindow::loadInputFileForErrorReport(QDomDocument &domInputFile) const
 {
+  if (DocumentContainer::isContainerFile (m_originalFile)) {
+
+    // Only the xml section is wanted, which leaves out the image just like the CDATA removal below
+    DocumentContainer container (m_originalFile);
+    if (container.isValid ()) {
+      domInputFile.setContent (container.xml ());
+    }
+
+    return;
+  }
+
   QFile file (m_originalFile);
 
   // File should be available for opening, if not then the dom will be left empty. We assume it has not been
@@ -1141,20 +1218,35 @@ void MainWindow::rebuildRecentFileListForCurrentFile(const QString &filePath)
   updateRecentFileList();
 }
 
+void MainWindow::removeImagePreview ()
+{
+  if (m_imagePreview != 0) {
+    m_scene->removeItem (m_imagePreview);
+    delete m_imagePreview;
+    m_imagePreview = 0;
+  }
+}
+
 void MainWindow::removePixmaps ()
 {
+  removeImagePreview ();
+
+  // Items are deleted rather than just removed, since the pyramids hold tiles and possibly a running thread
   if (m_imageNone != 0) {
     m_scene->removeItem (m_imageNone);
+    delete m_imageNone;
     m_imageNone = 0;
   }
 
   if (m_imageUnfiltered != 0) {
     m_scene->removeItem (m_imageUnfiltered);
+    delete m_imageUnfiltered;
     m_imageUnfiltered = 0;
   }
 
   if (m_imageFiltered != 0) {
     m_scene->removeItem (m_imageFiltered);
+    delete m_imageFiltered;
     m_imageFiltered = 0;
   }
 }
@@ -1184,12 +1276,28 @@ bool MainWindow::saveDocumentFile (const QString &fileName)
 
   rebuildRecentFileListForCurrentFile (fileName);
 
+  // Xml is the default format. The DocumentContainer format is only used when its extension is chosen
+  bool success = true;
   QApplication::setOverrideCursor (Qt::WaitCursor);
-  QXmlStreamWriter stream(&file);
-  stream.setAutoFormatting(true);
-  m_cmdMediator->document().saveXml(stream);
+  if (fileName.endsWith (QString (".%1").arg (ENGAUGE_CONTAINER_FILENAME_EXTENSION))) {
+    success = m_cmdMediator->document().saveContainer (file);
+  } else {
+    QXmlStreamWriter stream(&file);
+    stream.setAutoFormatting(true);
+    m_cmdMediator->document().saveXml(stream);
+    success = !stream.hasError ();
+  }
   QApplication::restoreOverrideCursor ();
 
+  if (!success) {
+    QMessageBox::warning (this,
+                          engaugeWindowTitle(),
+                          tr ("Cannot write file %1: \n%2.").
+                          arg(fileName).
+                          arg(file.errorString()));
+    return false;
+  }
+
   // Notify the undo stack that the current state is now considered "clean". This will automatically trigger a
   // signal back to this class that will update the modified marker in the title bar
   m_cmdMediator->setClean ();
@@ -1399,6 +1507,8 @@ void MainWindow::settingsReadEnvironment (QSettings &settings)
   settings.beginGroup (SETTINGS_GROUP_ENVIRONMENT);
   QDir::setCurrent (settings.value (SETTINGS_CURRENT_DIRECTORY,
                                     QDir::currentPath ()).toString ());
+  m_tileCacheMegabytes = settings.value (SETTINGS_TILE_CACHE_MEGABYTES,
+                                         TILE_CACHE_MEGABYTES_DEFAULT).toInt ();
   settings.endGroup ();
 }
 
@@ -1457,6 +1567,7 @@ void MainWindow::settingsWrite ()
 
   settings.beginGroup (SETTINGS_GROUP_ENVIRONMENT);
   settings.setValue (SETTINGS_CURRENT_DIRECTORY, QDir::currentPath ());
+  settings.setValue (SETTINGS_TILE_CACHE_MEGABYTES, m_tileCacheMegabytes);
   settings.endGroup ();
 
   settings.beginGroup (SETTINGS_GROUP_MAIN_WINDOW);
@@ -1736,14 +1847,117 @@ void MainWindow::slotFileImportDraggedImageUrl(QUrl url)
   m_loadImageFromUrl->startLoadImage (url);
 }
 
-void MainWindow::slotFileImportImage(QString fileName, QImage image)
+void MainWindow::slotFileImportData(QString name, QByteArray data)
+{
+  LOG4CPP_INFO_S ((*mainCat)) << "MainWindow::slotFileImportData name=" << name.toLatin1 ().data ();
+
+  startLoadImageThread (new LoadImageThread (name,
+                                             data,
+                                             false));
+}
+
+void MainWindow::slotFileImportFailed(QString name, QString reason)
+{
+  LOG4CPP_INFO_S ((*mainCat)) << "MainWindow::slotFileImportFailed"
+                              << " name=" << name.toLatin1 ().data ()
+                              << " reason=" << reason.toLatin1 ().data ();
+
+  if (!isSignalFromLoadImageThread ()) {
+    return;
+  }
+
+  m_loadImageThread->wait ();
+  delete m_loadImageThread;
+  m_loadImageThread = 0;
+  QApplication::restoreOverrideCursor ();
+
+  // Bring back the previous Document, if there is one, from behind the preview
+  removeImagePreview ();
+  if (m_imageUnfiltered != 0) {
+    m_scene->setSceneRect (m_imageUnfiltered->boundingRect ());
+    slotViewZoomFill ();
+  }
+
+  QMessageBox::warning (this,
+                        engaugeWindowTitle(),
+                        tr("Cannot read file %1.").
+                        arg(name));
+}
+
+void MainWindow::slotFileImportFile(QString fileName)
+{
+  LOG4CPP_INFO_S ((*mainCat)) << "MainWindow::slotFileImportFile fileName=" << fileName.toLatin1 ().data ();
+
+  fileImport (fileName);
+}
+
+void MainWindow::slotFileImportImage(QString name, QImage image, QImage imageFiltered)
 {
-  LOG4CPP_INFO_S ((*mainCat)) << "MainWindow::slotFileImportImage fileName=" << fileName.toLatin1 ().data ();
+  LOG4CPP_INFO_S ((*mainCat)) << "MainWindow::slotFileImportImage name=" << name.toLatin1 ().data ();
+
+  if (!isSignalFromLoadImageThread ()) {
+    return;
+  }
+
+  // Images from files are available for logging in case an error occurs later. Downloaded images are not
+  if (!m_loadImageThread->fileName ().isEmpty ()) {
+    m_originalFile = m_loadImageThread->fileName ();
+    m_originalFileWasImported = true;
+  }
+
+  bool isDocumentImage = m_loadImageThread->isDocumentImage ();
+
+  // The thread has sent its last signal, so it is about to finish
+  m_loadImageThread->wait ();
+  delete m_loadImageThread;
+  m_loadImageThread = 0;
+  QApplication::restoreOverrideCursor ();
+
+  // Decoded image has the same pixels as the pixmap made from it, so updateImages does not convert the pixmap back
+  m_imageFromImport = image;
 
-  loadImage (fileName,
+  if (isDocumentImage) {
+
+    // Image chunk of the current Document replaces its placeholder. Any other load would have abandoned this thread
+    m_cmdMediator->document ().setImage (image);
+    setPixmap (m_cmdMediator->pixmap ());
+    updateViewsOfSettings (); // Segment filter histogram was computed from the placeholder
+    updateControls (); // Image dependent controls were disabled while the image was pending
+    return;
+  }
+
+  m_imageFilteredFromImport = imageFiltered;
+
+  loadImage (name,
              image);
 }
 
+void MainWindow::slotFileImportPreview(QString name, QImage imagePreview, QSize sizeFull)
+{
+  LOG4CPP_INFO_S ((*mainCat)) << "MainWindow::slotFileImportPreview"
+                              << " name=" << name.toLatin1 ().data ()
+                              << " preview=" << imagePreview.width () << "x" << imagePreview.height ()
+                              << " full=" << sizeFull.width () << "x" << sizeFull.height ();
+
+  if (!isSignalFromLoadImageThread ()) {
+    return;
+  }
+
+  // Preview is stretched to the size of the full image, so the zoom does not jump when the full image replaces it
+  removeImagePreview ();
+  m_imagePreview = m_scene->addPixmap (QPixmap::fromImage (imagePreview));
+  m_imagePreview->setTransformationMode (Qt::SmoothTransformation);
+  m_imagePreview->setTransform (QTransform::fromScale ((double) sizeFull.width () / imagePreview.width (),
+                                                       (double) sizeFull.height () / imagePreview.height ()));
+  m_imagePreview->setZValue (Z_VALUE_IMAGE_PREVIEW);
+
+  m_scene->setSceneRect (QRectF (QPointF (0, 0),
+                                 sizeFull));
+  m_view->fitInView (m_imagePreview);
+
+  m_statusBar->showTemporaryMessage (tr ("Loading %1").arg (name));
+}
+
 void MainWindow::slotFileOpen()
 {
   LOG4CPP_INFO_S ((*mainCat)) << "MainWindow::slotFileOpen";
@@ -1752,9 +1966,10 @@ void MainWindow::slotFileOpen()
 
     // Allow selection of files with strange suffixes in case the file extension was changed. Since
     // the default is the first filter, the wildcard filter is added afterwards (it is the off-nominal case)
-    QString filter = QString ("%1 (*.%2);; All Files (*.*)")
+    QString filter = QString ("%1 (*.%2 *.%3);; All Files (*.*)")
                      .arg (ENGAUGE_FILENAME_DESCRIPTION)
-                     .arg (ENGAUGE_FILENAME_EXTENSION);
+                     .arg (ENGAUGE_FILENAME_EXTENSION)
+                     .arg (ENGAUGE_CONTAINER_FILENAME_EXTENSION);
 
     QString fileName = QFileDialog::getOpenFileName (this,
                                                      tr("Open Document"),
@@ -1798,7 +2013,8 @@ bool MainWindow::slotFileSaveAs()
 
   // Append engauge file extension if it is not already there
   QString filenameDefault = m_currentFile;
-  if (!m_currentFile.endsWith (ENGAUGE_FILENAME_EXTENSION)) {
+  if (!m_currentFile.endsWith (ENGAUGE_FILENAME_EXTENSION) &&
+      !m_currentFile.endsWith (ENGAUGE_CONTAINER_FILENAME_EXTENSION)) {
     filenameDefault = QString ("%1.%2")
                                .arg (m_currentFile)
                                .arg (ENGAUGE_FILENAME_EXTENSION);
@@ -1811,15 +2027,22 @@ bool MainWindow::slotFileSaveAs()
   QString filterDigitizer = QString ("%1 (*.%2)")
                             .arg (ENGAUGE_FILENAME_DESCRIPTION)
                             .arg (ENGAUGE_FILENAME_EXTENSION);
+  QString filterContainer = QString ("%1 (*.%2)")
+                            .arg (ENGAUGE_CONTAINER_FILENAME_DESCRIPTION)
+                            .arg (ENGAUGE_CONTAINER_FILENAME_EXTENSION);
   QString filterAll ("All files (*. *)");
 
   QStringList filters;
   filters << filterDigitizer;
+  filters << filterContainer;
   filters << filterAll;
 
+  // Name filters must be set before one of them can be selected
   QFileDialog dlg(this);
-  dlg.selectNameFilter (filterDigitizer);
   dlg.setNameFilters (filters);
+  dlg.selectNameFilter (filenameDefault.endsWith (ENGAUGE_CONTAINER_FILENAME_EXTENSION) ?
+                        filterContainer :
+                        filterDigitizer);
   dlg.setWindowModality(Qt::WindowModal);
   dlg.setAcceptMode(QFileDialog::AcceptSave);
   dlg.selectFile(filenameDefault);
@@ -1873,7 +2096,12 @@ void MainWindow::slotMouseMove (QPointF pos)
                                  coordsGraph,
                                  resolutionGraph);
 
-    updateGraphicsLinesToMatchGraphicsPoints();
+    // Lines only move while points are being dragged, and are then updated by the timer so many mouse moves result
+    // in one update. Plain hovering involves no line work
+    if (m_scene->dragSessionIsActive () &&
+        !m_timerDragLines->isActive ()) {
+      m_timerDragLines->start ();
+    }
   }
 }
 
@@ -1890,6 +2118,12 @@ void MainWindow::slotMouseRelease (QPointF pos)
 {
   LOG4CPP_INFO_S ((*mainCat)) << "MainWindow::slotMouseRelease";
 
+  // Catch up on any line update that is still waiting for the timer
+  if (m_timerDragLines->isActive ()) {
+    m_timerDragLines->stop ();
+    slotTimeoutDragLines ();
+  }
+
   m_digitizeStateContext->handleMouseRelease (pos);
 }
 
@@ -1996,6 +2230,18 @@ void MainWindow::slotSettingsSegments ()
   m_dlgSettingsSegments->show ();
 }
 
+void MainWindow::slotTimeoutDragLines ()
+{
+  LOG4CPP_DEBUG_S ((*mainCat)) << "MainWindow::slotTimeoutDragLines";
+
+  if ((m_cmdMediator != 0) &&
+      m_scene->dragSessionIsActive ()) {
+
+    m_scene->updateGraphicsLinesForDragSession (m_cmdMediator->document().modelCurveStyles(),
+                                                m_transformation);
+  }
+}
+
 void MainWindow::slotUndoTextChanged (const QString &text)
 {
   LOG4CPP_DEBUG_S ((*mainCat)) << "MainWindow::slotUndoTextChanged";
@@ -2384,6 +2630,25 @@ void MainWindow::slotViewZoomOut ()
   }
 }
 
+void MainWindow::startLoadImageThread (LoadImageThread *loadImageThread)
+{
+  LOG4CPP_INFO_S ((*mainCat)) << "MainWindow::startLoadImageThread";
+
+  abandonLoadImageThread ();
+
+  // Busy rather than wait cursor, since the user interface stays responsive
+  QApplication::setOverrideCursor (Qt::BusyCursor);
+
+  m_loadImageThread = loadImageThread;
+  connect (m_loadImageThread, SIGNAL (signalTransferFailed (QString, QString)),
+           this, SLOT (slotFileImportFailed (QString, QString)));
+  connect (m_loadImageThread, SIGNAL (signalTransferImage (QString, QImage, QImage)),
+           this, SLOT (slotFileImportImage (QString, QImage, QImage)));
+  connect (m_loadImageThread, SIGNAL (signalTransferPreview (QString, QImage, QSize)),
+           this, SLOT (slotFileImportPreview (QString, QImage, QSize)));
+  m_loadImageThread->start ();
+}
+
 Transformation MainWindow::transformation() const
 {
   Q_ASSERT (transformIsDefined ());
@@ -2459,6 +2724,15 @@ void MainWindow::updateAfterCommandStatusBarCoords ()
 
   }
 
+  if ((m_transformationBefore != m_transformation) &&
+      m_cmdMediator->document().modelGridRemoval().removeDefinedGridLines()) {
+
+    // Grid lines are defined in graph coordinates so they move on the screen along with the transformation
+    updateImages (m_cmdMediator->document().pixmap());
+    updateViewedBackground ();
+
+  }
+
   QPoint posLocal = m_view->mapFromGlobal (QCursor::pos ()) - HACK_SO_GRAPH_COORDINATE_MATCHES_INPUT;
   QPointF posScreen = m_view->mapToScene (posLocal);
 
@@ -2476,14 +2750,20 @@ void MainWindow::updateControls ()
 {
 //  LOG4CPP_INFO_S ((*mainCat)) << "MainWindow::updateControls";
 
-  m_cmbBackground->setEnabled (!m_currentFile.isEmpty ());
+  // While the image chunk of a DocumentContainer is being decoded, the Document pixmap is a blank placeholder. The
+  // tools, dialogs and outputs that read its pixels stay disabled until slotFileImportImage brings in the image
+  bool imageIsReady = (!m_currentFile.isEmpty () &&
+                       ((m_cmdMediator == 0) ||
+                        !m_cmdMediator->document ().imageIsPending ()));
+
+  m_cmbBackground->setEnabled (imageIsReady);
 
   m_menuFileOpenRecent->setEnabled ((m_actionRecentFiles.count () > 0) &&
                                     (m_actionRecentFiles.at(0)->isVisible ())); // Need at least one visible recent file entry
   m_actionSave->setEnabled (!m_engaugeFile.isEmpty ());
   m_actionSaveAs->setEnabled (!m_currentFile.isEmpty ());
   m_actionExport->setEnabled (!m_currentFile.isEmpty ());
-  m_actionPrint->setEnabled (!m_currentFile.isEmpty ());
+  m_actionPrint->setEnabled (imageIsReady);
 
   if (m_cmdMediator == 0) {
     m_actionEditUndo->setEnabled (false);
@@ -2492,16 +2772,16 @@ void MainWindow::updateControls ()
     m_actionEditUndo->setEnabled (m_cmdMediator->canUndo ());
     m_actionEditRedo->setEnabled (m_cmdMediator->canRedo () || m_cmdStackShadow->canRedo ());
   }
-  m_actionEditCut->setEnabled (m_scene->selectedItems().count () > 0);
-  m_actionEditCopy->setEnabled (m_scene->selectedItems().count () > 0);
+  m_actionEditCut->setEnabled (m_scene->hasSelectedPoints ());
+  m_actionEditCopy->setEnabled (m_scene->hasSelectedPoints ());
   m_actionEditPaste->setEnabled (false);
-  m_actionEditDelete->setEnabled (m_scene->selectedItems().count () > 0);
+  m_actionEditDelete->setEnabled (m_scene->hasSelectedPoints ());
 
-  m_actionDigitizeAxis->setEnabled (!m_currentFile.isEmpty ());
+  m_actionDigitizeAxis->setEnabled (imageIsReady); // Completing the axes classifies the grid lines in the image
   m_actionDigitizeCurve ->setEnabled (!m_currentFile.isEmpty ());
-  m_actionDigitizePointMatch->setEnabled (!m_currentFile.isEmpty ());
-  m_actionDigitizeColorPicker->setEnabled (!m_currentFile.isEmpty ());
-  m_actionDigitizeSegment->setEnabled (!m_currentFile.isEmpty ());
+  m_actionDigitizePointMatch->setEnabled (imageIsReady);
+  m_actionDigitizeColorPicker->setEnabled (imageIsReady);
+  m_actionDigitizeSegment->setEnabled (imageIsReady);
   m_actionDigitizeSelect->setEnabled (!m_currentFile.isEmpty ());
 
   m_actionViewBackground->setEnabled (!m_currentFile.isEmpty());
@@ -2512,11 +2792,11 @@ void MainWindow::updateControls ()
   m_actionSettingsCurveProperties->setEnabled (!m_currentFile.isEmpty ());
   m_actionSettingsCurves->setEnabled (!m_currentFile.isEmpty ());
   m_actionSettingsExport->setEnabled (!m_currentFile.isEmpty ());
-  m_actionSettingsColorFilter->setEnabled (!m_currentFile.isEmpty ());
+  m_actionSettingsColorFilter->setEnabled (imageIsReady);
   m_actionSettingsAxesChecker->setEnabled (!m_currentFile.isEmpty ());
-  m_actionSettingsGridRemoval->setEnabled (!m_currentFile.isEmpty ());
-  m_actionSettingsPointMatch->setEnabled (!m_currentFile.isEmpty ());
-  m_actionSettingsSegments->setEnabled (!m_currentFile.isEmpty ());
+  m_actionSettingsGridRemoval->setEnabled (imageIsReady);
+  m_actionSettingsPointMatch->setEnabled (imageIsReady);
+  m_actionSettingsSegments->setEnabled (imageIsReady);
 
   m_groupBackground->setEnabled (!m_currentFile.isEmpty ());
   m_groupPoints->setEnabled (!m_currentFile.isEmpty ());
@@ -2526,11 +2806,12 @@ void MainWindow::updateControls ()
   m_actionZoomOut->setEnabled (!m_currentFile.isEmpty ()); // Disable at startup so shortcut has no effect
 }
 
-void MainWindow::updateGraphicsLinesToMatchGraphicsPoints()
+void MainWindow::updateGraphicsLinesToMatchGraphicsPoints(const QVector<PointId> &pointIds)
 {
   LOG4CPP_INFO_S ((*mainCat)) << "MainWindow::updateGraphicsLinesToMatchGraphicsPoints";
 
-  m_scene->updateGraphicsLinesToMatchGraphicsPoints(m_cmdMediator->document().modelCurveStyles(),
+  m_scene->updateGraphicsLinesToMatchGraphicsPoints(pointIds,
+                                                    m_cmdMediator->document().modelCurveStyles(),
                                                     m_transformation);
 }
 
@@ -2540,38 +2821,72 @@ void MainWindow::updateImages (const QPixmap &pixmap)
 
   removePixmaps ();
 
-  // Empty background
-  QPixmap pixmapNone (pixmap);
-  pixmapNone.fill (Qt::white);
-  m_imageNone = m_scene->addPixmap (pixmapNone);
+  // Empty background, which is just a brush so no pixels are stored
+  m_imageNone = m_scene->addRect (QRectF (pixmap.rect ()),
+                                  QPen (Qt::NoPen),
+                                  QBrush (Qt::white));
   m_imageNone->setData (DATA_KEY_IDENTIFIER, "view");
   m_imageNone->setData (DATA_KEY_GRAPHICS_ITEM_TYPE, GRAPHICS_ITEM_TYPE_IMAGE);
 
-  // Unfiltered original image
-  m_imageUnfiltered = m_scene->addPixmap (pixmap);
-  m_imageUnfiltered->setData (DATA_KEY_IDENTIFIER, "view");
-  m_imageUnfiltered->setData (DATA_KEY_GRAPHICS_ITEM_TYPE, GRAPHICS_ITEM_TYPE_IMAGE);
+  // Unfiltered original image. The conversion is skipped while the pixmap is unchanged, which also lets m_gridRemoval
+  // mask just the pixels around grid lines that changed
+  if (m_imageOriginal.isNull () ||
+      (m_imageOriginalKey != pixmap.cacheKey ())) {
+    if (!m_imageFromImport.isNull () &&
+        (m_imageFromImport.size () == pixmap.size ())) {
+      m_imageOriginal = m_imageFromImport;
+    } else {
+      m_imageOriginal = pixmap.toImage ();
+    }
+    m_imageOriginalKey = pixmap.cacheKey ();
+  }
+  m_imageFromImport = QImage ();
+  const QImage &imageOriginal = m_imageOriginal;
+
+  // Full resolution is drawn from the pixmap, which the Document already holds, so no full resolution tiles are made
+  m_imageUnfiltered = new GraphicsImagePyramid (pixmap,
+                                                imageOriginal,
+                                                m_tileCacheMegabytes);
+  m_scene->addItem (m_imageUnfiltered);
 
   // Reset scene rectangle or else small image after large image will be off-center
   m_scene->setSceneRect (m_imageUnfiltered->boundingRect ());
 
-  // Filtered image
-  ColorFilter filter;
-  QImage imageUnfiltered (pixmap.toImage ());
-  QImage imageFiltered (pixmap.width (),
-                        pixmap.height (),
-                        QImage::Format_RGB32);
-  QRgb rgbBackground = filter.marginColor (&imageUnfiltered);
-  filter.filterImage (imageUnfiltered,
-                      imageFiltered,
-                      cmdMediator().document().modelColorFilter().colorFilterMode(selectedGraphCurve ()),
-                      cmdMediator().document().modelColorFilter().low(selectedGraphCurve ()),
-                      cmdMediator().document().modelColorFilter().high(selectedGraphCurve ()),
-                      rgbBackground);
-
-  m_imageFiltered = m_scene->addPixmap (QPixmap::fromImage (imageFiltered));
-  m_imageFiltered->setData (DATA_KEY_IDENTIFIER, "view");
-  m_imageFiltered->setData (DATA_KEY_GRAPHICS_ITEM_TYPE, GRAPHICS_ITEM_TYPE_IMAGE);
+  // Filtered image. A new import was filtered already by LoadImageThread, with the default settings of a new Document
+  QImage imageFiltered;
+  if (!m_imageFilteredFromImport.isNull () &&
+      (m_imageFilteredFromImport.size () == pixmap.size ()) &&
+      !m_transformation.transformIsDefined ()) {
+
+    imageFiltered = m_imageFilteredFromImport;
+
+  } else {
+
+    // The grid lines are removed from a copy of the original image
+    ColorFilter filter;
+    QImage imageUnfiltered (imageOriginal);
+    imageFiltered = QImage (pixmap.width (),
+                            pixmap.height (),
+                            QImage::Format_RGB32);
+    QRgb rgbBackground = filter.marginColor (&imageUnfiltered);
+    if (m_transformation.transformIsDefined ()) {
+      m_gridRemoval.removeGridLines (m_transformation,
+                                     cmdMediator().document().modelGridRemoval(),
+                                     rgbBackground,
+                                     imageUnfiltered);
+    }
+    filter.filterImage (imageUnfiltered,
+                        imageFiltered,
+                        cmdMediator().document().modelColorFilter().colorFilterMode(selectedGraphCurve ()),
+                        cmdMediator().document().modelColorFilter().low(selectedGraphCurve ()),
+                        cmdMediator().document().modelColorFilter().high(selectedGraphCurve ()),
+                        rgbBackground);
+  }
+  m_imageFilteredFromImport = QImage ();
+
+  m_imageFiltered = new GraphicsImagePyramid (imageFiltered,
+                                              m_tileCacheMegabytes);
+  m_scene->addItem (m_imageFiltered);
 }
 
 void MainWindow::updateRecentFileList()
@@ -2658,6 +2973,8 @@ void MainWindow::updateSettingsGridRemoval(const DocumentModelGridRemoval &model
   LOG4CPP_INFO_S ((*mainCat)) << "MainWindow::updateSettingsGridRemoval";
 
   m_cmdMediator->document().setModelGridRemoval(modelGridRemoval);
+  updateImages (cmdMediator().document().pixmap());
+  updateViewedBackground ();
 }
 
 void MainWindow::updateSettingsPointMatch(const DocumentModelPointMatch &modelPointMatch)
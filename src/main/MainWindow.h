@@ -2,9 +2,14 @@
 #define MAIN_WINDOW_H
 
 #include "BackgroundImage.h"
+#include "GridRemoval.h"
+#include "PointIdTable.h"
 #include <QCursor>
+#include <QImage>
 #include <QMainWindow>
+#include <QStringList>
 #include <QUrl>
+#include <QVector>
 #include "Transformation.h"
 
 class CmdMediator;
@@ -27,9 +32,11 @@ class DocumentModelColorFilter;
 class DocumentModelGridRemoval;
 class DocumentModelPointMatch;
 class DocumentModelSegments;
+class GraphicsImagePyramid;
 class GraphicsScene;
 class GraphicsView;
 class LoadImageFromUrl;
+class LoadImageThread;
 class QAction;
 class QActionGroup;
 class QCloseEvent;
@@ -37,8 +44,10 @@ class QComboBox;
 class QDomDocument;
 class QGraphicsLineItem;
 class QGraphicsPixmapItem;
+class QGraphicsRectItem;
 class QMenu;
 class QSettings;
+class QTimer;
 class QToolBar;
 class QVBoxLayout;
 class StatusBar;
@@ -94,9 +103,9 @@ public:
   /// Call MainWindow::updateControls (which is private) after the very specific case - a mouse press/release.
   void updateAfterMouseRelease();
 
-  /// Update the graphics lines so they follow the graphics points, after a drag, addition, removal, and such. The points
-  /// in the Document may (and probably are) out of date with respect to the graphics points
-  void updateGraphicsLinesToMatchGraphicsPoints();
+  /// Update the graphics lines so they follow the specified graphics points, after they were moved. Only the lines of
+  /// the curves containing those points are updated
+  void updateGraphicsLinesToMatchGraphicsPoints(const QVector<PointId> &pointIds);
 
   /// Update with new axes indicator properties.
   void updateSettingsAxesChecker(const DocumentModelAxesChecker &modelAxesChecker);
@@ -155,7 +164,11 @@ private slots:
   void slotFileImport();
   void slotFileImportDraggedImage(QImage);
   void slotFileImportDraggedImageUrl(QUrl);
-  void slotFileImportImage(QString, QImage);
+  void slotFileImportData(QString, QByteArray);
+  void slotFileImportFailed(QString, QString);
+  void slotFileImportFile(QString);
+  void slotFileImportImage(QString, QImage, QImage);
+  void slotFileImportPreview(QString, QImage, QSize);
   void slotFileOpen();
   void slotFilePrint();
   bool slotFileSave(); /// Slot method that is sometimes called directly with return value expected
@@ -178,6 +191,7 @@ private slots:
   void slotSettingsGridRemoval ();
   void slotSettingsPointMatch ();
   void slotSettingsSegments ();
+  void slotTimeoutDragLines ();
   void slotUndoTextChanged (const QString &);
   void slotViewGroupBackground(QAction*);
   void slotViewGroupPoints(QAction*);
@@ -208,6 +222,7 @@ private:
   MainWindow();
 
   virtual void closeEvent(QCloseEvent *event);
+  void abandonLoadImageThread (); // Disconnects any image that is still being decoded, which deletes itself later
   void createActions();
   void createActionsDigitize ();
   void createActionsEdit ();
@@ -227,6 +242,7 @@ private:
   void createStatusBar();
   void createToolBars();
   void fileImport (const QString &fileName);
+  bool isSignalFromLoadImageThread () const; // False for a signal that was queued by an abandoned LoadImageThread
   void loadCurveListFromCmdMediator(); /// Update the combobox that has the curve names.
   void loadDocumentFile (const QString &fileName);
   void loadErrorReportFile(const QString &initialPath,
@@ -237,6 +253,7 @@ private:
   void loadToolTips ();
   bool maybeSave();
   void rebuildRecentFileListForCurrentFile(const QString &filePath);
+  void removeImagePreview ();
   void removePixmaps();
   bool saveDocumentFile(const QString &fileName);
   void setCurrentFile(const QString &fileName);
@@ -248,6 +265,7 @@ private:
   void settingsWrite ();
   void setupAfterLoad (const QString &fileName,
                        const QString &temporaryMessage);
+  void startLoadImageThread (LoadImageThread *loadImageThread); // Replaces any import that is still being decoded
   void updateAfterCommandStatusBarCoords ();
   void updateControls (); // Update the widgets (typically in terms of show/hide state) depending on the application state.
   void updateImages (const QPixmap &pixmap);
@@ -342,17 +360,26 @@ private:
   QVBoxLayout *m_layout;
   GraphicsScene *m_scene;
   GraphicsView *m_view;
+  QTimer *m_timerDragLines; // Throttles line updates while dragging points to about the display refresh rate
 
-  QGraphicsPixmapItem *m_imageNone; // White background with boundary indicating the edge of the original image
-  QGraphicsPixmapItem *m_imageUnfiltered; // Original unfiltered image
-  QGraphicsPixmapItem *m_imageFiltered; // Image produced by Filter class
+  QGraphicsRectItem *m_imageNone; // White background, drawn with a brush, covering the extent of the original image
+  GraphicsImagePyramid *m_imageUnfiltered; // Original unfiltered image
+  GraphicsImagePyramid *m_imageFiltered; // Image produced by Filter class
+  int m_tileCacheMegabytes; // Memory budget for the tile pixmaps of each GraphicsImagePyramid, from the settings
 
   StatusBar *m_statusBar;
   Transformation m_transformation;
+  GridRemoval m_gridRemoval; // Grid removal stage ahead of the color filter. Caches rasterized grid lines between updates
+  QImage m_imageOriginal; // Original image, kept while the pixmap is unchanged so m_gridRemoval recognizes it
+  qint64 m_imageOriginalKey; // Cache key of the pixmap that m_imageOriginal was converted from
 
   QComboBox *m_cmbCurve;
   QToolBar *m_toolDigitize;
   LoadImageFromUrl *m_loadImageFromUrl;
+  LoadImageThread *m_loadImageThread; // Import that is being decoded, if any
+  QGraphicsPixmapItem *m_imagePreview; // Downscaled preview shown while the import is being decoded
+  QImage m_imageFilteredFromImport; // Filtered image from LoadImageThread, used once by updateImages
+  QImage m_imageFromImport; // Decoded image from LoadImageThread, used once by updateImages as the original image
 
   QComboBox *m_cmbBackground;
   QToolBar *m_toolBackground;